@@ -42,9 +42,11 @@
 #include "MotionModels/MotionModelMethod.h"
 #include "ObservationModels/ObservationModelMethod.h"
 #include "SpaceInformation/SpaceInformation.h"
+#include "Utils/FIRMUtils.h"
 #include "ompl/base/Cost.h"
 #include "boost/date_time/local_time/local_time.hpp"
 #include <boost/thread.hpp>
+#include <memory>
 
 /** \brief Base class for Controller. A controller's task is to use the filter to estimate the belief robot's state and
           generate control commands using the separated controller. For example by fusing an LQR and Kalman Filter
@@ -131,10 +133,55 @@ class Controller
         static void setMaxTrajectoryDeviation(double dev) {nominalTrajDeviationThreshold_ = dev; }
 
         /** \brief Return the number of linear systems. */
-        size_t Length() { return lss_.size(); }
+        size_t Length() const { return lss_.size(); }
+
+        /** \brief Hand the nominal states and controls the controller was built from over to the controller. They are freed
+                   together with the controller's own copies once the last copy of this controller is destroyed. */
+        void adoptNominalTrajectory(const std::vector<ompl::base::State*> &nominalXs, const std::vector<ompl::control::Control*> &nominalUs)
+        {
+            assert(ownedMemory_);
+            ownedMemory_->states.insert(ownedMemory_->states.end(), nominalXs.begin(), nominalXs.end());
+            ownedMemory_->controls.insert(ownedMemory_->controls.end(), nominalUs.begin(), nominalUs.end());
+        }
+
+        /** \brief Get the nominal states and controls the controller was built from, used to save the controller with the roadmap. */
+        void getNominalTrajectory(std::vector<arma::colvec> &nominalXs, std::vector<arma::colvec> &nominalUs)
+        {
+            nominalXs.clear();
+            nominalUs.clear();
+
+            for(size_t i = 0; i < lss_.size(); i++)
+            {
+                nominalXs.push_back(lss_[i].getX()->as<StateType>()->getArmaData());
+                nominalUs.push_back(si_->getMotionModel()->OMPL2ARMA(lss_[i].getU()));
+            }
+        }
 
     private:
 
+        /** \brief The states and controls that the copies of a controller point to. Controllers are copied around by value,
+                    so the memory is released when the last copy lets go of it. */
+        struct OwnedMemory
+        {
+            SpaceInformationPtr si;
+
+            std::vector<ompl::base::State*> states;
+
+            std::vector<ompl::control::Control*> controls;
+
+            ~OwnedMemory()
+            {
+                for(size_t i = 0; i < states.size(); i++)
+                    si->freeState(states[i]);
+
+                for(size_t i = 0; i < controls.size(); i++)
+                    si->freeControl(controls[i]);
+            }
+        };
+
+        /** \brief Shared by all copies of this controller, NULL for a default constructed controller. */
+        std::shared_ptr<OwnedMemory> ownedMemory_;
+
         /** \brief The pointer to the space information. */
         SpaceInformationPtr si_; // Instead of the actuation system, in OMPL we have the spaceinformation
 
@@ -205,6 +252,12 @@ Controller<SeparatedControllerType, FilterType>::Controller(const ompl::base::St
 
   si_->copyState(goal_, goal);
 
+  ownedMemory_ = std::make_shared<OwnedMemory>();
+
+  ownedMemory_->si = si_;
+
+  ownedMemory_->states.push_back(goal_);
+
   lss_.reserve(nominalXs.size());
 
   for(size_t i=0; i<nominalXs.size(); ++i)
@@ -213,6 +266,9 @@ Controller<SeparatedControllerType, FilterType>::Controller(const ompl::base::St
     LinearSystem ls(si_, nominalXs[i], nominalUs[i], si_->getMotionModel(), si_->getObservationModel());
 
     lss_.push_back(ls);
+
+    // the linear system works on its own copy of the nominal state
+    ownedMemory_->states.push_back(ls.getX());
   }
 
   //copy construct separated controller
@@ -322,7 +378,7 @@ bool Controller<SeparatedControllerType, FilterType>::Execute(const ompl::base::
 
         if(!constructionMode)
         {
-          boost::this_thread::sleep(boost::posix_time::milliseconds(20));
+          FIRMUtils::waitForViewer(20);
         }
     }
 
@@ -384,7 +440,8 @@ bool Controller<SeparatedControllerType, FilterType>::executeOneStep(const int k
     ompl::base::State *internalState = si_->allocState();
     si_->copyState(internalState, startState);
 
-    ompl::base::State  *nominalX_K = si_->allocState();
+    // points into the nominal trajectory, owned by the linear system
+    ompl::base::State  *nominalX_K = NULL;
 
     this->Evolve(internalState, k, endState) ;
 
@@ -395,6 +452,7 @@ bool Controller<SeparatedControllerType, FilterType>::executeOneStep(const int k
     {
         if(!si_->checkTrueStateValidity())
         {
+            si_->freeState(internalState);
             return false;
         }
     }
@@ -410,6 +468,7 @@ bool Controller<SeparatedControllerType, FilterType>::executeOneStep(const int k
 
     if(abs(norm(deviation,2)) > nominalTrajDeviationThreshold_ || !si_->checkTrueStateValidity())
     {
+      si_->freeState(internalState);
       return false;
     }
 
@@ -419,7 +478,7 @@ bool Controller<SeparatedControllerType, FilterType>::executeOneStep(const int k
     arma::mat tempCovMat = endState->as<StateType>()->getCovariance();
     cost += arma::trace(tempCovMat);
 
-    if(!constructionMode) boost::this_thread::sleep(boost::posix_time::milliseconds(20));
+    if(!constructionMode) FIRMUtils::waitForViewer(20);
 
     //filteringCost.v = cost;
     filteringCost = ompl::base::Cost(cost);
@@ -515,6 +574,8 @@ void Controller<SeparatedControllerType, FilterType>::Evolve(const ompl::base::S
 
     si_->setBelief(nextBelief);
 
+    si_->freeState(nextBelief);
+
 }
 
 
@@ -553,7 +614,7 @@ void Controller<SeparatedControllerType, FilterType>::Stabilize(const ompl::base
 
         if(!constructionMode)
         {
-            boost::this_thread::sleep(boost::posix_time::milliseconds(20));
+            FIRMUtils::waitForViewer(20);
         }
 
     }
@@ -0,0 +1,149 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef BATCH_EXPERIMENT_H
+#define BATCH_EXPERIMENT_H
+
+#include <string>
+#include <vector>
+#include "Planner/FIRM.h"
+
+class TiXmlElement;
+
+/**
+    @par Short Description
+    Runs a list of jobs (setup file, seed, parameter overrides) without the GUI and collects what
+    every run did into one table. Each job runs in its own process, so the global state of a run
+    (the Visualizer, the random generators, the static parameters of the belief space) cannot leak
+    into another, and a run that crashes or hangs only loses its own row.
+
+    A parameter override has the form "Element/Child@attribute=value", e.g.
+    "FIRM/MCParticles@numparticles=20", and is applied to the parsed setup file in memory
+    (see SetupConfiguration). All files of a job are kept in the output directory: job-<id>.log
+    (its console output) and job-<id>.result.
+
+    \brief Headless batch experiment driver.
+*/
+class BatchExperiment
+{
+    public:
+
+        struct Job
+        {
+            unsigned int id;
+
+            std::string setupFile;
+
+            unsigned int seed;
+
+            std::vector<std::string> overrides;
+        };
+
+        struct Result
+        {
+            Job job;
+
+            /** \brief "ok", "failed" (exited without a result), "crashed" or "timeout" */
+            std::string status;
+
+            /** \brief The planner found a policy */
+            bool solved;
+
+            FIRM::RunStatistics statistics;
+
+            /** \brief Wall time of the whole job, seconds */
+            double wallTime;
+        };
+
+        /** \brief All files are written to outputDirectory, it is created if needed */
+        BatchExperiment(const std::string &outputDirectory);
+
+        /** \brief Add a job, returns its id */
+        unsigned int addJob(const std::string &setupFile, unsigned int seed, const std::vector<std::string> &overrides);
+
+        /** \brief Number of jobs that run at the same time, 0 uses all cores */
+        void setNumWorkers(unsigned int numWorkers)
+        {
+            numWorkers_ = numWorkers;
+        }
+
+        /** \brief A job still running after this many seconds is killed, 0 waits forever */
+        void setTimeout(double seconds)
+        {
+            timeout_ = seconds;
+        }
+
+        /** \brief Run all jobs, returns their results in the order they were added */
+        const std::vector<Result>& run();
+
+        /** \brief Write one row per job to path (CSV) */
+        bool writeResults(const std::string &path) const;
+
+        /** \brief Write one row per setup file and set of overrides with the success rate and the mean of the metrics (CSV) */
+        bool writeSummary(const std::string &path) const;
+
+        /** \brief Run a job in the calling process */
+        static Result runJob(const Job &job);
+
+        /** \brief Quote a CSV field if it contains a comma or a quote */
+        static std::string csvField(const std::string &field);
+
+        /** \brief The seeds listed in the seeds attribute of an experiment file element, e.g. seeds = "1 2 3". Seed 1 if there are none. */
+        static std::vector<unsigned int> readSeeds(const TiXmlElement *element);
+
+        /** \brief Append the overrides of the <Set value = "Element/Child@attribute=value" /> children of element */
+        static void readOverrides(const TiXmlElement *element, std::vector<std::string> &overrides);
+
+    private:
+
+        /** \brief Fork a worker process for the job, returns its pid or -1 */
+        int startJob(const Job &job);
+
+        /** \brief Fill in the result of a finished worker from its result file and exit status */
+        void finishJob(Result &result, int exitStatus);
+
+        std::string jobPath(const Job &job, const std::string &extension) const;
+
+        std::string outputDirectory_;
+
+        std::vector<Job> jobs_;
+
+        std::vector<Result> results_;
+
+        unsigned int numWorkers_;
+
+        double timeout_;
+};
+
+#endif
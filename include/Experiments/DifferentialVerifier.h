@@ -0,0 +1,165 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef DIFFERENTIAL_VERIFIER_H
+#define DIFFERENTIAL_VERIFIER_H
+
+#include <string>
+#include <vector>
+#include <boost/function.hpp>
+#include "Experiments/NamedRunner.h"
+
+/** \brief The results of one variant in one trial, see DifferentialVerifier */
+struct DifferentialOutput
+{
+    std::vector<double> values;
+
+    std::vector<long> decisions;
+};
+
+/** \brief Two values agree if they differ by at most absolute or by at most relative times the larger magnitude */
+struct DifferentialTolerance
+{
+    double absolute;
+
+    double relative;
+
+    /** \brief Fraction of the decisions that may differ */
+    double decisions;
+};
+
+/** \brief A reference and a candidate implementation compared by DifferentialVerifier */
+struct DifferentialCheck
+{
+    /** \brief Fills output with the results of a trial */
+    typedef boost::function<void(unsigned int trial, DifferentialOutput &output)> Variant;
+
+    Variant reference;
+
+    Variant candidate;
+
+    DifferentialTolerance tolerance;
+};
+
+/** \brief How far apart the variants of a check were over all trials */
+struct DifferentialResult
+{
+    std::string name;
+
+    unsigned int trials;
+
+    /** \brief Values and decisions compared over all trials */
+    std::size_t values;
+
+    std::size_t decisions;
+
+    double maxAbsoluteDeviation;
+
+    double maxRelativeDeviation;
+
+    /** \brief Values outside of the tolerance */
+    std::size_t valueMismatches;
+
+    std::size_t decisionMismatches;
+
+    /** \brief The variants returned a different number of values or decisions in some trial */
+    bool sizeMismatch;
+
+    DifferentialTolerance tolerance;
+
+    bool passed;
+};
+
+/**
+    @par Short Description
+    Runs a reference implementation and a faster alternative (a filter, a DP solver, a collision
+    backend) on the same inputs and reports how far apart their results are. Both variants of a
+    check produce numbers (means, covariances, costs-to-go) and discrete decisions (the feedback
+    edge of a node, whether a landmark is visible). The numbers are compared element by element
+    with an absolute and a relative tolerance, the decisions by the fraction that differ.
+
+    Every trial runs both variants with the random generators of the planner (armadillo and rand())
+    seeded the same way, with seed + trial, so that noise drawn inside a variant is the same for both.
+
+    \brief Runner for the bsp-verify differential checks.
+*/
+class DifferentialVerifier : public NamedRunner<DifferentialCheck, DifferentialResult>
+{
+    public:
+
+        typedef DifferentialOutput Output;
+
+        typedef DifferentialCheck::Variant Variant;
+
+        typedef DifferentialTolerance Tolerance;
+
+        typedef DifferentialResult Result;
+
+        /** \brief Trial t seeds the generators with seed + t */
+        DifferentialVerifier(unsigned int seed);
+
+        /** \brief Register a check, name identifies it in the output */
+        void add(const std::string &name, const Variant &reference, const Variant &candidate, const Tolerance &tolerance);
+
+        /** \brief Replace the tolerance of the check called name, returns false if there is none */
+        bool setTolerance(const std::string &name, const Tolerance &tolerance);
+
+        /** \brief Number of trials of every check */
+        void setTrials(unsigned int trials)
+        {
+            trials_ = trials;
+        }
+
+        /** \brief True if every check that ran stayed within its tolerance */
+        bool passed() const;
+
+        /** \brief One row per check, the run parameters go to the JSON output */
+        virtual ResultTable getResultTable() const;
+
+    protected:
+
+        virtual Result runEntry(const std::string &name, const DifferentialCheck &check);
+
+        virtual void report(const Result &result) const;
+
+    private:
+
+        void seedTrial(unsigned int trial) const;
+
+        unsigned int seed_;
+
+        unsigned int trials_;
+};
+
+#endif
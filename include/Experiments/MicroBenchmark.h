@@ -0,0 +1,131 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef MICRO_BENCHMARK_H
+#define MICRO_BENCHMARK_H
+
+#include <string>
+#include <vector>
+#include <boost/function.hpp>
+#include "Experiments/NamedRunner.h"
+
+/** \brief Timing of one kernel, see MicroBenchmark */
+struct MicroBenchmarkResult
+{
+    std::string name;
+
+    unsigned int iterations;
+
+    double meanNs;
+
+    double medianNs;
+
+    double p90Ns;
+
+    double minNs;
+
+    double maxNs;
+
+    double stdDevNs;
+};
+
+/**
+    @par Short Description
+    Times small kernels (a filter step, a Jacobian, a DARE solve, a collision check) in isolation.
+    Every kernel is warmed up, then called until it has run for at least the minimum number of
+    iterations and the minimum time, each call timed on its own so that the median and the tail are
+    reported next to the mean. The random generators used by the planner (armadillo and rand())
+    are reseeded before every kernel, so a kernel sees the same noise no matter which kernels ran
+    before it.
+
+    \brief Runner for the bsp-bench microbenchmarks.
+*/
+class MicroBenchmark : public NamedRunner<boost::function<void()>, MicroBenchmarkResult>
+{
+    public:
+
+        typedef boost::function<void()> Kernel;
+
+        typedef MicroBenchmarkResult Result;
+
+        /** \brief seed is applied before every kernel */
+        MicroBenchmark(unsigned int seed);
+
+        /** \brief Calls made before timing starts */
+        void setWarmupIterations(unsigned int n)
+        {
+            warmupIterations_ = n;
+        }
+
+        /** \brief Every kernel runs at least n timed iterations */
+        void setMinIterations(unsigned int n)
+        {
+            minIterations_ = n;
+        }
+
+        /** \brief Every kernel runs for at least this many seconds, unless it reaches the maximum number of iterations */
+        void setMinTime(double seconds)
+        {
+            minTime_ = seconds;
+        }
+
+        /** \brief Upper bound on the timed iterations of a kernel */
+        void setMaxIterations(unsigned int n)
+        {
+            maxIterations_ = n;
+        }
+
+        /** \brief One row per kernel, the run parameters go to the JSON output */
+        virtual ResultTable getResultTable() const;
+
+    protected:
+
+        virtual Result runEntry(const std::string &name, const Kernel &kernel);
+
+        virtual void report(const Result &result) const;
+
+    private:
+
+        unsigned int seed_;
+
+        unsigned int warmupIterations_;
+
+        unsigned int minIterations_;
+
+        unsigned int maxIterations_;
+
+        double minTime_;
+};
+
+#endif
@@ -0,0 +1,118 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef NAMED_RUNNER_H
+#define NAMED_RUNNER_H
+
+#include <string>
+#include <utility>
+#include <vector>
+#include "Experiments/ResultTable.h"
+
+/**
+    @par Short Description
+    Keeps named entries (benchmark kernels, verification checks) in the order they were added and
+    runs those whose name contains the filter, one result per entry. The runners only implement
+    how an entry is run, how its result is logged and how the results become a ResultTable.
+
+    \brief Base of the runners behind bsp-bench and bsp-verify.
+*/
+template <class Entry, class Result>
+class NamedRunner
+{
+    public:
+
+        virtual ~NamedRunner()
+        {
+        }
+
+        /** \brief Register an entry, name identifies it in the output */
+        void add(const std::string &name, const Entry &entry)
+        {
+            entries_.push_back(std::make_pair(name, entry));
+        }
+
+        /** \brief Only run entries whose name contains filter */
+        void setFilter(const std::string &filter)
+        {
+            filter_ = filter;
+        }
+
+        /** \brief True if the entry called name runs with the current filter */
+        bool isSelected(const std::string &name) const
+        {
+            return filter_.empty() || name.find(filter_) != std::string::npos;
+        }
+
+        /** \brief Run the selected entries in the order they were added */
+        const std::vector<Result>& run()
+        {
+            results_.clear();
+
+            for(size_t i = 0; i < entries_.size(); i++)
+            {
+                if(!isSelected(entries_[i].first))
+                    continue;
+
+                results_.push_back(runEntry(entries_[i].first, entries_[i].second));
+
+                report(results_.back());
+            }
+
+            return results_;
+        }
+
+        const std::vector<Result>& getResults() const
+        {
+            return results_;
+        }
+
+        /** \brief The results of the last run, one row per entry */
+        virtual ResultTable getResultTable() const = 0;
+
+    protected:
+
+        virtual Result runEntry(const std::string &name, const Entry &entry) = 0;
+
+        /** \brief Log the result of an entry right after it ran */
+        virtual void report(const Result &result) const = 0;
+
+        std::vector<std::pair<std::string, Entry> > entries_;
+
+        std::vector<Result> results_;
+
+        std::string filter_;
+};
+
+#endif
@@ -0,0 +1,211 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef PARAMETER_TUNER_H
+#define PARAMETER_TUNER_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "Experiments/BatchExperiment.h"
+
+/**
+    @par Short Description
+    Searches the planner parameters of a setup file (NNRadius, NumNN, MCParticles, RolloutSteps,
+    the NBM3P sampling grid, ...) for the cheapest configuration that meets a target, and writes
+    it back as a setup file. The target is a success rate floor and a planning time budget: among
+    the candidates whose runs reach the goal without collision often enough, the one with the
+    lowest mean planning time (roadmap construction and dynamic programming) within the budget
+    wins. If no candidate meets the target, the one with the highest success rate is written.
+
+    The search is described by a tuning file:
+
+    \verbatim
+    <Tuning name = "Task3" setup = "./SetupFiles/Task3.xml" seeds = "1 2 3" timeout = "900" strategy = "coordinate">
+        <Target successRate = "0.8" planningTime = "120" />
+        <Set value = "FIRM/Roadmap@save=0" />
+        <Parameter path = "FIRM/NNRadius@nnradius" values = "2.0 3.0 4.0" />
+        <Parameter path = "FIRM/MCParticles@numparticles" min = "5" max = "40" step = "5" />
+    </Tuning>
+    \endverbatim
+
+    Set elements apply to the runs only, the written setup file holds the original values with
+    the tuned parameters replaced. A parameter lists its values or spans min to max in steps.
+
+    The strategy "grid" runs every combination of the values. "coordinate" starts from the
+    middle value of every parameter and sweeps one parameter at a time with the others fixed at
+    their best value so far, until a full pass brings no improvement; it needs far fewer runs
+    when there are more than two parameters. Every candidate runs once per seed as a job of a
+    BatchExperiment, i.e. in its own headless process, and is never run twice.
+
+    \brief Parameter tuning sweep over a setup file.
+*/
+class ParameterTuner
+{
+    public:
+
+        struct Parameter
+        {
+            /** \brief "Element/Child@attribute" */
+            std::string path;
+
+            std::vector<std::string> values;
+        };
+
+        /** \brief A set of parameter values, by index into Parameter::values, and how its runs did */
+        struct Candidate
+        {
+            std::vector<size_t> choice;
+
+            unsigned int runs;
+
+            /** \brief Runs that reached the goal without collision */
+            unsigned int successes;
+
+            /** \brief Runs that did not finish ("crashed", "failed" or "timeout") */
+            unsigned int failures;
+
+            /** \brief Mean over the solved runs, seconds */
+            double meanPlanningTime;
+
+            /** \brief Mean over the successful runs */
+            double meanExecutionCost;
+
+            double meanWallTime;
+
+            double successRate() const
+            {
+                return runs ? double(successes)/runs : 0;
+            }
+        };
+
+        /** \brief Load the tuning file, exits if it cannot be loaded. All runs are written to outputDirectory. */
+        ParameterTuner(const std::string &pathToTuningFile, const std::string &outputDirectory);
+
+        /** \brief Replace the seeds of the tuning file */
+        void setSeeds(const std::vector<unsigned int> &seeds)
+        {
+            seeds_ = seeds;
+        }
+
+        /** \brief Replace the strategy of the tuning file, "grid" or "coordinate" */
+        void setStrategy(const std::string &strategy)
+        {
+            strategy_ = strategy;
+        }
+
+        /** \brief Number of runs that execute at the same time, 0 uses all cores. Planning times are only comparable if
+                   the runs do not compete for the cores, so keep it low when the time budget matters. */
+        void setNumWorkers(unsigned int numWorkers)
+        {
+            numWorkers_ = numWorkers;
+        }
+
+        const std::vector<Parameter>& getParameters() const
+        {
+            return parameters_;
+        }
+
+        /** \brief Search the parameters and write candidates.csv to the output directory. Returns false if nothing could be
+                   evaluated or a file could not be written. */
+        bool run();
+
+        /** \brief Write the setup file with the values of the best candidate */
+        bool writeBestSetup(const std::string &path) const;
+
+        /** \brief The best candidate found by run() */
+        const Candidate& getBest() const
+        {
+            return candidates_.at(best_);
+        }
+
+        /** \brief The candidate meets the success rate floor and the planning time budget */
+        bool meetsTarget(const Candidate &candidate) const;
+
+    private:
+
+        /** \brief Run the candidates that were not evaluated yet, one BatchExperiment per round */
+        void evaluate(const std::vector<std::vector<size_t> > &choices);
+
+        /** \brief Returns true if a is better than b */
+        bool isBetter(const Candidate &a, const Candidate &b) const;
+
+        /** \brief Index of the best evaluated candidate among choices */
+        size_t bestOf(const std::vector<std::vector<size_t> > &choices) const;
+
+        void searchGrid();
+
+        void searchCoordinate();
+
+        /** \brief The overrides that set the parameters to choice */
+        std::vector<std::string> parameterOverrides(const std::vector<size_t> &choice) const;
+
+        bool writeCandidates(const std::string &path) const;
+
+        std::string name_;
+
+        std::string setupFile_;
+
+        std::string outputDirectory_;
+
+        std::string strategy_;
+
+        std::vector<Parameter> parameters_;
+
+        /** \brief Overrides that only apply to the runs */
+        std::vector<std::string> runOverrides_;
+
+        std::vector<unsigned int> seeds_;
+
+        double minSuccessRate_;
+
+        /** \brief Planning time budget, seconds, 0 for none */
+        double planningTimeBudget_;
+
+        double timeout_;
+
+        unsigned int numWorkers_;
+
+        unsigned int rounds_;
+
+        /** \brief Every evaluated candidate, in the order it was run */
+        std::vector<Candidate> candidates_;
+
+        /** \brief Index into candidates_ by choice */
+        std::map<std::vector<size_t>, size_t> evaluated_;
+
+        size_t best_;
+};
+
+#endif
@@ -0,0 +1,136 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef PLANNER_BENCHMARK_H
+#define PLANNER_BENCHMARK_H
+
+#include <string>
+#include <vector>
+#include "Experiments/BatchExperiment.h"
+
+/**
+    @par Short Description
+    Runs a fixed set of scenarios end to end (roadmap construction or loading, dynamic programming,
+    execution with plain feedback, rollout or kidnapping and NBM3P recovery) over fixed seeds with
+    the same planning budget, so that runs of different commits can be compared.
+
+    The scenarios are read from a benchmark file:
+
+    \verbatim
+    <Benchmark name = "Reference" seeds = "1 2 3" budget = "120" timeout = "1800">
+        <Set value = "FIRM/Policy@save=0" />
+        <Scenario name = "TROSims-Rollout" setup = "./SetupFiles/SetupTROSims.xml">
+            <Set value = "PlanningProblem/PlannerMode@method=1" />
+        </Scenario>
+    </Benchmark>
+    \endverbatim
+
+    Set elements directly under Benchmark apply to every scenario. The budget (seconds) overrides
+    PlanningProblem/PlanningTime@maxTime of every scenario, a run still going after timeout seconds
+    is killed. Every run is a job of a BatchExperiment, i.e. its own process.
+
+    Next to results.csv and summary.csv, one log per setup file is written in the format of
+    ompl::tools::Benchmark (the scenarios of the setup file are its planners), so the logs can be
+    loaded with ompl_benchmark_statistics.py and viewed in Planner Arena.
+
+    \brief End-to-end benchmark of the planner over reference scenarios.
+*/
+class PlannerBenchmark
+{
+    public:
+
+        struct Scenario
+        {
+            std::string name;
+
+            std::string setupFile;
+
+            /** \brief The overrides of the benchmark followed by those of the scenario */
+            std::vector<std::string> overrides;
+        };
+
+        /** \brief Load the benchmark file, exits if it cannot be loaded. The results go to outputDirectory. */
+        PlannerBenchmark(const std::string &pathToBenchmarkFile, const std::string &outputDirectory);
+
+        /** \brief Replace the seeds of the benchmark file */
+        void setSeeds(const std::vector<unsigned int> &seeds)
+        {
+            seeds_ = seeds;
+        }
+
+        /** \brief Replace the planning budget of the benchmark file, seconds */
+        void setBudget(double seconds)
+        {
+            budget_ = seconds;
+        }
+
+        /** \brief Number of runs that execute at the same time, 0 uses all cores. Runs share the machine, so use 1 for timings. */
+        void setNumWorkers(unsigned int numWorkers)
+        {
+            numWorkers_ = numWorkers;
+        }
+
+        const std::vector<Scenario>& getScenarios() const
+        {
+            return scenarios_;
+        }
+
+        /** \brief Run every scenario with every seed and write the results, returns false if a file could not be written */
+        bool run();
+
+    private:
+
+        /** \brief Write the runs of the scenarios that use setupFile as an OMPL benchmark log */
+        bool writeLog(const std::string &path, const std::string &setupFile, const std::vector<BatchExperiment::Result> &results,
+                      double totalDuration) const;
+
+        std::string name_;
+
+        std::string outputDirectory_;
+
+        std::vector<Scenario> scenarios_;
+
+        std::vector<unsigned int> seeds_;
+
+        double budget_;
+
+        double timeout_;
+
+        unsigned int numWorkers_;
+
+        /** \brief The scenario of every job, by job id */
+        std::vector<size_t> jobScenarios_;
+};
+
+#endif
@@ -0,0 +1,101 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef RESULT_TABLE_H
+#define RESULT_TABLE_H
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+    @par Short Description
+    The rows a command line tool reports, one per kernel or check, written as CSV (a header and one
+    line per row) or as a JSON object with the run parameters and an array of the rows, keyed by the
+    column names. Every cell carries its CSV and its JSON text, so that names are quoted and flags
+    become true/false in JSON only.
+
+    \brief Result rows of bsp-bench and bsp-verify and how they are written out.
+*/
+class ResultTable
+{
+    public:
+
+        struct Cell
+        {
+            std::string csv;
+
+            std::string json;
+        };
+
+        /** \brief rowsName is the key of the array of rows in the JSON output */
+        ResultTable(const std::string &rowsName, const std::vector<std::string> &columns);
+
+        static Cell text(const std::string &value);
+
+        /** \brief value with precision digits, after the decimal point if fixed is set */
+        static Cell number(double value, int precision, bool fixed = false);
+
+        static Cell count(std::size_t value);
+
+        /** \brief 1 or 0 in CSV, true or false in JSON */
+        static Cell flag(bool value);
+
+        /** \brief A run parameter, only written to JSON */
+        void addParameter(const std::string &name, const Cell &value);
+
+        /** \brief One cell per column */
+        void addRow(const std::vector<Cell> &row);
+
+        bool writeCSV(std::ostream &out) const;
+
+        bool writeJSON(std::ostream &out) const;
+
+        /** \brief Write as "csv" or "json" */
+        bool write(std::ostream &out, const std::string &format) const;
+
+    private:
+
+        std::string rowsName_;
+
+        std::vector<std::string> columns_;
+
+        std::vector<std::pair<std::string, Cell> > parameters_;
+
+        std::vector<std::vector<Cell> > rows_;
+};
+
+#endif
@@ -0,0 +1,111 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef TOOL_DRIVER_H
+#define TOOL_DRIVER_H
+
+#include <string>
+#include <vector>
+#include <boost/program_options.hpp>
+#include "Experiments/ResultTable.h"
+#include "Utils/SetupConfiguration.h"
+
+/**
+    @par Short Description
+    What the command line tools that report a table of results (bsp-bench, bsp-verify) share: the
+    options for the setup file, its overrides, the seed, the filter, the format and the output file,
+    loading the setup, seeding the random generators of the planner and writing the results. With
+    the output "-" the results go to stdout and everything the planner prints is sent to stderr, so
+    that the results can be piped.
+
+    \brief Command line handling shared by bsp-bench and bsp-verify.
+*/
+class ToolDriver
+{
+    public:
+
+        /** \brief name prefixes the log messages, entries is what --filter selects ("kernels", "checks") */
+        ToolDriver(const std::string &name, const std::string &entries, const std::string &defaultSetupFile, const std::string &seedHelp);
+
+        ~ToolDriver();
+
+        /** \brief The options of the tool, the shared ones are already in, tools add their own before parse() */
+        boost::program_options::options_description& getOptions()
+        {
+            return options_;
+        }
+
+        /** \brief Parse the command line. Returns -1 if the tool should go on, otherwise its exit code (0 after --help). */
+        int parse(int argc, char *argv[]);
+
+        /** \brief Point stdout at stderr if the results go to stdout, seed the random generators, run headless and load the setup
+                   file with the --set overrides applied. Returns null if an override does not match the file. */
+        SetupConfiguration::SetupConfigurationPtr start();
+
+        /** \brief Write the table in the requested format to the output, logs an error if it cannot */
+        bool write(const ResultTable &table) const;
+
+        unsigned int getSeed() const
+        {
+            return seed_;
+        }
+
+        const std::string& getFilter() const
+        {
+            return filter_;
+        }
+
+    private:
+
+        std::string name_;
+
+        boost::program_options::options_description options_;
+
+        std::string setupFile_;
+
+        std::vector<std::string> overrides_;
+
+        unsigned int seed_;
+
+        std::string filter_;
+
+        std::string format_;
+
+        std::string outputFile_;
+
+        /** \brief The original stdout while it points at stderr, -1 otherwise */
+        int resultFd_;
+};
+
+#endif
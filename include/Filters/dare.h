@@ -39,11 +39,14 @@
 
 #include "armadillo"
 #include <cassert>
+#include "Utils/Profiler.h"
 
 /** \brief Solver for the Differential Algebraic Riccatti Equation. */
 inline bool dare(const arma::mat& _A, const arma::mat& _B, const arma::mat& _Q, const arma::mat& _R, arma::mat &S)
 
 {
+    FIRM_PROFILE_SCOPE("dare");
+
     using namespace arma;
     using namespace std;
 
@@ -112,6 +112,9 @@ class LinearSystem
     /** \brief  Return the state at which this system was constructed. */
     ompl::base::State* getX() {return x_; }
 
+    /** \brief  Return the control at which this system was constructed. */
+    const ompl::control::Control* getU() const {return u_; }
+
     /** \brief  Get the state transition jacobian. */
     arma::mat getA() const { return motionModel_->getStateJacobian(x_, u_, w_); }
 
@@ -38,6 +38,7 @@
 #define OMNIDIRECTIONAL_MOTIONMODEL_
 
 #include "MotionModelMethod.h"
+#include "Utils/SetupConfiguration.h"
 #include <limits>
 #include <cassert>
 
@@ -57,9 +58,14 @@ class OmnidirectionalMotionModel: public MotionModelMethod
     typedef typename MotionModelMethod::JacobianType JacobianType;
 
     /** \brief XML-based constructor */
-    OmnidirectionalMotionModel(const ompl::control::SpaceInformationPtr si, const char *pathToSetupFile) : MotionModelMethod(si, motionNoiseDim)
+    OmnidirectionalMotionModel(const ompl::control::SpaceInformationPtr si, const SetupConfiguration &config) : MotionModelMethod(si, motionNoiseDim)
+    {
+        this->loadParameters(config);
+    }
+
+    /** \brief Parses the setup file for this model only, prefer passing the configuration the setup already parsed */
+    OmnidirectionalMotionModel(const ompl::control::SpaceInformationPtr si, const char *pathToSetupFile) : OmnidirectionalMotionModel(si, SetupConfiguration(pathToSetupFile))
     {
-        this->loadParameters(pathToSetupFile);
     }
 
     /** \brief Destructor. */
@@ -99,7 +105,7 @@ class OmnidirectionalMotionModel: public MotionModelMethod
     arma::mat controlNoiseCovariance(const ompl::control::Control* control);
 
     /** \brief Load parameters from XML. */
-    void loadParameters(const char *pathToSetupFile);
+    void loadParameters(const SetupConfiguration &config);
 
     /** \brief Bias standard deviation of the motion noise */
     arma::colvec sigma_; //
@@ -38,6 +38,7 @@
 #define LANDMARK_RANGEBEARING_H_
 
 #include "ObservationModelMethod.h"
+#include "Utils/SetupConfiguration.h"
 #include <boost/math/constants/constants.hpp>
 /**
   @par Short Description
@@ -71,12 +72,17 @@ class CamAruco2DObservationModel : public ObservationModelMethod
     // get the observation for a given configuration,
     // corrupted by noise from a given distribution
     /** \brief Constructor */
-    CamAruco2DObservationModel(ompl::control::SpaceInformationPtr si, const char *pathToSetupFile) : ObservationModelMethod(si)
+    CamAruco2DObservationModel(ompl::control::SpaceInformationPtr si, const SetupConfiguration &config) : ObservationModelMethod(si)
     {
 
         // initialize etaPhi_, etaD_, sigma_;
-        this->loadLandmarks(pathToSetupFile);
-        this->loadParameters(pathToSetupFile);
+        this->loadLandmarks(config);
+        this->loadParameters(config);
+    }
+
+    /** \brief Parses the setup file for this model only, prefer passing the configuration the setup already parsed */
+    CamAruco2DObservationModel(ompl::control::SpaceInformationPtr si, const char *pathToSetupFile) : CamAruco2DObservationModel(si, SetupConfiguration(pathToSetupFile))
+    {
     }
 
     ObservationType getObservation(const ompl::base::State *state, bool isSimulation);
@@ -113,6 +119,12 @@ class CamAruco2DObservationModel : public ObservationModelMethod
 
     bool isStateObservable(const ompl::base::State *state);
 
+    /** \brief The landmarks (id, x, y, orientation) loaded from the setup file */
+    const std::vector<arma::colvec>& getLandmarks() const
+    {
+        return landmarks_;
+    }
+
   private:
 
     ObservationType removeSpuriousObservations(const ObservationType& Zg);
@@ -129,9 +141,9 @@ class CamAruco2DObservationModel : public ObservationModelMethod
     std::vector<arma::colvec> landmarks_;
 
     //Function to load landmarks from XML file into the object
-    void loadLandmarks(const char *pathToSetupFile);
+    void loadLandmarks(const SetupConfiguration &config);
 
-    void loadParameters(const char *pathToSetupFile);
+    void loadParameters(const SetupConfiguration &config);
 
     double cameraRange_;
     double cameraHalfFov_;
@@ -38,6 +38,7 @@
 #define HEADING_BEACON_H_
 
 #include "ObservationModelMethod.h"
+#include "Utils/SetupConfiguration.h"
 #include <boost/math/constants/constants.hpp>
 /**
   @par Short Description
@@ -64,12 +65,17 @@ class HeadingBeaconObservationModel : public ObservationModelMethod
     typedef arma::mat JacobianType;
 
     /** \brief Constructor */
-    HeadingBeaconObservationModel(ompl::control::SpaceInformationPtr si, const char *pathToSetupFile) : ObservationModelMethod(si)
+    HeadingBeaconObservationModel(ompl::control::SpaceInformationPtr si, const SetupConfiguration &config) : ObservationModelMethod(si)
     {
 
         // initialize etaPhi_, etaD_, sigma_;
-        this->loadLandmarks(pathToSetupFile);
-        this->loadParameters(pathToSetupFile);
+        this->loadLandmarks(config);
+        this->loadParameters(config);
+    }
+
+    /** \brief Parses the setup file for this model only, prefer passing the configuration the setup already parsed */
+    HeadingBeaconObservationModel(ompl::control::SpaceInformationPtr si, const char *pathToSetupFile) : HeadingBeaconObservationModel(si, SetupConfiguration(pathToSetupFile))
+    {
     }
 
     /** \brief z = h(x,v) get the observation for a given configuration, corrupted by noise from a given distribution */
@@ -111,9 +117,9 @@ class HeadingBeaconObservationModel : public ObservationModelMethod
     std::vector<arma::colvec> landmarks_;
 
     //Function to load landmarks from XML file into the object
-    void loadLandmarks(const char *pathToSetupFile);
+    void loadLandmarks(const SetupConfiguration &config);
 
-    void loadParameters(const char *pathToSetupFile);
+    void loadParameters(const SetupConfiguration &config);
 
     arma::colvec sigmaHeading_;
 
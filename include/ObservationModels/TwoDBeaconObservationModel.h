@@ -38,6 +38,7 @@
 #define TWODBEACON_H_
 
 #include "ObservationModelMethod.h"
+#include "Utils/SetupConfiguration.h"
 #include <boost/math/constants/constants.hpp>
 /**
   @par Short Description
@@ -64,12 +65,17 @@ class TwoDBeaconObservationModel : public ObservationModelMethod
     typedef arma::mat JacobianType;
 
     /** \brief Constructor */
-    TwoDBeaconObservationModel(ompl::control::SpaceInformationPtr si, const char *pathToSetupFile) : ObservationModelMethod(si)
+    TwoDBeaconObservationModel(ompl::control::SpaceInformationPtr si, const SetupConfiguration &config) : ObservationModelMethod(si)
     {
 
         // initialize etaPhi_, etaD_, sigma_;
-        this->loadLandmarks(pathToSetupFile);
-        this->loadParameters(pathToSetupFile);
+        this->loadLandmarks(config);
+        this->loadParameters(config);
+    }
+
+    /** \brief Parses the setup file for this model only, prefer passing the configuration the setup already parsed */
+    TwoDBeaconObservationModel(ompl::control::SpaceInformationPtr si, const char *pathToSetupFile) : TwoDBeaconObservationModel(si, SetupConfiguration(pathToSetupFile))
+    {
     }
 
     /** \brief z = h(x,v) get the observation for a given configuration, corrupted by noise from a given distribution */
@@ -114,9 +120,9 @@ class TwoDBeaconObservationModel : public ObservationModelMethod
     std::vector<arma::colvec> landmarks_;
 
     //Function to load landmarks from XML file into the object
-    void loadLandmarks(const char *pathToSetupFile);
+    void loadLandmarks(const SetupConfiguration &config);
 
-    void loadParameters(const char *pathToSetupFile);
+    void loadParameters(const SetupConfiguration &config);
 
 };
 
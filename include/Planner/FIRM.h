@@ -47,6 +47,9 @@
 #include <utility>
 #include <vector>
 #include <map>
+#include <set>
+#include <tuple>
+#include <unordered_map>
 #include "ompl/geometric/planners/PlannerIncludes.h"
 #include "ompl/datastructures/NearestNeighbors.h"
 #include "ompl/control/ControlSpace.h"
@@ -62,6 +65,15 @@
 #include "NBM3P.h"
 #include "Spaces/R2BeliefSpace.h"
 #include "Spaces/SE2BeliefSpace.h"
+#include "Utils/TimeSeriesLogger.h"
+#include "Utils/RoadmapFile.h"
+#include "Utils/RoadmapDelta.h"
+#include "Utils/PolicyFile.h"
+#include "Utils/EnvironmentStamp.h"
+#include "Utils/LRUCache.h"
+#include "Utils/ExecutionTrace.h"
+#include "Utils/SetupConfiguration.h"
+#include "Samplers/UniformValidBeliefSampler.h"
 
 /**
    @anchor FIRM
@@ -249,10 +261,24 @@ public:
         return si_->distance(stateProperty_[a], stateProperty_[b]);
     }
 
-    /** \brief Compute distance between two milestones (this is simply distance between the states of the milestones) */
+    /** \brief The number of milestones in the roadmap, the slots of removed vertices are not counted */
     unsigned int milestoneCount(void) const
     {
-        return boost::num_vertices(g_);
+        return boost::num_vertices(g_) - freeVertices_.size();
+    }
+
+    /** \brief Whether \e v is a milestone of the roadmap, false once it was removed with removeVertex() */
+    bool isVertexAlive(const Vertex v) const;
+
+    /** \brief For every vertex slot, the index of the milestone among the live ones, -1 for a removed vertex. Saved
+               roadmaps and policies number the nodes this way. */
+    std::vector<long> vertexOrdinals(void) const;
+
+    /** \brief The number of times the slot of \e v was removed. A vertex id kept together with its generation refers
+               to a removed milestone if the generation has changed since. */
+    unsigned int getVertexGeneration(const Vertex v) const
+    {
+        return v < vertexGenerations_.size() ? vertexGenerations_[v] : 0;
     }
 
     /** \brief Get the nearest neighbor structure */
@@ -270,26 +296,144 @@ public:
     /** \brief Executes the rollout policy algorithm (See ICRA '14 paper) */
     void executeFeedbackWithRollout(void);
 
+    /** \brief What a run of the planner did, reported by the batch experiment driver */
+    struct RunStatistics
+    {
+        /** \brief Wall time of solve() (roadmap construction until a policy was found), seconds */
+        double solveTime;
+
+        /** \brief Part of solveTime spent growing the roadmap, seconds */
+        double roadmapTime;
+
+        /** \brief Nodes added to the roadmap by solve() */
+        unsigned int nodesAdded;
+
+        /** \brief Total time spent solving the dynamic program, seconds */
+        double dpTime;
+
+        unsigned int dpSolves;
+
+        /** \brief The last execution reached its goal */
+        bool goalReached;
+
+        /** \brief The robot collided in any execution */
+        bool collided;
+
+        double executionCost;
+
+        int timeSteps;
+
+        int nodesReached;
+
+        unsigned int numNodes;
+
+        unsigned int numEdges;
+
+        /** \brief Rollout decisions taken while executing with rollout */
+        unsigned int rolloutDecisions;
+
+        /** \brief Total time of the rollout decisions (adding the current belief and choosing the edge), seconds */
+        double rolloutTime;
+
+        /** \brief Times the robot was kidnapped and relocalized with NBM3P */
+        unsigned int recoveries;
+
+        /** \brief Total time of the recoveries, from sampling the modes until one remained, seconds */
+        double recoveryTime;
+    };
+
+    /** \brief Statistics of the runs since this planner was created */
+    RunStatistics getRunStatistics() const;
+
+    /** \brief The solver used by the dynamic program. DP_SOLVER_MAP is the reference implementation, DP_SOLVER_INDEXED runs the
+               same sweeps on a flat copy of the roadmap, bsp-verify checks that both agree. */
+    enum DPSolverType
+    {
+        DP_SOLVER_MAP,
+        DP_SOLVER_INDEXED
+    };
+
+    void setDPSolver(DPSolverType solver)
+    {
+        dpSolver_ = solver;
+    }
+
+    DPSolverType getDPSolver() const
+    {
+        return dpSolver_;
+    }
+
+    /** \brief Solve the dynamic program for goalVertex with the given solver and return the cost-to-go and the feedback edge
+               of every vertex. The solution also becomes the current policy. */
+    void solvePolicy(const Vertex goalVertex, DPSolverType solver, std::map<Vertex, double> &costToGo, std::map<Vertex, Edge> &feedback);
+
+    /** \brief Answer to a start/goal query, see query() */
+    struct QueryResult
+    {
+        bool solved;
+
+        /** \brief The roadmap nodes the feedback policy passes through, from the start node to the goal node */
+        std::vector<Vertex> path;
+
+        /** \brief Probability of reaching the goal when following the policy */
+        double successProbability;
+
+        /** \brief Cost-to-go of the start under the policy */
+        double cost;
+
+        /** \brief The policy for this goal was kept from an earlier query */
+        bool cachedPolicy;
+    };
+
+    /** \brief Plan from start to goal on the roadmap built so far, without growing it. Start and goal become roadmap nodes the
+               first time they are queried and are reused by later queries from the same poses. The policy of every goal is kept
+               in memory, so a query to a known goal only needs a Bellman backup for nodes added since. If start carries a
+               covariance, the first edge is simulated from that belief instead of the stationary belief of the start node. */
+    QueryResult query(const ompl::base::State *start, const ompl::base::State *goal);
+
+    /** \brief The belief of a roadmap node */
+    const ompl::base::State* getVertexState(const Vertex v) const
+    {
+        return stateProperty_[v];
+    }
+
     /** \brief Set the minimum number of FIRM nodes */
     void setMinFIRMNodes(const unsigned int numNodes)
     {
         minFIRMNodes_ = numNodes ;
     }
 
-    /** \brief Saves the roadmap to an XML */
+    /** \brief Saves the roadmap, as a binary roadmap file with the edge controllers or as XML if requested in the parameters */
     virtual void savePlannerData();
 
-    /** \brief Load the roadmap info from a file */
+    /** \brief Load the roadmap info from a file, binary roadmap files are detected by their header, anything else is read as XML */
     virtual void loadRoadMapFromFile(const std::string &pathToFile);
 
     /** \brief Load planner parameters specific to this planner. */
     virtual void loadParametersFromFile(const std::string &pathToFile);
 
+    /** \brief Load planner parameters specific to this planner from the parsed setup file. */
+    virtual void loadParameters(const SetupConfiguration &config);
+
     void setKidnappedState(ompl::base::State *state)
     {
         kidnappedState_ = si_->cloneState(state);
     }
 
+    /** \brief Limit the memory held by built edge controllers, 0 keeps every controller. With a limit, controllers
+               are built on first use and the least recently used ones are dropped and rebuilt when needed again. */
+    void setEdgeControllerMemoryBudget(std::size_t bytes)
+    {
+        edgeControllers_.setBudget(bytes);
+    }
+
+    /** \brief Set the environment the planner works in. Saved roadmaps are stamped with it, and a roadmap that was
+               saved in a different environment only has the nodes and edges near the changes recomputed on load. */
+    void setEnvironmentStamp(const std::shared_ptr<EnvironmentStamp> &stamp)
+    {
+        environmentStamp_ = stamp;
+    }
+
     /** \brief Change the policy execution space. */
     void setPolicyExecutionSpace(firm::SpaceInformation::SpaceInformationPtr executionSI)
     {
@@ -301,6 +445,9 @@ public:
         si_->setStateValidityChecker(svc);
         siF_->setStateValidityChecker(svc);
         policyExecutionSI_->setStateValidityChecker(svc);
+
+        // the edge costs the kept policies were solved with are no longer valid
+        policyCache_.clear();
     }
 
 protected:
@@ -310,7 +457,22 @@ protected:
 
     /** \brief Construct a graph node for a given state (\e state), store it in the nearest neighbors data structure
         and then connect it to the roadmap in accordance to the connection strategy. */
-    virtual Vertex addStateToGraph(ompl::base::State *state, bool addReverseEdge = true, bool shouldCreateNodeController=true);
+    virtual Vertex addStateToGraph(ompl::base::State *state, bool addReverseEdge = true, bool shouldCreateNodeController=true, bool transient=false);
+
+    /** \brief True for nodes added with addStateToGraph(state, ..., transient = true). They are connected like other nodes but
+        are not united with the connected components, not shown and not part of the observation graph, so that
+        removeVertex() can take them out again. */
+    bool isVertexTransient(const Vertex v) const;
+
+    /** \brief Add a vertex to the graph, reusing the slot of a removed vertex if there is one. Vertex ids of the
+        other milestones never change. */
+    Vertex allocateVertex(void);
+
+    /** \brief Remove a milestone, its edges, node controller and policy entries in time proportional to its degree
+        instead of the size of the graph. The slot is kept for allocateVertex(), so no other vertex id changes. The
+        connected components are not split, only remove milestones that were never united with others, like the
+        rollout nodes. The state of the milestone is freed. */
+    void removeVertex(const Vertex v);
 
     /** \brief Load a state from XML and add to Graph*/
     //virtual Vertex loadStateToGraph(ompl::base::State *state);
@@ -320,13 +482,17 @@ protected:
     void uniteComponents(Vertex m1, Vertex m2);
 
     /** \brief Check if two milestones (\e m1 and \e m2) are part of the same connected component. This is not a const
-        function since we use incremental connected components from boost */
+        function since we use incremental connected components from boost. A transient milestone is in the components
+        of its neighbors. */
     bool sameComponent(Vertex m1, Vertex m2);
 
     /** \brief Randomly sample the state space, add and connect nodes
          in the roadmap. Stop this process when the termination condition*/
     virtual void growRoadmap(const ompl::base::PlannerTerminationCondition &ptc, ompl::base::State *workState);
 
+    /** \brief growRoadmap() for SE2 beliefs, the samples are drawn and collision checked ompl::magic::SAMPLE_BATCH_SIZE at a time */
+    void growRoadmapInBatches(const ompl::base::PlannerTerminationCondition &ptc);
+
      /** \brief Attempt to connect disjoint components in the
                 roadmap using random bounding motions (the PRM
                 expansion step) */
@@ -351,6 +517,10 @@ protected:
     /** \brief Generates the cost of the edge */
     virtual FIRMWeight generateEdgeControllerWithCost(const Vertex a, const Vertex b, EdgeControllerType &edgeController);
 
+    /** \brief Runs the Monte Carlo simulation of an edge controller from start and returns the edge weight. Not thread safe,
+               the simulation moves the true state and belief of the space information. */
+    FIRMWeight simulateEdgeController(const ompl::base::State *start, EdgeControllerType &edgeController);
+
     /** \brief Generates an edge controller and loads the edge properties from XML */
     //virtual FIRMWeight loadEdgeControllerWithCost(const Vertex start, const Vertex goal, EdgeControllerType &edgeController);
 
@@ -360,9 +530,69 @@ protected:
     /** \brief Generates the node controller that stabilizes the robot to the node and sets the stationary covariance at the node. */
     virtual void generateNodeController(ompl::base::State *state, NodeControllerType &nodeController);
 
+    /** \brief Builds the node controller for a state whose stationary covariance is already set. */
+    void createNodeController(const ompl::base::State *state, NodeControllerType &nodeController);
+
+    /** \brief Returns the controller of an edge, building it if it is not in the cache. */
+    EdgeControllerType getEdgeController(const Edge &e);
+
+    /** \brief Builds the controller of an existing edge from the roadmap file it was loaded from or else from its end nodes. */
+    void materializeEdgeController(const Edge &e, EdgeControllerType &edgeController);
+
+    /** \brief Approximate heap memory held by an edge controller, used for the cache budget. */
+    std::size_t estimateEdgeControllerMemory(const EdgeControllerType &edgeController) const;
+
+    /** \brief Rebuilds an edge controller from the nominal trajectory saved in a roadmap file instead of running the local planner. */
+    void restoreEdgeController(const ompl::base::State* target, const RoadmapFile &roadmapFile, const RoadmapFile::Edge &edge, EdgeControllerType &edgeController);
+
+    /** \brief Writes the nodes and edge weights to an XML roadmap, returns the name of the file written. */
+    std::string saveRoadMapToXMLFile();
+
+    /** \brief Writes the roadmap and the nominal trajectories of the edge controllers to a binary roadmap file, returns false on failure. */
+    bool saveRoadMapToBinaryFile(const std::string &pathToFile);
+
+    /** \brief Loads an XML roadmap, the node covariances and edge controllers are computed again. */
+    void loadRoadMapFromXMLFile(const std::string &pathToFile);
+
+    /** \brief Loads a binary roadmap file. The stored covariances and trajectories are used as they are unless the
+               roadmap was saved in a different environment, see updateLoadedRoadmap(). */
+    void loadRoadMapFromBinaryFile(const std::string &pathToFile);
+
+    /** \brief Brings the nodes and edges read from a stamped roadmap file up to date with environmentStamp_. Nodes that are now
+               in collision and edges that can no longer succeed are removed. Node ids are compacted, and edgeRecords gives the file record
+               of each remaining edge. The changes are applied from the roadmap's delta file if one exists for this
+               environment. Otherwise they are computed and saved to it. Returns true if the saved nominal trajectories are stale. */
+    bool updateLoadedRoadmap(const std::string &pathToFile, const RoadmapFile &roadmapFile, std::vector<ompl::base::State*> &states,
+                             std::vector<std::pair<std::pair<int,int>,FIRMWeight> > &edgeProperties, std::vector<std::size_t> &edgeRecords);
+
+    /** \brief Recomputes the nodes and edges of a roadmap file that are affected by the difference between the two environments. */
+    void computeRoadmapDelta(const RoadmapFile &roadmapFile, const EnvironmentStamp::Difference &difference, std::vector<ompl::base::State*> &states,
+                             RoadmapDelta &delta);
+
+    /** \brief Inserts the nodes and edges of a loaded roadmap with their controllers into the graph, the nearest neighbor
+               structure, the NBM3P observation graph and the visualization, each in one batch. Node i becomes vertex i. */
+    void addLoadedRoadmapToGraph(const std::vector<ompl::base::State*> &states, const std::vector<NodeControllerType> &nodeControllers,
+                                 const std::vector<std::pair<std::pair<int,int>,FIRMWeight> > &edgeProperties, const std::vector<EdgeControllerType> &edgeControllers);
+
     /** \brief Solves the dynamic program to return a feedback policy */
     virtual void solveDynamicProgram(const Vertex goalVertex);
 
+    /** \brief The sweeps of solveDynamicProgram on a flat copy of the roadmap, sets costToGo_ and feedback_ */
+    void solveDynamicProgramIndexed(const Vertex goalVertex);
+
+    /** \brief Hash of a saved roadmap, the environment and the DP parameters, a saved policy is only used if it matches. */
+    std::uint64_t fingerprintPolicy(const std::string &pathToRoadmap) const;
+
+    /** \brief True if the graph is the roadmap loaded from file with only the start, goal and query nodes added to it. */
+    bool isLoadedRoadmapIntact() const;
+
+    /** \brief Sets feedback_ and costToGo_ from the policy saved for the loaded roadmap and this goal. Nodes added
+               after loading get one Bellman backup on the saved cost-to-go. Returns false if there is no valid saved policy. */
+    bool restorePolicy(const Vertex goal);
+
+    /** \brief Adds the current policy for the first numRoadmapVertices nodes to the policy file of a roadmap. */
+    void savePolicy(const std::string &pathToRoadmap, std::size_t numRoadmapVertices, const Vertex goal);
+
     /** \brief Generate the rollout policy */
     virtual Edge generateRolloutPolicy(const Vertex currentVertex, const FIRM::Vertex goal);
 
@@ -388,12 +618,18 @@ protected:
     /** \brief Calculates the new cost to go from a node*/
     std::pair<typename FIRM::Edge,double> getUpdatedNodeCostToGo(const Vertex node, const Vertex goal);
 
+    /** \brief The node of a query pose, the pose is added as a transient node the first time it is queried */
+    Vertex getQueryVertex(const ompl::base::State *state);
+
     /** \brief Flag indicating whether the default connection strategy is the Star strategy */
     bool                                                   starStrategy_;
 
     /** \brief Sampler user for generating valid samples in the state space */
     ompl::base::ValidStateSamplerPtr                             sampler_;
 
+    /** \brief Sampler used by growRoadmapInBatches() */
+    std::shared_ptr<UniformValidBeliefSampler>                   batchSampler_;
+
     /** \brief Sampler user for generating random in the state space */
     ompl::base::StateSamplerPtr                                  simpleSampler_;
 
@@ -420,6 +656,9 @@ protected:
     boost::property_map<Graph,
         vertex_successful_connection_attempts_t>::type     successfulConnectionAttemptsProperty_;
 
+    /** \brief Access to the flags of a vertex, marks the vertices that were removed */
+    boost::property_map<Graph, vertex_flags_t>::type       vertexFlagsProperty_;
+
     /** \brief Access to the weights of each Edge */
     boost::property_map<Graph, boost::edge_weight_t>::type weightProperty_;
 
@@ -435,6 +674,12 @@ protected:
     /** \brief Maximum unique id number used so for for edges */
     unsigned int                                           maxEdgeID_;
 
+    /** \brief Slots of removed vertices, reused by allocateVertex() */
+    std::vector<Vertex>                                    freeVertices_;
+
+    /** \brief For every vertex slot, the number of times it was removed */
+    std::vector<unsigned int>                              vertexGenerations_;
+
     /** \brief Function that returns the milestones to attempt connections with */
     ConnectionStrategy                                     connectionStrategy_;
 
@@ -458,8 +703,53 @@ protected:
                 function to change this parameter. Particularly useful if you wish to drive a real robot and get sensor readings.*/
     firm::SpaceInformation::SpaceInformationPtr policyExecutionSI_;
 
-    /** \brief A table that stores the edge controllers according to the edges */
-    std::map <Edge, EdgeControllerType > edgeControllers_;
+    /** \brief The edge controllers that are currently built, see setEdgeControllerMemoryBudget() */
+    LRUCache<Edge, EdgeControllerType> edgeControllers_;
+
+    /** \brief The binary roadmap the graph was loaded from, kept mapped to rebuild evicted edge controllers */
+    std::shared_ptr<RoadmapFile> loadedRoadmapFile_;
+
+    /** \brief For every edge id, the index of the edge's record in loadedRoadmapFile_, -1 for edges that are not in the file */
+    std::vector<long> roadmapFileEdgeRecords_;
+
+    /** \brief The environment the planner works in, see setEnvironmentStamp() */
+    std::shared_ptr<EnvironmentStamp> environmentStamp_;
+
+    /** \brief The roadmap file the graph was loaded from, empty if it was not loaded */
+    std::string loadedRoadmapPath_;
+
+    /** \brief Number of nodes in the loaded roadmap, they are the vertices 0 to numLoadedVertices_-1 */
+    std::size_t numLoadedVertices_;
+
+    /** \brief The goal that feedback_ and costToGo_ were solved for */
+    Vertex policyGoalVertex_;
+
+    /** \brief A solved dynamic program kept for later queries to the same goal */
+    struct CachedPolicy
+    {
+        std::map<Vertex, Edge> feedback;
+
+        std::map<Vertex, double> costToGo;
+    };
+
+    /** \brief The policies solved by query(), by goal node. The budget counts policies, each is inserted with a size of 1 */
+    LRUCache<Vertex, CachedPolicy> policyCache_;
+
+    /** \brief A transient node added for a query pose */
+    struct QueryVertex
+    {
+        Vertex vertex;
+
+        /** \brief Value of queryClock_ when the pose was last queried */
+        unsigned long lastUse;
+    };
+
+    /** \brief The nodes added for query poses, by pose rounded to the query resolution. The least recently queried ones are
+               removed from the roadmap once there are too many. */
+    std::map<std::tuple<long, long, long>, QueryVertex> queryVertices_;
+
+    /** \brief Counts the lookups of query poses, orders queryVertices_ by use */
+    unsigned long queryClock_;
 
     /** \brief A table that stores the node controllers according to the node (vertex) ids */
     std::map <Vertex, NodeControllerType > nodeControllers_;
@@ -484,8 +774,17 @@ protected:
     /** \brief Send the most likely path to visualizer based on start location*/
     void sendMostLikelyPathToViz(const Vertex start, const Vertex goal);
 
-    /** \brief Writes a time series data to a file */
-    void writeTimeSeriesDataToFile(std::string fname, std::string dataName);
+    /** \brief Start streaming the execution time series to <logFilePath_><prefix>*History.csv (only when logs are saved) */
+    void openTimeSeriesLogs(const std::string &prefix);
+
+    /** \brief Write out and close the execution time series logs */
+    void closeTimeSeriesLogs();
+
+    /** \brief Start recording the execution to <logFilePath_><prefix>.trace, beginning with the roadmap (only when traces are saved) */
+    void openExecutionTrace(const std::string &prefix);
+
+    /** \brief Stop recording the execution */
+    void closeExecutionTrace();
 
 private:
 
@@ -503,18 +802,22 @@ private:
 
     ompl::base::State *kidnappedState_;
 
-    std::vector<std::pair<int, float> > costToGoHistory_;
+    TimeSeriesLogger costToGoHistory_;
 
-    std::vector<std::pair<int, double> > successProbabilityHistory_;
+    TimeSeriesLogger successProbabilityHistory_;
 
-    std::vector<std::pair<int, std::vector<float> > > weightsHistory_;
+    TimeSeriesLogger weightsHistory_;
 
-    std::vector<std::pair<int, int> > nodeReachedHistory_;
+    TimeSeriesLogger nodeReachedHistory_;
 
-    std::vector<std::pair<int, double> > velocityHistory_;
+    /** \brief Shared with the space information, which logs the applied velocities */
+    std::shared_ptr<TimeSeriesLogger> velocityHistory_;
 
     int currentTimeStep_;
 
+    /** \brief Timing and outcome of the runs, see getRunStatistics() */
+    RunStatistics runStatistics_;
+
     int numberofNodesReached_;
 
     double executionCost_;
@@ -525,12 +828,24 @@ private:
     /** \brief Flag to save roadmap or not */
     bool doSavePlannerData_;
 
+    /** \brief Save the roadmap as XML (nodes and weights only) instead of the binary roadmap file */
+    bool saveRoadmapAsXML_;
+
+    /** \brief Save the solved policies next to the roadmap and reuse them when the same roadmap is loaded again */
+    bool doSavePolicy_;
+
     /** \brief Flag to save run time simulation logs or not */
     bool doSaveLogs_;
 
     /** \brief Flag to save video */
     bool doSaveVideo_;
 
+    /** \brief Record an execution trace of every run, it can be replayed with --replay */
+    bool doSaveTrace_;
+
+    /** \brief Shared with the space information, which records the steps of the robot */
+    ExecutionTrace::ExecutionTracePtr executionTrace_;
+
     double NNRadius_;
 
     int numNearestNeighbors_;
@@ -553,6 +868,8 @@ private:
 
     double convergenceThresholdDP_;
 
+    DPSolverType dpSolver_;
+
 };
 
 
@@ -94,6 +94,8 @@ class NBM3P
         /** \brief Constructor */
         NBM3P(firm::SpaceInformation::SpaceInformationPtr si):si_(si),
         maxEdgeID_(0),
+        samplingGridSize_(0),
+        samplingRotationSpacing_(0),
         stateProperty_(boost::get(vertex_state_t(), g_)),
         weightProperty_(boost::get(boost::edge_weight, g_)),
         edgeIDProperty_(boost::get(boost::edge_index, g_))
@@ -141,6 +143,10 @@ class NBM3P
             this->addStateToObservationGraph(si_->cloneState(state));
         }
 
+        /** \brief Add many FIRM nodes at once, e.g. when a roadmap is loaded. Every node's observation list is computed
+                   once instead of once per pair it is compared against. */
+        void addFIRMNodesToObservationGraph(const std::vector<ompl::base::State*> &states);
+
         /** \brief For each belief state, there is a target node to go to, set those here */
         void setBeliefTargetStates(const std::vector<ompl::base::State*> states)
         {
@@ -239,6 +245,14 @@ class NBM3P
             policyExecutionSI_ = executionSI;
         }
 
+        /** \brief Spacing of the grid of start beliefs sampled after a kidnapping, meters, and of their headings, degrees.
+                   A value of 0 keeps the default. */
+        void setSamplingGrid(double gridSize, double rotationSpacing)
+        {
+            samplingGridSize_ = gridSize;
+            samplingRotationSpacing_ = rotationSpacing;
+        }
+
     private:
 
         //float computeWeightForMode(const int currentBeliefIndx,const arma::colvec trueObservation);
@@ -255,6 +269,9 @@ class NBM3P
         /** \brief Get the overlap in observation for two vertices*/
         virtual bool getObservationOverlap(const Vertex a, const Vertex b, unsigned int &weight);
 
+        /** \brief Same as getObservationOverlap but uses the observation lists already stored for the two vertices */
+        bool countObservationOverlap(const Vertex a, const Vertex b, unsigned int &weight);
+
         /** \brief Get the nodes within some radius "r" to state */
         std::vector<Vertex> getNeighbors(const ompl::base::State *state);
 
@@ -329,5 +346,11 @@ class NBM3P
         /** \brief keep a track of how long a belief has been predicting to observe something that is not seen by the robot*/
         std::vector<double> timeSinceDivergence_;
 
+        /** \brief Spacing of the sampling grid (meters), 0 uses SAMPLING_GRID_SIZE */
+        double samplingGridSize_;
+
+        /** \brief Heading spacing of the sampling grid (degrees), 0 uses SAMPLING_ROTATION_SPACING */
+        double samplingRotationSpacing_;
+
 };
 #endif
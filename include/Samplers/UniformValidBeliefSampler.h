@@ -39,6 +39,7 @@
 
 #include "ompl/base/ValidStateSampler.h"
 #include "ompl/base/StateSampler.h"
+#include "ompl/util/RandomNumbers.h"
 #include "SpaceInformation/SpaceInformation.h"
 
 /*
@@ -63,6 +64,13 @@ class UniformValidBeliefSampler : public ompl::base::ValidStateSampler
     virtual bool sample(State *state);
     virtual bool sampleNear(State *state, const State *near, const double distance);
 
+    /** \brief Fill states[0..count) with valid, observable samples. The candidates are drawn in blocks straight
+        into the caller's states (no temporary allocation). A signed distance field checks a whole block
+        with one call, other validity checkers run after the cheap observability lookup. Returns the number
+        of states filled, at most count, fewer only if the attempt budget (attempts per sample times count)
+        runs out. Used by FIRM::growRoadmap(). */
+    unsigned int sampleBatch(State **states, unsigned int count);
+
     /**
     void setObservationModel(ObservationModelPointer om)
     {
@@ -75,6 +83,9 @@ class UniformValidBeliefSampler : public ompl::base::ValidStateSampler
     /** \brief The sampler to build upon */
     StateSamplerPtr sampler_;
 
+    /** \brief Random number generator for the batch sampler */
+    ompl::RNG rng_;
+
     /** brief Checks if the sample is observable
         i.e. If it can observe sufficient landmarks
         Ideally, observability check should be performed in the filter instead of obs model
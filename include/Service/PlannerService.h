@@ -0,0 +1,91 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef PLANNER_SERVICE_H
+#define PLANNER_SERVICE_H
+
+#include <string>
+
+class TwoDPointRobotSetup;
+
+/**
+    @par Short Description
+    Keeps a solved setup (roadmap, node and edge controllers, the policies of the goals asked
+    for so far) in memory and answers start/goal queries on it. Requests and responses are
+    single lines, read from a Unix domain socket or from stdin:
+
+    plan <sx> <sy> <syaw> <gx> <gy> <gyaw> [cov <9 values, row major>]
+    stats
+    quit      (ends the connection)
+    shutdown  (stops the service)
+
+    Each request is answered with one line of JSON, e.g.
+    {"ok":true,"solved":true,"successProbability":0.94,"cost":13.2,"cachedPolicy":true,"timeMs":3.1,
+     "nodes":[[12,1.5,2.0,0.0],...]}
+    where nodes lists [id, x, y, yaw] of the roadmap nodes the feedback policy passes through.
+
+    Queries are answered one at a time, the planner is not thread safe. A socket client that
+    stays idle for a few seconds is disconnected so the next one is served.
+
+    \brief Resident planner answering queries over a local socket or stdin.
+*/
+class PlannerService
+{
+    public:
+
+        /** \brief The setup must have been solved once, so that it has a roadmap */
+        PlannerService(TwoDPointRobotSetup *setup);
+
+        /** \brief Answer one request line. Sets closeConnection for quit and shutdown, and shutdown for shutdown. */
+        std::string handleRequest(const std::string &request, bool &closeConnection, bool &shutdown);
+
+        /** \brief Serve the requests read from inFd until end of file, quit or shutdown, responses go to outFd.
+                   Returns true if the service should shut down. */
+        bool serveConnection(int inFd, int outFd);
+
+        /** \brief Listen on a Unix domain socket at path and serve clients one after another until shutdown */
+        bool serveSocket(const std::string &path);
+
+    private:
+
+        std::string plan(const std::string &arguments);
+
+        std::string stats() const;
+
+        TwoDPointRobotSetup *setup_;
+
+        unsigned long numQueries_;
+};
+
+#endif
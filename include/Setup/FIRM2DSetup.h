@@ -118,6 +118,16 @@ public:
     void setPathToSetupFile(const std::string &path)
     {
         pathToSetupFile_  = path;       
+
+        config_.reset();
+    }
+
+    /** \brief Use a setup file that was already parsed (and possibly changed in memory) instead of reading pathToSetupFile */
+    void setSetupConfiguration(const SetupConfiguration::SetupConfigurationPtr &config)
+    {
+        config_ = config;
+
+        pathToSetupFile_ = config->getPath();
     }
 
     void setStartState(const double X, const double Y, const double Yaw)
@@ -147,13 +157,19 @@ public:
     {
         if(!setup_)
         {
-            this->loadParameters();
-
-            if(pathToSetupFile_.length() == 0)
+            if(!config_)
             {
-                throw ompl::Exception("Path to setup file not set!");
+                if(pathToSetupFile_.length() == 0)
+                {
+                    throw ompl::Exception("Path to setup file not set!");
+                }
+
+                // parse the setup file once, every component below reads its section from it
+                config_ = std::make_shared<SetupConfiguration>(pathToSetupFile_);
             }
 
+            this->loadParameters();
+
             if(!hasEnvironment() || !hasRobot())
             {
                 throw ompl::Exception("Robot/Environment mesh files not setup!");
@@ -166,12 +182,12 @@ public:
             siF_->setStateValidityChecker(fclSVC);
 
             // provide the observation model to the space
-            ObservationModelMethod::ObservationModelPointer om(new CamAruco2DObservationModel(siF_, pathToSetupFile_.c_str()));
+            ObservationModelMethod::ObservationModelPointer om(new CamAruco2DObservationModel(siF_, *config_));
             siF_->setObservationModel(om);
 
             // Provide the motion model to the space
-            //MotionModelMethod::MotionModelPointer mm(new UnicycleMotionModel(siF_, pathToSetupFile_.c_str()));
-            MotionModelMethod::MotionModelPointer mm(new OmnidirectionalMotionModel(siF_, pathToSetupFile_.c_str()));
+            //MotionModelMethod::MotionModelPointer mm(new UnicycleMotionModel(siF_, *config_));
+            MotionModelMethod::MotionModelPointer mm(new OmnidirectionalMotionModel(siF_, *config_));
             siF_->setMotionModel(mm);
 
             ompl::control::StatePropagatorPtr prop(ompl::control::StatePropagatorPtr(new OmnidirectionalStatePropagator(siF_)));
@@ -200,7 +216,7 @@ public:
 
             planner_->setup();
 
-            planner_->as<FIRM>()->loadParametersFromFile(pathToSetupFile_.c_str());
+            planner_->as<FIRM>()->loadParameters(*config_);
 
             // Setup visualizer because it is needed while loading roadmap and visualizing it
             Visualizer::updateSpaceInformation(this->getSpaceInformation());
@@ -294,28 +310,17 @@ protected:
     {
 
         using namespace arma;
-        // Load XML containing landmarks
-        TiXmlDocument doc(pathToSetupFile_);
-        bool loadOkay = doc.LoadFile();
-
-        if(!loadOkay)
-        {
-            printf( "Could not load setup file. Error='%s'. Exiting.\n", doc.ErrorDesc() );
-
-            exit( 1 );
-        }
-
-        TiXmlNode* node = 0;
-        TiXmlElement* landmarkElement = 0;
-        TiXmlElement* itemElement = 0;
+        const TiXmlNode* node = 0;
+        const TiXmlElement* landmarkElement = 0;
+        const TiXmlElement* itemElement = 0;
 
         // Get the landmarklist node
-        node = doc.FirstChild( "GoalList" );
+        node = config_->getSection( "GoalList" );
         assert( node );
         landmarkElement = node->ToElement(); //convert node to element
         assert( landmarkElement  );
 
-        TiXmlNode* child = 0;
+        const TiXmlNode* child = 0;
 
         //Iterate through all the landmarks and put them into the "landmarks_" list
         while( (child = landmarkElement ->IterateChildren(child)))
@@ -342,25 +347,14 @@ protected:
     {
         using namespace arma;
 
-        TiXmlDocument doc(pathToSetupFile_);
-
-        bool loadOkay = doc.LoadFile();
+        const TiXmlNode* node = 0;
 
-        if ( !loadOkay )
-        {
-            printf( "Could not load setup file in planning problem. Error='%s'. Exiting.\n", doc.ErrorDesc() );
-
-            exit( 1 );
-        }
+        const TiXmlElement* itemElement = 0;
 
-        TiXmlNode* node = 0;
-
-        TiXmlElement* itemElement = 0;
-
-        node = doc.FirstChild( "PlanningProblem" );
+        node = config_->getSection( "PlanningProblem" );
         assert( node );
 
-        TiXmlNode* child = 0;
+        const TiXmlNode* child = 0;
 
         // Read the env mesh file
         child = node->FirstChild("Environment");
@@ -520,6 +514,9 @@ private:
 
     std::string pathToSetupFile_;
 
+    /** \brief The parsed setup file */
+    SetupConfiguration::SetupConfigurationPtr config_;
+
     std::string pathToRoadMapFile_;
 
     int useSavedRoadMap_;
@@ -124,6 +124,15 @@ public:
     {
         pathToSetupFile_  = path;
 
+        config_.reset();
+    }
+
+    /** \brief Use a setup file that was already parsed (and possibly changed in memory) instead of reading pathToSetupFile */
+    void setSetupConfiguration(const SetupConfiguration::SetupConfigurationPtr &config)
+    {
+        config_ = config;
+
+        pathToSetupFile_ = config->getPath();
     }
 
     void setStartState(const double X, const double Y, const double Yaw)
@@ -153,13 +162,19 @@ public:
     {
         if(!setup_)
         {
-            this->loadParameters();
-
-            if(pathToSetupFile_.length() == 0)
+            if(!config_)
             {
-                throw ompl::Exception("Path to setup file not set!");
+                if(pathToSetupFile_.length() == 0)
+                {
+                    throw ompl::Exception("Path to setup file not set!");
+                }
+
+                // parse the setup file once, every component below reads its section from it
+                config_ = std::make_shared<SetupConfiguration>(pathToSetupFile_);
             }
 
+            this->loadParameters();
+
             if(!hasEnvironment() || !hasRobot())
             {
                 throw ompl::Exception("Robot/Environment mesh files not setup!");
@@ -173,12 +188,12 @@ public:
             siROS_->setStateValidityChecker(fclSVC);
 
             // provide the observation model to the space
-            ObservationModelMethod::ObservationModelPointer om(new CamAruco2DObservationModel(siF_, pathToSetupFile_.c_str()));
+            ObservationModelMethod::ObservationModelPointer om(new CamAruco2DObservationModel(siF_, *config_));
             siF_->setObservationModel(om);
             siROS_->setObservationModel(om);
 
             // Provide the motion model to the space
-            MotionModelMethod::MotionModelPointer mm(new UnicycleMotionModel(siF_, pathToSetupFile_.c_str()));
+            MotionModelMethod::MotionModelPointer mm(new UnicycleMotionModel(siF_, *config_));
             siF_->setMotionModel(mm);
             siROS_->setMotionModel(mm);
 
@@ -215,7 +230,7 @@ public:
 
             planner_->setup();
 
-            planner_->as<FIRM>()->loadParametersFromFile(pathToSetupFile_.c_str());
+            planner_->as<FIRM>()->loadParameters(*config_);
             
             Visualizer::updateSpaceInformation(this->getSpaceInformation());
 
@@ -309,28 +324,17 @@ protected:
     {
 
         using namespace arma;
-        // Load XML containing landmarks
-        TiXmlDocument doc(pathToSetupFile_);
-        bool loadOkay = doc.LoadFile();
-
-        if(!loadOkay)
-        {
-            printf( "Could not load setup file. Error='%s'. Exiting.\n", doc.ErrorDesc() );
-
-            exit( 1 );
-        }
-
-        TiXmlNode* node = 0;
-        TiXmlElement* landmarkElement = 0;
-        TiXmlElement* itemElement = 0;
+        const TiXmlNode* node = 0;
+        const TiXmlElement* landmarkElement = 0;
+        const TiXmlElement* itemElement = 0;
 
         // Get the landmarklist node
-        node = doc.FirstChild( "GoalList" );
+        node = config_->getSection( "GoalList" );
         assert( node );
         landmarkElement = node->ToElement(); //convert node to element
         assert( landmarkElement  );
 
-        TiXmlNode* child = 0;
+        const TiXmlNode* child = 0;
 
         //Iterate through all the landmarks and put them into the "landmarks_" list
         while( (child = landmarkElement ->IterateChildren(child)))
@@ -357,25 +361,14 @@ protected:
     {
         using namespace arma;
 
-        TiXmlDocument doc(pathToSetupFile_);
-
-        bool loadOkay = doc.LoadFile();
+        const TiXmlNode* node = 0;
 
-        if ( !loadOkay )
-        {
-            printf( "Could not load setup file in planning problem. Error='%s'. Exiting.\n", doc.ErrorDesc() );
+        const TiXmlElement* itemElement = 0;
 
-            exit( 1 );
-        }
-
-        TiXmlNode* node = 0;
-
-        TiXmlElement* itemElement = 0;
-
-        node = doc.FirstChild( "PlanningProblem" );
+        node = config_->getSection( "PlanningProblem" );
         assert( node );
 
-        TiXmlNode* child = 0;
+        const TiXmlNode* child = 0;
 
         // Read the env mesh file
         child = node->FirstChild("Environment");
@@ -535,6 +528,9 @@ private:
 
     std::string pathToSetupFile_;
 
+    /** \brief The parsed setup file */
+    SetupConfiguration::SetupConfigurationPtr config_;
+
     std::string pathToRoadMapFile_;
 
     int useSavedRoadMap_;
@@ -129,6 +129,18 @@ public:
     {
         pathToSetupFile_  = path;
 
+        config_ = std::make_shared<SetupConfiguration>(path);
+
+        this->loadParameters();
+    }
+
+    /** \brief Use a setup file that was already parsed (and possibly changed in memory) instead of reading it from disk */
+    void setSetupConfiguration(const SetupConfiguration::SetupConfigurationPtr &config)
+    {
+        pathToSetupFile_ = config->getPath();
+
+        config_ = config;
+
         this->loadParameters();
     }
 
@@ -185,11 +197,11 @@ public:
             siF_->setStateValidityCheckingResolution(0.005);
 
             // provide the observation model to the space
-            ObservationModelMethod::ObservationModelPointer om(new CamAruco2DObservationModel(siF_, pathToSetupFile_.c_str()));
+            ObservationModelMethod::ObservationModelPointer om(new CamAruco2DObservationModel(siF_, *config_));
             siF_->setObservationModel(om);
 
             // Provide the motion model to the space
-            MotionModelMethod::MotionModelPointer mm(new UnicycleMotionModel(siF_, pathToSetupFile_.c_str()));
+            MotionModelMethod::MotionModelPointer mm(new UnicycleMotionModel(siF_, *config_));
             siF_->setMotionModel(mm);
 
             ompl::control::StatePropagatorPtr prop(ompl::control::StatePropagatorPtr(new UnicycleStatePropagator(siF_)));
@@ -282,7 +294,7 @@ public:
 
                 //std::cout<<"Clearance :"<<siF_->getStateValidityChecker()->clearance(currentTrueState)<<std::endl;
 
-                boost::this_thread::sleep(boost::posix_time::milliseconds(20));
+                FIRMUtils::waitForViewer(20);
             }
         }
 
@@ -313,25 +325,14 @@ protected:
     {
         using namespace arma;
 
-        TiXmlDocument doc(pathToSetupFile_);
-
-        bool loadOkay = doc.LoadFile();
-
-        if ( !loadOkay )
-        {
-            printf( "Could not load setup file in planning problem. Error='%s'. Exiting.\n", doc.ErrorDesc() );
-
-            exit( 1 );
-        }
-
-        TiXmlNode* node = 0;
+        const TiXmlNode* node = 0;
 
-        TiXmlElement* itemElement = 0;
+        const TiXmlElement* itemElement = 0;
 
-        node = doc.FirstChild( "PlanningProblem" );
+        node = config_->getSection( "PlanningProblem" );
         assert( node );
 
-        TiXmlNode* child = 0;
+        const TiXmlNode* child = 0;
 
         // Read the env mesh file
         child = node->FirstChild("Environment");
@@ -419,25 +420,16 @@ protected:
 
     void loadStartBeliefs()
     {
-        TiXmlDocument doc(pathToSetupFile_);
-        bool loadOkay = doc.LoadFile();
-
-        if ( !loadOkay )
-        {
-            printf( "Could not load beliefs . Error='%s'. Exiting.\n", doc.ErrorDesc() );
-            exit( 1 );
-        }
-
-        TiXmlNode* node = 0;
-        TiXmlElement* landmarkElement = 0;
-        TiXmlElement* itemElement = 0;
+        const TiXmlNode* node = 0;
+        const TiXmlElement* landmarkElement = 0;
+        const TiXmlElement* itemElement = 0;
 
-        node = doc.FirstChild( "BeliefList" );
+        node = config_->getSection( "BeliefList" );
         assert( node );
         landmarkElement = node->ToElement(); //convert node to element
         assert( landmarkElement  );
 
-        TiXmlNode* child = 0;
+        const TiXmlNode* child = 0;
 
         arma::mat cov = arma::eye(3,3);
         cov(0,0) = 0.03;
@@ -470,25 +462,16 @@ protected:
 
     void loadTargets()
     {
-         TiXmlDocument doc(pathToSetupFile_);
-        bool loadOkay = doc.LoadFile();
+        const TiXmlNode* node = 0;
+        const TiXmlElement* landmarkElement = 0;
+        const TiXmlElement* itemElement = 0;
 
-        if ( !loadOkay )
-        {
-            printf( "Could not load beliefs . Error='%s'. Exiting.\n", doc.ErrorDesc() );
-            exit( 1 );
-        }
-
-        TiXmlNode* node = 0;
-        TiXmlElement* landmarkElement = 0;
-        TiXmlElement* itemElement = 0;
-
-        node = doc.FirstChild( "TargetList" );
+        node = config_->getSection( "TargetList" );
         assert( node );
         landmarkElement = node->ToElement(); //convert node to element
         assert( landmarkElement  );
 
-        TiXmlNode* child = 0;
+        const TiXmlNode* child = 0;
 
         while( (child = landmarkElement ->IterateChildren(child)))
         {
@@ -536,6 +519,9 @@ private:
 
     std::string pathToSetupFile_;
 
+    /** \brief The parsed setup file */
+    SetupConfiguration::SetupConfigurationPtr config_;
+
     double planningTime_;
 
     bool setup_;
@@ -115,6 +115,12 @@ public:
         dynamicObstacles_ = false;
 
         plannerMethod_ = 0; // by default we use FIRM
+
+        useObservabilityMap_ = false;
+
+        useSDFValidityChecker_ = false;
+
+        useAdaptiveMotionValidator_ = false;
     }
 
     virtual ~TwoDPointRobotSetup(void)
@@ -129,6 +135,16 @@ public:
     void setPathToSetupFile(const std::string &path)
     {
         pathToSetupFile_  = path;       
+
+        config_.reset();
+    }
+
+    /** \brief Use a setup file that was already parsed (and possibly changed in memory) instead of reading pathToSetupFile */
+    void setSetupConfiguration(const SetupConfiguration::SetupConfigurationPtr &config)
+    {
+        config_ = config;
+
+        pathToSetupFile_ = config->getPath();
     }
 
     void setStartState(const double X, const double Y)
@@ -158,13 +174,19 @@ public:
     {
         if(!setup_)
         {
-            this->loadParameters();
-
-            if(pathToSetupFile_.length() == 0)
+            if(!config_)
             {
-                throw ompl::Exception("Path to setup file not set!");
+                if(pathToSetupFile_.length() == 0)
+                {
+                    throw ompl::Exception("Path to setup file not set!");
+                }
+
+                // parse the setup file once, every component below reads its section from it
+                config_ = std::make_shared<SetupConfiguration>(pathToSetupFile_);
             }
 
+            this->loadParameters();
+
             if(!hasEnvironment() || !hasRobot())
             {
                 throw ompl::Exception("Robot/Environment mesh files not setup!");
@@ -172,17 +194,24 @@ public:
 
             ss_->as<SE2BeliefSpace>()->setBounds(inferEnvironmentBounds());
 
-            // Create an FCL state validity checker and assign to space information
-            const ompl::base::StateValidityCheckerPtr &fclSVC = this->allocStateValidityChecker(siF_, getGeometricStateExtractor(), false);
-            siF_->setStateValidityChecker(fclSVC);
+            // Create the state validity checker (FCL unless the setup file asks for the distance field) and assign to space information
+            siF_->setStateValidityChecker(allocValidityChecker(pathToEnvironmentMesh_));
+
+            // build the checkers of all dynamic obstacle variants now, so that switching later is only a pointer swap
+            if(dynamicObstacles_)
+                preloadEnvironmentVariants();
+
+            // step along motions by the local clearance, the distance field ignores the heading so no rotation term is needed then
+            if(useAdaptiveMotionValidator_)
+                siF_->setMotionValidator(std::make_shared<ClearanceAdaptiveMotionValidator>(siF_, useSDFValidityChecker_ ? 0.0 : robotRadius_));
 
             // provide the observation model to the space
-            ObservationModelMethod::ObservationModelPointer om(new HeadingBeaconObservationModel(siF_, pathToSetupFile_.c_str()));
+            ObservationModelMethod::ObservationModelPointer om(new HeadingBeaconObservationModel(siF_, *config_));
             siF_->setObservationModel(om);
 
             // Provide the motion model to the space
             // We use the omnidirectional model because collision checking requires SE2
-            MotionModelMethod::MotionModelPointer mm(new OmnidirectionalMotionModel(siF_, pathToSetupFile_.c_str()));            
+            MotionModelMethod::MotionModelPointer mm(new OmnidirectionalMotionModel(siF_, *config_));            
             siF_->setMotionModel(mm);
 
             ompl::control::StatePropagatorPtr prop(ompl::control::StatePropagatorPtr(new OmnidirectionalStatePropagator(siF_)));
@@ -209,7 +238,7 @@ public:
 
             planner_->as<FIRM>()->setKidnappedState(kidnappedState_);
 
-            planner_->as<FIRM>()->loadParametersFromFile(pathToSetupFile_.c_str());
+            planner_->as<FIRM>()->loadParameters(*config_);
             
             planner_->setup();            
 
@@ -218,6 +247,14 @@ public:
 
             Visualizer::updateRenderer(*dynamic_cast<const ompl::app::RigidBodyGeometry*>(this), this->getGeometricStateExtractor());
 
+            if(useObservabilityMap_) setupObservabilityMap();
+
+            // stamp the environment so a saved roadmap can tell which of its nodes and edges are out of date
+            std::shared_ptr<EnvironmentStamp> environmentStamp = std::make_shared<EnvironmentStamp>();
+
+            if(environmentStamp->compute(*config_, pathToEnvironmentMesh_))
+                planner_->as<FIRM>()->setEnvironmentStamp(environmentStamp);
+
             if (useSavedRoadMap_ == 1) planner_->as<FIRM>()->loadRoadMapFromFile(pathToRoadMapFile_.c_str());
 
             setup_ = true;
@@ -259,6 +296,18 @@ public:
 
     }
 
+    /** \brief The FIRM planner, valid after setup() */
+    FIRM* getFIRM() const
+    {
+        return planner_->as<FIRM>();
+    }
+
+    /** \brief Timing and outcome of the runs of the planner */
+    FIRM::RunStatistics getRunStatistics() const
+    {
+        return planner_->as<FIRM>()->getRunStatistics();
+    }
+
     void  Run()
     {
 
@@ -292,11 +341,17 @@ public:
         
         if(dynamicObstacles_)
         {
-            // Set environment to new mesh with some dynamic / additional obstacles
-            if(!this->setEnvironmentMesh(dynObstList_[obindx]))
-                OMPL_ERROR("Couldn't set mesh with path: %s",dynObstList_[obindx]);
-            
-            const ompl::base::StateValidityCheckerPtr &svc = std::make_shared<ompl::app::FCLStateValidityChecker<ompl::app::Motion_2D>>(siF_,  getGeometrySpecification(), getGeometricStateExtractor(), false);
+            // Set environment to new mesh with some dynamic / additional obstacles, the mesh is only needed for rendering now,
+            // so a headless run does not parse it at every switch
+            if(!FIRMUtils::isHeadless())
+            {
+                if(!this->setEnvironmentMesh(dynObstList_[obindx]))
+                    OMPL_ERROR("Couldn't set mesh with path: %s",dynObstList_[obindx].c_str());
+
+                Visualizer::environmentChanged();
+            }
+
+            const ompl::base::StateValidityCheckerPtr &svc = envVariantCheckers_[obindx];
 
             siF_->setStateValidityChecker(svc);
 
@@ -328,37 +383,72 @@ protected:
         return ss;
     }
 
-    const ompl::base::State* getGeometricComponentStateInternal(const ompl::base::State *state, unsigned int /*index*/) const
+    /** \brief Allocate the validity checker selected in the setup file for the given environment mesh */
+    ompl::base::StateValidityCheckerPtr allocValidityChecker(const std::string &pathToEnvironmentMesh)
     {
-        return state;
+        if(useSDFValidityChecker_)
+        {
+            return std::make_shared<SignedDistanceFieldValidityChecker>(siF_, pathToEnvironmentMesh, sdfResolution_, robotRadius_, environmentCacheDir_);
+        }
+
+        return std::make_shared<ompl::app::FCLStateValidityChecker<ompl::app::Motion_2D>>(siF_,  getGeometrySpecification(), getGeometricStateExtractor(), false);
     }
 
-    void loadGoals()
+    /** \brief Allocate a validity checker for every mesh in the dynamic obstacle list */
+    void preloadEnvironmentVariants()
     {
+        envVariantCheckers_.clear();
 
-        using namespace arma;
-        // Load XML containing landmarks
-        TiXmlDocument doc(pathToSetupFile_);
-        bool loadOkay = doc.LoadFile();
-
-        if(!loadOkay)
+        for(unsigned int i = 0; i < dynObstList_.size(); i++)
         {
-            printf( "Could not load setup file. Error='%s'. Exiting.\n", doc.ErrorDesc() );
+            // FCL builds its BVH from the current environment mesh
+            if(!useSDFValidityChecker_ && !this->setEnvironmentMesh(dynObstList_[i]))
+                OMPL_ERROR("Couldn't set mesh with path: %s",dynObstList_[i].c_str());
+
+            envVariantCheckers_.push_back(allocValidityChecker(dynObstList_[i]));
+        }
+
+        if(!useSDFValidityChecker_)
+            this->setEnvironmentMesh(pathToEnvironmentMesh_);
+
+        OMPL_INFORM("Preloaded validity checkers for %u environment variants", (unsigned int)envVariantCheckers_.size());
+    }
+
+    /** \brief Load the observability map saved with the roadmap, or build it if there is none for the current landmarks */
+    void setupObservabilityMap()
+    {
+        ObservabilityMap::ObservabilityMapPtr obsMap(new ObservabilityMap());
+
+        std::uint64_t fingerprint = ObservabilityMap::fingerprintSensing(*config_);
 
-            exit( 1 );
+        if(useSavedRoadMap_ != 1 || !obsMap->load(ObservabilityMap::pathForRoadmap(pathToRoadMapFile_), fingerprint))
+        {
+            obsMap->build(siF_, obsMapResolution_, obsMapYawBins_, fingerprint);
         }
 
-        TiXmlNode* node = 0;
-        TiXmlElement* landmarkElement = 0;
-        TiXmlElement* itemElement = 0;
+        siF_->setObservabilityMap(obsMap);
+    }
+
+    const ompl::base::State* getGeometricComponentStateInternal(const ompl::base::State *state, unsigned int /*index*/) const
+    {
+        return state;
+    }
+
+    void loadGoals()
+    {
+
+        using namespace arma;
+        const TiXmlNode* node = 0;
+        const TiXmlElement* landmarkElement = 0;
+        const TiXmlElement* itemElement = 0;
 
         // Get the landmarklist node
-        node = doc.FirstChild( "GoalList" );
+        node = config_->getSection( "GoalList" );
         assert( node );
         landmarkElement = node->ToElement(); //convert node to element
         assert( landmarkElement  );
 
-        TiXmlNode* child = 0;
+        const TiXmlNode* child = 0;
 
         //Iterate through all the landmarks and put them into the "landmarks_" list
         while( (child = landmarkElement ->IterateChildren(child)))
@@ -383,28 +473,18 @@ protected:
     void loadDynamicObstaclesList()
     {
 
-        // Load XML containing dynamic obstacle model paths
-        TiXmlDocument doc(pathToSetupFile_);
-        bool loadOkay = doc.LoadFile();
-
-        if(!loadOkay)
-        {
-            printf( "Could not load setup file. Error='%s'. Exiting.\n", doc.ErrorDesc() );
-            exit( 1 );
-        }
-
-        TiXmlNode* node = 0;
-        TiXmlElement* landmarkElement = 0;
-        TiXmlElement* itemElement = 0;
+        const TiXmlNode* node = 0;
+        const TiXmlElement* landmarkElement = 0;
+        const TiXmlElement* itemElement = 0;
 
         // Get the dynamic obstacle list node
-        node = doc.FirstChild( "DynamicObstacleList" );
+        node = config_->getSection( "DynamicObstacleList" );
         assert( node );
 
         landmarkElement = node->ToElement(); //convert node to element
         assert( landmarkElement  );
 
-        TiXmlNode* child = 0;
+        const TiXmlNode* child = 0;
 
         //Iterate through all the obstacles and put them into a list
         while( (child = landmarkElement ->IterateChildren(child)))
@@ -431,25 +511,14 @@ protected:
     {
         using namespace arma;
 
-        TiXmlDocument doc(pathToSetupFile_);
-
-        bool loadOkay = doc.LoadFile();
-
-        if ( !loadOkay )
-        {
-            printf( "Could not load setup file in planning problem. Error='%s'. Exiting.\n", doc.ErrorDesc() );
-
-            exit( 1 );
-        }
-
-        TiXmlNode* node = 0;
+        const TiXmlNode* node = 0;
 
-        TiXmlElement* itemElement = 0;
+        const TiXmlElement* itemElement = 0;
 
-        node = doc.FirstChild( "PlanningProblem" );
+        node = config_->getSection( "PlanningProblem" );
         assert( node );
 
-        TiXmlNode* child = 0;
+        const TiXmlNode* child = 0;
 
         // Planner Mode
         child = node->FirstChild("PlannerMode");
@@ -513,6 +582,61 @@ protected:
         itemElement->QueryIntAttribute("useRoadMap", &usermap);
         useSavedRoadMap_ = usermap;
 
+        // Read the collision checker settings (optional, FCL against the robot mesh by default)
+        useSDFValidityChecker_ = false;
+
+        useAdaptiveMotionValidator_ = false;
+
+        sdfResolution_ = 0.05;
+
+        robotRadius_ = 0.2;
+
+        environmentCacheDir_.clear();
+
+        child  = node->FirstChild("CollisionChecker");
+
+        if(child)
+        {
+            itemElement = child->ToElement();
+            assert( itemElement );
+
+            std::string checkerType;
+            itemElement->QueryStringAttribute("type", &checkerType);
+            useSDFValidityChecker_ = checkerType == "sdf";
+
+            itemElement->QueryDoubleAttribute("resolution", &sdfResolution_);
+
+            itemElement->QueryDoubleAttribute("robotRadius", &robotRadius_);
+
+            itemElement->QueryStringAttribute("cacheDir", &environmentCacheDir_);
+
+            int adaptiveMotion = 0;
+            itemElement->QueryIntAttribute("adaptiveMotionCheck", &adaptiveMotion);
+            useAdaptiveMotionValidator_ = adaptiveMotion == 1;
+        }
+
+        // Read the observability map settings (optional)
+        useObservabilityMap_ = false;
+
+        child  = node->FirstChild("ObservabilityMap");
+
+        if(child)
+        {
+            itemElement = child->ToElement();
+            assert( itemElement );
+
+            int useMap = 0;
+            itemElement->QueryIntAttribute("use", &useMap);
+            useObservabilityMap_ = useMap == 1;
+
+            obsMapResolution_ = 0.25;
+            itemElement->QueryDoubleAttribute("resolution", &obsMapResolution_);
+
+            int yawBins = 8;
+            itemElement->QueryIntAttribute("yawbins", &yawBins);
+            obsMapYawBins_ = yawBins;
+        }
+
         // Read the start Pose
         child  = node->FirstChild("StartPose");
         assert( child );
@@ -631,6 +755,9 @@ private:
 
     std::string pathToSetupFile_;
 
+    /** \brief The parsed setup file */
+    SetupConfiguration::SetupConfigurationPtr config_;
+
     std::string pathToRoadMapFile_;
 
     std::string pathToEnvironmentMesh_;
@@ -649,5 +776,32 @@ private:
     std::vector<string> dynObstList_;
 
     int plannerMethod_;
+
+    /** \brief Use the 2D signed distance field instead of FCL for collision checking */
+    bool useSDFValidityChecker_;
+
+    /** \brief Directory of the precomputed distance field cache, no caching if empty */
+    std::string environmentCacheDir_;
+
+    /** \brief Validity checkers of the dynamic obstacle meshes, same order as dynObstList_ */
+    std::vector<ompl::base::StateValidityCheckerPtr> envVariantCheckers_;
+
+    /** \brief Check motions by conservative advancement on the clearance instead of fixed resolution sampling */
+    bool useAdaptiveMotionValidator_;
+
+    /** \brief Cell size of the signed distance field */
+    double sdfResolution_;
+
+    /** \brief Radius of the disc bounding the robot, used by the signed distance field */
+    double robotRadius_;
+
+    /** \brief Reject unobservable samples with a precomputed map */
+    bool useObservabilityMap_;
+
+    /** \brief Cell size of the observability map in x and y */
+    double obsMapResolution_;
+
+    /** \brief Number of heading cells of the observability map */
+    unsigned int obsMapYawBins_;
 };
 #endif
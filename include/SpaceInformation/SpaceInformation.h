@@ -41,6 +41,10 @@
 #include "ompl/control/SpaceInformation.h"
 #include "MotionModels/MotionModelMethod.h"
 #include "ObservationModels/ObservationModelMethod.h"
+#include "Utils/TimeSeriesLogger.h"
+#include "Utils/ObservabilityMap.h"
+#include "Utils/ExecutionTrace.h"
+#include "Utils/Profiler.h"
 
 
 /**
@@ -69,6 +73,7 @@ namespace firm
                 belief_    = this->allocState();
                 showRobot_ = true;
                 logVelocity_ = false;
+                velocityLogCount_ = 0;
             }
 
 
@@ -108,6 +113,8 @@ namespace firm
             /** \brief Checks whether the true system state is in valid or not*/
             bool checkTrueStateValidity(void)
             {
+                FIRM_PROFILE_SCOPE("SpaceInformation::checkTrueStateValidity");
+
                 return this->isValid(trueState_);
             }
 
@@ -120,9 +127,11 @@ namespace firm
                 showRobot_ = flag;
             }
 
-            void getVelocityLog(std::vector<std::pair<double,double> > &vLog)
+            /** \brief Set the logger that receives the speed of every applied control while velocity logging is on */
+            void setVelocityLogger(const std::shared_ptr<TimeSeriesLogger> &logger)
             {
-                vLog = velocityLog_;
+                velocityLogger_ = logger;
+                velocityLogCount_ = 0;
             }
 
             void doVelocityLogging(bool logFlag)
@@ -130,6 +139,29 @@ namespace firm
                 logVelocity_ = logFlag;
             }
 
+            /** \brief Set the precomputed observability map used to reject unobservable samples */
+            void setObservabilityMap(const ObservabilityMap::ObservabilityMapPtr &map)
+            {
+                observabilityMap_ = map;
+            }
+
+            /** \brief Returns the observability map, NULL if none was set */
+            const ObservabilityMap::ObservabilityMapPtr& getObservabilityMap(void) const
+            {
+                return observabilityMap_;
+            }
+
+            /** \brief Set the trace that records every step of the robot, NULL stops recording */
+            void setExecutionTrace(const ExecutionTrace::ExecutionTracePtr &trace)
+            {
+                executionTrace_ = trace;
+            }
+
+            const ExecutionTrace::ExecutionTracePtr& getExecutionTrace(void) const
+            {
+                return executionTrace_;
+            }
+
         protected:
 
             /** \brief Model of the robot's sensor */
@@ -150,9 +182,17 @@ namespace firm
             /** \brief To log/not log velocity*/
             bool logVelocity_;
 
-            /** \brief Storage for velocity log v, w*/
-            std::vector<std::pair<double,double> > velocityLog_;
+            /** \brief Streams the logged speeds to file, memory use does not grow with the mission length */
+            std::shared_ptr<TimeSeriesLogger> velocityLogger_;
+
+            /** \brief Number of velocities logged so far, used as the time index */
+            unsigned int velocityLogCount_;
+
+            /** \brief Lookup table of observable poses, optional */
+            ObservabilityMap::ObservabilityMapPtr observabilityMap_;
 
+            /** \brief Records the true state and belief of the robot, optional */
+            ExecutionTrace::ExecutionTracePtr executionTrace_;
 
 
     };
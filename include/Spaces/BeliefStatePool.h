@@ -0,0 +1,226 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef BELIEF_STATE_POOL_H_
+#define BELIEF_STATE_POOL_H_
+
+#include <atomic>
+#include <vector>
+#include <string>
+#include <ompl/util/Console.h>
+
+/**
+    @par Short Description
+    A thread-local free-list that recycles fully constructed belief states (state object, its
+    sub-components and its covariance storage). The belief spaces allocate, clone and free states
+    in the inner loops of the filters, controllers and Monte Carlo edge simulations, so handing back
+    a recently freed state avoids the heap round trip and keeps the memory cache-warm.
+
+    Every thread owns its own free-list, so acquire/release never lock. A state may be freed on a
+    different thread than the one it was allocated on; it simply joins that thread's free-list.
+    The counters are global and tell us how many states are alive at any moment, which makes leaks
+    in a planning phase visible (compare getStatistics().live before and after the phase).
+
+    \brief Thread-local recycling allocator for belief states.
+
+    \tparam SpaceType The belief space, it must define StateType and a static
+            destroyPooledState(StateType*) that releases the memory of a state for good.
+*/
+template <class SpaceType>
+class BeliefStatePool
+{
+    public:
+
+        typedef typename SpaceType::StateType StateType;
+
+        /** \brief Snapshot of the pool counters */
+        struct Statistics
+        {
+            /** \brief States handed out and not yet returned */
+            long live;
+
+            /** \brief Maximum number of live states seen so far */
+            long peak;
+
+            /** \brief States that had to be created on the heap */
+            unsigned long allocated;
+
+            /** \brief States served from a free-list */
+            unsigned long reused;
+
+            /** \brief States whose memory was actually released */
+            unsigned long destroyed;
+        };
+
+        /** \brief Returns a recycled state or NULL if the calling thread has none cached.
+                   In the latter case the caller constructs the state and calls recordAllocation(). */
+        static StateType* acquire()
+        {
+            std::vector<StateType*> &freeList = localFreeList().states_;
+
+            if(freeList.empty())
+                return NULL;
+
+            StateType *state = freeList.back();
+
+            freeList.pop_back();
+
+            reused_++;
+
+            incrementLive();
+
+            return state;
+        }
+
+        /** \brief Register a state that was newly created on the heap. */
+        static void recordAllocation()
+        {
+            allocated_++;
+
+            incrementLive();
+        }
+
+        /** \brief Give a state back to the calling thread's free-list. If the list is full, the state is destroyed. */
+        static void release(StateType *state)
+        {
+            live_--;
+
+            std::vector<StateType*> &freeList = localFreeList().states_;
+
+            if(freeList.size() < maxCachedStates_)
+            {
+                freeList.push_back(state);
+            }
+            else
+            {
+                SpaceType::destroyPooledState(state);
+                destroyed_++;
+            }
+        }
+
+        /** \brief Set the maximum number of states that each thread keeps in its free-list. */
+        static void setMaxCachedStates(const size_t n)
+        {
+            maxCachedStates_ = n;
+        }
+
+        /** \brief Get a snapshot of the counters. */
+        static Statistics getStatistics()
+        {
+            Statistics stats;
+            stats.live      = live_.load();
+            stats.peak      = peak_.load();
+            stats.allocated = allocated_.load();
+            stats.reused    = reused_.load();
+            stats.destroyed = destroyed_.load();
+            return stats;
+        }
+
+        /** \brief Print the counters, tag identifies the phase of the planner that is reporting. */
+        static void printStatistics(const std::string &tag)
+        {
+            Statistics stats = getStatistics();
+
+            OMPL_INFORM("BeliefStatePool [%s]: live = %ld, peak = %ld, heap allocations = %lu, reused = %lu, destroyed = %lu",
+                        tag.c_str(), stats.live, stats.peak, stats.allocated, stats.reused, stats.destroyed);
+        }
+
+    private:
+
+        /** \brief The per-thread list of free states, emptied when the thread exits. */
+        struct FreeList
+        {
+            ~FreeList()
+            {
+                while(!states_.empty())
+                {
+                    SpaceType::destroyPooledState(states_.back());
+                    states_.pop_back();
+                    destroyed_++;
+                }
+            }
+
+            std::vector<StateType*> states_;
+        };
+
+        static FreeList& localFreeList()
+        {
+            static thread_local FreeList freeList;
+            return freeList;
+        }
+
+        static void incrementLive()
+        {
+            long live = ++live_;
+
+            long peak = peak_.load();
+
+            while(live > peak && !peak_.compare_exchange_weak(peak, live))
+            {
+            }
+        }
+
+        static std::atomic<long> live_;
+
+        static std::atomic<long> peak_;
+
+        static std::atomic<unsigned long> allocated_;
+
+        static std::atomic<unsigned long> reused_;
+
+        static std::atomic<unsigned long> destroyed_;
+
+        /** \brief Upper bound on the number of cached states per thread */
+        static size_t maxCachedStates_;
+};
+
+template <class SpaceType>
+std::atomic<long> BeliefStatePool<SpaceType>::live_(0);
+
+template <class SpaceType>
+std::atomic<long> BeliefStatePool<SpaceType>::peak_(0);
+
+template <class SpaceType>
+std::atomic<unsigned long> BeliefStatePool<SpaceType>::allocated_(0);
+
+template <class SpaceType>
+std::atomic<unsigned long> BeliefStatePool<SpaceType>::reused_(0);
+
+template <class SpaceType>
+std::atomic<unsigned long> BeliefStatePool<SpaceType>::destroyed_(0);
+
+template <class SpaceType>
+size_t BeliefStatePool<SpaceType>::maxCachedStates_ = 4096;
+
+#endif
@@ -43,6 +43,7 @@
 //other includes
 #include <boost/math/constants/constants.hpp>
 #include <armadillo>
+#include "Spaces/BeliefStatePool.h"
 
 using namespace ompl::base;
 class R2BeliefSpace : public ompl::base::RealVectorStateSpace
@@ -117,6 +118,13 @@ class R2BeliefSpace : public ompl::base::RealVectorStateSpace
                 return stateVec;
             }
 
+            /** \brief Restore the values a newly constructed belief has, used when a pooled state is handed out again */
+            void resetBelief(void)
+            {
+                covariance_.zeros(2,2);
+                controllerID_ = -1;
+            }
+
             /** \brief Checks if the input state has stabilized to this state (node reachability check) */
             bool isReached(ompl::base::State *state, bool relaxedConstraint=false) const;
 
@@ -147,6 +155,9 @@ class R2BeliefSpace : public ompl::base::RealVectorStateSpace
 
         virtual void freeState(State *state) const;
 
+        /** \brief Release the memory of a state for good, called by BeliefStatePool when a state is not recycled */
+        static void destroyPooledState(StateType *state);
+
         //virtual void registerProjections(void);
         virtual double distance(const State* state1, const State *state2);
 
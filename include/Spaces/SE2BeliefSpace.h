@@ -44,6 +44,7 @@
 //other includes
 #include <boost/math/constants/constants.hpp>
 #include <armadillo>
+#include "Spaces/BeliefStatePool.h"
 
 using namespace ompl::base;
 class SE2BeliefSpace : public ompl::base::CompoundStateSpace
@@ -142,6 +143,13 @@ class SE2BeliefSpace : public ompl::base::CompoundStateSpace
                 return stateVec;
             }
 
+            /** \brief Restore the values a newly constructed belief has, used when a pooled state is handed out again */
+            void resetBelief(void)
+            {
+                covariance_.zeros(3,3);
+                controllerID_ = -1;
+            }
+
             /** \brief Checks if the input state has stabilized to this state (node reachability check) */
             bool isReached(ompl::base::State *state, bool relaxedConstraint=false) const;
 
@@ -185,6 +193,9 @@ class SE2BeliefSpace : public ompl::base::CompoundStateSpace
         virtual void copyState(State *destination,const State *source) const;
         virtual void freeState(State *state) const;
 
+        /** \brief Release the memory of a state for good, called by BeliefStatePool when a state is not recycled */
+        static void destroyPooledState(StateType *state);
+
         //virtual void registerProjections(void);
         virtual double distance(const State* state1, const State *state2);
 
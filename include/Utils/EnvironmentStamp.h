@@ -0,0 +1,145 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef ENVIRONMENT_STAMP_H
+#define ENVIRONMENT_STAMP_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+class SetupConfiguration;
+
+/**
+    @par Short Description
+    Identifies the world a roadmap was built in: hashes of the environment mesh, the landmark list and the
+    observation and motion model parameters. It also keeps the mesh faces (as hashes with their XY bounding
+    boxes) and the landmarks themselves. Comparing the stamp saved with a roadmap to the current one then
+    tells not only that something changed but where. Only the nodes and edges near those places
+    have to be recomputed.
+
+    \brief Fingerprint of the environment and models a roadmap depends on.
+*/
+class EnvironmentStamp
+{
+    public:
+
+        /** \brief Axis aligned box in the XY plane */
+        struct Box
+        {
+            double xMin, yMin, xMax, yMax;
+        };
+
+        /** \brief A mesh face, hash of its vertex coordinates and its XY bounding box */
+        struct Face
+        {
+            std::uint64_t hash;
+            Box box;
+        };
+
+        struct Landmark
+        {
+            std::int64_t id;
+            double x, y, theta;
+        };
+
+        /** \brief What changed from an older stamp to this one */
+        struct Difference
+        {
+            Difference() : motionModelChanged(false), observationModelChanged(false), sensingChangedEverywhere(false) {}
+
+            /** \brief Every node covariance and edge controller depends on the motion model */
+            bool motionModelChanged;
+
+            /** \brief Every node covariance depends on the observation model */
+            bool observationModelChanged;
+
+            /** \brief Landmarks changed and the sensor has no range limit, so every node sees the change */
+            bool sensingChangedEverywhere;
+
+            /** \brief Bounding boxes of the faces that were added or removed */
+            std::vector<Box> obstacleRegions;
+
+            /** \brief Areas from which an added or removed landmark can be seen */
+            std::vector<Box> sensingRegions;
+
+            bool isGlobal() const
+            {
+                return motionModelChanged || observationModelChanged || sensingChangedEverywhere;
+            }
+
+            bool isEmpty() const
+            {
+                return !isGlobal() && obstacleRegions.empty() && sensingRegions.empty();
+            }
+        };
+
+        EnvironmentStamp();
+
+        /** \brief Stamp the environment described by the parsed setup file and an environment mesh. The sensing range is taken
+                   from a camera_range attribute in the ObservationModels section, without one the range is unbounded. */
+        bool compute(const SetupConfiguration &config, const std::string &pathToEnvironmentMesh);
+
+        /** \brief True if all hashes agree */
+        bool matches(const EnvironmentStamp &other) const;
+
+        /** \brief Changes from older to this stamp */
+        Difference diff(const EnvironmentStamp &older) const;
+
+        /** \brief A single hash over all parts of the stamp */
+        std::uint64_t getCombinedHash() const;
+
+        /** \brief True if the boxes overlap once a is grown by margin on every side */
+        static bool intersects(const Box &a, const Box &b, double margin);
+
+        /** \brief True if box a, grown by margin, overlaps any of the regions */
+        static bool intersectsAny(const Box &a, const std::vector<Box> &regions, double margin);
+
+        std::uint64_t meshHash;
+
+        std::uint64_t landmarkHash;
+
+        std::uint64_t observationModelHash;
+
+        std::uint64_t motionModelHash;
+
+        /** \brief Maximum distance at which a landmark is observed, negative if unbounded */
+        double sensingRange;
+
+        std::vector<Face> faces;
+
+        std::vector<Landmark> landmarks;
+};
+
+#endif
@@ -0,0 +1,194 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef EXECUTION_TRACE_H
+#define EXECUTION_TRACE_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <utility>
+#include <memory>
+#include <boost/thread/mutex.hpp>
+#include <ompl/base/State.h>
+
+/**
+    @par Short Description
+    A compact binary record of a policy execution: the true state and belief at every step of the
+    robot, the roadmap, the edges the policy chose, the rollout candidates and the NBM3P modes.
+    Recording only appends a few fixed size records to a buffered file, so it can stay on for
+    headless runs, and the run can be inspected afterwards with "bsp-app-demo --replay <trace>".
+
+    Events are tied to the step of the robot at which they happened, i.e. the number of steps
+    recorded before them.
+
+    \brief Recorder and reader of execution traces.
+*/
+class ExecutionTrace
+{
+    public:
+
+        typedef std::shared_ptr<ExecutionTrace> ExecutionTracePtr;
+
+        /** \brief A belief: mean (x, y, yaw) and the 3x3 covariance in column major order */
+        struct Pose
+        {
+            double x, y, yaw;
+            double covariance[9];
+        };
+
+        /** \brief A line between the means of two states */
+        struct Segment
+        {
+            double x1, y1, x2, y2;
+        };
+
+        /** \brief One step of the robot */
+        struct Step
+        {
+            Pose trueState;
+            Pose belief;
+        };
+
+        struct RoadmapEvent
+        {
+            std::uint64_t step;
+            std::vector<Pose> nodes;
+            std::vector<Segment> edges;
+        };
+
+        /** \brief The robot starts to follow the edge from node source to node target */
+        struct EdgeEvent
+        {
+            std::uint64_t step;
+            std::int64_t source, target;
+            Segment segment;
+        };
+
+        /** \brief A rollout compared the connections in candidates and took chosen */
+        struct RolloutEvent
+        {
+            std::uint64_t step;
+            std::vector<Segment> candidates;
+            Segment chosen;
+        };
+
+        /** \brief The belief modes tracked by NBM3P and their weights */
+        struct ModesEvent
+        {
+            std::uint64_t step;
+            std::vector<Pose> modes;
+            std::vector<float> weights;
+        };
+
+        ExecutionTrace();
+
+        /** \brief Closes the file if it is recording */
+        ~ExecutionTrace();
+
+        /** \brief Start recording into the file at path (truncated). Closes the previous file if any. */
+        bool open(const std::string &path);
+
+        /** \brief Flush and close the file */
+        void close();
+
+        bool isOpen() const
+        {
+            return out_.is_open();
+        }
+
+        void recordRoadmap(const std::vector<const ompl::base::State*> &nodes,
+                           const std::vector<std::pair<const ompl::base::State*, const ompl::base::State*> > &edges);
+
+        void recordStep(const ompl::base::State *trueState, const ompl::base::State *belief);
+
+        void recordEdge(std::int64_t source, std::int64_t target, const ompl::base::State *sourceState, const ompl::base::State *targetState);
+
+        void recordRollout(const ompl::base::State *from, const std::vector<const ompl::base::State*> &candidates, const ompl::base::State *chosen);
+
+        void recordModes(const std::vector<ompl::base::State*> &modes, const std::vector<float> &weights);
+
+        /** \brief Read a recorded trace, a trace cut short by a crash is read up to its last complete record */
+        bool load(const std::string &path);
+
+        const std::vector<Step>& getSteps() const
+        {
+            return steps_;
+        }
+
+        const std::vector<RoadmapEvent>& getRoadmaps() const
+        {
+            return roadmaps_;
+        }
+
+        const std::vector<EdgeEvent>& getEdges() const
+        {
+            return edges_;
+        }
+
+        const std::vector<RolloutEvent>& getRollouts() const
+        {
+            return rollouts_;
+        }
+
+        const std::vector<ModesEvent>& getModes() const
+        {
+            return modes_;
+        }
+
+    private:
+
+        /** \brief Write the record type and the current step */
+        void writeHeader(std::uint8_t type);
+
+        std::ofstream out_;
+
+        /** \brief Steps recorded so far */
+        std::uint64_t numSteps_;
+
+        boost::mutex mutex_;
+
+        std::vector<Step> steps_;
+
+        std::vector<RoadmapEvent> roadmaps_;
+
+        std::vector<EdgeEvent> edges_;
+
+        std::vector<RolloutEvent> rollouts_;
+
+        std::vector<ModesEvent> modes_;
+};
+
+#endif
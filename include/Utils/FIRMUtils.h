@@ -37,6 +37,10 @@
 
 #include "Weight/FIRMWeight.h"
 #include "Spaces/SE2BeliefSpace.h"
+#include <cstdint>
+#include <boost/function.hpp>
+
+class TiXmlElement;
 
 /** \brief A class containing utility functions used commonly*/
 class FIRMUtils
@@ -52,12 +56,38 @@ class FIRMUtils
         /** \brief Generates a random number within the give range */
         static int generateRandomIntegerInRange(const int floor, const int ceiling);
 
-        /** \brief Save the FIRM graph to an XML file */
-        static void writeFIRMGraphToXML(const std::vector<std::pair<int,std::pair<arma::colvec,arma::mat> > > nodes, const std::vector<std::pair<std::pair<int,int>,FIRMWeight> > edgeWeights);
+        /** \brief Save the FIRM graph to an XML file, returns the name of the file written */
+        static std::string writeFIRMGraphToXML(const std::vector<std::pair<int,std::pair<arma::colvec,arma::mat> > > nodes, const std::vector<std::pair<std::pair<int,int>,FIRMWeight> > edgeWeights);
 
         /** \brief Reads the Graph properties from an XML file */
         static bool readFIRMGraphFromXML(const std::string &pathToXML,std::vector<std::pair<int, arma::colvec> > &FIRMNodePosList, std::vector<std::pair<int, arma::mat> > &FIRMNodeCovarianceList, std::vector<std::pair<std::pair<int,int>,FIRMWeight> > &edgeWeights);
 
+        /** \brief Read the vertices (x, y, z) and the faces (0 based vertex indices) of a Wavefront OBJ mesh, faces with invalid indices are skipped */
+        static bool readOBJMesh(const std::string &path, std::vector<arma::colvec> &vertices, std::vector<std::vector<int> > &faces);
+
+        /** \brief Start value of the hashes below */
+        static const std::uint64_t HASH_SEED = 14695981039346656037ULL;
+
+        /** \brief Combine the name, attributes and children of an XML element into hash (64 bit FNV-1a, start with HASH_SEED).
+                   The result does not depend on the build, so it can be saved to detect changes to a section of a setup file. */
+        static void hashXMLElement(const TiXmlElement *element, std::uint64_t &hash);
+
+        /** \brief 64 bit FNV-1a hash of the contents of a file, 0 if it cannot be read. Used to key caches on file contents. */
+        static std::uint64_t hashFileContents(const std::string &path);
+
+        /** \brief Calls task(i) for every i in [0, n) spread over numThreads worker threads (0 uses all cores) and returns once all calls
+                   are done. Calls for different i run concurrently, so the task may only write to data owned by index i. If a task throws,
+                   the remaining indices are skipped and the first exception is rethrown in the calling thread. */
+        static void parallelFor(std::size_t n, const boost::function<void (std::size_t)> &task, unsigned int numThreads = 0);
+
+        /** \brief In a headless run nobody watches, so execution is not slowed down for the viewer and nothing waits for console input */
+        static void setHeadless(bool headless);
+
+        static bool isHeadless();
+
+        /** \brief Sleep so that the robot can be followed in the window, returns at once in a headless run */
+        static void waitForViewer(unsigned int milliseconds);
+
         /** \brief Convert degree to radian */
         static double degree2Radian(double deg);
 
@@ -0,0 +1,218 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef LRU_CACHE_H
+#define LRU_CACHE_H
+
+#include <list>
+#include <map>
+#include <cstddef>
+#include <boost/thread/mutex.hpp>
+
+/**
+    @par Short Description
+    A map that keeps its entries in order of last use and drops the least recently used ones once the
+    memory reported for the entries exceeds a budget. The caller tells the cache what an entry costs,
+    the cache only does the bookkeeping. Values are handed out as copies under a lock, so an entry
+    can be evicted while a copy of it is still in use.
+
+    \brief Memory budgeted least-recently-used cache.
+*/
+template <class Key, class Value>
+class LRUCache
+{
+    public:
+
+        /** \brief A budget of 0 bytes means unlimited, nothing is ever evicted */
+        LRUCache(std::size_t budget = 0) : budget_(budget), used_(0), evictions_(0)
+        {
+        }
+
+        /** \brief Copy the value for key into value and mark it as most recently used, returns false on a miss */
+        bool get(const Key &key, Value &value)
+        {
+            boost::mutex::scoped_lock _(mutex_);
+
+            typename std::map<Key, Entry>::iterator it = entries_.find(key);
+
+            if(it == entries_.end())
+                return false;
+
+            order_.splice(order_.begin(), order_, it->second.position);
+
+            value = it->second.value;
+
+            return true;
+        }
+
+        /** \brief Insert or replace the value for key, then evict the least recently used entries until the budget
+                   is met again. The entry just inserted is never evicted. */
+        void insert(const Key &key, const Value &value, std::size_t bytes)
+        {
+            boost::mutex::scoped_lock _(mutex_);
+
+            typename std::map<Key, Entry>::iterator it = entries_.find(key);
+
+            if(it != entries_.end())
+            {
+                used_ -= it->second.bytes;
+                order_.erase(it->second.position);
+                entries_.erase(it);
+            }
+
+            order_.push_front(key);
+
+            Entry entry;
+            entry.value = value;
+            entry.bytes = bytes;
+            entry.position = order_.begin();
+
+            entries_.insert(std::make_pair(key, entry));
+
+            used_ += bytes;
+
+            evict();
+        }
+
+        /** \brief Remove the entry for key if there is one */
+        void erase(const Key &key)
+        {
+            boost::mutex::scoped_lock _(mutex_);
+
+            typename std::map<Key, Entry>::iterator it = entries_.find(key);
+
+            if(it == entries_.end())
+                return;
+
+            used_ -= it->second.bytes;
+            order_.erase(it->second.position);
+            entries_.erase(it);
+        }
+
+        /** \brief Call function(key, value) for every entry without changing the use order. The function may change a value
+                   but not what it costs. */
+        template <class Function>
+        void forEach(Function function)
+        {
+            boost::mutex::scoped_lock _(mutex_);
+
+            for(typename std::map<Key, Entry>::iterator it = entries_.begin(); it != entries_.end(); ++it)
+                function(it->first, it->second.value);
+        }
+
+        bool contains(const Key &key) const
+        {
+            boost::mutex::scoped_lock _(mutex_);
+            return entries_.find(key) != entries_.end();
+        }
+
+        void clear()
+        {
+            boost::mutex::scoped_lock _(mutex_);
+            entries_.clear();
+            order_.clear();
+            used_ = 0;
+        }
+
+        /** \brief Change the budget, evicts right away if the cache is over the new budget */
+        void setBudget(std::size_t budget)
+        {
+            boost::mutex::scoped_lock _(mutex_);
+            budget_ = budget;
+            evict();
+        }
+
+        std::size_t getBudget() const
+        {
+            return budget_;
+        }
+
+        std::size_t size() const
+        {
+            boost::mutex::scoped_lock _(mutex_);
+            return entries_.size();
+        }
+
+        /** \brief Sum of the sizes reported for the cached entries */
+        std::size_t getMemoryUsage() const
+        {
+            boost::mutex::scoped_lock _(mutex_);
+            return used_;
+        }
+
+        /** \brief Number of entries dropped to stay within the budget so far */
+        std::size_t getEvictionCount() const
+        {
+            boost::mutex::scoped_lock _(mutex_);
+            return evictions_;
+        }
+
+    private:
+
+        struct Entry
+        {
+            Value value;
+            std::size_t bytes;
+            typename std::list<Key>::iterator position;
+        };
+
+        /** \brief Drop entries from the back of the use order, the caller holds the lock */
+        void evict()
+        {
+            while(budget_ > 0 && used_ > budget_ && order_.size() > 1)
+            {
+                typename std::map<Key, Entry>::iterator it = entries_.find(order_.back());
+
+                used_ -= it->second.bytes;
+                entries_.erase(it);
+                order_.pop_back();
+                evictions_++;
+            }
+        }
+
+        std::size_t budget_;
+
+        std::size_t used_;
+
+        std::size_t evictions_;
+
+        /** \brief Most recently used key first */
+        std::list<Key> order_;
+
+        std::map<Key, Entry> entries_;
+
+        mutable boost::mutex mutex_;
+};
+
+#endif
@@ -0,0 +1,122 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef OBSERVABILITY_MAP_H
+#define OBSERVABILITY_MAP_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <ompl/base/State.h>
+
+namespace firm
+{
+    class SpaceInformation;
+}
+
+class SetupConfiguration;
+
+/**
+    @par Short Description
+    A grid over (x, y, yaw) that stores, for the landmark set it was built with, whether the
+    linearized system at the cell center is stable i.e. the DARE at that pose has a solution.
+    It is computed once, saved next to the roadmap and then lets the samplers and the roadmap
+    builder throw away unobservable samples with a table lookup instead of a linearization and a
+    Riccati solve per sample.
+
+    The map is tied to the sensing setup through a fingerprint of the landmarks and observation model parameters,
+    a map whose fingerprint does not match the current setup file is not loaded.
+
+    \brief Precomputed observability/stability lookup table.
+*/
+class ObservabilityMap
+{
+    public:
+
+        typedef std::shared_ptr<ObservabilityMap> ObservabilityMapPtr;
+
+        ObservabilityMap();
+
+        /** \brief Evaluate the stability test at the center of every cell of the state space bounds.
+            \param resolution Cell size in x and y (meters).
+            \param yawBins Number of cells in [-pi, pi).
+            \param sensingFingerprint See fingerprintSensing(). */
+        void build(const std::shared_ptr<firm::SpaceInformation> &si, double resolution, unsigned int yawBins, std::uint64_t sensingFingerprint);
+
+        /** \brief Returns false if the cell containing the state is not stable. Returns true if the map is empty
+                   or the state lies outside the mapped area, so a missing map never rejects anything. */
+        bool isObservable(const ompl::base::State *state) const;
+
+        /** \brief Save to a binary file */
+        bool save(const std::string &path) const;
+
+        /** \brief Load from a binary file, fails if the file was built for another landmark set or motion model */
+        bool load(const std::string &path, std::uint64_t sensingFingerprint);
+
+        bool isEmpty() const
+        {
+            return cells_.empty();
+        }
+
+        /** \brief The linearize-and-solve-DARE test that the map caches */
+        static bool isStateStable(const std::shared_ptr<firm::SpaceInformation> &si, const ompl::base::State *state);
+
+        /** \brief Hash of the LandmarkList, ObservationModels and MotionModels sections of the setup file, i.e. everything the stability test depends on */
+        static std::uint64_t fingerprintSensing(const SetupConfiguration &config);
+
+        /** \brief The file the map of a roadmap is saved to */
+        static std::string pathForRoadmap(const std::string &pathToRoadmap)
+        {
+            return pathToRoadmap + ".obsmap";
+        }
+
+    private:
+
+        /** \brief Index of the cell containing (x, y, yaw), returns false if it is outside the map */
+        bool cellIndex(double x, double y, double yaw, std::size_t &index) const;
+
+        double xMin_, yMin_;
+
+        double resolution_;
+
+        unsigned int nx_, ny_, nyaw_;
+
+        std::uint64_t sensingFingerprint_;
+
+        /** \brief 1 if stable, 0 otherwise, yaw varies fastest then x then y */
+        std::vector<unsigned char> cells_;
+};
+
+#endif
@@ -0,0 +1,107 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef POLICY_FILE_H
+#define POLICY_FILE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+    @par Short Description
+    The feedback policies solved on a roadmap, one table per goal. For every roadmap node a table holds the node
+    the feedback edge leads to and the cost-to-go. It is saved next to the roadmap and tied to it by a fingerprint of
+    the roadmap file, the environment and the DP parameters. A planner that loads the same roadmap for the same goal
+    can then execute the policy right away without solving the dynamic program again.
+
+    \brief Saved DP policy tables of a roadmap.
+*/
+class PolicyFile
+{
+    public:
+
+        /** \brief The feedback of one node. next is the node the feedback edge leads to, NEXT_GOAL if it leads to the goal
+                   (which is not a roadmap node) or NEXT_NONE if the node has no feedback. */
+        struct Entry
+        {
+            std::int64_t vertex;
+            std::int64_t next;
+            double costToGo;
+        };
+
+        static const std::int64_t NEXT_NONE = -1;
+
+        static const std::int64_t NEXT_GOAL = -2;
+
+        /** \brief The policy towards one goal, the goal is given by its mean (x, y, yaw) */
+        struct Policy
+        {
+            double goal[3];
+            std::vector<Entry> entries;
+        };
+
+        PolicyFile();
+
+        /** \brief Save to a binary file */
+        bool save(const std::string &path) const;
+
+        /** \brief Load from a binary file, fails if the file was saved for another roadmap, environment or DP parameters */
+        bool load(const std::string &path, std::uint64_t fingerprint);
+
+        /** \brief The policy for the goal, NULL if there is none */
+        const Policy* find(const double goal[3]) const;
+
+        /** \brief Add a policy, it replaces the policy for the same goal */
+        void set(const Policy &policy);
+
+        void setFingerprint(std::uint64_t fingerprint)
+        {
+            fingerprint_ = fingerprint;
+        }
+
+        /** \brief The file the policies of a roadmap are saved to */
+        static std::string pathForRoadmap(const std::string &pathToRoadmap)
+        {
+            return pathToRoadmap + ".policy";
+        }
+
+    private:
+
+        std::uint64_t fingerprint_;
+
+        std::vector<Policy> policies_;
+};
+
+#endif
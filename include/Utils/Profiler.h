@@ -0,0 +1,176 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef FIRM_PROFILER_H
+#define FIRM_PROFILER_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+/**
+    @par Short Description
+    Aggregates the time spent in named scopes of the planner's hot paths (sampling, DARE solves,
+    edge Monte Carlo, filter steps, collision checks, dynamic programming sweeps, rollout decisions
+    and the NBM3P phases). Every scope keeps a call count, total/min/max time and a histogram with
+    power-of-two nanosecond buckets, so the tail of a scope is visible and not only its mean.
+    Named counters record how often something happens (e.g. Monte Carlo particles simulated).
+
+    Recording goes to a per-thread store, threads never contend with each other. The first
+    TRACE_EVENTS_PER_THREAD scope executions of every thread are also kept as trace events, and at most
+    RETIRED_TRACE_EVENTS of those of the threads that have exited (e.g. parallelFor workers), which
+    writeChromeTrace() exports in the Chrome trace-event format (load it in chrome://tracing or Perfetto).
+
+    The FIRM_PROFILE_SCOPE / FIRM_PROFILE_COUNT macros are what the planner code uses. They expand
+    to nothing unless the tree is configured with -DFIRM_PROFILING=ON (which defines
+    FIRM_ENABLE_PROFILING), so a normal build pays nothing for the instrumentation.
+
+    \brief Low overhead scoped timers and counters with aggregated histograms.
+*/
+class Profiler
+{
+    public:
+
+        /** \brief Number of histogram buckets, bucket i counts executions that took [2^i, 2^(i+1)) ns */
+        static const unsigned int HISTOGRAM_BUCKETS = 40;
+
+        /** \brief Maximum number of trace events kept per thread, later executions are only aggregated */
+        static const unsigned int TRACE_EVENTS_PER_THREAD = 200000;
+
+        /** \brief Maximum number of trace events kept from all exited threads together, the events of later exits are dropped */
+        static const unsigned int RETIRED_TRACE_EVENTS = 1000000;
+
+        /** \brief Aggregate of all executions of one scope */
+        struct ScopeStatistics
+        {
+            ScopeStatistics();
+
+            /** \brief Fold other into this */
+            void merge(const ScopeStatistics &other);
+
+            /** \brief Add one execution that took ns nanoseconds */
+            void add(std::uint64_t ns);
+
+            /** \brief Approximate q-quantile (0 <= q <= 1) in nanoseconds, read off the histogram */
+            double quantile(double q) const;
+
+            std::uint64_t count;
+
+            std::uint64_t totalNs;
+
+            std::uint64_t minNs;
+
+            std::uint64_t maxNs;
+
+            std::uint64_t buckets[HISTOGRAM_BUCKETS];
+        };
+
+        /** \brief Times the enclosing block. Use FIRM_PROFILE_SCOPE rather than this class directly. */
+        class Scope
+        {
+            public:
+
+                /** \brief name must outlive the program, i.e. be a string literal */
+                explicit Scope(const char *name) : name_(name), startNs_(Profiler::now())
+                {
+                }
+
+                ~Scope()
+                {
+                    Profiler::record(name_, startNs_, Profiler::now());
+                }
+
+            private:
+
+                Scope(const Scope&);
+
+                Scope& operator=(const Scope&);
+
+                const char *name_;
+
+                std::uint64_t startNs_;
+        };
+
+        /** \brief Nanoseconds on a monotonic clock */
+        static std::uint64_t now();
+
+        /** \brief Record one execution of the scope name that ran from startNs to endNs */
+        static void record(const char *name, std::uint64_t startNs, std::uint64_t endNs);
+
+        /** \brief Add n to the counter name */
+        static void count(const char *name, std::uint64_t n);
+
+        /** \brief True if the tree was built with the profiling scopes compiled in */
+        static bool isEnabled();
+
+        /** \brief Merged statistics of all threads, by scope name */
+        static std::map<std::string, ScopeStatistics> getStatistics();
+
+        /** \brief Merged counters of all threads, by counter name */
+        static std::map<std::string, std::uint64_t> getCounters();
+
+        /** \brief Drop everything recorded so far */
+        static void reset();
+
+        /** \brief Write the per-scope statistics, histograms and counters as JSON */
+        static bool writeJSON(const std::string &path);
+
+        /** \brief Write the recorded trace events in the Chrome trace-event format */
+        static bool writeChromeTrace(const std::string &path);
+
+        /** \brief When the process exits, write prefix + ".json" and prefix + "Trace.json".
+                   Calling it again only changes the prefix. */
+        static void exportAtExit(const std::string &prefix);
+};
+
+#ifdef FIRM_ENABLE_PROFILING
+
+#define FIRM_PROFILE_CONCAT_IMPL(a, b) a##b
+#define FIRM_PROFILE_CONCAT(a, b) FIRM_PROFILE_CONCAT_IMPL(a, b)
+
+/** \brief Time the rest of the enclosing block under name (a string literal) */
+#define FIRM_PROFILE_SCOPE(name) Profiler::Scope FIRM_PROFILE_CONCAT(firmProfileScope, __LINE__)(name)
+
+/** \brief Add n to the counter name (a string literal) */
+#define FIRM_PROFILE_COUNT(name, n) Profiler::count(name, n)
+
+#else
+
+#define FIRM_PROFILE_SCOPE(name) do {} while(0)
+
+#define FIRM_PROFILE_COUNT(name, n) do {} while(0)
+
+#endif
+
+#endif
@@ -0,0 +1,109 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef ROADMAP_DELTA_H
+#define ROADMAP_DELTA_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <armadillo>
+
+/**
+    @par Short Description
+    The changes that bring a saved roadmap up to date with an environment that differs from the one it
+    was built in. It lists the nodes that are now in collision, the nodes whose stationary covariance was
+    solved for again, and the edges that were dropped or re-simulated. Nodes and edges are given by their
+    index in the base roadmap file. The delta is saved as XML next to the roadmap. It is only valid for the
+    exact base file and environment it was computed for, so loading the same roadmap into the same changed
+    environment again skips the recomputation.
+
+    \brief Incremental update of a saved roadmap to a changed environment.
+*/
+class RoadmapDelta
+{
+    public:
+
+        struct NodeUpdate
+        {
+            std::size_t id;
+            arma::mat covariance;
+        };
+
+        struct EdgeUpdate
+        {
+            std::size_t index;
+            double cost;
+            double successProbability;
+        };
+
+        RoadmapDelta();
+
+        /** \brief Save as XML */
+        bool save(const std::string &path) const;
+
+        /** \brief Load from XML, returns false if the file is missing or malformed */
+        bool load(const std::string &path);
+
+        /** \brief True if the delta was computed for this base roadmap and environment */
+        bool appliesTo(std::uint64_t roadmapHash, std::uint64_t environmentHash) const
+        {
+            return baseRoadmapHash == roadmapHash && this->environmentHash == environmentHash;
+        }
+
+        /** \brief The file the delta of a roadmap is saved to */
+        static std::string pathForRoadmap(const std::string &pathToRoadmap)
+        {
+            return pathToRoadmap + ".delta";
+        }
+
+        /** \brief Hash of the contents of the base roadmap file */
+        std::uint64_t baseRoadmapHash;
+
+        /** \brief EnvironmentStamp::getCombinedHash() of the environment the delta brings the roadmap to */
+        std::uint64_t environmentHash;
+
+        /** \brief The motion model changed, the nominal trajectories in the base file are stale */
+        bool regenerateEdgeControllers;
+
+        std::vector<std::size_t> removedNodes;
+
+        std::vector<NodeUpdate> updatedNodes;
+
+        std::vector<std::size_t> removedEdges;
+
+        std::vector<EdgeUpdate> updatedEdges;
+};
+
+#endif
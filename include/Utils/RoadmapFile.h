@@ -0,0 +1,154 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef ROADMAP_FILE_H
+#define ROADMAP_FILE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class EnvironmentStamp;
+
+/**
+    @par Short Description
+    Versioned binary container for a FIRM roadmap. Next to the node beliefs and the edge weights it
+    stores, for every edge, the nominal trajectory (intermediate states and open loop controls) that
+    the edge controller tracks, so a saved roadmap can be brought back without re-running the local
+    planner and the stationary covariance computation for every node and edge.
+
+    The file is a fixed header followed by the node records, the edge records, one flat array of
+    trajectory values and, if the roadmap was stamped, the mesh faces and landmarks of the environment
+    it was built in (see EnvironmentStamp). Everything is plain old data written in host byte order and 8 byte aligned,
+    so a reader maps the file and uses the records in place.
+
+    \brief Memory-mapped binary roadmap file.
+*/
+class RoadmapFile
+{
+    public:
+
+        /** \brief Bump when the layout changes, files of other versions are refused */
+        static const std::uint32_t VERSION = 2;
+
+        /** \brief A FIRM node, the mean (x, y, yaw) and the column-major 3x3 stationary covariance */
+        struct Node
+        {
+            std::int64_t id;
+            double state[3];
+            double covariance[9];
+        };
+
+        /** \brief A FIRM edge. The nominal trajectory starts at trajectoryOffset in the trajectory array
+                   and holds trajectoryLength states followed by trajectoryLength controls. A length of 0
+                   means no controller data was stored for the edge. */
+        struct Edge
+        {
+            std::int64_t source;
+            std::int64_t target;
+            double cost;
+            double successProbability;
+            std::uint64_t trajectoryOffset;
+            std::uint64_t trajectoryLength;
+        };
+
+        RoadmapFile();
+
+        ~RoadmapFile();
+
+        /** \brief Write a roadmap. The file is written to a temporary path and renamed so a reader never maps a partial file.
+                   If stamp is not NULL the environment the roadmap was built in is stored with it. */
+        static bool write(const std::string &path, std::uint32_t stateDimension, std::uint32_t controlDimension,
+                          const std::vector<Node> &nodes, const std::vector<Edge> &edges, const std::vector<double> &trajectories,
+                          const EnvironmentStamp *stamp = NULL);
+
+        /** \brief Returns true if the file starts with the binary roadmap magic, used to tell it apart from an XML roadmap */
+        static bool isRoadmapFile(const std::string &path);
+
+        /** \brief Map a roadmap file read-only, fails if the magic, version or sizes do not check out */
+        bool map(const std::string &path);
+
+        /** \brief Release the mapping, all pointers handed out before become invalid */
+        void unmap();
+
+        bool isMapped() const
+        {
+            return mapped_ != NULL;
+        }
+
+        std::uint32_t getStateDimension() const;
+
+        std::uint32_t getControlDimension() const;
+
+        std::size_t getNumNodes() const;
+
+        std::size_t getNumEdges() const;
+
+        const Node& getNode(std::size_t i) const;
+
+        const Edge& getEdge(std::size_t i) const;
+
+        /** \brief The nominal states of an edge, getStateDimension() values per state */
+        const double* getNominalStates(const Edge &edge) const;
+
+        /** \brief The nominal controls of an edge, getControlDimension() values per control */
+        const double* getNominalControls(const Edge &edge) const;
+
+        /** \brief Read the environment stamp stored with the roadmap, returns false if the roadmap is not stamped */
+        bool getEnvironmentStamp(EnvironmentStamp &stamp) const;
+
+    private:
+
+        /** \brief Non-copyable, the object owns the mapping */
+        RoadmapFile(const RoadmapFile&);
+
+        RoadmapFile& operator=(const RoadmapFile&);
+
+        void *mapped_;
+
+        std::size_t mappedSize_;
+
+        const Node *nodes_;
+
+        const Edge *edges_;
+
+        const double *trajectories_;
+
+        const void *stampFaces_;
+
+        const void *stampLandmarks_;
+};
+
+#endif
@@ -0,0 +1,92 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef SETUP_CONFIGURATION_H_
+#define SETUP_CONFIGURATION_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <tinyxml.h>
+
+/**
+    @par Short Description
+    The setup file, parsed once. The setups hand it to the motion and observation models, the
+    planner and their own loaders, which read their section (PlanningProblem, FIRM, MotionModels,
+    ...) from it instead of opening and parsing the file again.
+
+    Values can be overridden in memory before the configuration is handed out, which is how a
+    batch run changes parameters without writing a new setup file.
+
+    \brief Parsed setup file shared by the components of a setup.
+*/
+class SetupConfiguration
+{
+    public:
+
+        typedef std::shared_ptr<SetupConfiguration> SetupConfigurationPtr;
+
+        /** \brief Parse the setup file, exits if it cannot be loaded */
+        SetupConfiguration(const std::string &pathToSetupFile);
+
+        /** \brief The file this configuration was parsed from */
+        const std::string& getPath() const
+        {
+            return path_;
+        }
+
+        /** \brief The top level element with this name (e.g. "FIRM"), NULL if the file has none */
+        const TiXmlElement* getSection(const char *name) const
+        {
+            return doc_.FirstChildElement(name);
+        }
+
+        /** \brief Set an attribute in memory, override has the form "Section/Child@attribute=value".
+                   Returns false if the override is malformed or the element does not exist. */
+        bool setAttribute(const std::string &override);
+
+        /** \brief Apply several overrides, stops at the first one that fails */
+        bool setAttributes(const std::vector<std::string> &overrides);
+
+        /** \brief Write the configuration, including the overrides, to path */
+        bool saveFile(const std::string &path) const;
+
+    private:
+
+        std::string path_;
+
+        TiXmlDocument doc_;
+};
+
+#endif
@@ -0,0 +1,133 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef TIME_SERIES_LOGGER_H
+#define TIME_SERIES_LOGGER_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <boost/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+/**
+    @par Short Description
+    Streams rows of the form "time,value[,value...]" to a CSV file. Rows go into a ring buffer of
+    fixed capacity and a background thread appends them to the file and flushes it, so memory
+    stays constant however long the mission runs and everything logged up to the last flush is on
+    disk if the process dies. A logger that is not open ignores all rows.
+
+    If the writer falls behind and the buffer is full, log() waits for space instead of dropping rows.
+
+    \brief Bounded, streaming writer for time series logs.
+*/
+class TimeSeriesLogger
+{
+    public:
+
+        /** \brief capacity is the maximum number of rows held in memory */
+        TimeSeriesLogger(size_t capacity = 1024);
+
+        /** \brief Flushes and closes the file */
+        ~TimeSeriesLogger();
+
+        /** \brief Start streaming into the file at path (truncated). Closes the previous file if any. */
+        bool open(const std::string &path);
+
+        /** \brief Write all buffered rows, close the file and stop the writer thread. */
+        void close();
+
+        bool isOpen() const
+        {
+            return isOpen_;
+        }
+
+        /** \brief Append a row with a single value. */
+        void log(double time, double value);
+
+        /** \brief Append a row with several values. */
+        void log(double time, const std::vector<double> &values);
+
+        /** \brief Append a row with several values. */
+        void log(double time, const std::vector<float> &values);
+
+        /** \brief Block until every row logged so far is written to the file. */
+        void flush();
+
+    private:
+
+        struct Row
+        {
+            double time;
+            std::vector<double> values;
+        };
+
+        /** \brief Reserve the next slot in the ring, waits while the ring is full. Must hold mutex_. */
+        Row& nextRow(boost::unique_lock<boost::mutex> &lock);
+
+        /** \brief Body of the writer thread */
+        void writerLoop();
+
+        std::ofstream file_;
+
+        /** \brief The ring buffer, slots keep their value storage so steady state logging does not allocate */
+        std::vector<Row> ring_;
+
+        /** \brief Rows taken out of the ring by the writer thread */
+        std::vector<Row> batch_;
+
+        size_t head_;
+
+        size_t count_;
+
+        /** \brief Number of rows handed to the writer that are not on disk yet */
+        size_t writing_;
+
+        bool isOpen_;
+
+        bool stop_;
+
+        boost::mutex mutex_;
+
+        /** \brief Signals the writer that rows are available or that it should stop */
+        boost::condition_variable rowsAvailable_;
+
+        /** \brief Signals producers that space was freed and flush() that rows were written */
+        boost::condition_variable rowsWritten_;
+
+        boost::thread writerThread_;
+};
+
+#endif
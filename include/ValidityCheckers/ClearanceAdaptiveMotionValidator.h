@@ -0,0 +1,79 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef CLEARANCE_ADAPTIVE_MOTION_VALIDATOR_H
+#define CLEARANCE_ADAPTIVE_MOTION_VALIDATOR_H
+
+#include <ompl/base/MotionValidator.h>
+#include <ompl/base/SpaceInformation.h>
+
+/**
+    @par Short Description
+    Checks straight line motions in SE2 by conservative advancement. At the current point of the
+    motion the clearance of the robot is queried; no point of the robot can move further than
+    (translation + boundingRadius * rotation) along the motion, so the motion is collision free up to
+    the parameter where that bound reaches the clearance and the next query is placed there. Far
+    from obstacles a long edge needs a handful of queries, close to obstacles the steps shrink to the
+    space's state validity checking resolution, i.e. the behavior of the discrete motion validator.
+
+    If the state validity checker does not compute clearance, every motion is sampled at the
+    validity checking resolution.
+
+    \brief Motion validator that steps by the local clearance.
+*/
+class ClearanceAdaptiveMotionValidator : public ompl::base::MotionValidator
+{
+    public:
+
+        /** \brief boundingRadius is the largest distance of a point of the robot from its reference point,
+                   0 for a disc robot (or a checker that ignores the heading). */
+        ClearanceAdaptiveMotionValidator(const ompl::base::SpaceInformationPtr &si, double boundingRadius);
+
+        virtual ~ClearanceAdaptiveMotionValidator()
+        {
+        }
+
+        virtual bool checkMotion(const ompl::base::State *s1, const ompl::base::State *s2) const;
+
+        virtual bool checkMotion(const ompl::base::State *s1, const ompl::base::State *s2, std::pair<ompl::base::State*, double> &lastValid) const;
+
+    private:
+
+        /** \brief Walks from s1 towards s2, returns the parameter up to which the motion is known valid (1 if all of it) */
+        double advance(const ompl::base::State *s1, const ompl::base::State *s2) const;
+
+        double boundingRadius_;
+};
+
+#endif
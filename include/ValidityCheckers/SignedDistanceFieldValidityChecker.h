@@ -0,0 +1,132 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef SIGNED_DISTANCE_FIELD_VALIDITY_CHECKER_H
+#define SIGNED_DISTANCE_FIELD_VALIDITY_CHECKER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ompl/base/StateValidityChecker.h>
+
+/**
+    @par Short Description
+    Collision checker for a disc robot moving in the plane. The environment mesh (.obj) is projected
+    onto the XY plane and rasterized at a fixed resolution, then a signed Euclidean distance
+    transform gives, for every cell, the distance to the nearest obstacle boundary (negative inside
+    obstacles). A state is valid if the bilinearly interpolated distance at its position exceeds the
+    robot radius, so isValid and clearance are one lookup instead of a mesh-mesh FCL query.
+
+    The yaw of the state is ignored, which is exact for disc shaped robots. States outside the
+    rasterized area are invalid.
+
+    If a cache directory is given, the field is stored there in a binary file keyed by a hash of the
+    mesh contents, the resolution and the radius. Later runs memory-map that file instead of
+    rebuilding the field.
+
+    \brief 2D signed distance field state validity checker.
+*/
+class SignedDistanceFieldValidityChecker : public ompl::base::StateValidityChecker
+{
+    public:
+
+        /** \brief Build the field for the environment mesh.
+            \param resolution Cell size in meters.
+            \param robotRadius Radius of the disc that bounds the robot.
+            \param cacheDirectory Where to look for / store the precomputed field, no caching if empty. */
+        SignedDistanceFieldValidityChecker(const ompl::base::SpaceInformationPtr &si, const std::string &pathToEnvironmentMesh,
+                                           double resolution, double robotRadius, const std::string &cacheDirectory = "");
+
+        /** \brief Releases the memory mapped cache file, if any */
+        virtual ~SignedDistanceFieldValidityChecker();
+
+        /** \brief Valid if inside the state bounds and the robot disc does not touch an obstacle */
+        virtual bool isValid(const ompl::base::State *state) const;
+
+        /** \brief Valid check that also reports the clearance */
+        virtual bool isValid(const ompl::base::State *state, double &dist) const;
+
+        /** \brief Check states[0..count) at once, valid[i] is set to 1 if states[i] is valid. One bounds check and one
+                   field lookup per state, without a virtual call or profiler scope per state. */
+        void isValid(const ompl::base::State *const *states, unsigned int count, std::vector<unsigned char> &valid) const;
+
+        /** \brief Distance between the robot disc and the nearest obstacle, negative in collision */
+        virtual double clearance(const ompl::base::State *state) const;
+
+        /** \brief Signed distance from the point (x,y) to the nearest obstacle boundary */
+        double signedDistance(double x, double y) const;
+
+        double getRobotRadius() const
+        {
+            return robotRadius_;
+        }
+
+    private:
+
+        /** \brief Read the vertices and faces of the .obj file and mark every cell that an obstacle face covers */
+        bool rasterizeMesh(const std::string &pathToEnvironmentMesh, std::vector<unsigned char> &occupied);
+
+        /** \brief Fill distances_ from the occupancy grid */
+        void computeSignedDistances(const std::vector<unsigned char> &occupied);
+
+        /** \brief Memory-map a cache file, fails if it is missing or was written for another key */
+        bool mapCache(const std::string &path, std::uint64_t key);
+
+        /** \brief Write the field to a cache file */
+        void writeCache(const std::string &path, std::uint64_t key) const;
+
+        /** \brief Squared Euclidean distance transform to the nearest cell where seed is set */
+        void squaredDistanceTransform(const std::vector<unsigned char> &seed, std::vector<double> &dist) const;
+
+        double xMin_, yMin_;
+
+        double resolution_;
+
+        int nx_, ny_;
+
+        double robotRadius_;
+
+        /** \brief Signed distance at cell centers in meters, row major in y. Points into storage_ or the mapped cache file. */
+        const float *distances_;
+
+        /** \brief Owns the field when it was computed in this process */
+        std::vector<float> storage_;
+
+        /** \brief The mapped cache file, NULL if the field was computed */
+        void *mapped_;
+
+        std::size_t mappedSize_;
+};
+
+#endif
@@ -0,0 +1,136 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef FIRM_OMPL_FRAME_RECORDER_H
+#define FIRM_OMPL_FRAME_RECORDER_H
+
+#include <atomic>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+#include <boost/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+/**
+    @par Short Description
+    Records the frames of the GL window as one YUV4MPEG2 (.y4m) stream. The GUI thread only copies
+    the framebuffer into one of a fixed ring of buffers and hands it over; colour conversion and
+    writing happen on a background thread. If every buffer is still waiting to be written, the
+    frame is dropped instead of stalling the GUI (and with it the planner).
+
+    The stream goes to a file, or to the stdin of an external encoder command
+    (e.g. "ffmpeg -y -loglevel error -i - -pix_fmt yuv420p trial.mp4").
+
+    \brief Asynchronous frame capture for video recording.
+*/
+class FrameRecorder
+{
+    public:
+
+        /** \brief An RGB frame as returned by glReadPixels, bottom row first */
+        struct Frame
+        {
+            int width;
+
+            int height;
+
+            std::vector<unsigned char> pixels;
+        };
+
+        /** \brief The stream is written to outputPath, or piped into encoderCommand if it is not empty */
+        FrameRecorder(const std::string &outputPath, const std::string &encoderCommand,
+                      unsigned int framesPerSecond, unsigned int ringSize);
+
+        /** \brief Writes the frames still queued, then closes the stream */
+        ~FrameRecorder();
+
+        /** \brief Get a free buffer sized for a width x height frame, NULL if all buffers are queued (the frame is dropped) */
+        Frame* acquire(int width, int height);
+
+        /** \brief Queue a frame obtained from acquire() for writing */
+        void submit(Frame *frame);
+
+        /** \brief Number of frames dropped so far because the writer could not keep up */
+        unsigned int getDroppedFrames() const
+        {
+            return droppedFrames_;
+        }
+
+    private:
+
+        /** \brief The writer thread */
+        void writeFrames();
+
+        /** \brief Open the file or the encoder pipe and write the stream header, the first frame fixes the size */
+        bool openStream(int width, int height);
+
+        /** \brief Convert a frame to planar YUV 4:4:4 and append it to the stream */
+        bool writeFrame(const Frame &frame);
+
+        std::string outputPath_;
+
+        std::string encoderCommand_;
+
+        unsigned int framesPerSecond_;
+
+        /** \brief All the buffers, they are allocated once */
+        std::vector<Frame> ring_;
+
+        std::deque<Frame*> freeFrames_;
+
+        std::deque<Frame*> queuedFrames_;
+
+        boost::mutex queueMutex_;
+
+        boost::condition_variable frameQueued_;
+
+        bool stop_;
+
+        std::atomic<unsigned int> droppedFrames_;
+
+        /** \brief Owned by the writer thread */
+        FILE *stream_;
+
+        int streamWidth_;
+
+        int streamHeight_;
+
+        std::vector<unsigned char> yuv_;
+
+        boost::thread writer_;
+};
+
+#endif // FIRM_OMPL_FRAME_RECORDER_H
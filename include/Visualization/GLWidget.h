@@ -51,6 +51,7 @@ using namespace std;
 
 
 #include "Visualizer.h"
+#include "FrameRecorder.h"
 #include <omplapp/graphics/detail/assimpGUtil.h>
 #include <omplapp/geometry/RigidBodyGeometry.h>
 
@@ -61,7 +62,7 @@ class GLWidget : public QGLWidget {
     typedef Visualizer Display;
 
     GLWidget(QWidget *parent = 0);
-    ~GLWidget(){}
+    ~GLWidget();
 
     //For Window to know how big to draw the GL scene in the window
     QSize minimumSizeHint() const;
@@ -119,7 +120,7 @@ class GLWidget : public QGLWidget {
     bool m_view; //true represents overhead over robot. False is for viewing whole environment.
 
     QString m_snapshotPath;
-    QString m_framePath;
+    FrameRecorder* m_frameRecorder; //encodes the video frames on its own thread, created by the first saveFrame()
 
 };
 
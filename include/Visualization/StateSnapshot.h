@@ -0,0 +1,76 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef FIRM_OMPL_STATE_SNAPSHOT_H
+#define FIRM_OMPL_STATE_SNAPSHOT_H
+
+#include <atomic>
+#include "Spaces/SE2BeliefSpace.h"
+
+/**
+    @par Short Description
+    A seqlock holding the latest pose and covariance of a belief state. The simulation thread
+    publishes every step without taking any lock and the render thread copies out the most
+    recent consistent value once per frame. A reader that overlaps a write simply retries, the
+    writer never waits for the reader, so the planner is not slowed down by rendering.
+
+    There must be a single writer per snapshot (the thread that executes the robot).
+
+    \brief Single producer, wait-free for the producer, snapshot of a SE2 belief.
+*/
+class StateSnapshot
+{
+    public:
+
+        StateSnapshot();
+
+        /** \brief Publish a new value, called by the simulation thread. */
+        void publish(const ompl::base::State *state);
+
+        /** \brief Copy the latest published value into state. Returns false if nothing was published yet. */
+        bool read(ompl::base::State *state) const;
+
+    private:
+
+        /** \brief x, y, yaw followed by the 3x3 covariance in column major order */
+        static const unsigned int DATA_SIZE = 12;
+
+        /** \brief Odd while a write is in progress, 0 if nothing was published */
+        std::atomic<unsigned int> sequence_;
+
+        /** \brief Stored as relaxed atomics so that a torn read is a retry, not a data race */
+        std::atomic<double> data_[DATA_SIZE];
+};
+
+#endif // FIRM_OMPL_STATE_SNAPSHOT_H
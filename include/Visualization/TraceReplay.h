@@ -0,0 +1,101 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef FIRM_OMPL_TRACE_REPLAY_H
+#define FIRM_OMPL_TRACE_REPLAY_H
+
+#include <string>
+#include "Utils/ExecutionTrace.h"
+#include "SpaceInformation/SpaceInformation.h"
+
+/**
+    @par Short Description
+    Shows a recorded execution trace in the Visualizer. seek() puts the Visualizer in the state it
+    was in at a step of the recorded run: the roadmap, the robot and its belief, the edge being
+    followed and, if the last decision was a rollout or a multi-modal update, the rollout
+    connections or the belief modes. The environment mesh is not part of the trace.
+
+    \brief Offline replay of an execution trace.
+*/
+class TraceReplay
+{
+    public:
+
+        TraceReplay();
+
+        /** \brief Load the trace and show its first step */
+        bool load(const std::string &path);
+
+        /** \brief Number of recorded steps of the robot */
+        size_t getNumberOfSteps() const
+        {
+            return trace_.getSteps().size();
+        }
+
+        size_t getCurrentStep() const
+        {
+            return currentStep_;
+        }
+
+        /** \brief Show the run as it was at step, clamped to the recorded steps */
+        void seek(long step);
+
+    private:
+
+        /** \brief Allocate a state with the mean and covariance of pose, the caller frees it */
+        ompl::base::State* allocState(const ExecutionTrace::Pose &pose) const;
+
+        /** \brief Allocate the two end states of a segment, the caller frees them */
+        std::pair<ompl::base::State*, ompl::base::State*> allocStates(const ExecutionTrace::Segment &segment) const;
+
+        void freeStates(const std::pair<ompl::base::State*, ompl::base::State*> &states) const;
+
+        /** \brief Index of the last event at or before step, -1 if there is none */
+        template <class Event>
+        static long findLastEvent(const std::vector<Event> &events, size_t step);
+
+        void showRoadmap(long index);
+
+        ExecutionTrace trace_;
+
+        /** \brief Only used to allocate the states handed to the Visualizer */
+        firm::SpaceInformation::SpaceInformationPtr si_;
+
+        size_t currentStep_;
+
+        /** \brief The roadmap event currently shown, -1 if none */
+        long shownRoadmap_;
+};
+
+#endif // FIRM_OMPL_TRACE_REPLAY_H
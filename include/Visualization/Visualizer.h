@@ -46,12 +46,27 @@
 
 #include <armadillo>
 #include <list>
+#include <algorithm>
+#include <chrono>
 #include <boost/thread/mutex.hpp>
 #include <boost/thread.hpp>
+#include <boost/optional.hpp>
 #include "Spaces/SE2BeliefSpace.h"
 #include "SpaceInformation/SpaceInformation.h"
+#include "Visualization/StateSnapshot.h"
 #include <omplapp/graphics/RenderGeometry.h>
 
+/**
+    @par Short Description
+    The planner thread adds and clears what is drawn, the render thread (the QTimer of MyWindow) draws it.
+    Writers store only the pose and covariance of each state, under a short lock, and bump the version of
+    the layer they changed. Once per frame the render thread copies out the layers whose version changed
+    and releases the lock before drawing. The roadmap nodes, roadmap edges, feedback edges, landmarks and
+    environment are each compiled into a display list that is rebuilt only when the layer changed. The
+    frame itself is a handful of glCallList calls plus the few moving parts (robot, belief, rollout).
+
+    \brief Draws the roadmap, the policy and the robot in the OpenGL window.
+*/
 class Visualizer
 {
 
@@ -78,10 +93,27 @@ class Visualizer
             MultiModalMode
         };
 
+        /** \brief What is drawn of a belief: the pose and the xy block of the covariance */
+        struct VZRPose
+        {
+            double x, y, yaw;
+            double cxx, cxy, cyy;
+        };
+
+        /** \brief A line segment between two states */
+        struct VZREdge
+        {
+            double x1, y1, x2, y2;
+
+            bool operator==(const VZREdge &other) const
+            {
+                return x1 == other.x1 && y1 == other.y1 && x2 == other.x2 && y2 == other.y2;
+            }
+        };
+
         struct VZRFeedbackEdge
         {
-            ompl::base::State *source;
-            ompl::base::State *target;
+            VZREdge edge;
             double cost;
         };
 
@@ -90,14 +122,30 @@ class Visualizer
         {
             boost::mutex::scoped_lock sl(drawMutex_);
             landmarks_.insert(landmarks_.end(), landmarks.begin(), landmarks.end());
+            layerVersion_[LandmarksLayer]++;
         }
 
         /** \brief Add the states i.e. graph nodes to be drawn*/
         static void addState(const ompl::base::State *state)
         {
-            boost::mutex::scoped_lock sl(drawMutex_);
             assert(state);
-            states_.push_back(si_->cloneState(state));
+            const VZRPose pose = toPose(state);
+            boost::mutex::scoped_lock sl(drawMutex_);
+            states_.push_back(pose);
+            layerVersion_[NodesLayer]++;
+        }
+
+        /** \brief Add many graph nodes under a single lock, so the renderer is not stalled once per node */
+        static void addStates(const std::vector<ompl::base::State*> &states)
+        {
+            boost::mutex::scoped_lock sl(drawMutex_);
+            states_.reserve(states_.size() + states.size());
+            for(unsigned int i = 0; i < states.size(); i++)
+            {
+                assert(states[i]);
+                states_.push_back(toPose(states[i]));
+            }
+            layerVersion_[NodesLayer]++;
         }
 
 
@@ -106,14 +154,16 @@ class Visualizer
         {
             boost::mutex::scoped_lock sl(drawMutex_);
             states_.clear();
+            layerVersion_[NodesLayer]++;
         }
 
         /** \brief Add state to belief mode list */
         static void addBeliefMode(ompl::base::State *state)
         {
-            boost::mutex::scoped_lock sl(drawMutex_);
             assert(state);
-            beliefModes_.push_back(si_->cloneState(state));
+            const VZRPose pose = toPose(state);
+            boost::mutex::scoped_lock sl(drawMutex_);
+            beliefModes_.push_back(pose);
         }
 
         /** \brief Clear belief Modes */
@@ -126,66 +176,74 @@ class Visualizer
         /** \brief Add a Roadmap Graph edge to the visualization */
         static void addGraphEdge(const ompl::base::State *source, const ompl::base::State *target)
         {
+            const VZREdge edge = toEdge(source, target);
             boost::mutex::scoped_lock sl(drawMutex_);
+            graphEdges_.push_back(edge);
+            layerVersion_[GraphEdgesLayer]++;
+        }
 
-            std::pair<const ompl::base::State*, const ompl::base::State*> edge;
-
-            edge = std::make_pair(si_->cloneState(source),si_->cloneState(target));
+        /** \brief Add many roadmap edges under a single lock */
+        static void addGraphEdges(const std::vector<std::pair<const ompl::base::State*, const ompl::base::State*> > &edges)
+        {
+            boost::mutex::scoped_lock sl(drawMutex_);
+            graphEdges_.reserve(graphEdges_.size() + edges.size());
+            for(unsigned int i = 0; i < edges.size(); i++)
+            {
+                graphEdges_.push_back(toEdge(edges[i].first, edges[i].second));
+            }
+            layerVersion_[GraphEdgesLayer]++;
+        }
 
-            graphEdges_.push_back(edge);
+        static void clearGraphEdges()
+        {
+            boost::mutex::scoped_lock sl(drawMutex_);
+            graphEdges_.clear();
+            layerVersion_[GraphEdgesLayer]++;
         }
 
         static void addFeedbackEdge(const ompl::base::State *source, const ompl::base::State *target, double cost)
         {
-            boost::mutex::scoped_lock sl(drawMutex_);
             VZRFeedbackEdge edge;
 
-            edge.source = si_->allocState();
-            si_->copyState(edge.source, source);
-
-            edge.target = si_->allocState();
-            si_->copyState(edge.target, target);
+            edge.edge = toEdge(source, target);
 
             edge.cost = cost;
 
+            boost::mutex::scoped_lock sl(drawMutex_);
+
             feedbackEdges_.push_back(edge);
+
+            layerVersion_[FeedbackLayer]++;
         }
 
         /** \brief Add a rollout connection to the visualization */
         static void addRolloutConnection(const ompl::base::State *source, const ompl::base::State *target)
         {
+            const VZREdge edge = toEdge(source, target);
             boost::mutex::scoped_lock sl(drawMutex_);
-
-            std::pair<const ompl::base::State*, const ompl::base::State*> edge;
-
-            edge = std::make_pair(si_->cloneState(source),si_->cloneState(target));
-
             rolloutConnections_.push_back(edge);
         }
 
          /** \brief Add a rollout connection to the visualization */
         static void addMostLikelyPathEdge(const ompl::base::State *source, const ompl::base::State *target)
         {
-            boost::mutex::scoped_lock sl(drawMutex_);
+            const VZREdge edge = toEdge(source, target);
 
-            std::pair<const ompl::base::State*, const ompl::base::State*> edge;
-
-            edge = std::make_pair(si_->cloneState(source),si_->cloneState(target));
+            boost::mutex::scoped_lock sl(drawMutex_);
 
             mostLikelyPath_.push_back(edge);
+
+            // feedback edges on the most likely path are only drawn as part of the path
+            layerVersion_[FeedbackLayer]++;
         }
 
         static void setChosenRolloutConnection(const ompl::base::State *source, const ompl::base::State *target)
         {
+            const VZREdge edge = toEdge(source, target);
             boost::mutex::scoped_lock sl(drawMutex_);
-
-            boost::optional<std::pair<const ompl::base::State*, const ompl::base::State*> > edge(std::make_pair(si_->cloneState(source),si_->cloneState(target)));
-
             chosenRolloutConnection_ = edge;
         }
 
-        static void drawRobotPath();
-
         static void setMode(VZRDrawingMode mode)
         {
             mode_ = mode;
@@ -195,6 +253,7 @@ class Visualizer
         {
             boost::mutex::scoped_lock sl(drawMutex_);
             feedbackEdges_.clear();
+            layerVersion_[FeedbackLayer]++;
         }
 
         static void clearRolloutConnections()
@@ -207,12 +266,18 @@ class Visualizer
         {
             boost::mutex::scoped_lock sl(drawMutex_);
             mostLikelyPath_.clear();
+            layerVersion_[FeedbackLayer]++;
         }
 
         static void addOpenLoopRRTPath(const ompl::geometric::PathGeometric path)
         {
+            std::vector<VZRPose> polyline;
+            for(unsigned int i = 0; i < path.getStateCount(); i++)
+            {
+                polyline.push_back(toPose(path.getState(i)));
+            }
             boost::mutex::scoped_lock sl(drawMutex_);
-            openLoopRRTPaths_.push_back(path);
+            openLoopRRTPaths_.push_back(polyline);
         }
 
         static void clearOpenLoopRRTPaths()
@@ -221,23 +286,16 @@ class Visualizer
             openLoopRRTPaths_.clear();
         }
 
-        /** \brief update the robot's true state for drawing */
+        /** \brief update the robot's true state for drawing, does not block on the render thread */
         static void updateTrueState(const ompl::base::State *state)
         {
-            if(si_)
-            {
-                boost::mutex::scoped_lock sl(drawMutex_);
-                if(!trueState_) trueState_ = si_->allocState();
-                si_->copyState(trueState_,state);
-            }
+            trueStateSnapshot_.publish(state);
         }
 
-        /** \brief update the robot's belief for drawing */
+        /** \brief update the robot's belief for drawing, does not block on the render thread */
         static void updateCurrentBelief(const ompl::base::State *state)
         {
-            boost::mutex::scoped_lock sl(drawMutex_);
-            if(!currentBelief_) currentBelief_ = si_->allocState();
-            si_->copyState(currentBelief_,state);
+            currentBeliefSnapshot_.publish(state);
         }
 
         /** \brief Copy the space information pointer */
@@ -256,6 +314,7 @@ class Visualizer
         {
             boost::mutex::scoped_lock sl(drawMutex_);
             renderGeom_ = renderer;
+            layerVersion_[EnvironmentLayer]++;
         }
 
         static void updateRenderer(const ompl::app::RigidBodyGeometry &rbg, const ompl::app::GeometricStateExtractor &se)
@@ -263,43 +322,34 @@ class Visualizer
             boost::mutex::scoped_lock sl(drawMutex_);
             //ompl::app::RenderGeometry rd(new ompl::app::RenderGeometry(rbg,se));
             renderGeom_ = new ompl::app::RenderGeometry(rbg,se);
+            layerVersion_[EnvironmentLayer]++;
+        }
+
+        /** \brief The environment mesh was changed, its display list is rebuilt on the next frame */
+        static void environmentChanged()
+        {
+            boost::mutex::scoped_lock sl(drawMutex_);
+            layerVersion_[EnvironmentLayer]++;
         }
 
         static void clearRobotPath()
         {
             boost::mutex::scoped_lock sl(drawMutex_);
             robotPath_.clear();
+            robotPathGeneration_++;
         }
 
         /** \brief Draw a single landmark that is passed to this function */
-        static void drawLandmark(arma::colvec& landmark);
+        static void drawLandmark(const arma::colvec& landmark);
 
         /** \brief Draw the true robot rendering*/
-        static void drawRobot(const ompl::base::State *state);
+        static void drawRobot(const VZRPose &pose);
 
         /** \brief Draw a single state that is passed to this function */
-        static void drawState(const ompl::base::State* state, VZRStateType stateType);
+        static void drawState(const VZRPose &pose, VZRStateType stateType);
 
         /** \brief Draw an edge that belongs to the Roadmap graph */
-        static void drawEdge(const ompl::base::State* source, const ompl::base::State* target);
-
-        /** \brief Draw the stored graph nodes */
-        static void drawGraphBeliefNodes();
-
-        /** \brief Draw belief modes. */
-        static void drawBeliefModes();
-
-        /** \brief Draw the edges in the roadmap graph */
-        static void drawGraphEdges();
-
-        /** \brief Draw graph feedback edges */
-        static void drawFeedbackEdges();
-
-        /** \brief Draw rollout connections */
-        static void drawRolloutConnections();
-
-        /** \brief Draw the most likely path under FIRM */
-        static void drawMostLikelyPath();
+        static void drawEdge(const VZREdge &edge);
 
         /** \brief Draw the X&Y bounds*/
         static void drawEnvironment();
@@ -307,9 +357,7 @@ class Visualizer
         static void drawObstacle();
 
         /** \brief Draw geometric path.*/
-        static void drawGeometricPath(const ompl::geometric::PathGeometric path);
-
-        static void drawOpenLoopRRTPaths();
+        static void drawGeometricPath(const std::vector<VZRPose> &path);
 
         /** \brief Refresh the drawing and show latest scenario*/
         static void refresh();
@@ -324,13 +372,48 @@ class Visualizer
             saveVideo_ = flag;
         }
 
+        /** \brief Command that encodes the recorded frames from its stdin, empty to write a .y4m file */
+        static void setVideoEncoder(const std::string &command)
+        {
+            boost::mutex::scoped_lock sl(drawMutex_);
+            videoEncoder_ = command;
+        }
+
+        static std::string videoEncoder()
+        {
+            boost::mutex::scoped_lock sl(drawMutex_);
+            return videoEncoder_;
+        }
+
         static void printRobotPathToFile(std::string path);
 
 
     private:
 
+        /** \brief The parts of the scene that are compiled into display lists */
+        enum VZRLayer
+        {
+            EnvironmentLayer,
+            LandmarksLayer,
+            NodesLayer,
+            GraphEdgesLayer,
+            FeedbackLayer,
+            NUM_LAYERS
+        };
+
+        static VZRPose toPose(const ompl::base::State *state);
+
+        static VZREdge toEdge(const ompl::base::State *source, const ompl::base::State *target);
+
+        /** \brief Compile the display list of a layer from the data copied out for this frame */
+        static void buildLayer(VZRLayer layer, const std::vector<VZRPose> &nodes, const std::vector<VZREdge> &edges,
+                               const std::vector<arma::colvec> &landmarks);
+
+        /** \brief The unit disk that every drawn state is scaled from */
+        static void drawDisk(double radius);
+
         /** \brief A list that stores the graph nodes*/
-        static std::list<ompl::base::State*> states_;
+        static std::vector<VZRPose> states_;
 
         /** \brief visualizer thread mutex, allows us to place a lock so that class state changes while drawing */
         static boost::mutex drawMutex_;
@@ -341,8 +424,14 @@ class Visualizer
         /** \brief Store the robots belief state */
         static ompl::base::State* currentBelief_;
 
+        /** \brief Latest true state published by the simulation, copied into trueState_ at the start of a frame */
+        static StateSnapshot trueStateSnapshot_;
+
+        /** \brief Latest belief published by the simulation, copied into currentBelief_ at the start of a frame */
+        static StateSnapshot currentBeliefSnapshot_;
+
         /** \brief Store the belief modes for multi-modal operation */
-        static std::list<ompl::base::State*> beliefModes_;
+        static std::vector<VZRPose> beliefModes_;
 
         /** \brief Store the landmarks */
         static std::vector<arma::colvec> landmarks_;
@@ -351,25 +440,28 @@ class Visualizer
         static firm::SpaceInformation::SpaceInformationPtr si_;
 
         /** \brief Store the Roadmap graph edges */
-        static std::vector<std::pair<const ompl::base::State*, const ompl::base::State*> > graphEdges_;
+        static std::vector<VZREdge> graphEdges_;
 
         /** \brief Store the Rollout connections */
-        static std::vector<std::pair<const ompl::base::State*, const ompl::base::State*> > rolloutConnections_;
+        static std::vector<VZREdge> rolloutConnections_;
 
-        /** \brief Store the Rollout connections */
-        static std::vector<std::pair<const ompl::base::State*, const ompl::base::State*> > mostLikelyPath_;
+        /** \brief Store the most likely path */
+        static std::vector<VZREdge> mostLikelyPath_;
 
         /** \brief The rollout connection that gets chosen as the next target*/
-        static boost::optional<std::pair<const ompl::base::State*, const ompl::base::State*> >chosenRolloutConnection_;
+        static boost::optional<VZREdge> chosenRolloutConnection_;
 
         /** \brief Store the feedback edges */
         static std::vector<VZRFeedbackEdge> feedbackEdges_;
 
         /** \brief stores the sequence of states of the real robot */
-        static std::vector<const ompl::base::State*> robotPath_;
+        static std::vector<VZRPose> robotPath_;
+
+        /** \brief Bumped when robotPath_ is cleared */
+        static unsigned int robotPathGeneration_;
 
         /** \brief Container for RRT paths generated as candidates during Multi-Modal operation */
-        static std::vector<ompl::geometric::PathGeometric> openLoopRRTPaths_;
+        static std::vector<std::vector<VZRPose> > openLoopRRTPaths_;
 
         /** \brief Visualizer drawing mode setting */
         static VZRDrawingMode mode_;
@@ -385,6 +477,26 @@ class Visualizer
 
         static bool saveVideo_;
 
+        static std::string videoEncoder_;
+
+        /** \brief Bumped by the writers of a layer, guarded by drawMutex_ */
+        static unsigned int layerVersion_[NUM_LAYERS];
+
+        // the members below are only touched by the render thread
+
+        /** \brief The version each display list was compiled from */
+        static unsigned int builtVersion_[NUM_LAYERS];
+
+        /** \brief When each display list was last compiled, a layer that keeps changing is rebuilt at a bounded rate */
+        static std::chrono::steady_clock::time_point buildTime_[NUM_LAYERS];
+
+        static GLuint layerList_[NUM_LAYERS];
+
+        static GLuint diskList_;
+
+        /** \brief x, y of the robot path points copied so far, the path only grows between clears */
+        static std::vector<double> renderedRobotPath_;
 
+        static unsigned int renderedRobotPathGeneration_;
 };
 #endif // FIRM_OMPL_VISUALIZER_H
@@ -47,6 +47,7 @@ using namespace std;
 #include <QtGui/QComboBox>
 
 class GLWidget;
+class TraceReplay;
 
 class MyWindow : public QWidget {
   Q_OBJECT
@@ -58,6 +59,9 @@ class MyWindow : public QWidget {
      //call back for buttons
     void resetCamera();
 
+    //show a recorded trace instead of a live run, scrubbed with the arrow keys
+    void setReplay(TraceReplay *replay);
+
   protected:
     void keyPressEvent(QKeyEvent *event);
 
@@ -67,8 +71,13 @@ class MyWindow : public QWidget {
 
 
   private:
+    //show the replayed trace at step and report the step in the title
+    void seekReplay(long step);
+
     QTimer timer_; //controls framerate
     GLWidget* glWidget_; //GLScene
+    TraceReplay* replay_; //NULL unless a trace is replayed
+    bool playing_; //the replay advances one step per frame
 };
 
 #endif
@@ -97,6 +97,8 @@
 
 // Validity checkers
 #include "ValidityCheckers/FIRMValidityChecker.h"
+#include "ValidityCheckers/SignedDistanceFieldValidityChecker.h"
+#include "ValidityCheckers/ClearanceAdaptiveMotionValidator.h"
 
 //Multi-Modal
 #include "Planner/NBM3P.h"
@@ -108,6 +110,8 @@
 
 // Utilities
 #include "Utils/FIRMUtils.h"
+#include "Utils/ObservabilityMap.h"
+#include "Utils/TimeSeriesLogger.h"
 
 // ROS
 #ifdef USE_ROS
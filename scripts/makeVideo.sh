@@ -1 +1,6 @@
-ffmpeg -r 8 -i "${1}/Frame_%07d.png" -s 1834x1001 -an "${2}.mov"
+# usage: makeVideo.sh <recording.y4m | folder of Frame_*.png> <output name>
+if [ -d "${1}" ]; then
+    ffmpeg -r 8 -i "${1}/Frame_%07d.png" -s 1834x1001 -an "${2}.mov"
+else
+    ffmpeg -i "${1}" -s 1834x1001 -pix_fmt yuv420p -an "${2}.mov"
+fi
@@ -0,0 +1,434 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "Experiments/BatchExperiment.h"
+#include "Setup/TwoDPointRobotSetup.h"
+#include "Utils/FIRMUtils.h"
+#include <ompl/util/RandomNumbers.h>
+#include <boost/filesystem.hpp>
+#include <boost/thread.hpp>
+#include <boost/algorithm/string.hpp>
+#include <tinyxml.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <chrono>
+#include <cstdio>
+#include <csignal>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+    /** \brief How often the driver checks on its workers */
+    const unsigned int WORKER_POLL_INTERVAL_MS = 100;
+
+    std::string joinOverrides(const std::vector<std::string> &overrides)
+    {
+        return boost::algorithm::join(overrides, ";");
+    }
+}
+
+BatchExperiment::BatchExperiment(const std::string &outputDirectory) :
+    outputDirectory_(outputDirectory), numWorkers_(0), timeout_(0)
+{
+    boost::filesystem::create_directories(boost::filesystem::path(outputDirectory_));
+}
+
+unsigned int BatchExperiment::addJob(const std::string &setupFile, unsigned int seed, const std::vector<std::string> &overrides)
+{
+    Job job;
+
+    job.id = jobs_.size();
+    job.setupFile = setupFile;
+    job.seed = seed;
+    job.overrides = overrides;
+
+    jobs_.push_back(job);
+
+    return job.id;
+}
+
+std::string BatchExperiment::jobPath(const Job &job, const std::string &extension) const
+{
+    std::ostringstream path;
+
+    path << (boost::filesystem::path(outputDirectory_) / "job-").string() << job.id << extension;
+
+    return path.str();
+}
+
+BatchExperiment::Result BatchExperiment::runJob(const Job &job)
+{
+    Result result;
+
+    result.job = job;
+    result.status = "ok";
+    result.solved = false;
+    result.statistics = FIRM::RunStatistics();
+    result.wallTime = 0;
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    // the Monte Carlo simulations run on several threads, so a seed fixes the samples but not every noise draw
+    ompl::RNG::setSeed(job.seed);
+    arma::arma_rng::set_seed(job.seed);
+    srand(job.seed);
+
+    FIRMUtils::setHeadless(true);
+
+    SetupConfiguration::SetupConfigurationPtr config = std::make_shared<SetupConfiguration>(job.setupFile);
+
+    if(!config->setAttributes(job.overrides))
+        throw ompl::Exception("Invalid parameter override");
+
+    TwoDPointRobotSetup *setup(new TwoDPointRobotSetup);
+
+    setup->setSetupConfiguration(config);
+
+    setup->setup();
+
+    if(setup->solve())
+    {
+        result.solved = true;
+
+        setup->Run();
+    }
+
+    result.statistics = setup->getRunStatistics();
+
+    result.wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    delete setup;
+
+    return result;
+}
+
+int BatchExperiment::startJob(const Job &job)
+{
+    std::remove(jobPath(job, ".result").c_str());
+
+    // nothing else runs in the driver, so the worker starts from a clean copy of it
+    const pid_t pid = fork();
+
+    if(pid != 0)
+        return pid;
+
+    if(!freopen(jobPath(job, ".log").c_str(), "w", stdout) || dup2(fileno(stdout), fileno(stderr)) < 0)
+        _exit(1);
+
+    try
+    {
+        Result result = runJob(job);
+
+        std::ofstream out(jobPath(job, ".result").c_str());
+
+        const FIRM::RunStatistics &s = result.statistics;
+
+        out << result.solved << " " << s.solveTime << " " << s.roadmapTime << " " << s.nodesAdded << " " << s.dpTime << " "
+            << s.dpSolves << " " << s.goalReached << " " << s.collided << " " << s.executionCost << " " << s.timeSteps << " "
+            << s.nodesReached << " " << s.numNodes << " " << s.numEdges << " " << s.rolloutDecisions << " " << s.rolloutTime << " "
+            << s.recoveries << " " << s.recoveryTime << std::endl;
+    }
+    catch(std::exception &e)
+    {
+        OMPL_ERROR("BatchExperiment: Job %u failed: %s", job.id, e.what());
+        fflush(stdout);
+        _exit(1);
+    }
+
+    fflush(stdout);
+
+    // skip the static destructors of the copied driver
+    _exit(0);
+}
+
+void BatchExperiment::finishJob(Result &result, int exitStatus)
+{
+    std::ifstream in(jobPath(result.job, ".result").c_str());
+
+    FIRM::RunStatistics &s = result.statistics;
+
+    if(in >> result.solved >> s.solveTime >> s.roadmapTime >> s.nodesAdded >> s.dpTime >> s.dpSolves >> s.goalReached >> s.collided
+          >> s.executionCost >> s.timeSteps >> s.nodesReached >> s.numNodes >> s.numEdges >> s.rolloutDecisions >> s.rolloutTime
+          >> s.recoveries >> s.recoveryTime)
+    {
+        result.status = "ok";
+    }
+    else if(WIFSIGNALED(exitStatus))
+    {
+        result.status = "crashed";
+    }
+    else
+    {
+        result.status = "failed";
+    }
+}
+
+const std::vector<BatchExperiment::Result>& BatchExperiment::run()
+{
+    const unsigned int numWorkers = numWorkers_ > 0 ? numWorkers_ : std::max(1u, boost::thread::hardware_concurrency());
+
+    results_.assign(jobs_.size(), Result());
+
+    struct Worker
+    {
+        size_t index;
+        std::chrono::steady_clock::time_point startTime;
+        bool killed;
+    };
+
+    std::map<pid_t, Worker> running;
+
+    size_t next = 0, done = 0;
+
+    OMPL_INFORM("BatchExperiment: Running %u jobs on %u workers, output in %s", (unsigned int)jobs_.size(), numWorkers, outputDirectory_.c_str());
+
+    while(next < jobs_.size() || !running.empty())
+    {
+        while(running.size() < numWorkers && next < jobs_.size())
+        {
+            Result &result = results_[next];
+
+            result.job = jobs_[next];
+            result.status = "failed";
+            result.solved = false;
+            result.statistics = FIRM::RunStatistics();
+            result.wallTime = 0;
+
+            const int pid = startJob(jobs_[next]);
+
+            if(pid > 0)
+            {
+                Worker worker = {next, std::chrono::steady_clock::now(), false};
+                running[pid] = worker;
+            }
+            else
+            {
+                done++;
+            }
+
+            next++;
+        }
+
+        int exitStatus = 0;
+
+        const pid_t pid = waitpid(-1, &exitStatus, WNOHANG);
+
+        if(pid > 0 && running.count(pid))
+        {
+            const Worker worker = running[pid];
+
+            running.erase(pid);
+
+            Result &result = results_[worker.index];
+
+            finishJob(result, exitStatus);
+
+            if(worker.killed)
+                result.status = "timeout";
+
+            result.wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - worker.startTime).count();
+
+            done++;
+
+            OMPL_INFORM("BatchExperiment: [%u/%u] job %u (%s, seed %u) %s, goal %s, cost %g, %.1f s", (unsigned int)done,
+                        (unsigned int)jobs_.size(), result.job.id, result.job.setupFile.c_str(), result.job.seed, result.status.c_str(),
+                        result.statistics.goalReached ? "reached" : "not reached", result.statistics.executionCost, result.wallTime);
+
+            continue;
+        }
+
+        if(timeout_ > 0)
+        {
+            for(std::map<pid_t, Worker>::iterator it = running.begin(); it != running.end(); ++it)
+            {
+                const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - it->second.startTime).count();
+
+                if(!it->second.killed && elapsed > timeout_)
+                {
+                    kill(it->first, SIGKILL);
+                    it->second.killed = true;
+                }
+            }
+        }
+
+        usleep(WORKER_POLL_INTERVAL_MS*1000);
+    }
+
+    return results_;
+}
+
+bool BatchExperiment::writeResults(const std::string &path) const
+{
+    std::ofstream out(path.c_str());
+
+    if(!out.is_open())
+    {
+        OMPL_ERROR("BatchExperiment: Could not write %s", path.c_str());
+        return false;
+    }
+
+    out << "job,setup,seed,overrides,status,solved,goalReached,collided,solveTime,roadmapTime,nodesAdded,dpTime,dpSolves,"
+           "executionCost,timeSteps,nodesReached,numNodes,numEdges,rolloutDecisions,rolloutTime,recoveries,recoveryTime,wallTime" << std::endl;
+
+    for(size_t i = 0; i < results_.size(); i++)
+    {
+        const Result &r = results_[i];
+
+        const FIRM::RunStatistics &s = r.statistics;
+
+        out << r.job.id << "," << csvField(r.job.setupFile) << "," << r.job.seed << "," << csvField(joinOverrides(r.job.overrides)) << ","
+            << r.status << "," << r.solved << "," << s.goalReached << "," << s.collided << "," << s.solveTime << "," << s.roadmapTime << ","
+            << s.nodesAdded << "," << s.dpTime << "," << s.dpSolves << "," << s.executionCost << "," << s.timeSteps << ","
+            << s.nodesReached << "," << s.numNodes << "," << s.numEdges << "," << s.rolloutDecisions << "," << s.rolloutTime << ","
+            << s.recoveries << "," << s.recoveryTime << "," << r.wallTime << std::endl;
+    }
+
+    return out.good();
+}
+
+bool BatchExperiment::writeSummary(const std::string &path) const
+{
+    struct Group
+    {
+        unsigned int runs, solved, reached, collided;
+        double solveTime, dpTime, executionCost, timeSteps;
+    };
+
+    // keep the groups in the order their first job was added
+    std::vector<std::pair<std::string, std::string> > keys;
+
+    std::map<std::pair<std::string, std::string>, Group> groups;
+
+    for(size_t i = 0; i < results_.size(); i++)
+    {
+        const Result &r = results_[i];
+
+        const std::pair<std::string, std::string> key(r.job.setupFile, joinOverrides(r.job.overrides));
+
+        if(!groups.count(key))
+        {
+            Group empty = {0, 0, 0, 0, 0, 0, 0, 0};
+            groups[key] = empty;
+            keys.push_back(key);
+        }
+
+        Group &g = groups[key];
+
+        g.runs++;
+
+        if(r.status != "ok")
+            continue;
+
+        g.collided += r.statistics.collided;
+
+        // the means divide by the solved runs, so only their times are added up
+        if(r.solved)
+        {
+            g.solved++;
+            g.solveTime += r.statistics.solveTime;
+            g.dpTime += r.statistics.dpTime;
+        }
+
+        // cost and length are only comparable over runs that made it to the goal
+        if(r.statistics.goalReached && !r.statistics.collided)
+        {
+            g.reached++;
+            g.executionCost += r.statistics.executionCost;
+            g.timeSteps += r.statistics.timeSteps;
+        }
+    }
+
+    std::ofstream out(path.c_str());
+
+    if(!out.is_open())
+    {
+        OMPL_ERROR("BatchExperiment: Could not write %s", path.c_str());
+        return false;
+    }
+
+    out << "setup,overrides,runs,solved,goalReached,collided,successRate,meanSolveTime,meanDPTime,meanExecutionCost,meanTimeSteps" << std::endl;
+
+    for(size_t i = 0; i < keys.size(); i++)
+    {
+        const Group &g = groups[keys[i]];
+
+        out << csvField(keys[i].first) << "," << csvField(keys[i].second) << "," << g.runs << "," << g.solved << "," << g.reached << ","
+            << g.collided << "," << double(g.reached)/g.runs << "," << (g.solved ? g.solveTime/g.solved : 0) << ","
+            << (g.solved ? g.dpTime/g.solved : 0) << "," << (g.reached ? g.executionCost/g.reached : 0) << ","
+            << (g.reached ? g.timeSteps/g.reached : 0) << std::endl;
+    }
+
+    return out.good();
+}
+
+std::string BatchExperiment::csvField(const std::string &field)
+{
+    if(field.find_first_of(",\"") == std::string::npos)
+        return field;
+
+    return "\"" + boost::algorithm::replace_all_copy(field, "\"", "\"\"") + "\"";
+}
+
+std::vector<unsigned int> BatchExperiment::readSeeds(const TiXmlElement *element)
+{
+    std::vector<unsigned int> seeds;
+
+    if(const char *attribute = element->Attribute("seeds"))
+    {
+        std::istringstream in(attribute);
+
+        unsigned int seed;
+
+        while(in >> seed)
+            seeds.push_back(seed);
+    }
+
+    if(seeds.empty())
+        seeds.push_back(1);
+
+    return seeds;
+}
+
+void BatchExperiment::readOverrides(const TiXmlElement *element, std::vector<std::string> &overrides)
+{
+    for(const TiXmlElement *set = element->FirstChildElement("Set"); set; set = set->NextSiblingElement("Set"))
+    {
+        if(const char *value = set->Attribute("value"))
+            overrides.push_back(value);
+    }
+}
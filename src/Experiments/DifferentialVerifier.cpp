@@ -0,0 +1,205 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "Experiments/DifferentialVerifier.h"
+#include <ompl/util/Console.h>
+#include <armadillo>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace
+{
+    const unsigned int DEFAULT_TRIALS = 5;
+}
+
+DifferentialVerifier::DifferentialVerifier(unsigned int seed) : seed_(seed), trials_(DEFAULT_TRIALS)
+{
+}
+
+void DifferentialVerifier::add(const std::string &name, const Variant &reference, const Variant &candidate, const Tolerance &tolerance)
+{
+    DifferentialCheck check = {reference, candidate, tolerance};
+
+    NamedRunner<DifferentialCheck, DifferentialResult>::add(name, check);
+}
+
+bool DifferentialVerifier::setTolerance(const std::string &name, const Tolerance &tolerance)
+{
+    for(size_t i = 0; i < entries_.size(); i++)
+    {
+        if(entries_[i].first == name)
+        {
+            entries_[i].second.tolerance = tolerance;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void DifferentialVerifier::seedTrial(unsigned int trial) const
+{
+    arma::arma_rng::set_seed(seed_ + trial);
+    srand(seed_ + trial);
+}
+
+void DifferentialVerifier::report(const Result &r) const
+{
+    if(r.passed)
+        OMPL_INFORM("DifferentialVerifier: %-30s passed, max deviation %g (relative %g), %u of %u decisions differ", r.name.c_str(),
+                    r.maxAbsoluteDeviation, r.maxRelativeDeviation, (unsigned int)r.decisionMismatches, (unsigned int)r.decisions);
+    else
+        OMPL_ERROR("DifferentialVerifier: %-30s FAILED, max deviation %g (relative %g), %u values out of tolerance, %u of %u decisions differ%s",
+                   r.name.c_str(), r.maxAbsoluteDeviation, r.maxRelativeDeviation, (unsigned int)r.valueMismatches,
+                   (unsigned int)r.decisionMismatches, (unsigned int)r.decisions, r.sizeMismatch ? ", output sizes differ" : "");
+}
+
+DifferentialVerifier::Result DifferentialVerifier::runEntry(const std::string &name, const DifferentialCheck &check)
+{
+    Result result;
+
+    result.name = name;
+    result.trials = trials_;
+    result.values = 0;
+    result.decisions = 0;
+    result.maxAbsoluteDeviation = 0;
+    result.maxRelativeDeviation = 0;
+    result.valueMismatches = 0;
+    result.decisionMismatches = 0;
+    result.sizeMismatch = false;
+    result.tolerance = check.tolerance;
+
+    for(unsigned int trial = 0; trial < trials_; trial++)
+    {
+        Output reference, candidate;
+
+        seedTrial(trial);
+
+        check.reference(trial, reference);
+
+        seedTrial(trial);
+
+        check.candidate(trial, candidate);
+
+        if(reference.values.size() != candidate.values.size() || reference.decisions.size() != candidate.decisions.size())
+            result.sizeMismatch = true;
+
+        const size_t numValues = std::min(reference.values.size(), candidate.values.size());
+
+        for(size_t k = 0; k < numValues; k++)
+        {
+            const double a = reference.values[k], b = candidate.values[k];
+
+            const double deviation = std::abs(a - b);
+
+            const double scale = std::max(std::abs(a), std::abs(b));
+
+            const double relative = scale > 0 ? deviation / scale : 0;
+
+            // a NaN on one side only is a mismatch, NaN on both sides is not
+            const bool bothNaN = std::isnan(a) && std::isnan(b);
+
+            if(!bothNaN && (std::isnan(deviation) || (deviation > check.tolerance.absolute && relative > check.tolerance.relative)))
+                result.valueMismatches++;
+
+            if(!std::isnan(deviation))
+            {
+                result.maxAbsoluteDeviation = std::max(result.maxAbsoluteDeviation, deviation);
+                result.maxRelativeDeviation = std::max(result.maxRelativeDeviation, relative);
+            }
+        }
+
+        const size_t numDecisions = std::min(reference.decisions.size(), candidate.decisions.size());
+
+        for(size_t k = 0; k < numDecisions; k++)
+            result.decisionMismatches += reference.decisions[k] != candidate.decisions[k];
+
+        result.values += numValues;
+        result.decisions += numDecisions;
+    }
+
+    result.passed = !result.sizeMismatch && result.valueMismatches == 0 &&
+                    result.decisionMismatches <= check.tolerance.decisions * result.decisions;
+
+    return result;
+}
+
+bool DifferentialVerifier::passed() const
+{
+    for(size_t i = 0; i < results_.size(); i++)
+    {
+        if(!results_[i].passed)
+            return false;
+    }
+
+    return true;
+}
+
+ResultTable DifferentialVerifier::getResultTable() const
+{
+    const char *columns[] = {"check", "trials", "values", "decisions", "maxAbsoluteDeviation", "maxRelativeDeviation", "valueMismatches",
+                             "decisionMismatches", "sizeMismatch", "absoluteTolerance", "relativeTolerance", "decisionTolerance", "passed"};
+
+    ResultTable table("checks", std::vector<std::string>(columns, columns + 13));
+
+    table.addParameter("seed", ResultTable::count(seed_));
+    table.addParameter("trials", ResultTable::count(trials_));
+    table.addParameter("passed", ResultTable::flag(passed()));
+
+    for(size_t i = 0; i < results_.size(); i++)
+    {
+        const Result &r = results_[i];
+
+        std::vector<ResultTable::Cell> row;
+
+        row.push_back(ResultTable::text(r.name));
+        row.push_back(ResultTable::count(r.trials));
+        row.push_back(ResultTable::count(r.values));
+        row.push_back(ResultTable::count(r.decisions));
+        row.push_back(ResultTable::number(r.maxAbsoluteDeviation, 6));
+        row.push_back(ResultTable::number(r.maxRelativeDeviation, 6));
+        row.push_back(ResultTable::count(r.valueMismatches));
+        row.push_back(ResultTable::count(r.decisionMismatches));
+        row.push_back(ResultTable::flag(r.sizeMismatch));
+        row.push_back(ResultTable::number(r.tolerance.absolute, 6));
+        row.push_back(ResultTable::number(r.tolerance.relative, 6));
+        row.push_back(ResultTable::number(r.tolerance.decisions, 6));
+        row.push_back(ResultTable::flag(r.passed));
+
+        table.addRow(row);
+    }
+
+    return table;
+}
@@ -0,0 +1,150 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "Experiments/MicroBenchmark.h"
+#include <ompl/util/Console.h>
+#include <armadillo>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+namespace
+{
+    const unsigned int DEFAULT_WARMUP_ITERATIONS = 10;
+
+    const unsigned int DEFAULT_MIN_ITERATIONS = 100;
+
+    const unsigned int DEFAULT_MAX_ITERATIONS = 1000000;
+
+    const double DEFAULT_MIN_TIME = 0.5;
+}
+
+MicroBenchmark::MicroBenchmark(unsigned int seed) : seed_(seed), warmupIterations_(DEFAULT_WARMUP_ITERATIONS),
+    minIterations_(DEFAULT_MIN_ITERATIONS), maxIterations_(DEFAULT_MAX_ITERATIONS), minTime_(DEFAULT_MIN_TIME)
+{
+}
+
+void MicroBenchmark::report(const Result &r) const
+{
+    OMPL_INFORM("MicroBenchmark: %-45s %9u iterations, median %12.1f ns, mean %12.1f ns", r.name.c_str(), r.iterations, r.medianNs, r.meanNs);
+}
+
+MicroBenchmark::Result MicroBenchmark::runEntry(const std::string &name, const Kernel &kernel)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    arma::arma_rng::set_seed(seed_);
+    srand(seed_);
+
+    for(unsigned int i = 0; i < warmupIterations_; i++)
+        kernel();
+
+    std::vector<double> samples;
+
+    samples.reserve(minIterations_);
+
+    const Clock::time_point runStart = Clock::now();
+
+    const std::chrono::duration<double> minTime(minTime_);
+
+    while(samples.size() < maxIterations_ && (samples.size() < minIterations_ || Clock::now() - runStart < minTime))
+    {
+        const Clock::time_point start = Clock::now();
+
+        kernel();
+
+        samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+    }
+
+    Result result;
+
+    result.name = name;
+    result.iterations = samples.size();
+
+    double sum = 0;
+
+    for(size_t i = 0; i < samples.size(); i++)
+        sum += samples[i];
+
+    result.meanNs = samples.empty() ? 0 : sum / samples.size();
+
+    double squares = 0;
+
+    for(size_t i = 0; i < samples.size(); i++)
+        squares += (samples[i] - result.meanNs) * (samples[i] - result.meanNs);
+
+    result.stdDevNs = samples.size() > 1 ? std::sqrt(squares / (samples.size() - 1)) : 0;
+
+    std::sort(samples.begin(), samples.end());
+
+    result.minNs    = samples.empty() ? 0 : samples.front();
+    result.maxNs    = samples.empty() ? 0 : samples.back();
+    result.medianNs = samples.empty() ? 0 : samples[samples.size() / 2];
+    result.p90Ns    = samples.empty() ? 0 : samples[std::min(samples.size() - 1, size_t(0.9 * samples.size()))];
+
+    return result;
+}
+
+ResultTable MicroBenchmark::getResultTable() const
+{
+    const char *columns[] = {"kernel", "iterations", "meanNs", "medianNs", "p90Ns", "minNs", "maxNs", "stdDevNs"};
+
+    ResultTable table("kernels", std::vector<std::string>(columns, columns + 8));
+
+    table.addParameter("seed", ResultTable::count(seed_));
+    table.addParameter("warmupIterations", ResultTable::count(warmupIterations_));
+    table.addParameter("minIterations", ResultTable::count(minIterations_));
+    table.addParameter("minTime", ResultTable::number(minTime_, 6));
+
+    for(size_t i = 0; i < results_.size(); i++)
+    {
+        const Result &r = results_[i];
+
+        std::vector<ResultTable::Cell> row;
+
+        row.push_back(ResultTable::text(r.name));
+        row.push_back(ResultTable::count(r.iterations));
+        row.push_back(ResultTable::number(r.meanNs, 1, true));
+        row.push_back(ResultTable::number(r.medianNs, 1, true));
+        row.push_back(ResultTable::number(r.p90Ns, 1, true));
+        row.push_back(ResultTable::number(r.minNs, 1, true));
+        row.push_back(ResultTable::number(r.maxNs, 1, true));
+        row.push_back(ResultTable::number(r.stdDevNs, 1, true));
+
+        table.addRow(row);
+    }
+
+    return table;
+}
@@ -0,0 +1,451 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "Experiments/ParameterTuner.h"
+#include "Utils/SetupConfiguration.h"
+#include <ompl/util/Console.h>
+#include <boost/filesystem.hpp>
+#include <boost/algorithm/string.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+    /** \brief A grid with more candidates is run anyway, but the user is warned */
+    const size_t LARGE_GRID_SIZE = 200;
+
+    /** \brief min, min + step, ... up to max, printed without trailing zeros */
+    std::vector<std::string> valueRange(double min, double max, double step)
+    {
+        std::vector<std::string> values;
+
+        if(step <= 0 || max < min)
+            return values;
+
+        const unsigned int count = std::floor((max - min)/step + 1e-9) + 1;
+
+        for(unsigned int i = 0; i < count; i++)
+        {
+            std::ostringstream value;
+            value << min + i*step;
+            values.push_back(value.str());
+        }
+
+        return values;
+    }
+}
+
+ParameterTuner::ParameterTuner(const std::string &pathToTuningFile, const std::string &outputDirectory) :
+    outputDirectory_(outputDirectory), strategy_("coordinate"), minSuccessRate_(1.0), planningTimeBudget_(0), timeout_(0),
+    numWorkers_(1), rounds_(0), best_(0)
+{
+    SetupConfiguration config(pathToTuningFile);
+
+    const TiXmlElement *tuning = config.getSection("Tuning");
+
+    if(!tuning || !tuning->Attribute("setup"))
+    {
+        printf("Failed to load %s, it has no Tuning element with a setup file \n", pathToTuningFile.c_str());
+        exit(1);
+    }
+
+    setupFile_ = tuning->Attribute("setup");
+
+    const char *name = tuning->Attribute("name");
+
+    name_ = name ? name : boost::filesystem::path(setupFile_).stem().string();
+
+    if(const char *strategy = tuning->Attribute("strategy"))
+        strategy_ = strategy;
+
+    tuning->QueryDoubleAttribute("timeout", &timeout_);
+
+    seeds_ = BatchExperiment::readSeeds(tuning);
+
+    if(const TiXmlElement *target = tuning->FirstChildElement("Target"))
+    {
+        target->QueryDoubleAttribute("successRate", &minSuccessRate_);
+        target->QueryDoubleAttribute("planningTime", &planningTimeBudget_);
+    }
+
+    BatchExperiment::readOverrides(tuning, runOverrides_);
+
+    for(const TiXmlElement *element = tuning->FirstChildElement("Parameter"); element; element = element->NextSiblingElement("Parameter"))
+    {
+        Parameter parameter;
+
+        const char *path = element->Attribute("path");
+
+        if(!path || std::string(path).find('@') == std::string::npos)
+        {
+            OMPL_WARN("ParameterTuner: Skipping a parameter without a path of the form Element/Child@attribute in %s", pathToTuningFile.c_str());
+            continue;
+        }
+
+        parameter.path = path;
+
+        if(const char *values = element->Attribute("values"))
+        {
+            boost::algorithm::split(parameter.values, boost::algorithm::trim_copy(std::string(values)), boost::algorithm::is_space(),
+                                    boost::algorithm::token_compress_on);
+        }
+        else
+        {
+            double min = 0, max = 0, step = 0;
+
+            element->QueryDoubleAttribute("min", &min);
+            element->QueryDoubleAttribute("max", &max);
+            element->QueryDoubleAttribute("step", &step);
+
+            parameter.values = valueRange(min, max, step);
+        }
+
+        if(parameter.values.empty() || parameter.values.front().empty())
+        {
+            OMPL_WARN("ParameterTuner: Skipping parameter %s, it has no values", path);
+            continue;
+        }
+
+        parameters_.push_back(parameter);
+    }
+
+    OMPL_INFORM("ParameterTuner: %s tunes %u parameters of %s", name_.c_str(), (unsigned int)parameters_.size(), setupFile_.c_str());
+}
+
+bool ParameterTuner::meetsTarget(const Candidate &candidate) const
+{
+    if(candidate.successes == 0 || candidate.successRate() < minSuccessRate_)
+        return false;
+
+    return planningTimeBudget_ <= 0 || candidate.meanPlanningTime <= planningTimeBudget_;
+}
+
+bool ParameterTuner::isBetter(const Candidate &a, const Candidate &b) const
+{
+    const bool aMeets = meetsTarget(a), bMeets = meetsTarget(b);
+
+    if(aMeets != bMeets)
+        return aMeets;
+
+    // within the target the cheaper one wins, outside of it the more reliable one
+    if(aMeets)
+    {
+        if(a.meanPlanningTime != b.meanPlanningTime)
+            return a.meanPlanningTime < b.meanPlanningTime;
+
+        return a.successRate() > b.successRate();
+    }
+
+    if(a.successRate() != b.successRate())
+        return a.successRate() > b.successRate();
+
+    return a.meanPlanningTime < b.meanPlanningTime;
+}
+
+size_t ParameterTuner::bestOf(const std::vector<std::vector<size_t> > &choices) const
+{
+    size_t best = evaluated_.at(choices.front());
+
+    for(size_t i = 1; i < choices.size(); i++)
+    {
+        const size_t index = evaluated_.at(choices[i]);
+
+        if(isBetter(candidates_[index], candidates_[best]))
+            best = index;
+    }
+
+    return best;
+}
+
+std::vector<std::string> ParameterTuner::parameterOverrides(const std::vector<size_t> &choice) const
+{
+    std::vector<std::string> overrides;
+
+    for(size_t i = 0; i < parameters_.size(); i++)
+        overrides.push_back(parameters_[i].path + "=" + parameters_[i].values[choice[i]]);
+
+    return overrides;
+}
+
+void ParameterTuner::evaluate(const std::vector<std::vector<size_t> > &choices)
+{
+    std::vector<std::vector<size_t> > pending;
+
+    for(size_t i = 0; i < choices.size(); i++)
+    {
+        if(!evaluated_.count(choices[i]) && std::find(pending.begin(), pending.end(), choices[i]) == pending.end())
+            pending.push_back(choices[i]);
+    }
+
+    if(pending.empty())
+        return;
+
+    std::ostringstream roundDirectory;
+    roundDirectory << (boost::filesystem::path(outputDirectory_) / "round-").string() << rounds_++;
+
+    BatchExperiment batch(roundDirectory.str());
+
+    batch.setNumWorkers(numWorkers_);
+
+    batch.setTimeout(timeout_);
+
+    for(size_t i = 0; i < pending.size(); i++)
+    {
+        std::vector<std::string> overrides = runOverrides_;
+
+        const std::vector<std::string> parameters = parameterOverrides(pending[i]);
+
+        overrides.insert(overrides.end(), parameters.begin(), parameters.end());
+
+        for(size_t j = 0; j < seeds_.size(); j++)
+            batch.addJob(setupFile_, seeds_[j], overrides);
+    }
+
+    OMPL_INFORM("ParameterTuner: Round %u evaluates %u candidates", rounds_ - 1, (unsigned int)pending.size());
+
+    const std::vector<BatchExperiment::Result> &results = batch.run();
+
+    batch.writeResults((boost::filesystem::path(roundDirectory.str()) / "results.csv").string());
+
+    for(size_t i = 0; i < pending.size(); i++)
+    {
+        Candidate c;
+
+        c.choice = pending[i];
+        c.runs = seeds_.size();
+        c.successes = 0;
+        c.failures = 0;
+        c.meanPlanningTime = 0;
+        c.meanExecutionCost = 0;
+        c.meanWallTime = 0;
+
+        unsigned int solved = 0;
+
+        // the jobs of candidate i were added one per seed, in a row
+        for(size_t j = 0; j < seeds_.size(); j++)
+        {
+            const BatchExperiment::Result &r = results[i*seeds_.size() + j];
+
+            c.meanWallTime += r.wallTime;
+
+            if(r.status != "ok")
+            {
+                c.failures++;
+                continue;
+            }
+
+            if(r.solved)
+            {
+                solved++;
+                c.meanPlanningTime += r.statistics.solveTime;
+            }
+
+            if(r.statistics.goalReached && !r.statistics.collided)
+            {
+                c.successes++;
+                c.meanExecutionCost += r.statistics.executionCost;
+            }
+        }
+
+        c.meanPlanningTime = solved ? c.meanPlanningTime/solved : 0;
+        c.meanExecutionCost = c.successes ? c.meanExecutionCost/c.successes : 0;
+        c.meanWallTime /= c.runs;
+
+        evaluated_[c.choice] = candidates_.size();
+
+        candidates_.push_back(c);
+
+        OMPL_INFORM("ParameterTuner: %s: success rate %g, planning time %g s%s", boost::algorithm::join(parameterOverrides(c.choice), " ").c_str(),
+                    c.successRate(), c.meanPlanningTime, meetsTarget(c) ? ", meets the target" : "");
+    }
+}
+
+void ParameterTuner::searchGrid()
+{
+    std::vector<std::vector<size_t> > choices;
+
+    std::vector<size_t> choice(parameters_.size(), 0);
+
+    // count through the combinations like an odometer, the last parameter turning fastest
+    while(true)
+    {
+        choices.push_back(choice);
+
+        int p = parameters_.size() - 1;
+
+        while(p >= 0 && ++choice[p] == parameters_[p].values.size())
+            choice[p--] = 0;
+
+        if(p < 0)
+            break;
+    }
+
+    if(choices.size() > LARGE_GRID_SIZE)
+        OMPL_WARN("ParameterTuner: The grid has %u candidates, consider the coordinate strategy", (unsigned int)choices.size());
+
+    evaluate(choices);
+}
+
+void ParameterTuner::searchCoordinate()
+{
+    std::vector<size_t> current(parameters_.size());
+
+    for(size_t p = 0; p < parameters_.size(); p++)
+        current[p] = parameters_[p].values.size()/2;
+
+    evaluate(std::vector<std::vector<size_t> >(1, current));
+
+    bool improved = true;
+
+    while(improved)
+    {
+        improved = false;
+
+        for(size_t p = 0; p < parameters_.size(); p++)
+        {
+            std::vector<std::vector<size_t> > choices(1, current);
+
+            for(size_t v = 0; v < parameters_[p].values.size(); v++)
+            {
+                std::vector<size_t> choice = current;
+                choice[p] = v;
+                choices.push_back(choice);
+            }
+
+            evaluate(choices);
+
+            const std::vector<size_t> &best = candidates_[bestOf(choices)].choice;
+
+            if(best != current)
+            {
+                current = best;
+                improved = true;
+            }
+        }
+    }
+}
+
+bool ParameterTuner::run()
+{
+    if(parameters_.empty())
+    {
+        OMPL_ERROR("ParameterTuner: %s has no parameters to tune", name_.c_str());
+        return false;
+    }
+
+    boost::filesystem::create_directories(boost::filesystem::path(outputDirectory_));
+
+    if(strategy_ == "grid")
+    {
+        searchGrid();
+    }
+    else
+    {
+        if(strategy_ != "coordinate")
+            OMPL_WARN("ParameterTuner: Unknown strategy %s, using coordinate", strategy_.c_str());
+
+        searchCoordinate();
+    }
+
+    if(candidates_.empty())
+        return false;
+
+    std::vector<std::vector<size_t> > choices;
+
+    for(size_t i = 0; i < candidates_.size(); i++)
+        choices.push_back(candidates_[i].choice);
+
+    best_ = bestOf(choices);
+
+    const Candidate &best = candidates_[best_];
+
+    if(meetsTarget(best))
+        OMPL_INFORM("ParameterTuner: Best of %u candidates: %s", (unsigned int)candidates_.size(),
+                    boost::algorithm::join(parameterOverrides(best.choice), " ").c_str());
+    else
+        OMPL_WARN("ParameterTuner: None of %u candidates meets the target, the most reliable is %s", (unsigned int)candidates_.size(),
+                  boost::algorithm::join(parameterOverrides(best.choice), " ").c_str());
+
+    return writeCandidates((boost::filesystem::path(outputDirectory_) / "candidates.csv").string());
+}
+
+bool ParameterTuner::writeCandidates(const std::string &path) const
+{
+    std::ofstream out(path.c_str());
+
+    if(!out.is_open())
+    {
+        OMPL_ERROR("ParameterTuner: Could not write %s", path.c_str());
+        return false;
+    }
+
+    out << "candidate,";
+
+    for(size_t p = 0; p < parameters_.size(); p++)
+        out << BatchExperiment::csvField(parameters_[p].path) << ",";
+
+    out << "runs,successes,failures,successRate,meanPlanningTime,meanExecutionCost,meanWallTime,meetsTarget,best" << std::endl;
+
+    for(size_t i = 0; i < candidates_.size(); i++)
+    {
+        const Candidate &c = candidates_[i];
+
+        out << i << ",";
+
+        for(size_t p = 0; p < parameters_.size(); p++)
+            out << BatchExperiment::csvField(parameters_[p].values[c.choice[p]]) << ",";
+
+        out << c.runs << "," << c.successes << "," << c.failures << "," << c.successRate() << "," << c.meanPlanningTime << ","
+            << c.meanExecutionCost << "," << c.meanWallTime << "," << meetsTarget(c) << "," << (i == best_) << std::endl;
+    }
+
+    return out.good();
+}
+
+bool ParameterTuner::writeBestSetup(const std::string &path) const
+{
+    if(candidates_.empty())
+        return false;
+
+    SetupConfiguration config(setupFile_);
+
+    if(!config.setAttributes(parameterOverrides(candidates_[best_].choice)))
+        return false;
+
+    return config.saveFile(path);
+}
@@ -0,0 +1,341 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "Experiments/PlannerBenchmark.h"
+#include "Utils/SetupConfiguration.h"
+#include <ompl/config.h>
+#include <ompl/util/Console.h>
+#include <boost/filesystem.hpp>
+#include <boost/thread.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+namespace
+{
+    /** \brief One value of a run in the benchmark log, an empty value is stored as NULL */
+    struct LogProperty
+    {
+        std::string name;
+
+        std::string value;
+    };
+
+    template <typename T>
+    LogProperty logProperty(const std::string &name, const T &value)
+    {
+        std::ostringstream s;
+        s << value;
+
+        LogProperty p = {name, s.str()};
+        return p;
+    }
+
+    /** \brief value = numerator / denominator, NULL if the denominator is 0 */
+    LogProperty logRatio(const std::string &name, double numerator, double denominator)
+    {
+        if(denominator == 0)
+        {
+            LogProperty p = {name, ""};
+            return p;
+        }
+
+        return logProperty(name, numerator / denominator);
+    }
+
+    /** \brief The properties of a run, sorted by name as ompl::tools::Benchmark writes them */
+    std::vector<LogProperty> runProperties(const BatchExperiment::Result &r)
+    {
+        const FIRM::RunStatistics &s = r.statistics;
+
+        std::vector<LogProperty> p;
+
+        p.push_back(logProperty("collided BOOLEAN", s.collided));
+        p.push_back(logProperty("crashed BOOLEAN", r.status == "crashed" || r.status == "failed"));
+        p.push_back(logProperty("dp solves INTEGER", s.dpSolves));
+        p.push_back(logProperty("dp time REAL", s.dpTime));
+        p.push_back(logProperty("execution cost REAL", s.executionCost));
+        p.push_back(logProperty("goal reached BOOLEAN", s.goalReached));
+        p.push_back(logProperty("graph motions INTEGER", s.numEdges));
+        p.push_back(logProperty("graph states INTEGER", s.numNodes));
+        p.push_back(logProperty("nodes added INTEGER", s.nodesAdded));
+        p.push_back(logRatio("nodes per second REAL", s.nodesAdded, s.roadmapTime));
+        p.push_back(logProperty("recoveries INTEGER", s.recoveries));
+        p.push_back(logRatio("recovery time REAL", s.recoveryTime, s.recoveries));
+        p.push_back(logProperty("roadmap time REAL", s.roadmapTime));
+        p.push_back(logProperty("rollout decisions INTEGER", s.rolloutDecisions));
+        p.push_back(logRatio("rollout latency REAL", s.rolloutTime, s.rolloutDecisions));
+        p.push_back(logProperty("seed INTEGER", r.job.seed));
+        p.push_back(logProperty("solved BOOLEAN", r.solved));
+        p.push_back(logProperty("success BOOLEAN", s.goalReached && !s.collided));
+        p.push_back(logProperty("time REAL", s.solveTime));
+        p.push_back(logProperty("time steps INTEGER", s.timeSteps));
+        p.push_back(logProperty("timed out BOOLEAN", r.status == "timeout"));
+        p.push_back(logProperty("wall time REAL", r.wallTime));
+
+        return p;
+    }
+
+    std::string hostName()
+    {
+        char name[256];
+
+        if(gethostname(name, sizeof(name)) != 0)
+            return "UNKNOWN";
+
+        name[sizeof(name) - 1] = '\0';
+
+        return name;
+    }
+
+    std::string cpuInfo()
+    {
+        std::ostringstream info;
+
+        std::ifstream in("/proc/cpuinfo");
+
+        std::string line;
+
+        while(std::getline(in, line))
+        {
+            if(boost::algorithm::starts_with(line, "model name"))
+            {
+                info << line << std::endl;
+                break;
+            }
+        }
+
+        info << "cores : " << boost::thread::hardware_concurrency() << std::endl;
+
+        return info.str();
+    }
+}
+
+PlannerBenchmark::PlannerBenchmark(const std::string &pathToBenchmarkFile, const std::string &outputDirectory) :
+    outputDirectory_(outputDirectory), budget_(0), timeout_(0), numWorkers_(1)
+{
+    SetupConfiguration config(pathToBenchmarkFile);
+
+    const TiXmlElement *benchmark = config.getSection("Benchmark");
+
+    if(!benchmark)
+    {
+        printf("Failed to load %s, it has no Benchmark element \n", pathToBenchmarkFile.c_str());
+        exit(1);
+    }
+
+    const char *name = benchmark->Attribute("name");
+
+    name_ = name ? name : "NO_NAME";
+
+    benchmark->QueryDoubleAttribute("budget", &budget_);
+
+    benchmark->QueryDoubleAttribute("timeout", &timeout_);
+
+    seeds_ = BatchExperiment::readSeeds(benchmark);
+
+    std::vector<std::string> commonOverrides;
+
+    BatchExperiment::readOverrides(benchmark, commonOverrides);
+
+    for(const TiXmlElement *element = benchmark->FirstChildElement("Scenario"); element; element = element->NextSiblingElement("Scenario"))
+    {
+        Scenario scenario;
+
+        const char *scenarioName = element->Attribute("name");
+
+        const char *setupFile = element->Attribute("setup");
+
+        if(!setupFile)
+        {
+            OMPL_WARN("PlannerBenchmark: Skipping a scenario without setup file in %s", pathToBenchmarkFile.c_str());
+            continue;
+        }
+
+        scenario.setupFile = setupFile;
+
+        scenario.name = scenarioName ? scenarioName : boost::filesystem::path(setupFile).stem().string();
+
+        scenario.overrides = commonOverrides;
+
+        BatchExperiment::readOverrides(element, scenario.overrides);
+
+        scenarios_.push_back(scenario);
+    }
+
+    OMPL_INFORM("PlannerBenchmark: %s has %u scenarios", name_.c_str(), (unsigned int)scenarios_.size());
+}
+
+bool PlannerBenchmark::run()
+{
+    BatchExperiment batch(outputDirectory_);
+
+    batch.setNumWorkers(numWorkers_);
+
+    batch.setTimeout(timeout_);
+
+    jobScenarios_.clear();
+
+    for(size_t i = 0; i < scenarios_.size(); i++)
+    {
+        std::vector<std::string> overrides = scenarios_[i].overrides;
+
+        if(budget_ > 0)
+        {
+            std::ostringstream budget;
+            budget << "PlanningProblem/PlanningTime@maxTime=" << budget_;
+            overrides.push_back(budget.str());
+        }
+
+        for(size_t j = 0; j < seeds_.size(); j++)
+        {
+            batch.addJob(scenarios_[i].setupFile, seeds_[j], overrides);
+
+            jobScenarios_.push_back(i);
+        }
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    const std::vector<BatchExperiment::Result> &results = batch.run();
+
+    const double totalDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    bool written = batch.writeResults((boost::filesystem::path(outputDirectory_) / "results.csv").string());
+
+    written = batch.writeSummary((boost::filesystem::path(outputDirectory_) / "summary.csv").string()) && written;
+
+    // one log per setup file, in the order the setup files first appear
+    std::vector<std::string> setupFiles;
+
+    for(size_t i = 0; i < scenarios_.size(); i++)
+    {
+        if(std::find(setupFiles.begin(), setupFiles.end(), scenarios_[i].setupFile) == setupFiles.end())
+            setupFiles.push_back(scenarios_[i].setupFile);
+    }
+
+    for(size_t i = 0; i < setupFiles.size(); i++)
+    {
+        const std::string logPath = (boost::filesystem::path(outputDirectory_) /
+                                     (boost::filesystem::path(setupFiles[i]).stem().string() + ".log")).string();
+
+        written = writeLog(logPath, setupFiles[i], results, totalDuration) && written;
+    }
+
+    return written;
+}
+
+bool PlannerBenchmark::writeLog(const std::string &path, const std::string &setupFile, const std::vector<BatchExperiment::Result> &results,
+                                double totalDuration) const
+{
+    std::ofstream out(path.c_str());
+
+    if(!out.is_open())
+    {
+        OMPL_ERROR("PlannerBenchmark: Could not write %s", path.c_str());
+        return false;
+    }
+
+    std::vector<size_t> scenarios;
+
+    std::ostringstream setupInfo;
+
+    setupInfo << "setup file: " << setupFile << std::endl;
+
+    for(size_t i = 0; i < scenarios_.size(); i++)
+    {
+        if(scenarios_[i].setupFile != setupFile)
+            continue;
+
+        scenarios.push_back(i);
+
+        setupInfo << scenarios_[i].name << ": " << boost::algorithm::join(scenarios_[i].overrides, " ") << std::endl;
+    }
+
+    out << "OMPL version " << OMPL_VERSION << std::endl;
+    out << "Experiment " << name_ << "-" << boost::filesystem::path(setupFile).stem().string() << std::endl;
+    out << "1 experiment properties" << std::endl;
+    out << "budget REAL = " << budget_ << std::endl;
+    out << "Running on " << hostName() << std::endl;
+    out << "Starting at " << boost::posix_time::to_simple_string(boost::posix_time::second_clock::local_time()) << std::endl;
+    out << "<<<|" << std::endl << setupInfo.str() << "|>>>" << std::endl;
+    out << "<<<|" << std::endl << cpuInfo() << "|>>>" << std::endl;
+    out << seeds_.front() << " is the random seed" << std::endl;
+    out << budget_ << " seconds per run" << std::endl;
+    out << 0 << " MB per run" << std::endl;
+    out << seeds_.size() << " runs per planner" << std::endl;
+    out << totalDuration << " seconds spent to collect the data" << std::endl;
+    out << "0 enum types" << std::endl;
+    out << scenarios.size() << " planners" << std::endl;
+
+    for(size_t i = 0; i < scenarios.size(); i++)
+    {
+        std::vector<std::vector<LogProperty> > runs;
+
+        for(size_t j = 0; j < results.size(); j++)
+        {
+            if(jobScenarios_[results[j].job.id] == scenarios[i])
+                runs.push_back(runProperties(results[j]));
+        }
+
+        const std::vector<LogProperty> names = runProperties(BatchExperiment::Result());
+
+        out << scenarios_[scenarios[i]].name << std::endl;
+        out << "0 common properties" << std::endl;
+        out << names.size() << " properties for each run" << std::endl;
+
+        for(size_t k = 0; k < names.size(); k++)
+            out << names[k].name << std::endl;
+
+        out << runs.size() << " runs" << std::endl;
+
+        for(size_t j = 0; j < runs.size(); j++)
+        {
+            for(size_t k = 0; k < runs[j].size(); k++)
+                out << runs[j][k].value << "; ";
+
+            out << std::endl;
+        }
+
+        out << "." << std::endl;
+    }
+
+    return out.good();
+}
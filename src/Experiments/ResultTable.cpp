@@ -0,0 +1,141 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "Experiments/ResultTable.h"
+#include <cassert>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+ResultTable::ResultTable(const std::string &rowsName, const std::vector<std::string> &columns) : rowsName_(rowsName), columns_(columns)
+{
+}
+
+ResultTable::Cell ResultTable::text(const std::string &value)
+{
+    Cell cell = {value, "\"" + value + "\""};
+
+    return cell;
+}
+
+ResultTable::Cell ResultTable::number(double value, int precision, bool fixed)
+{
+    std::ostringstream out;
+
+    if(fixed)
+        out << std::fixed;
+
+    out << std::setprecision(precision) << value;
+
+    Cell cell = {out.str(), out.str()};
+
+    return cell;
+}
+
+ResultTable::Cell ResultTable::count(std::size_t value)
+{
+    std::ostringstream out;
+
+    out << value;
+
+    Cell cell = {out.str(), out.str()};
+
+    return cell;
+}
+
+ResultTable::Cell ResultTable::flag(bool value)
+{
+    Cell cell = {value ? "1" : "0", value ? "true" : "false"};
+
+    return cell;
+}
+
+void ResultTable::addParameter(const std::string &name, const Cell &value)
+{
+    parameters_.push_back(std::make_pair(name, value));
+}
+
+void ResultTable::addRow(const std::vector<Cell> &row)
+{
+    assert(row.size() == columns_.size());
+
+    rows_.push_back(row);
+}
+
+bool ResultTable::writeCSV(std::ostream &out) const
+{
+    for(size_t c = 0; c < columns_.size(); c++)
+        out << (c == 0 ? "" : ",") << columns_[c];
+
+    out << "\n";
+
+    for(size_t r = 0; r < rows_.size(); r++)
+    {
+        for(size_t c = 0; c < rows_[r].size(); c++)
+            out << (c == 0 ? "" : ",") << rows_[r][c].csv;
+
+        out << "\n";
+    }
+
+    return out.good();
+}
+
+bool ResultTable::writeJSON(std::ostream &out) const
+{
+    out << "{";
+
+    for(size_t p = 0; p < parameters_.size(); p++)
+        out << "\n  \"" << parameters_[p].first << "\": " << parameters_[p].second.json << ",";
+
+    out << "\n  \"" << rowsName_ << "\": [";
+
+    for(size_t r = 0; r < rows_.size(); r++)
+    {
+        out << (r == 0 ? "\n    {" : ",\n    {");
+
+        for(size_t c = 0; c < rows_[r].size(); c++)
+            out << (c == 0 ? "" : ", ") << "\"" << columns_[c] << "\": " << rows_[r][c].json;
+
+        out << "}";
+    }
+
+    out << "\n  ]\n}\n";
+
+    return out.good();
+}
+
+bool ResultTable::write(std::ostream &out, const std::string &format) const
+{
+    return format == "json" ? writeJSON(out) : writeCSV(out);
+}
@@ -0,0 +1,149 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "Experiments/ToolDriver.h"
+#include <ompl/util/Console.h>
+#include <ompl/util/RandomNumbers.h>
+#include <armadillo>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+#include "Utils/FIRMUtils.h"
+
+namespace po = boost::program_options;
+
+ToolDriver::ToolDriver(const std::string &name, const std::string &entries, const std::string &defaultSetupFile, const std::string &seedHelp) :
+    name_(name), options_("Options"), seed_(1), resultFd_(-1)
+{
+    options_.add_options()
+        ("help", "show this message")
+        ("setup", po::value<std::string>(&setupFile_)->default_value(defaultSetupFile), ("setup file the " + entries + " are built from").c_str())
+        ("set", po::value<std::vector<std::string> >(&overrides_)->composing(), "parameter override Element/Child@attribute=value, may be repeated")
+        ("seed", po::value<unsigned int>(&seed_)->default_value(1), seedHelp.c_str())
+        ("filter", po::value<std::string>(&filter_), ("only run " + entries + " whose name contains this").c_str())
+        ("format", po::value<std::string>(&format_)->default_value("csv"), "csv or json")
+        ("out", po::value<std::string>(&outputFile_)->default_value("-"), "output file, - writes to stdout and the log to stderr");
+}
+
+ToolDriver::~ToolDriver()
+{
+    if(resultFd_ >= 0)
+        close(resultFd_);
+}
+
+int ToolDriver::parse(int argc, char *argv[])
+{
+    po::variables_map vm;
+
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, options_), vm);
+
+        if(vm.count("help"))
+        {
+            std::cout << options_ << std::endl;
+            return 0;
+        }
+
+        po::notify(vm);
+    }
+    catch(po::error &e)
+    {
+        std::cerr << e.what() << std::endl << options_ << std::endl;
+        return 1;
+    }
+
+    if(format_ != "csv" && format_ != "json")
+    {
+        std::cerr << "Unknown format " << format_ << std::endl << options_ << std::endl;
+        return 1;
+    }
+
+    return -1;
+}
+
+SetupConfiguration::SetupConfigurationPtr ToolDriver::start()
+{
+    // keep stdout for the results, everything the planner prints goes to stderr
+    if(outputFile_ == "-" && resultFd_ < 0)
+    {
+        std::cout.flush();
+
+        resultFd_ = dup(STDOUT_FILENO);
+
+        dup2(STDERR_FILENO, STDOUT_FILENO);
+    }
+
+    ompl::RNG::setSeed(seed_);
+    arma::arma_rng::set_seed(seed_);
+    srand(seed_);
+
+    FIRMUtils::setHeadless(true);
+
+    SetupConfiguration::SetupConfigurationPtr config = std::make_shared<SetupConfiguration>(setupFile_);
+
+    if(!config->setAttributes(overrides_))
+        return SetupConfiguration::SetupConfigurationPtr();
+
+    return config;
+}
+
+bool ToolDriver::write(const ResultTable &table) const
+{
+    bool written = false;
+
+    if(resultFd_ >= 0)
+    {
+        std::ostringstream out;
+
+        written = table.write(out, format_);
+
+        const std::string text = out.str();
+
+        written = written && ::write(resultFd_, text.data(), text.size()) == (ssize_t)text.size();
+    }
+    else
+    {
+        std::ofstream out(outputFile_.c_str());
+
+        written = table.write(out, format_);
+    }
+
+    if(!written)
+        OMPL_ERROR("%s: Could not write the results to %s", name_.c_str(), outputFile_.c_str());
+
+    return written;
+}
@@ -35,6 +35,7 @@
 /* Authors: Saurav Agarwal, Ali-akbar Agha-mohammadi */
 
 #include "Filters/ExtendedKF.h"
+#include "Utils/Profiler.h"
 #include "boost/date_time/local_time/local_time.hpp"
 
 const int ExtendedKF::covGrowthFactor_=1.01;
@@ -43,6 +44,7 @@ void ExtendedKF::Predict(const ompl::base::State *belief,
   const ompl::control::Control* control,
   const LinearSystem& ls, ompl::base::State *predictedState)
 {
+  FIRM_PROFILE_SCOPE("ExtendedKF::Predict");
 
   using namespace arma;
 
@@ -61,6 +63,7 @@ void ExtendedKF::Predict(const ompl::base::State *belief,
 void ExtendedKF::Update(const ompl::base::State *belief, const typename ObservationModelMethod::ObservationType& obs,
 const LinearSystem& ls, ompl::base::State *updatedState)
 {
+  FIRM_PROFILE_SCOPE("ExtendedKF::Update");
 
   using namespace arma;
 
@@ -104,6 +107,7 @@ void ExtendedKF::Evolve(const ompl::base::State *belief,
     const LinearSystem& lsUpdate,
     ompl::base::State *evolvedState)
 {
+    FIRM_PROFILE_SCOPE("ExtendedKF::Evolve");
 
     // In the EKF we do not use the linear systems passed to the filter, instead we generate the linear systems on the fly
 
@@ -118,6 +122,7 @@ void ExtendedKF::Evolve(const ompl::base::State *belief,
     if(!obs.n_rows || !obs.n_cols)
     {
         si_->copyState(evolvedState, bPred);
+        si_->freeState(bPred);
         return;
     }
 
@@ -35,6 +35,7 @@
 /* Authors: Saurav Agarwal, Ali-akbar Agha-mohammadi */
 
 #include "Filters/LinearizedKF.h"
+#include "Utils/Profiler.h"
 
 void LinearizedKF::Predict(const ompl::base::State *belief,
   const ompl::control::Control* control, const LinearSystem& ls, ompl::base::State *predictedState)
@@ -95,6 +96,8 @@ void LinearizedKF::Evolve(const ompl::base::State *belief,
     const LinearSystem& lsUpdate,
     ompl::base::State *evolvedState)
 {
+    FIRM_PROFILE_SCOPE("LinearizedKF::Evolve");
+
 
     using namespace arma;
 
@@ -116,6 +119,8 @@ void LinearizedKF::Evolve(const ompl::base::State *belief,
 
 arma::mat LinearizedKF::computeStationaryCovariance (const LinearSystem& ls)
 {
+    FIRM_PROFILE_SCOPE("LinearizedKF::computeStationaryCovariance");
+
     using namespace arma;
 
     mat H = ls.getH();
@@ -223,27 +223,17 @@ arma::mat TwoDPointMotionModel::controlNoiseCovariance(const ompl::control::Cont
     return P_Un;
 }
 
-void TwoDPointMotionModel::loadParameters(const char *pathToSetupFile)
+void TwoDPointMotionModel::loadParameters(const SetupConfiguration &config)
 {
     using namespace arma;
 
-    TiXmlDocument doc(pathToSetupFile);
-    bool loadOkay = doc.LoadFile();
+    const TiXmlNode* node = 0;
+    const TiXmlElement* itemElement = 0;
 
-    if ( !loadOkay )
-    {
-        printf( "Could not load setup file in motion model. Error='%s'. Exiting.\n", doc.ErrorDesc() );
-
-        exit( 1 );
-    }
-
-    TiXmlNode* node = 0;
-    TiXmlElement* itemElement = 0;
-
-    node = doc.FirstChild( "MotionModels" );
+    node = config.getSection( "MotionModels" );
     assert( node );
 
-    TiXmlNode* child = 0;
+    const TiXmlNode* child = 0;
 
     child = node->FirstChild("TwoDPointMotionModel");
 
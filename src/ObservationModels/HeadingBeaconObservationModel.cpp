@@ -226,32 +226,22 @@ bool HeadingBeaconObservationModel::isStateObservable(const ompl::base::State *s
 
 }
 
-void HeadingBeaconObservationModel::loadLandmarks(const char *pathToSetupFile)
+void HeadingBeaconObservationModel::loadLandmarks(const SetupConfiguration &config)
 {
 
 	using namespace arma;
-	// Load XML containing landmarks
-	TiXmlDocument doc(pathToSetupFile);
-	bool loadOkay = doc.LoadFile();
 
-	if (!loadOkay)
-	{
-		printf( "Could not load Landmark list . Error='%s'. Exiting.\n", doc.ErrorDesc() );
-
-		exit( 1 );
-	}
-
-	TiXmlNode* node = 0;
-	TiXmlElement* landmarkElement = 0;
-	TiXmlElement* itemElement = 0;
+	const TiXmlNode* node = 0;
+	const TiXmlElement* landmarkElement = 0;
+	const TiXmlElement* itemElement = 0;
 
 	// Get the landmarklist node
-	node = doc.FirstChild( "LandmarkList" );
+	node = config.getSection( "LandmarkList" );
 	assert( node );
 	landmarkElement = node->ToElement(); //convert node to element
 	assert( landmarkElement  );
 
-	TiXmlNode* child = 0;
+	const TiXmlNode* child = 0;
 
 	//Iterate through all the landmarks and put them into the "landmarks_" list
 	while( (child = landmarkElement ->IterateChildren(child)))
@@ -278,31 +268,21 @@ void HeadingBeaconObservationModel::loadLandmarks(const char *pathToSetupFile)
 	Visualizer::addLandmarks(landmarks_);
 }
 
-void HeadingBeaconObservationModel::loadParameters(const char *pathToSetupFile)
+void HeadingBeaconObservationModel::loadParameters(const SetupConfiguration &config)
 {
 
 	using namespace arma;
-    // Load XML containing landmarks
-    TiXmlDocument doc(pathToSetupFile);
-    bool loadOkay = doc.LoadFile();
-
-    if ( !loadOkay )
-    {
-        printf( "Could not load setup file . Error='%s'. Exiting.\n", doc.ErrorDesc() );
-
-        exit( 1 );
-    }
 
-    TiXmlNode* node = 0;
+    const TiXmlNode* node = 0;
 
-    TiXmlElement* itemElement = 0;
+    const TiXmlElement* itemElement = 0;
 
     // Get the landmarklist node
-    node = doc.FirstChild( "ObservationModels" );
+    node = config.getSection( "ObservationModels" );
     assert( node );
 
 
-    TiXmlNode* child = 0;
+    const TiXmlNode* child = 0;
 
     child = node->FirstChild("HeadingBeaconObservationModel");
     
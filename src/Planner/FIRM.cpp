@@ -46,9 +46,12 @@
 #include <boost/property_map/vector_property_map.hpp>
 #include <boost/foreach.hpp>
 #include <boost/thread.hpp>
+#include <boost/functional/hash.hpp>
 #include <tinyxml.h>
 #include "Visualization/Visualizer.h"
 #include "Utils/FIRMUtils.h"
+#include "Utils/Profiler.h"
+#include "Utils/RoadmapFile.h"
 #include "Planner/FIRM.h"
 
 #define foreach BOOST_FOREACH
@@ -115,6 +118,37 @@ namespace ompl
         static const int DEFAULT_STEPS_TO_ROLLOUT = 10;
 
         static const double EDGE_COST_BIAS = 0.01; // In controller.h all edge costs are added up from 0.01 as the starting cost, this helps DP converge
+
+        /** \brief Approximate heap footprint of a belief state: the state, its two components and the 3x3 covariance */
+        static const unsigned int BELIEF_STATE_BYTES = 256;
+
+        /** \brief Approximate heap footprint of a control */
+        static const unsigned int CONTROL_BYTES = 64;
+
+        /** \brief Distance around a changed obstacle within which nodes and edges of a loaded roadmap are checked again,
+            covers the footprint of the robot */
+        static const double ENVIRONMENT_CHANGE_MARGIN = 1.0;
+
+        /** \brief Number of edge controllers that are built at once when a loaded roadmap is updated */
+        static const unsigned int ROADMAP_DELTA_EDGE_BATCH = 256;
+
+        /** \brief Query poses closer than this (meters, radians) share a roadmap node */
+        static const double QUERY_POSE_RESOLUTION = 1e-3;
+
+        /** \brief The number of solved policies query() keeps, the least recently used ones are dropped */
+        static const unsigned int MAX_CACHED_POLICIES = 16;
+
+        /** \brief Vertex flag of a removed vertex whose slot waits to be reused */
+        static const unsigned int VERTEX_FLAG_REMOVED = 1;
+
+        /** \brief Vertex flag of a node that is removed again, see FIRM::isVertexTransient() */
+        static const unsigned int VERTEX_FLAG_TRANSIENT = 2;
+
+        /** \brief The number of query poses that keep their transient node */
+        static const unsigned int MAX_QUERY_VERTICES = 64;
+
+        /** \brief The number of roadmap samples drawn and collision checked at once */
+        static const unsigned int SAMPLE_BATCH_SIZE = 32;
     }
 }
 
@@ -124,6 +158,7 @@ FIRM::FIRM(const firm::SpaceInformation::SpaceInformationPtr &si, bool debugMode
     stateProperty_(boost::get(vertex_state_t(), g_)),
     totalConnectionAttemptsProperty_(boost::get(vertex_total_connection_attempts_t(), g_)),
     successfulConnectionAttemptsProperty_(boost::get(vertex_successful_connection_attempts_t(), g_)),
+    vertexFlagsProperty_(boost::get(vertex_flags_t(), g_)),
     weightProperty_(boost::get(boost::edge_weight, g_)),
     edgeIDProperty_(boost::get(boost::edge_index, g_)),
     disjointSets_(boost::get(boost::vertex_rank, g_),
@@ -144,7 +179,7 @@ FIRM::FIRM(const firm::SpaceInformation::SpaceInformationPtr &si, bool debugMode
 
     executionCost_ = 0;
 
-    costToGoHistory_.push_back(std::make_pair(currentTimeStep_,executionCost_));
+    velocityHistory_ = std::make_shared<TimeSeriesLogger>();
 
     policyGenerator_ = new NBM3P(si);
 
@@ -158,10 +193,28 @@ FIRM::FIRM(const firm::SpaceInformation::SpaceInformationPtr &si, bool debugMode
 
     doSavePlannerData_ = false;
 
+    saveRoadmapAsXML_ = false;
+
+    doSavePolicy_ = false;
+
+    numLoadedVertices_ = 0;
+
+    policyGoalVertex_ = 0;
+
+    queryClock_ = 0;
+
+    policyCache_.setBudget(ompl::magic::MAX_CACHED_POLICIES);
+
     doSaveLogs_ = false;
 
     doSaveVideo_ = false;
 
+    doSaveTrace_ = false;
+
+    runStatistics_ = RunStatistics();
+
+    executionTrace_.reset(new ExecutionTrace());
+
     NNRadius_ = ompl::magic::DEFAULT_NEAREST_NEIGHBOUR_RADIUS;
 
     numNearestNeighbors_ = ompl::magic::DEFAULT_NEAREST_NEIGHBORS;
@@ -184,6 +237,8 @@ FIRM::FIRM(const firm::SpaceInformation::SpaceInformationPtr &si, bool debugMode
     
     convergenceThresholdDP_ = ompl::magic::DEFAULT_DP_CONVERGENCE_THRESHOLD;
 
+    dpSolver_ = DP_SOLVER_MAP;
+
 }
 
 FIRM::~FIRM(void)
@@ -245,6 +300,7 @@ void FIRM::clear(void)
 {
     Planner::clear();
     sampler_.reset();
+    batchSampler_.reset();
     simpleSampler_.reset();
     freeMemory();
     if (nn_)
@@ -256,8 +312,15 @@ void FIRM::clear(void)
 void FIRM::freeMemory(void)
 {
     foreach (Vertex v, boost::vertices(g_))
-        si_->freeState(stateProperty_[v]);
+    {
+        if(isVertexAlive(v))
+            si_->freeState(stateProperty_[v]);
+    }
     g_.clear();
+    freeVertices_.clear();
+    vertexGenerations_.clear();
+    policyCache_.clear();
+    queryVertices_.clear();
 }
 
 void FIRM::expandRoadmap(double expandTime)
@@ -286,6 +349,9 @@ void FIRM::expandRoadmap(const ompl::base::PlannerTerminationCondition &ptc,
     ompl::PDF<Vertex> pdf;
     foreach (Vertex v, boost::vertices(g_))
     {
+        if(!isVertexAlive(v) || isVertexTransient(v))
+            continue;
+
         const unsigned int t = totalConnectionAttemptsProperty_[v];
         pdf.add(v, (double)(t - successfulConnectionAttemptsProperty_[v]) /(double)t);
     }
@@ -309,7 +375,7 @@ void FIRM::expandRoadmap(const ompl::base::PlannerTerminationCondition &ptc,
             for (unsigned int i = 0 ; i < s ; ++i)
             {
                 // add the vertex along the bouncing motion
-                Vertex m = boost::add_vertex(g_);
+                Vertex m = allocateVertex();
                 stateProperty_[m] = si_->cloneState(workStates[i]);
                 totalConnectionAttemptsProperty_[m] = 1;
                 successfulConnectionAttemptsProperty_[m] = 0;
@@ -382,6 +448,12 @@ void FIRM::growRoadmap(const ompl::base::PlannerTerminationCondition &ptc,
 {
     using namespace arma;
 
+    if(dynamic_cast<const SE2BeliefSpace*>(siF_->getStateSpace().get()))
+    {
+        growRoadmapInBatches(ptc);
+        return;
+    }
+
     while (ptc == false)
     {
         // search for a valid state
@@ -393,30 +465,19 @@ void FIRM::growRoadmap(const ompl::base::PlannerTerminationCondition &ptc,
             unsigned int attempts = 0;
             do
             {
+                FIRM_PROFILE_SCOPE("FIRM::sampleNode");
+
                 found = sampler_->sample(workState);
                 stateStable = false;
                 if(found)
                 {
+                    // cheap rejection from the precomputed map before any linear algebra
+                    const ObservabilityMap::ObservabilityMapPtr &obsMap = siF_->getObservabilityMap();
 
-                    ompl::base::State *lsState = si_->cloneState(workState);
-
-                    LinearSystem ls(siF_, lsState, siF_->getMotionModel()->getZeroControl(),
-                                siF_->getObservationModel()->getObservation(lsState, false), siF_->getMotionModel(), siF_->getObservationModel());
-
-                    arma::mat S;
-
-                    try
-                    {
-                        stateStable = dare (trans(ls.getA()),trans(ls.getH()),ls.getG() * ls.getQ() * trans(ls.getG()),
-                                ls.getM() * ls.getR() * trans(ls.getM()), S );
-
-                        //workState->as<FIRM::StateType>()->setCovariance(S);
-                    }
-                    catch(int e)
+                    if(!obsMap || obsMap->isObservable(workState))
                     {
-                        stateStable = false;
+                        stateStable = ObservabilityMap::isStateStable(siF_, workState);
                     }
-
                 }
                 attempts++;
             } while (attempts < ompl::magic::FIND_VALID_STATE_ATTEMPTS_WITHOUT_TERMINATION_CHECK && !found && !stateStable);
@@ -427,6 +488,36 @@ void FIRM::growRoadmap(const ompl::base::PlannerTerminationCondition &ptc,
     }
 }
 
+void FIRM::growRoadmapInBatches(const ompl::base::PlannerTerminationCondition &ptc)
+{
+    if(!batchSampler_)
+        batchSampler_ = std::make_shared<UniformValidBeliefSampler>(siF_.get());
+
+    std::vector<ompl::base::State*> batch(ompl::magic::SAMPLE_BATCH_SIZE);
+
+    siF_->allocStates(batch);
+
+    while (ptc == false)
+    {
+        unsigned int numSamples = 0;
+
+        {
+            FIRM_PROFILE_SCOPE("FIRM::sampleNode");
+
+            // the samples are valid and pass the observability map already
+            numSamples = batchSampler_->sampleBatch(&batch[0], batch.size());
+        }
+
+        for(unsigned int i = 0; i < numSamples && ptc == false; i++)
+        {
+            if(ObservabilityMap::isStateStable(siF_, batch[i]))
+                addStateToGraph(si_->cloneState(batch[i]));
+        }
+    }
+
+    siF_->freeStates(batch);
+}
+
 void FIRM::checkForSolution(const ompl::base::PlannerTerminationCondition &ptc,
                                             ompl::base::PathPtr &solution)
 {
@@ -460,9 +551,9 @@ bool FIRM::existsPolicy(const std::vector<Vertex> &starts, const std::vector<Ver
     ompl::base::Goal *g = pdef_->getGoal().get();
     ompl::base::Cost sol_cost(0.0);
 
-    OMPL_INFORM("%s: Number of current states = %u", getName().c_str(), boost::num_vertices(g_));
+    OMPL_INFORM("%s: Number of current states = %u", getName().c_str(), milestoneCount());
 
-    if(boost::num_vertices(g_) < minFIRMNodes_)
+    if(milestoneCount() < minFIRMNodes_)
     {
         OMPL_INFORM("FIRM: Do not yet have enough nodes (< %u).", minFIRMNodes_);
         return false;
@@ -483,8 +574,15 @@ bool FIRM::existsPolicy(const std::vector<Vertex> &starts, const std::vector<Ver
             {
 
                 boost::mutex::scoped_lock _(graphMutex_);
-                
-                solveDynamicProgram(goal);
+
+                if(!restorePolicy(goal))
+                {
+                    solveDynamicProgram(goal);
+
+                    // a planner restarted on the same roadmap picks the policy up without solving again
+                    if(doSavePolicy_ && isLoadedRoadmapIntact())
+                        savePolicy(loadedRoadmapPath_, numLoadedVertices_, goal);
+                }
                 
                 if(!constructFeedbackPath(start, goal, solution))
                     return false;
@@ -512,6 +610,8 @@ bool FIRM::addedNewSolution(void) const
 
 ompl::base::PlannerStatus FIRM::solve(const ompl::base::PlannerTerminationCondition &ptc)
 {
+    const auto solveStartTime = std::chrono::steady_clock::now();
+
     checkValidity();
     ompl::base::GoalSampleableRegion *goal = dynamic_cast<ompl::base::GoalSampleableRegion*>(pdef_->getGoal().get());
 
@@ -572,7 +672,7 @@ ompl::base::PlannerStatus FIRM::solve(const ompl::base::PlannerTerminationCondit
         }
     }
 
-    unsigned int nrStartStates = boost::num_vertices(g_);
+    unsigned int nrStartStates = milestoneCount();
     OMPL_INFORM("%s: Starting with %u states", getName().c_str(), nrStartStates);
 
     addedSolution_ = false;
@@ -591,19 +691,30 @@ ompl::base::PlannerStatus FIRM::solve(const ompl::base::PlannerTerminationCondit
         ompl::base::plannerOrTerminationCondition(ptc, ompl::base::PlannerTerminationCondition(boost::bind(&FIRM::addedNewSolution, this)));
 
     // If no roadmap was loaded or the number of loaded is less than min required by setup, then build roadmap
-    if(!loadedRoadmapFromFile_ || boost::num_vertices(g_) < minFIRMNodes_)
+    if(!loadedRoadmapFromFile_ || milestoneCount() < minFIRMNodes_)
     {
+        const auto roadmapStartTime = std::chrono::steady_clock::now();
+
         constructRoadmap(ptcOrSolutionFound);
+
+        runStatistics_.roadmapTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - roadmapStartTime).count();
     }
 
+    slnThread.join();
+
+    // saved after the solution thread is done so the policy it solved is saved with the roadmap
     if(doSavePlannerData_)
     {
         this->savePlannerData();
     }
 
-    slnThread.join();
+    runStatistics_.solveTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - solveStartTime).count();
+
+    runStatistics_.nodesAdded += milestoneCount() - nrStartStates;
 
-    OMPL_INFORM("%s: Created %u states", getName().c_str(), boost::num_vertices(g_) - nrStartStates);
+    OMPL_INFORM("%s: Created %u states", getName().c_str(), milestoneCount() - nrStartStates);
+
+    BeliefStatePool<SE2BeliefSpace>::printStatistics(getName());
 
     if (sol)
     {
@@ -642,8 +753,9 @@ void FIRM::constructRoadmap(const ompl::base::PlannerTerminationCondition &ptc)
     si_->freeStates(xstates);
 }
 
-FIRM::Vertex FIRM::addStateToGraph(ompl::base::State *state, bool addReverseEdge, bool shouldCreateNodeController)
+FIRM::Vertex FIRM::addStateToGraph(ompl::base::State *state, bool addReverseEdge, bool shouldCreateNodeController, bool transient)
 {
+    FIRM_PROFILE_SCOPE("FIRM::addStateToGraph");
 
     boost::mutex::scoped_lock _(graphMutex_);
 
@@ -655,9 +767,12 @@ FIRM::Vertex FIRM::addStateToGraph(ompl::base::State *state, bool addReverseEdge
     // Now add belief state to graph as FIRM node
     Vertex m;
 
-    m = boost::add_vertex(g_);
+    m = allocateVertex();
+
+    if(transient)
+        vertexFlagsProperty_[m] |= ompl::magic::VERTEX_FLAG_TRANSIENT;
 
-    if(addReverseEdge)
+    if(addReverseEdge && !transient)
         addStateToVisualization(state);
 
     stateProperty_[m] = state;
@@ -741,14 +856,22 @@ FIRM::Vertex FIRM::addStateToGraph(ompl::base::State *state, bool addReverseEdge
 
                             uniteComponents(m, n);
 
-                            Visualizer::addGraphEdge(stateProperty_[m], stateProperty_[n]);
-
-                            Visualizer::addGraphEdge(stateProperty_[n], stateProperty_[m]);
+                            if(!transient)
+                            {
+                                Visualizer::addGraphEdge(stateProperty_[m], stateProperty_[n]);
 
+                                Visualizer::addGraphEdge(stateProperty_[n], stateProperty_[m]);
+                            }
                         }
                         else
                         {
-                            boost::remove_edge(m,n,g_); // if you cannot add bidirectional edge, then keep no edge between the two nodes
+                            // if you cannot add bidirectional edge, then keep no edge between the two nodes
+                            std::pair<Edge, bool> forwardEdge = boost::edge(m, n, g_);
+
+                            if(forwardEdge.second)
+                                edgeControllers_.erase(forwardEdge.first);
+
+                            boost::remove_edge(m,n,g_);
                         }
                     }
 
@@ -757,19 +880,180 @@ FIRM::Vertex FIRM::addStateToGraph(ompl::base::State *state, bool addReverseEdge
         }
     }
 
-    policyGenerator_->addFIRMNodeToObservationGraph(state);
+    // rollout and query nodes are removed again, they do not belong in the observation graph
+    if(addReverseEdge && !transient)
+        policyGenerator_->addFIRMNodeToObservationGraph(state);
+
+    return m;
+}
+
+FIRM::Vertex FIRM::allocateVertex(void)
+{
+    if(freeVertices_.empty())
+        return boost::add_vertex(g_);
+
+    const Vertex m = freeVertices_.back();
+
+    freeVertices_.pop_back();
+
+    vertexFlagsProperty_[m] = 0;
 
     return m;
 }
 
+bool FIRM::isVertexAlive(const Vertex v) const
+{
+    return v < boost::num_vertices(g_) && !(vertexFlagsProperty_[v] & ompl::magic::VERTEX_FLAG_REMOVED);
+}
+
+bool FIRM::isVertexTransient(const Vertex v) const
+{
+    return v < boost::num_vertices(g_) && (vertexFlagsProperty_[v] & ompl::magic::VERTEX_FLAG_TRANSIENT);
+}
+
+void FIRM::removeVertex(const Vertex v)
+{
+    FIRM_PROFILE_SCOPE("FIRM::removeVertex");
+
+    boost::mutex::scoped_lock _(graphMutex_);
+
+    if(!isVertexAlive(v))
+        return;
+
+    std::vector<Vertex> sources;
+
+    // the nodes whose feedback leads into v are left without one, in the current and the cached policies
+    foreach (Edge e, boost::in_edges(v, g_))
+    {
+        const Vertex u = boost::source(e, g_);
+
+        std::map<Vertex, Edge>::iterator f = feedback_.find(u);
+
+        if(f != feedback_.end() && boost::target(f->second, g_) == v)
+            feedback_.erase(f);
+
+        sources.push_back(u);
+
+        edgeControllers_.erase(e);
+    }
+
+    // a reused policy gives the nodes without feedback a Bellman backup, see query()
+    policyCache_.erase(v);
+
+    policyCache_.forEach([&](const Vertex &, CachedPolicy &policy)
+    {
+        for(size_t i = 0; i < sources.size(); i++)
+        {
+            std::map<Vertex, Edge>::iterator f = policy.feedback.find(sources[i]);
+
+            if(f != policy.feedback.end() && boost::target(f->second, g_) == v)
+                policy.feedback.erase(f);
+        }
+
+        policy.feedback.erase(v);
+
+        policy.costToGo.erase(v);
+    });
+
+    foreach (Edge e, boost::out_edges(v, g_))
+    {
+        edgeControllers_.erase(e);
+    }
+
+    boost::clear_vertex(v, g_);
+
+    for(std::map<std::tuple<long, long, long>, QueryVertex>::iterator q = queryVertices_.begin(); q != queryVertices_.end(); )
+    {
+        if(q->second.vertex == v)
+            queryVertices_.erase(q++);
+        else
+            ++q;
+    }
+
+    // the nearest neighbor structure still needs the state to find v
+    nn_->remove(v);
+
+    nodeControllers_.erase(v);
+
+    costToGo_.erase(v);
+
+    feedback_.erase(v);
+
+    si_->freeState(stateProperty_[v]);
+
+    stateProperty_[v] = nullptr;
+
+    vertexFlagsProperty_[v] |= ompl::magic::VERTEX_FLAG_REMOVED;
+
+    if(vertexGenerations_.size() <= v)
+        vertexGenerations_.resize(v + 1, 0);
+
+    vertexGenerations_[v]++;
+
+    freeVertices_.push_back(v);
+}
+
+std::vector<long> FIRM::vertexOrdinals(void) const
+{
+    std::vector<long> ordinals(boost::num_vertices(g_), -1);
+
+    long next = 0;
+
+    for(std::size_t v = 0; v < ordinals.size(); v++)
+    {
+        if(isVertexAlive(v))
+            ordinals[v] = next++;
+    }
+
+    return ordinals;
+}
+
 void FIRM::uniteComponents(Vertex m1, Vertex m2)
 {
+    // the components cannot be split again when a transient node is removed, so it never joins one
+    if(isVertexTransient(m1) || isVertexTransient(m2))
+        return;
+
     disjointSets_.union_set(m1, m2);
 }
 
 bool FIRM::sameComponent(Vertex m1, Vertex m2)
 {
-    return boost::same_component(m1, m2, disjointSets_);
+    if(!isVertexTransient(m1) && !isVertexTransient(m2))
+        return boost::same_component(m1, m2, disjointSets_);
+
+    if(m1 == m2 || boost::edge(m1, m2, g_).second)
+        return true;
+
+    // the edges of a transient node go both ways, so it reaches and is reached from the components of its neighbors
+    std::vector<Vertex> from(1, m1), to(1, m2);
+
+    if(isVertexTransient(m1))
+    {
+        from.clear();
+
+        foreach (Edge e, boost::out_edges(m1, g_))
+            from.push_back(boost::target(e, g_));
+    }
+
+    if(isVertexTransient(m2))
+    {
+        to.clear();
+
+        foreach (Edge e, boost::in_edges(m2, g_))
+            to.push_back(boost::source(e, g_));
+    }
+
+    foreach (Vertex a, from)
+    {
+        foreach (Vertex b, to)
+        {
+            if(!isVertexTransient(a) && !isVertexTransient(b) && boost::same_component(a, b, disjointSets_))
+                return true;
+        }
+    }
+
+    return false;
 }
 
 bool FIRM::constructFeedbackPath(const Vertex &start, const Vertex &goal, ompl::base::PathPtr &solution)
@@ -794,7 +1078,7 @@ bool FIRM::constructFeedbackPath(const Vertex &start, const Vertex &goal, ompl::
         if(target > boost::num_vertices(g_))
             OMPL_ERROR("Error in constructing feedback path. Tried to access vertex ID not in graph.");
 
-        p->append(stateProperty_[currentVertex],edgeControllers_[edge]); // push the state and controller to take
+        p->append(stateProperty_[currentVertex],getEdgeController(edge)); // push the state and controller to take
 
         if(target == goal)
         {
@@ -840,7 +1124,7 @@ void FIRM::addEdgeToGraph(const FIRM::Vertex a, const FIRM::Vertex b, bool &edge
     // create an edge with the edge weight property
     std::pair<Edge, bool> newEdge = boost::add_edge(a, b, properties, g_);
 
-    edgeControllers_[newEdge.first] = edgeController;
+    edgeControllers_.insert(newEdge.first, edgeController, estimateEdgeControllerMemory(edgeController));
 
     edgeAdded = true;
 }
@@ -853,6 +1137,24 @@ FIRMWeight FIRM::generateEdgeControllerWithCost(const FIRM::Vertex a, const FIRM
      // Generate the edge controller for given start and end state
     generateEdgeController(startNodeState,targetNodeState,edgeController);
 
+    const FIRMWeight weight = simulateEdgeController(startNodeState, edgeController);
+
+    // the edge controller keeps its own copy of the target
+    siF_->freeState(startNodeState);
+
+    siF_->freeState(targetNodeState);
+
+    return weight;
+}
+
+FIRMWeight FIRM::simulateEdgeController(const ompl::base::State *start, EdgeControllerType &edgeController)
+{
+    FIRM_PROFILE_SCOPE("FIRM::edgeMonteCarlo");
+
+    FIRM_PROFILE_COUNT("FIRM::monteCarloParticles", numMCParticles_);
+
+    ompl::base::State* startNodeState = siF_->cloneState(start);
+
     double successCount = 0;
 
     // initialize costs to 0
@@ -885,10 +1187,14 @@ FIRMWeight FIRM::generateEdgeControllerWithCost(const FIRM::Vertex a, const FIRM
             //edgeCost.v = edgeCost.v + ompl::magic::INFORMATION_COST_WEIGHT*filteringCost.v + ompl::magic::TIME_TO_STOP_COST_WEIGHT*stepsToStop;
             edgeCost = ompl::base::Cost(edgeCost.value() + informationCostWeight_*filteringCost.value() + ompl::magic::TIME_TO_STOP_COST_WEIGHT*stepsToStop);
         }
+
+        siF_->freeState(endBelief);
     }
 
     siF_->showRobotVisualization(true);
 
+    siF_->freeState(startNodeState);
+
     //edgeCost.v = edgeCost.v / successCount ;
     edgeCost = ompl::base::Cost(edgeCost.value() / successCount);
 
@@ -923,15 +1229,21 @@ void FIRM::generateEdgeController(const ompl::base::State *start, const ompl::ba
         si_->copyState(intermediate, x);
     }
 
+    si_->freeState(intermediate);
+
     // create the edge controller
     EdgeControllerType ctrlr(target, intermediates, openLoopControls, siF_);
 
+    ctrlr.adoptNominalTrajectory(intermediates, openLoopControls);
+
     // assign the edge controller
     edgeController =  ctrlr;
 }
 
 void FIRM::generateNodeController(ompl::base::State *state, FIRM::NodeControllerType &nodeController)
 {
+    FIRM_PROFILE_SCOPE("FIRM::generateNodeController");
+
     // Create a copy of the node state
     ompl::base::State *node = si_->allocState();
     siF_->copyState(node, state);
@@ -961,6 +1273,16 @@ void FIRM::generateNodeController(ompl::base::State *state, FIRM::NodeController
     node->as<FIRM::StateType>()->setCovariance(stationaryCovariance);
     state->as<FIRM::StateType>()->setCovariance(stationaryCovariance);
 
+    createNodeController(node, nodeController);
+
+    si_->freeState(node);
+}
+
+void FIRM::createNodeController(const ompl::base::State *state, FIRM::NodeControllerType &nodeController)
+{
+    // the separated controller keeps a pointer to the nominal state, so it gets its own copy
+    ompl::base::State *node = siF_->cloneState(state);
+
     // create a node controller with node as the state and zero control as nominal control
     std::vector<ompl::control::Control*> zeroControl; zeroControl.push_back(siF_->getMotionModel()->getZeroControl());
 
@@ -968,9 +1290,92 @@ void FIRM::generateNodeController(ompl::base::State *state, FIRM::NodeController
 
     NodeControllerType ctrlr(node, nodeState, zeroControl, siF_);
 
+    // the zero control belongs to the motion model, only the state is handed over
+    ctrlr.adoptNominalTrajectory(nodeState, std::vector<ompl::control::Control*>());
+
     // assign the node controller
     nodeController = ctrlr;
+}
+
+FIRM::EdgeControllerType FIRM::getEdgeController(const FIRM::Edge &e)
+{
+    EdgeControllerType edgeController;
+
+    if(edgeControllers_.get(e, edgeController))
+        return edgeController;
+
+    materializeEdgeController(e, edgeController);
+
+    edgeControllers_.insert(e, edgeController, estimateEdgeControllerMemory(edgeController));
+
+    return edgeController;
+}
+
+void FIRM::materializeEdgeController(const FIRM::Edge &e, FIRM::EdgeControllerType &edgeController)
+{
+    const unsigned int id = edgeIDProperty_[e];
+
+    const ompl::base::State *source = stateProperty_[boost::source(e, g_)];
+
+    const ompl::base::State *target = stateProperty_[boost::target(e, g_)];
+
+    if(loadedRoadmapFile_ && id < roadmapFileEdgeRecords_.size() && roadmapFileEdgeRecords_[id] >= 0)
+    {
+        const RoadmapFile::Edge &record = loadedRoadmapFile_->getEdge(roadmapFileEdgeRecords_[id]);
+
+        if(record.trajectoryLength > 0)
+        {
+            restoreEdgeController(target, *loadedRoadmapFile_, record, edgeController);
+            return;
+        }
+    }
+
+    // the open loop controls only depend on the end nodes, so this gives back the controller the edge was built with
+    generateEdgeController(source, target, edgeController);
+}
+
+std::size_t FIRM::estimateEdgeControllerMemory(const FIRM::EdgeControllerType &edgeController) const
+{
+    // every step holds a linear system with its own copy of the nominal belief, the nominal belief and its control
+    const std::size_t bytesPerStep = sizeof(LinearSystem) + 2*ompl::magic::BELIEF_STATE_BYTES + ompl::magic::CONTROL_BYTES;
+
+    return sizeof(EdgeControllerType) + ompl::magic::BELIEF_STATE_BYTES + edgeController.Length()*bytesPerStep;
+}
+
+void FIRM::restoreEdgeController(const ompl::base::State* target, const RoadmapFile &roadmapFile, const RoadmapFile::Edge &edge, FIRM::EdgeControllerType &edgeController)
+{
+    const unsigned int stateDim = roadmapFile.getStateDimension();
+
+    const unsigned int controlDim = roadmapFile.getControlDimension();
+
+    const double *xs = roadmapFile.getNominalStates(edge);
+
+    const double *us = roadmapFile.getNominalControls(edge);
+
+    std::vector<ompl::base::State*> intermediates;
+
+    std::vector<ompl::control::Control*> openLoopControls;
 
+    intermediates.reserve(edge.trajectoryLength);
+
+    openLoopControls.reserve(edge.trajectoryLength);
+
+    for(std::size_t i = 0; i < edge.trajectoryLength; i++)
+    {
+        ompl::base::State *x = si_->allocState();
+        x->as<FIRM::StateType>()->setArmaData(arma::colvec(xs + i*stateDim, stateDim));
+        intermediates.push_back(x);
+
+        openLoopControls.push_back(siF_->getMotionModel()->ARMA2OMPL(arma::colvec(us + i*controlDim, controlDim)));
+    }
+
+    // create the edge controller
+    EdgeControllerType ctrlr(target, intermediates, openLoopControls, siF_);
+
+    ctrlr.adoptNominalTrajectory(intermediates, openLoopControls);
+
+    // assign the edge controller
+    edgeController =  ctrlr;
 }
 
 template<typename Map>
@@ -992,65 +1397,79 @@ void FIRM::solveDynamicProgram(const FIRM::Vertex goalVertex)
 
     using namespace arma;
 
-    float discountFactor = discountFactorDP_;
-
-    std::map<Vertex, double> newCostToGo;
+    feedback_.clear();
 
-    costToGo_ = std::map<Vertex, double>();
+    policyGoalVertex_ = goalVertex;
 
-    /**
-    --NOTES--
-    Assign a high cost to go initially for all nodes that are not in the goal connected component.
-    For nodes that are in the goal cc, we assign goal cost to go for the goal and init cost to go
-    for all other nodes.
-    */
-    foreach (Vertex v, boost::vertices(g_))
+    if(dpSolver_ == DP_SOLVER_INDEXED)
     {
-        if(v == goalVertex)
-        {
-            costToGo_[v] = goalCostToGo_;
-            newCostToGo[v] = goalCostToGo_;
-        }
-        else
-        {
-            costToGo_[v] = initalCostToGo_;
-            newCostToGo[v] = initalCostToGo_;
-        }
+        solveDynamicProgramIndexed(goalVertex);
     }
+    else
+    {
+        float discountFactor = discountFactorDP_;
 
-    feedback_.clear();
-
-    bool convergenceCondition = false;
+        std::map<Vertex, double> newCostToGo;
 
-    int nIter=0;
-    while(!convergenceCondition && nIter < maxDPIterations_)
-    {
-        nIter++;
+        costToGo_ = std::map<Vertex, double>();
 
-        foreach(Vertex v, boost::vertices(g_))
+        /**
+        --NOTES--
+        Assign a high cost to go initially for all nodes that are not in the goal connected component.
+        For nodes that are in the goal cc, we assign goal cost to go for the goal and init cost to go
+        for all other nodes.
+        */
+        foreach (Vertex v, boost::vertices(g_))
         {
+            if(!isVertexAlive(v))
+                continue;
 
-            //value for goal node stays the same or if has no out edges then ignore it
-            if( v == goalVertex || boost::out_degree(v,g_) == 0 )
+            if(v == goalVertex)
             {
-                continue;
+                costToGo_[v] = goalCostToGo_;
+                newCostToGo[v] = goalCostToGo_;
             }
+            else
+            {
+                costToGo_[v] = initalCostToGo_;
+                newCostToGo[v] = initalCostToGo_;
+            }
+        }
 
-            // Update the costToGo of vertex
-            std::pair<Edge,double> candidate = getUpdatedNodeCostToGo(v, goalVertex);
-
-            feedback_[v] = candidate.first;
+        bool convergenceCondition = false;
 
-            newCostToGo[v] = candidate.second * discountFactor;
+        int nIter=0;
+        while(!convergenceCondition && nIter < maxDPIterations_)
+        {
+            FIRM_PROFILE_SCOPE("FIRM::dpSweep");
 
-            //assert(costToGo_.size()==newCostToGo.size());
+            nIter++;
 
-        }
+            foreach(Vertex v, boost::vertices(g_))
+            {
 
-        convergenceCondition = (norm(MapToColvec(costToGo_)-MapToColvec(newCostToGo), "inf") <= convergenceThresholdDP_);
+                //value for goal node stays the same or if has no out edges then ignore it
+                if( v == goalVertex || boost::out_degree(v,g_) == 0 )
+                {
+                    continue;
+                }
+
+                // Update the costToGo of vertex
+                std::pair<Edge,double> candidate = getUpdatedNodeCostToGo(v, goalVertex);
+
+                feedback_[v] = candidate.first;
+
+                newCostToGo[v] = candidate.second * discountFactor;
+
+                //assert(costToGo_.size()==newCostToGo.size());
+
+            }
 
-        costToGo_.swap(newCostToGo);   // Equivalent to costToGo_ = newCostToGo
+            convergenceCondition = (norm(MapToColvec(costToGo_)-MapToColvec(newCostToGo), "inf") <= convergenceThresholdDP_);
 
+            costToGo_.swap(newCostToGo);   // Equivalent to costToGo_ = newCostToGo
+
+        }
     }
 
     auto end_time = std::chrono::high_resolution_clock::now();
@@ -1059,6 +1478,10 @@ void FIRM::solveDynamicProgram(const FIRM::Vertex goalVertex)
 
     OMPL_INFORM("FIRM: DP Solve Time: %2.3f seconds<----", timeDP/1000.0);
 
+    runStatistics_.dpTime += timeDP/1000.0;
+
+    runStatistics_.dpSolves++;
+
     OMPL_INFORM("FIRM: Solved DP");
 
     if(doSaveLogs_)
@@ -1123,310 +1546,694 @@ std::pair<typename FIRM::Edge,double> FIRM::getUpdatedNodeCostToGo(const FIRM::V
 
 }
 
-double FIRM::evaluateSuccessProbability(const Edge currentEdge, const FIRM::Vertex start, const FIRM::Vertex goal)
+void FIRM::solveDynamicProgramIndexed(const FIRM::Vertex goalVertex)
 {
-    const FIRMWeight currentEdgeWeight = boost::get(boost::edge_weight, g_, currentEdge);
+    /**
+    Same sweeps as the map based solver, on a flat copy of the roadmap: vertices are numbered once,
+    the out edges of every vertex are stored contiguously and the terms of the Bellman backup that
+    do not depend on the cost-to-go (failure cost, edge cost, distance of the target to the goal)
+    are computed once instead of in every sweep. The backup adds the terms in the same order as
+    getUpdatedNodeCostToGo, so both solvers produce the same numbers.
+    */
+    struct Transition
+    {
+        Edge edge;
+        std::size_t target;
+        double probability;
+        double failureCost;
+        double edgeCost;
+        double distanceCost;
+    };
 
-    double successProb = currentEdgeWeight.getSuccessProbability();
+    const float discountFactor = discountFactorDP_;
 
-    Vertex v = boost::target(currentEdge, g_);
+    std::vector<Vertex> vertices;
 
-    while(v != goal)
+    std::unordered_map<Vertex, std::size_t> index;
+
+    foreach(Vertex v, boost::vertices(g_))
     {
-        Edge edge = feedback_[v];
+        if(!isVertexAlive(v))
+            continue;
 
-        const FIRMWeight edgeWeight =  boost::get(boost::edge_weight, g_, edge);
+        index[v] = vertices.size();
+        vertices.push_back(v);
+    }
 
-        const double transitionProbability  = edgeWeight.getSuccessProbability();
+    const std::size_t n = vertices.size();
 
-        //OMPL_INFORM("The success probability of edge is %f", transitionProbability);
+    // the transitions of vertex i are transitions[first[i]] to transitions[first[i+1]-1]
+    std::vector<std::size_t> first(n + 1, 0);
 
-        successProb = successProb * transitionProbability;
+    std::vector<Transition> transitions;
 
-        v = boost::target(edge, g_);
+    transitions.reserve(boost::num_edges(g_));
+
+    const arma::colvec goalVec = stateProperty_[goalVertex]->as<FIRM::StateType>()->getArmaData();
+
+    for(std::size_t i = 0; i < n; i++)
+    {
+        first[i] = transitions.size();
+
+        //value for goal node stays the same or if has no out edges then ignore it
+        if(vertices[i] == goalVertex)
+            continue;
+
+        foreach(Edge e, boost::out_edges(vertices[i], g_))
+        {
+            const Vertex targetNode = boost::target(e, g_);
+
+            const FIRMWeight edgeWeight = boost::get(boost::edge_weight, g_, e);
+
+            arma::colvec targetToGoalVec = goalVec - stateProperty_[targetNode]->as<FIRM::StateType>()->getArmaData();
+
+            Transition t;
+
+            t.edge = e;
+            t.target = index[targetNode];
+            t.probability = edgeWeight.getSuccessProbability();
+            t.failureCost = (1-t.probability)*obstacleCostToGo_;
+            t.edgeCost = edgeWeight.getCost();
+            t.distanceCost = distanceCostWeight_*arma::norm(targetToGoalVec.subvec(0,1),2);
 
+            transitions.push_back(t);
+        }
     }
 
-    return successProb;
-}
+    first[n] = transitions.size();
 
-void FIRM::updateEdgeCollisionCost(FIRM::Vertex currentVertex, FIRM::Vertex goalVertex)
-{
-    // cycle through feedback, update edge costs for edges in collision
-    while(currentVertex != goalVertex)
+    std::vector<double> costToGo(n, initalCostToGo_);
+
+    costToGo[index[goalVertex]] = goalCostToGo_;
+
+    std::vector<double> newCostToGo = costToGo;
+
+    // index of the chosen transition of every vertex, transitions.size() marks vertices without one
+    std::vector<std::size_t> chosen(n, transitions.size());
+
+    bool convergenceCondition = false;
+
+    int nIter=0;
+    while(!convergenceCondition && nIter < maxDPIterations_)
     {
-        Edge edge = feedback_[currentVertex]; // get the edge
+        FIRM_PROFILE_SCOPE("FIRM::dpSweep");
 
-        Vertex target = boost::target(edge, g_); // get the target of this edge
+        nIter++;
 
-        // if edge is invalid, increase its cost
-        if(!si_->checkMotion(stateProperty_[currentVertex], stateProperty_[target]))
+        double maxChange = 0;
+
+        for(std::size_t i = 0; i < n; i++)
         {
-            double pvc1 = weightProperty_[edge].getCost();
-    
-            weightProperty_[edge].setCost(pvc1 + obstacleCostToGo_*10);
+            if(first[i] == first[i+1])
+                continue;
 
-            weightProperty_[edge].setSuccessProbability(0.0);
+            std::size_t best = first[i];
 
-            // Get outgoing edges of target
-            foreach(Edge e, boost::out_edges(target, g_))
+            double bestCostToGo = 0;
+
+            for(std::size_t k = first[i]; k < first[i+1]; k++)
             {
-                // if any outgoing edge is in collision, update its cost
-                if(!si_->checkMotion(stateProperty_[target], stateProperty_[boost::target(e, g_)]))
-                {
-                    double pvc2 = weightProperty_[e].getCost();
-    
-                    weightProperty_[e].setCost(pvc2 + obstacleCostToGo_*10);
+                const Transition &t = transitions[k];
 
-                    weightProperty_[e].setSuccessProbability(0.0);
+                const double singleCostToGo = (t.probability*costToGo[t.target] + t.failureCost + t.edgeCost) + t.distanceCost;
+
+                if(k == first[i] || singleCostToGo < bestCostToGo)
+                {
+                    best = k;
+                    bestCostToGo = singleCostToGo;
                 }
             }
 
+            chosen[i] = best;
+
+            newCostToGo[i] = bestCostToGo * discountFactor;
+
+            maxChange = std::max(maxChange, std::abs(costToGo[i] - newCostToGo[i]));
         }
-           
-        currentVertex =  target;
 
-    }
+        convergenceCondition = maxChange <= convergenceThresholdDP_;
 
-}
+        costToGo.swap(newCostToGo);
+    }
 
-void FIRM::executeFeedback(void)
-{
+    costToGo_.clear();
 
-    Vertex start = startM_[0];
-    Vertex goal  = goalM_[0] ;
+    for(std::size_t i = 0; i < n; i++)
+    {
+        costToGo_[vertices[i]] = costToGo[i];
 
-    ompl::base::State *goalState = si_->cloneState(stateProperty_[goal]);
+        if(chosen[i] < transitions.size())
+            feedback_[vertices[i]] = transitions[chosen[i]].edge;
+    }
+}
 
-    sendMostLikelyPathToViz(start, goal);
+void FIRM::solvePolicy(const Vertex goalVertex, DPSolverType solver, std::map<Vertex, double> &costToGo, std::map<Vertex, Edge> &feedback)
+{
+    const DPSolverType configured = dpSolver_;
 
-    siF_->setTrueState(stateProperty_[start]);
-    siF_->setBelief(stateProperty_[start]);
+    dpSolver_ = solver;
 
-    Vertex currentVertex =  start;
+    solveDynamicProgram(goalVertex);
 
-    EdgeControllerType controller;
+    dpSolver_ = configured;
 
-    ompl::base::State *cstartState = si_->allocState();
-    si_->copyState(cstartState, stateProperty_[start]);
+    costToGo = costToGo_;
 
-    ompl::base::State *cendState = si_->allocState();
+    feedback = feedback_;
+}
 
-    OMPL_INFORM("FIRM: Running policy execution");
+std::uint64_t FIRM::fingerprintPolicy(const std::string &pathToRoadmap) const
+{
+    std::size_t seed = 0;
 
-    Visualizer::doSaveVideo(doSaveVideo_);
+    boost::hash_combine(seed, FIRMUtils::hashFileContents(pathToRoadmap));
 
-    nodeReachedHistory_.push_back(std::make_pair(currentTimeStep_, numberofNodesReached_) );
+    if(environmentStamp_)
+        boost::hash_combine(seed, environmentStamp_->getCombinedHash());
 
-    siF_->doVelocityLogging(true);
+    boost::hash_combine(seed, discountFactorDP_);
+    boost::hash_combine(seed, distanceCostWeight_);
+    boost::hash_combine(seed, goalCostToGo_);
+    boost::hash_combine(seed, obstacleCostToGo_);
+    boost::hash_combine(seed, initalCostToGo_);
+    boost::hash_combine(seed, convergenceThresholdDP_);
+    boost::hash_combine(seed, maxDPIterations_);
 
-    while(!goalState->as<FIRM::StateType>()->isReached(cstartState))
-    {
+    return seed;
+}
 
-        if(currentVertex==goal)
-            break;
+bool FIRM::isLoadedRoadmapIntact() const
+{
+    return !loadedRoadmapPath_.empty() && milestoneCount() <= numLoadedVertices_ + startM_.size() + goalM_.size() + queryVertices_.size();
+}
 
-        Edge e = feedback_[currentVertex];
+bool FIRM::restorePolicy(const FIRM::Vertex goal)
+{
+    if(!doSavePolicy_ || !isLoadedRoadmapIntact())
+        return false;
 
-        assert(currentVertex < boost::num_vertices(g_));
+    PolicyFile policyFile;
 
-        OMPL_INFORM("FIRM: Moving from Vertex %u to %u", currentVertex, boost::target(e, g_));
+    const std::string pathToPolicy = PolicyFile::pathForRoadmap(loadedRoadmapPath_);
 
-        // Check if feedback policy is valid 
-        while(!isFeedbackPolicyValid(currentVertex, goal))
-        {
+    if(!policyFile.load(pathToPolicy, fingerprintPolicy(loadedRoadmapPath_)))
+        return false;
 
-            OMPL_INFORM("FIRM: Invalid path detected from Vertex %u to %u", currentVertex, boost::target(e, g_));
+    const arma::colvec goalVec = stateProperty_[goal]->as<FIRM::StateType>()->getArmaData();
 
-            updateEdgeCollisionCost(currentVertex, goal);
+    const double goalData[3] = {goalVec[0], goalVec[1], goalVec[2]};
 
-            // resolve DP
-            solveDynamicProgram(goal);
+    const PolicyFile::Policy *policy = policyFile.find(goalData);
 
-            e = feedback_[currentVertex];
+    if(!policy || policy->entries.size() != numLoadedVertices_)
+        return false;
 
-            OMPL_INFORM("FIRM: Updated path, moving from Vertex %u to %u", currentVertex, boost::target(e, g_));
-        }
+    std::map<Vertex, double> costToGo;
 
-        double succProb = evaluateSuccessProbability(e, currentVertex, goal);
+    std::map<Vertex, Edge> feedback;
 
-        OMPL_INFORM("FIRM: Moving from Vertex %u to %u with TP = %f", currentVertex, boost::target(e, g_), succProb);
+    foreach(Vertex v, boost::vertices(g_))
+    {
+        if(isVertexAlive(v))
+            costToGo[v] = v == goal ? goalCostToGo_ : initalCostToGo_;
+    }
 
-        successProbabilityHistory_.push_back(std::make_pair(currentTimeStep_, succProb) );
+    for(std::size_t i = 0; i < policy->entries.size(); i++)
+    {
+        const PolicyFile::Entry &entry = policy->entries[i];
 
-        controller = edgeControllers_[e];
+        if(entry.vertex < 0 || (std::size_t)entry.vertex >= numLoadedVertices_ || (entry.next >= 0 && (std::size_t)entry.next >= numLoadedVertices_))
+            return false;
 
-        ompl::base::Cost cost;
+        const Vertex v = entry.vertex;
 
-        int stepsExecuted = 0;
+        if(v == goal)
+            continue;
 
-        int stepsToStop = 0;
+        costToGo[v] = entry.costToGo;
 
-        controller.setSpaceInformation(policyExecutionSI_);
+        if(entry.next == PolicyFile::NEXT_NONE)
+            continue;
 
-        bool controllerStatus = controller.Execute(cstartState, cendState, cost, stepsExecuted, stepsToStop, false);
+        const Vertex next = entry.next == PolicyFile::NEXT_GOAL ? goal : (Vertex)entry.next;
 
-        executionCost_ += cost.value() - ompl::magic::EDGE_COST_BIAS;
+        std::pair<Edge, bool> e = boost::edge(v, next, g_);
 
-        costToGoHistory_.push_back(std::make_pair(currentTimeStep_,executionCost_));
+        if(!e.second)
+        {
+            OMPL_INFORM("FIRM: The policy in %s does not fit the roadmap, solving DP", pathToPolicy.c_str());
+            return false;
+        }
 
-        // get a copy of the true state
-        ompl::base::State *tempTrueStateCopy = si_->allocState();
+        feedback[v] = e.first;
+    }
 
-        siF_->getTrueState(tempTrueStateCopy);
+    costToGo_.swap(costToGo);
 
-        if(!si_->isValid(tempTrueStateCopy))
-        {
-           OMPL_INFORM("Robot Collided :(");
+    feedback_.swap(feedback);
 
-           return;
-        }
+    // the start was added in this run, it gets its feedback from one backup over the saved cost-to-go
+    foreach(Vertex v, boost::vertices(g_))
+    {
+        if(v == goal || boost::out_degree(v, g_) == 0 || feedback_.find(v) != feedback_.end())
+            continue;
 
-        currentTimeStep_ += stepsExecuted;
+        std::pair<Edge,double> candidate = getUpdatedNodeCostToGo(v, goal);
 
-        if(controllerStatus)
-        {
-            numberofNodesReached_++;
+        feedback_[v] = candidate.first;
 
-            nodeReachedHistory_.push_back(std::make_pair(currentTimeStep_, numberofNodesReached_) );
+        costToGo_[v] = candidate.second * discountFactorDP_;
+    }
 
-            currentVertex = boost::target(e, g_);
-        }
-        else
-        {
-            Visualizer::doSaveVideo(false);
-            siF_->doVelocityLogging(false);
+    policyGoalVertex_ = goal;
 
-            //
-            OMPL_INFORM("Controller stopped due to deviation, need to add new state at: ");
-            siF_->printState(cendState);
-            //
+    OMPL_INFORM("FIRM: Restored the policy from %s, no need to solve DP", pathToPolicy.c_str());
 
-            currentVertex = addStateToGraph(cendState);
+    Visualizer::clearMostLikelyPath();
 
-            // Set true state back to its correct value after Monte Carlo (happens during adding state to Graph)
-            siF_->setTrueState(tempTrueStateCopy);
+    sendFeedbackEdgesToViz();
 
-            solveDynamicProgram(goal);
+    Visualizer::setMode(Visualizer::VZRDrawingMode::FeedbackViewMode);
 
-            Visualizer::doSaveVideo(doSaveVideo_);
-            siF_->doVelocityLogging(true);
+    return true;
+}
 
-        }
+FIRM::Vertex FIRM::getQueryVertex(const ompl::base::State *state)
+{
+    const arma::colvec x = state->as<StateType>()->getArmaData();
 
-        si_->freeState(tempTrueStateCopy);
+    const std::tuple<long, long, long> key(std::lround(x[0]/ompl::magic::QUERY_POSE_RESOLUTION),
+                                           std::lround(x[1]/ompl::magic::QUERY_POSE_RESOLUTION),
+                                           std::lround(x[2]/ompl::magic::QUERY_POSE_RESOLUTION));
 
-        si_->copyState(cstartState, cendState);
+    std::map<std::tuple<long, long, long>, QueryVertex>::iterator it = queryVertices_.find(key);
 
+    if(it != queryVertices_.end())
+    {
+        it->second.lastUse = ++queryClock_;
 
+        return it->second.vertex;
     }
 
-    if(doSaveLogs_)
+    // the least recently queried pose gives its node back, so a long running service does not fill the roadmap
+    if(queryVertices_.size() >= ompl::magic::MAX_QUERY_VERTICES)
     {
-        std::vector<std::pair<double, double> > velLog;
+        std::map<std::tuple<long, long, long>, QueryVertex>::iterator oldest = queryVertices_.begin();
 
-        siF_->getVelocityLog(velLog);
-
-        for(int i=0; i < velLog.size(); i++)
+        for(it = queryVertices_.begin(); it != queryVertices_.end(); ++it)
         {
-            //velocityHistory_.push_back(std::make_pair(i, velLog[i].first)); //unicycle
-            velocityHistory_.push_back(std::make_pair(i, sqrt( pow(velLog[i].first,2) + pow(velLog[i].second,2) ))); // omni
+            if(it->second.lastUse < oldest->second.lastUse)
+                oldest = it;
         }
 
-        writeTimeSeriesDataToFile("StandardFIRMCostHistory.csv", "costToGo");
-
-        writeTimeSeriesDataToFile("StandardFIRMSuccessProbabilityHistory.csv", "successProbability");
+        const Vertex released = oldest->second.vertex;
 
-        writeTimeSeriesDataToFile("StandardFIRMNodesReachedHistory.csv","nodesReached");
+        queryVertices_.erase(oldest);
 
-        writeTimeSeriesDataToFile("StandardFIRMVelocityHistory.csv", "velocity");
+        removeVertex(released);
     }
 
-    Visualizer::doSaveVideo(false);
+    const Vertex v = addStateToGraph(si_->cloneState(state), true, true, true);
+
+    QueryVertex queryVertex = {v, ++queryClock_};
 
+    queryVertices_[key] = queryVertex;
+
+    return v;
 }
 
-void FIRM::executeFeedbackWithKidnapping(void)
+FIRM::QueryResult FIRM::query(const ompl::base::State *start, const ompl::base::State *goal)
 {
+    QueryResult result;
 
-    Vertex start = startM_[0];
-    Vertex goal  = goalM_[0] ;
+    result.solved = false;
+    result.successProbability = 0;
+    result.cost = 0;
+    result.cachedPolicy = false;
 
-    ompl::base::State *goalState = si_->cloneState(stateProperty_[goal]);
+    if(!si_->isValid(start) || !si_->isValid(goal))
+    {
+        OMPL_WARN("FIRM: Query start or goal is not valid.");
+        return result;
+    }
 
-    sendMostLikelyPathToViz(start, goal);
+    const Vertex startVertex = getQueryVertex(start);
 
-    siF_->setTrueState(stateProperty_[start]);
-    siF_->setBelief(stateProperty_[start]);
+    const Vertex goalVertex = getQueryVertex(goal);
 
-    Vertex currentVertex =  start;
+    boost::mutex::scoped_lock _(graphMutex_);
 
-    EdgeControllerType controller;
+    if(!sameComponent(startVertex, goalVertex))
+    {
+        OMPL_WARN("FIRM: Query start and goal nodes not in same connected component.");
+        return result;
+    }
 
-    ompl::base::State *cstartState = si_->allocState();
-    si_->copyState(cstartState, stateProperty_[start]);
+    CachedPolicy cached;
 
-    ompl::base::State *cendState = si_->allocState();
+    if(policyCache_.get(goalVertex, cached))
+    {
+        feedback_ = cached.feedback;
 
-    OMPL_INFORM("FIRM: Running policy execution");
+        costToGo_ = cached.costToGo;
 
-    bool kidnapped_flag = false;
+        policyGoalVertex_ = goalVertex;
 
-    int kidnappingCounter  = 0;
+        // nodes added since the policy was solved get one Bellman backup, as for restored policies
+        foreach(Vertex v, boost::vertices(g_))
+        {
+            if(v == goalVertex || boost::out_degree(v, g_) == 0 || feedback_.find(v) != feedback_.end())
+                continue;
 
-    Visualizer::doSaveVideo(doSaveVideo_);
+            std::pair<Edge,double> candidate = getUpdatedNodeCostToGo(v, goalVertex);
 
-    while(!goalState->as<FIRM::StateType>()->isReached(cstartState)/*currentVertex != goal*/)
+            feedback_[v] = candidate.first;
+
+            costToGo_[v] = candidate.second * discountFactorDP_;
+        }
+
+        result.cachedPolicy = true;
+    }
+    else if(!restorePolicy(goalVertex))
     {
+        solveDynamicProgram(goalVertex);
+    }
 
-        if(currentVertex==goal)
-            break;
+    CachedPolicy policy;
 
-        Edge e = feedback_[currentVertex];
+    policy.feedback = feedback_;
 
-        double succProb = evaluateSuccessProbability(e, currentVertex, goal);
+    policy.costToGo = costToGo_;
 
-        OMPL_INFORM("FIRM: Moving from Vertex %u to %u with TP = %f", currentVertex, boost::target(e, g_), succProb);
+    policyCache_.insert(goalVertex, policy, 1);
 
-        successProbabilityHistory_.push_back(std::make_pair(currentTimeStep_, succProb) );
+    result.path.push_back(startVertex);
 
-        controller = edgeControllers_[e];
+    while(result.path.back() != goalVertex)
+    {
+        std::map<Vertex, Edge>::const_iterator f = feedback_.find(result.path.back());
 
-        ompl::base::Cost cost(0);
+        if(f == feedback_.end() || result.path.size() > boost::num_vertices(g_))
+        {
+            OMPL_WARN("FIRM: There is no feedback to guide the query start to its goal.");
+            result.path.clear();
+            return result;
+        }
 
-        int stepsExecuted = 0;
+        result.path.push_back(boost::target(f->second, g_));
+    }
 
-        int stepsToStop = 0;
+    result.solved = true;
 
-        controller.setSpaceInformation(policyExecutionSI_);
+    if(startVertex == goalVertex)
+    {
+        result.successProbability = 1;
+        return result;
+    }
 
-        bool controllerStatus = controller.Execute(cstartState, cendState, cost, stepsExecuted, stepsToStop, false);
+    const Edge firstEdge = feedback_[startVertex];
 
-        executionCost_ += cost.value() - ompl::magic::EDGE_COST_BIAS;
+    result.successProbability = evaluateSuccessProbability(firstEdge, startVertex, goalVertex);
 
-        costToGoHistory_.push_back(std::make_pair(currentTimeStep_,executionCost_));
+    result.cost = costToGo_[startVertex];
 
-         // get a copy of the true state
-        ompl::base::State *tempTrueStateCopy = si_->allocState();
+    // the edge weights are for the stationary belief of the start node, a given belief is simulated along the first edge
+    if(arma::accu(arma::abs(start->as<StateType>()->getCovariance())) > 0)
+    {
+        const FIRMWeight nominal = boost::get(boost::edge_weight, g_, firstEdge);
 
-        siF_->getTrueState(tempTrueStateCopy);
+        EdgeControllerType edgeController = getEdgeController(firstEdge);
 
-        if(!si_->isValid(tempTrueStateCopy))
-        {
-            OMPL_INFORM("Robot Collided :(");
-            return;
-        }
+        const FIRMWeight fromBelief = simulateEdgeController(start, edgeController);
 
-        currentTimeStep_ += stepsExecuted;
+        if(fromBelief.getSuccessProbability() > 0 && nominal.getSuccessProbability() > 0)
+        {
+            // a belief better than the stationary one can push the ratio above 1
+            result.successProbability = std::min(1.0, result.successProbability * fromBelief.getSuccessProbability() / nominal.getSuccessProbability());
+
+            result.cost += fromBelief.getCost() - nominal.getCost();
+        }
+        else
+        {
+            result.successProbability = 0;
+        }
+    }
+
+    return result;
+}
+
+void FIRM::savePolicy(const std::string &pathToRoadmap, std::size_t numRoadmapVertices, const FIRM::Vertex goal)
+{
+    const std::string pathToPolicy = PolicyFile::pathForRoadmap(pathToRoadmap);
+
+    const std::uint64_t fingerprint = fingerprintPolicy(pathToRoadmap);
+
+    // keep the policies for the other goals of the same roadmap
+    PolicyFile policyFile;
+
+    policyFile.load(pathToPolicy, fingerprint);
+
+    policyFile.setFingerprint(fingerprint);
+
+    const arma::colvec goalVec = stateProperty_[goal]->as<FIRM::StateType>()->getArmaData();
+
+    PolicyFile::Policy policy;
+
+    std::copy(goalVec.begin(), goalVec.end(), policy.goal);
+
+    policy.entries.resize(numRoadmapVertices);
+
+    // the saved roadmap numbers the nodes without the removed vertices
+    const std::vector<long> ordinals = vertexOrdinals();
+
+    for(std::size_t v = 0; v < ordinals.size(); v++)
+    {
+        if(ordinals[v] < 0)
+            continue;
+
+        if((std::size_t)ordinals[v] >= numRoadmapVertices)
+            break;
+
+        PolicyFile::Entry &entry = policy.entries[ordinals[v]];
+
+        entry.vertex = ordinals[v];
+
+        entry.next = PolicyFile::NEXT_NONE;
+
+        std::map<Vertex, double>::const_iterator c = costToGo_.find(v);
+
+        entry.costToGo = c != costToGo_.end() ? c->second : initalCostToGo_;
+
+        std::map<Vertex, Edge>::const_iterator f = feedback_.find(v);
+
+        if(v == goal || f == feedback_.end())
+            continue;
+
+        const Vertex next = boost::target(f->second, g_);
+
+        if(ordinals[next] >= 0 && (std::size_t)ordinals[next] < numRoadmapVertices)
+            entry.next = ordinals[next];
+        else if(next == goal)
+            entry.next = PolicyFile::NEXT_GOAL;
+    }
+
+    policyFile.set(policy);
+
+    if(policyFile.save(pathToPolicy))
+        OMPL_INFORM("FIRM: Saved the policy for %lu nodes to %s", (unsigned long)numRoadmapVertices, pathToPolicy.c_str());
+}
+
+double FIRM::evaluateSuccessProbability(const Edge currentEdge, const FIRM::Vertex start, const FIRM::Vertex goal)
+{
+    const FIRMWeight currentEdgeWeight = boost::get(boost::edge_weight, g_, currentEdge);
+
+    double successProb = currentEdgeWeight.getSuccessProbability();
+
+    Vertex v = boost::target(currentEdge, g_);
+
+    while(v != goal)
+    {
+        Edge edge = feedback_[v];
+
+        const FIRMWeight edgeWeight =  boost::get(boost::edge_weight, g_, edge);
+
+        const double transitionProbability  = edgeWeight.getSuccessProbability();
+
+        //OMPL_INFORM("The success probability of edge is %f", transitionProbability);
+
+        successProb = successProb * transitionProbability;
+
+        v = boost::target(edge, g_);
+
+    }
+
+    return successProb;
+}
+
+void FIRM::updateEdgeCollisionCost(FIRM::Vertex currentVertex, FIRM::Vertex goalVertex)
+{
+    // cycle through feedback, update edge costs for edges in collision
+    while(currentVertex != goalVertex)
+    {
+        Edge edge = feedback_[currentVertex]; // get the edge
+
+        Vertex target = boost::target(edge, g_); // get the target of this edge
+
+        // if edge is invalid, increase its cost
+        if(!si_->checkMotion(stateProperty_[currentVertex], stateProperty_[target]))
+        {
+            double pvc1 = weightProperty_[edge].getCost();
+    
+            weightProperty_[edge].setCost(pvc1 + obstacleCostToGo_*10);
+
+            weightProperty_[edge].setSuccessProbability(0.0);
+
+            // Get outgoing edges of target
+            foreach(Edge e, boost::out_edges(target, g_))
+            {
+                // if any outgoing edge is in collision, update its cost
+                if(!si_->checkMotion(stateProperty_[target], stateProperty_[boost::target(e, g_)]))
+                {
+                    double pvc2 = weightProperty_[e].getCost();
+    
+                    weightProperty_[e].setCost(pvc2 + obstacleCostToGo_*10);
+
+                    weightProperty_[e].setSuccessProbability(0.0);
+                }
+            }
+
+        }
+           
+        currentVertex =  target;
+
+    }
+
+}
+
+void FIRM::executeFeedback(void)
+{
+
+    Vertex start = startM_[0];
+    Vertex goal  = goalM_[0] ;
+
+    ompl::base::State *goalState = si_->cloneState(stateProperty_[goal]);
+
+    sendMostLikelyPathToViz(start, goal);
+
+    openExecutionTrace("StandardFIRM");
+
+    runStatistics_.goalReached = false;
+
+    siF_->setTrueState(stateProperty_[start]);
+    siF_->setBelief(stateProperty_[start]);
+
+    Vertex currentVertex =  start;
+
+    EdgeControllerType controller;
+
+    ompl::base::State *cstartState = si_->allocState();
+    si_->copyState(cstartState, stateProperty_[start]);
+
+    ompl::base::State *cendState = si_->allocState();
+
+    OMPL_INFORM("FIRM: Running policy execution");
+
+    Visualizer::doSaveVideo(doSaveVideo_);
+
+    openTimeSeriesLogs("StandardFIRM");
+
+    nodeReachedHistory_.log(currentTimeStep_, numberofNodesReached_);
+
+    siF_->doVelocityLogging(true);
+
+    while(!goalState->as<FIRM::StateType>()->isReached(cstartState))
+    {
+
+        if(currentVertex==goal)
+            break;
+
+        Edge e = feedback_[currentVertex];
+
+        assert(currentVertex < boost::num_vertices(g_));
+
+        OMPL_INFORM("FIRM: Moving from Vertex %u to %u", currentVertex, boost::target(e, g_));
+
+        // Check if feedback policy is valid 
+        while(!isFeedbackPolicyValid(currentVertex, goal))
+        {
+
+            OMPL_INFORM("FIRM: Invalid path detected from Vertex %u to %u", currentVertex, boost::target(e, g_));
+
+            updateEdgeCollisionCost(currentVertex, goal);
+
+            // resolve DP
+            solveDynamicProgram(goal);
+
+            e = feedback_[currentVertex];
+
+            OMPL_INFORM("FIRM: Updated path, moving from Vertex %u to %u", currentVertex, boost::target(e, g_));
+        }
+
+        double succProb = evaluateSuccessProbability(e, currentVertex, goal);
+
+        OMPL_INFORM("FIRM: Moving from Vertex %u to %u with TP = %f", currentVertex, boost::target(e, g_), succProb);
+
+        successProbabilityHistory_.log(currentTimeStep_, succProb);
+
+        if(executionTrace_->isOpen())
+            executionTrace_->recordEdge(currentVertex, boost::target(e, g_), stateProperty_[currentVertex], stateProperty_[boost::target(e, g_)]);
+
+        controller = getEdgeController(e);
+
+        ompl::base::Cost cost;
+
+        int stepsExecuted = 0;
+
+        int stepsToStop = 0;
+
+        controller.setSpaceInformation(policyExecutionSI_);
+
+        bool controllerStatus = controller.Execute(cstartState, cendState, cost, stepsExecuted, stepsToStop, false);
+
+        executionCost_ += cost.value() - ompl::magic::EDGE_COST_BIAS;
+
+        costToGoHistory_.log(currentTimeStep_, executionCost_);
+
+        // get a copy of the true state
+        ompl::base::State *tempTrueStateCopy = si_->allocState();
+
+        siF_->getTrueState(tempTrueStateCopy);
+
+        if(!si_->isValid(tempTrueStateCopy))
+        {
+           OMPL_INFORM("Robot Collided :(");
+
+           runStatistics_.collided = true;
+
+           closeExecutionTrace();
+
+           return;
+        }
+
+        currentTimeStep_ += stepsExecuted;
 
         if(controllerStatus)
         {
+            numberofNodesReached_++;
+
+            nodeReachedHistory_.log(currentTimeStep_, numberofNodesReached_);
+
             currentVertex = boost::target(e, g_);
         }
         else
         {
-
             Visualizer::doSaveVideo(false);
+            siF_->doVelocityLogging(false);
+
+            //
+            OMPL_INFORM("Controller stopped due to deviation, need to add new state at: ");
+            siF_->printState(cendState);
+            //
 
             currentVertex = addStateToGraph(cendState);
 
@@ -1436,650 +2243,1380 @@ void FIRM::executeFeedbackWithKidnapping(void)
             solveDynamicProgram(goal);
 
             Visualizer::doSaveVideo(doSaveVideo_);
+            siF_->doVelocityLogging(true);
 
         }
 
         si_->freeState(tempTrueStateCopy);
 
-        /**
-        1. Check if innovation i.e. change in trace(cov) between start and end state is high
-        2. If the change is high, then switch to lost mode
-        3. Sample modes and run policygen till you converge to one mode
-        4. get back to policy execution
-        */
-        if(si_->distance(cendState,stateProperty_[goal]) < si_->distance(cendState,stateProperty_[start]) && !kidnapped_flag && kidnappingCounter < 1)
-        {
-            std::cout<<"Before Simulated Kidnapping! (Press Enter) \n";
-            //std::cin.get();
-            this->simulateKidnapping();
-            std::cout<<"AFter Simulated Kidnapping! (Press Enter) \n";
-            //std::cin.get();
-            kidnapped_flag = true;
-            kidnappingCounter++;
-        }
+        si_->copyState(cstartState, cendState);
 
-        if(kidnapped_flag) //if(this->detectKidnapping(cstartState, cendState))
-        {
-            recoverLostRobot(cendState);
 
-            siF_->setBelief(cendState);
+    }
+
+    closeTimeSeriesLogs();
+
+    runStatistics_.goalReached = true;
+
+    closeExecutionTrace();
+
+    Visualizer::doSaveVideo(false);
+
+}
+
+void FIRM::executeFeedbackWithKidnapping(void)
+{
+
+    Vertex start = startM_[0];
+    Vertex goal  = goalM_[0] ;
+
+    ompl::base::State *goalState = si_->cloneState(stateProperty_[goal]);
+
+    sendMostLikelyPathToViz(start, goal);
+
+    openExecutionTrace("KidnappingFIRM");
+
+    runStatistics_.goalReached = false;
+
+    siF_->setTrueState(stateProperty_[start]);
+    siF_->setBelief(stateProperty_[start]);
+
+    Vertex currentVertex =  start;
+
+    EdgeControllerType controller;
+
+    ompl::base::State *cstartState = si_->allocState();
+    si_->copyState(cstartState, stateProperty_[start]);
+
+    ompl::base::State *cendState = si_->allocState();
+
+    OMPL_INFORM("FIRM: Running policy execution");
+
+    bool kidnapped_flag = false;
+
+    int kidnappingCounter  = 0;
+
+    Visualizer::doSaveVideo(doSaveVideo_);
+
+    while(!goalState->as<FIRM::StateType>()->isReached(cstartState)/*currentVertex != goal*/)
+    {
+
+        if(currentVertex==goal)
+            break;
+
+        Edge e = feedback_[currentVertex];
+
+        double succProb = evaluateSuccessProbability(e, currentVertex, goal);
+
+        OMPL_INFORM("FIRM: Moving from Vertex %u to %u with TP = %f", currentVertex, boost::target(e, g_), succProb);
+
+        successProbabilityHistory_.log(currentTimeStep_, succProb);
+
+        if(executionTrace_->isOpen())
+            executionTrace_->recordEdge(currentVertex, boost::target(e, g_), stateProperty_[currentVertex], stateProperty_[boost::target(e, g_)]);
+
+        controller = getEdgeController(e);
+
+        ompl::base::Cost cost(0);
+
+        int stepsExecuted = 0;
+
+        int stepsToStop = 0;
+
+        controller.setSpaceInformation(policyExecutionSI_);
+
+        bool controllerStatus = controller.Execute(cstartState, cendState, cost, stepsExecuted, stepsToStop, false);
+
+        executionCost_ += cost.value() - ompl::magic::EDGE_COST_BIAS;
+
+        costToGoHistory_.log(currentTimeStep_, executionCost_);
+
+         // get a copy of the true state
+        ompl::base::State *tempTrueStateCopy = si_->allocState();
+
+        siF_->getTrueState(tempTrueStateCopy);
+
+        if(!si_->isValid(tempTrueStateCopy))
+        {
+            OMPL_INFORM("Robot Collided :(");
+            runStatistics_.collided = true;
+            closeExecutionTrace();
+            return;
+        }
+
+        currentTimeStep_ += stepsExecuted;
+
+        if(controllerStatus)
+        {
+            currentVertex = boost::target(e, g_);
+        }
+        else
+        {
+
+            Visualizer::doSaveVideo(false);
+
+            currentVertex = addStateToGraph(cendState);
+
+            // Set true state back to its correct value after Monte Carlo (happens during adding state to Graph)
+            siF_->setTrueState(tempTrueStateCopy);
+
+            solveDynamicProgram(goal);
+
+            Visualizer::doSaveVideo(doSaveVideo_);
+
+        }
+
+        si_->freeState(tempTrueStateCopy);
+
+        /**
+        1. Check if innovation i.e. change in trace(cov) between start and end state is high
+        2. If the change is high, then switch to lost mode
+        3. Sample modes and run policygen till you converge to one mode
+        4. get back to policy execution
+        */
+        if(si_->distance(cendState,stateProperty_[goal]) < si_->distance(cendState,stateProperty_[start]) && !kidnapped_flag && kidnappingCounter < 1)
+        {
+            std::cout<<"Before Simulated Kidnapping! (Press Enter) \n";
+            //std::cin.get();
+            this->simulateKidnapping();
+            std::cout<<"AFter Simulated Kidnapping! (Press Enter) \n";
+            //std::cin.get();
+            kidnapped_flag = true;
+            kidnappingCounter++;
+        }
+
+        if(kidnapped_flag) //if(this->detectKidnapping(cstartState, cendState))
+        {
+            recoverLostRobot(cendState);
+
+            siF_->setBelief(cendState);
+
+             // get a copy of the true state
+            ompl::base::State *tempTrueStateCopy = si_->allocState();
+
+            siF_->getTrueState(tempTrueStateCopy);
+
+            currentVertex = addStateToGraph(cendState);
+
+            // Set true state back to its correct value after Monte Carlo (happens during adding state to Graph)
+            siF_->setTrueState(tempTrueStateCopy);
+
+            siF_->freeState(tempTrueStateCopy);
+
+            solveDynamicProgram(goal);
+
+            sendMostLikelyPathToViz(currentVertex, goal);
+
+            kidnapped_flag = false;
+        }
+
+        si_->copyState(cstartState, cendState);
+
+    }
+
+    runStatistics_.goalReached = true;
+
+    closeExecutionTrace();
+
+    Visualizer::doSaveVideo(false);
+
+}
+
+// Experimental
+void FIRM::executeFeedbackWithRollout(void)
+{
+
+    // Open a file for writing rollout computation time
+    std::ofstream outfile;
+    if(doSaveLogs_)
+    {
+        outfile.open(logFilePath_+"RolloutComputationTime.csv");
+        outfile<<"RolloutNum, RadiusNN, NumNN, MCParticles, avgTimePerNeighbor, totalTimeSecs" <<std::endl;
+    }
+
+    Visualizer::setMode(Visualizer::VZRDrawingMode::RolloutMode);
+    Visualizer::clearRobotPath();
+
+    const Vertex start = startM_[0];
+    const Vertex goal  = goalM_[0] ;
+
+    sendMostLikelyPathToViz(start, goal) ;
+
+    ompl::base::State *goalState = si_->cloneState(stateProperty_[goal]);
+
+    //===== SET A Custom Init Covariance=====================
+    // using namespace arma;
+
+    // mat tempCC(3,3);
+
+    // tempCC<< 0.1 << 0.0 << 0.0 << endr
+    //         << 0.0 << 0.1 << 0.0 << endr
+    //         << 0.0 << 0.0 << 0.0000001<<endr;
+
+    // stateProperty_[start]->as<StateType>()->setCovariance(tempCC);
+    // Visualizer::updateCurrentBelief(stateProperty_[start]);
+    //================================
+
+    openExecutionTrace("RolloutFIRM");
+
+    runStatistics_.goalReached = false;
+
+    siF_->setTrueState(stateProperty_[start]);
+    siF_->setBelief(stateProperty_[start]);
+
+    Vertex currentVertex =  start;
+
+    ompl::base::State *cstartState = si_->allocState();
+    si_->copyState(cstartState, stateProperty_[start]);
+
+    ompl::base::State *cendState = si_->allocState();
+
+    OMPL_INFORM("FIRM: Running policy execution");
+
+    Edge e = feedback_[currentVertex];
+
+    Vertex tempVertex = currentVertex;
+
+    // tempVertex is a rollout node, it is removed once the edge leaving it has been executed
+    bool isRolloutVertex = false;
+
+    OMPL_INFORM("Goal State is: \n");
+
+    si_->printState(goalState);
+
+    double averageTimeForRolloutComputation = 0;
+
+    int numberOfRollouts = 0;
+
+    Visualizer::doSaveVideo(doSaveVideo_);
+
+    openTimeSeriesLogs("RolloutFIRM");
+
+    nodeReachedHistory_.log(currentTimeStep_, numberofNodesReached_);
+
+    // While the robot state hasn't reached the goal state, keep running
+    while(!goalState->as<FIRM::StateType>()->isReached(cstartState, true))
+    {
+
+        double succProb = evaluateSuccessProbability(e, tempVertex, goal);
+
+        OMPL_INFORM("FIRM Rollout: Moving from Vertex %u to %u with TP = %f", tempVertex, boost::target(e, g_), succProb);
+
+        successProbabilityHistory_.log(currentTimeStep_, succProb);
+
+        if(executionTrace_->isOpen())
+            executionTrace_->recordEdge(tempVertex, boost::target(e, g_), stateProperty_[tempVertex], stateProperty_[boost::target(e, g_)]);
+
+        EdgeControllerType controller = getEdgeController(e);
+
+        assert(controller.getGoal());
+
+        ompl::base::Cost cost;
+
+        siF_->doVelocityLogging(true);
+
+        /**
+            Instead of executing the entire controller, we need to execute N steps, then calculate the cost to go through the neighboring nodes.
+            Whichever gives the lowest cost to go, is our new path. Do this at every N steps.
+        */
+        int stepsExecuted = 0;
+
+        controller.setSpaceInformation(policyExecutionSI_);
+
+        controller.executeUpto(rolloutSteps_, cstartState, cendState, cost, stepsExecuted, false);
+
+        executionCost_ += cost.value() - ompl::magic::EDGE_COST_BIAS;
+
+        costToGoHistory_.log(currentTimeStep_, executionCost_);
+
+        const Vertex edgeTarget = boost::target(e, g_);
+
+        if(isRolloutVertex)
+        {
+            removeVertex(tempVertex);
+
+            isRolloutVertex = false;
+        }
+
+        ompl::base::State *tState = si_->allocState();
+
+        siF_->getTrueState(tState);
+
+        if(!si_->isValid(tState))
+        {
+            OMPL_INFORM("Robot Collided :(");
+            runStatistics_.collided = true;
+            closeExecutionTrace();
+            return;
+        }
+
+        currentTimeStep_ += stepsExecuted;
+
+        // If the robot has already reached a FIRM node then take feedback edge
+        // else do rollout
+        if(stateProperty_[edgeTarget]->as<FIRM::StateType>()->isReached(cendState, true))
+        {
+            OMPL_INFORM("FIRM Rollout: Reached FIRM Node: %u", edgeTarget);
+
+            numberofNodesReached_++;
+
+            nodeReachedHistory_.log(currentTimeStep_, numberofNodesReached_);
+
+            tempVertex = edgeTarget;
+
+            e = feedback_[tempVertex];
+
+        }
+
+        else
+        {
+	    
+            siF_->doVelocityLogging(false);
+
+            Visualizer::doSaveVideo(false);
+
+            // start profiling time to compute rollout
+            auto start_time = std::chrono::high_resolution_clock::now();
+
+            tempVertex = addStateToGraph(si_->cloneState(cendState), false, true, true);
+
+            isRolloutVertex = true;
+
+            siF_->setTrueState(tState);
+
+            e = generateRolloutPolicy(tempVertex, goal);
+
+            // end profiling time to compute rollout
+            auto end_time = std::chrono::high_resolution_clock::now();
+
+            runStatistics_.rolloutDecisions++;
+
+            runStatistics_.rolloutTime += std::chrono::duration<double>(end_time - start_time).count();
+
+            Visualizer::doSaveVideo(doSaveVideo_);
+
+            numberOfRollouts++;
+
+            int numNN = numNearestNeighbors_;
+
+            double timeToDoRollout = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+
+            averageTimeForRolloutComputation +=  timeToDoRollout / numNN;
+
+            if(doSaveLogs_)
+            {
+                outfile<<numberOfRollouts<<","<<NNRadius_<<","
+                   <<numNN<<","<<numMCParticles_<<","<<timeToDoRollout / (1000*numNN)<<","<<timeToDoRollout/1000<<std::endl;
+            }
+
+            std::cout << "Time to execute rollout : "<<timeToDoRollout << " milli seconds."<<std::endl;
+
+            showRolloutConnections(tempVertex);
+
+            if(executionTrace_->isOpen())
+            {
+                std::vector<const ompl::base::State*> candidates;
+
+                foreach (Vertex n, connectionStrategy_(tempVertex))
+                {
+                    candidates.push_back(stateProperty_[n]);
+                }
+
+                executionTrace_->recordRollout(stateProperty_[tempVertex], candidates, stateProperty_[boost::target(e,g_)]);
+            }
+
+            // clear the rollout candidate connection drawings and show the selected edge
+            Visualizer::clearRolloutConnections();
+
+            Visualizer::setChosenRolloutConnection(stateProperty_[tempVertex], stateProperty_[boost::target(e,g_)]);
+
+        }
+
+        si_->freeState(tState);
+
+        si_->copyState(cstartState, cendState);
+
+    }
+
+    if(isRolloutVertex)
+        removeVertex(tempVertex);
+
+    nodeReachedHistory_.log(currentTimeStep_, numberofNodesReached_);
+
+    OMPL_INFORM("FIRM: Number of nodes reached with Rollout: %u", numberofNodesReached_);
+
+    averageTimeForRolloutComputation = averageTimeForRolloutComputation / (1000*numberOfRollouts);
+
+    std::cout<<"Nearest Neighbor Radius: "<<NNRadius_<<", Monte Carlo Particles: "<<numMCParticles_<<", Avg Time/neighbor (seconds): "<<averageTimeForRolloutComputation<<std::endl;    
+
+    if(doSaveLogs_)
+    {
+
+        outfile.close();
+    }
+
+    closeTimeSeriesLogs();
+
+    runStatistics_.goalReached = true;
+
+    closeExecutionTrace();
+
+    Visualizer::doSaveVideo(false);
+
+
+}
+
+void FIRM::showRolloutConnections(const FIRM::Vertex v)
+{
+    Visualizer::clearRolloutConnections();
+
+    const std::vector<Vertex>& neighbors = connectionStrategy_(v);
+
+    foreach (Vertex n, neighbors)
+    {
+        Visualizer::addRolloutConnection(stateProperty_[v], stateProperty_[n]);
+    }
+
+    FIRMUtils::waitForViewer(50);
+}
+
+void FIRM::addStateToVisualization(const ompl::base::State *state)
+{
+    Visualizer::addState(state);
+}
+
+void FIRM::sendFeedbackEdgesToViz()
+{
+    Visualizer::ClearFeedbackEdges();
+
+    for(typename std::map<Vertex, Edge>::const_iterator i=feedback_.begin(), e=feedback_.end(); i!=e; ++i)
+    {
+        Vertex sourceVertex, targetVertex;
+        Edge edge;
+        sourceVertex = i->first;
+        edge = i->second;
+        targetVertex = boost::target(edge, g_);
+        //OMPL_INFORM("FIRM: MLP from Vertex %u to %u", sourceVertex,targetVertex);
+        Visualizer::addFeedbackEdge(stateProperty_[sourceVertex], stateProperty_[targetVertex], 0);
+    }
+
+}
+
+void FIRM::sendMostLikelyPathToViz(const FIRM::Vertex start, const FIRM::Vertex goal)
+{
+    Visualizer::clearMostLikelyPath();
+
+    Vertex v = start;
+
+    while(v != goal)
+    {
+        Vertex targetVertex;
+
+        Edge edge = feedback_[v];
+
+        targetVertex = boost::target(edge, g_);
+
+        OMPL_INFORM("Most Likely Path from %u to %u", v, targetVertex);
+        
+        Visualizer::addMostLikelyPathEdge(stateProperty_[v], stateProperty_[targetVertex]);
+
+        v = targetVertex;
+    }
+}
+
+bool FIRM::isFeedbackPolicyValid(FIRM::Vertex currentVertex, FIRM::Vertex goalVertex)
+{
+    // cycle through feedback, if feedback edge is invalid, return false
+    while(currentVertex != goalVertex)
+    {
+        Edge edge = feedback_[currentVertex]; // get the edge
+
+        Vertex target = boost::target(edge, g_); // get the target of this edge
+
+        // if edge is invalid, increase its cost
+        if(!si_->checkMotion(stateProperty_[currentVertex], stateProperty_[target]))
+        {
+            return false;
+        }
+           
+        currentVertex =  target;
+
+    }
+
+    return true;
+
+}
+
+FIRM::Edge FIRM::generateRolloutPolicy(const FIRM::Vertex currentVertex, const FIRM::Vertex goal)
+{
+    /**
+        For the given node, find the out edges and see the total cost of taking that edge
+        The cost of taking the edge is cost to go from the target of the edge + the cost of the edge itself
+    */
+    FIRM_PROFILE_SCOPE("FIRM::rolloutDecision");
+
+    double minCost = std::numeric_limits<double>::max();
+    Edge edgeToTake;
+
+    // Iterate over the out edges
+    foreach(Edge e, boost::out_edges(currentVertex, g_))
+    {
+
+        // Get the target node of the edge
+        Vertex targetNode = boost::target(e, g_);  
+
+        // The FIRM edge to take from the target node
+        Edge nextFIRMEdge = feedback_[targetNode];
+
+        // The node to which next firm edge goes
+        Vertex targetOfNextFIRMEdge = boost::target(nextFIRMEdge, g_);
+
+        // Check if feedback from target to goal is valid or not
+        if(!isFeedbackPolicyValid(targetNode, goal))
+        {
+
+            OMPL_INFORM("Rollout: Invalid path detected from Vertex %u to %u", targetNode, targetOfNextFIRMEdge);
+
+            updateEdgeCollisionCost(targetNode, goal);
+
+            // resolve DP
+            solveDynamicProgram(goal);
+
+            targetOfNextFIRMEdge = boost::target(feedback_[targetNode], g_);  
+
+            OMPL_INFORM("Rollout: Updated path, next firm edge moving from Vertex %u to %u", targetNode, targetOfNextFIRMEdge);
+
+        }
+
+        // The cost to go from the target node
+        double nextNodeCostToGo = costToGo_[targetNode];
+
+        // Find the weight of the edge
+        FIRMWeight edgeWeight =  boost::get(boost::edge_weight, g_, e);
+
+        // The transition prob of the edge
+        double transitionProbability = edgeWeight.getSuccessProbability();        
+        
+        // compute distance from goal to target
+        //arma::colvec targetToGoalVec = stateProperty_[goal]->as<FIRM::StateType>()->getArmaData() - stateProperty_[targetNode]->as<FIRM::StateType>()->getArmaData();
+        //double distToGoalFromTarget = arma::norm(targetToGoalVec.subvec(0,1),2); 
+
+        // the cost of taking the edge
+        double edgeCostToGo = transitionProbability*nextNodeCostToGo + (1-transitionProbability)*obstacleCostToGo_ + edgeWeight.getCost();
+
+        if(edgeCostToGo < minCost)
+        {
+            minCost  = edgeCostToGo;
+            edgeToTake = e;
+
+        }
 
-             // get a copy of the true state
-            ompl::base::State *tempTrueStateCopy = si_->allocState();
 
-            siF_->getTrueState(tempTrueStateCopy);
+    }
 
-            currentVertex = addStateToGraph(cendState);
+    return edgeToTake;
+}
 
-            // Set true state back to its correct value after Monte Carlo (happens during adding state to Graph)
-            siF_->setTrueState(tempTrueStateCopy);
+void FIRM::simulateKidnapping()
+{
+    siF_->setTrueState(kidnappedState_);
+}
 
-            siF_->freeState(tempTrueStateCopy);
+bool FIRM::detectKidnapping(ompl::base::State *previousState, ompl::base::State *newState)
+{
 
-            solveDynamicProgram(goal);
+    using namespace arma;
 
-            sendMostLikelyPathToViz(currentVertex, goal);
+    mat previousCov = previousState->as<FIRM::StateType>()->getCovariance();
 
-            kidnapped_flag = false;
-        }
+    mat newCov = newState->as<FIRM::StateType>()->getCovariance();
 
-        si_->copyState(cstartState, cendState);
+    double innovSignal = (trace(newCov) - trace(previousCov)) / trace(previousCov);
 
+    if(innovSignal >= ompl::magic::KIDNAPPING_INNOVATION_CHANGE_THRESHOLD )
+    {
+        return true;
     }
 
-    Visualizer::doSaveVideo(false);
+    return false;
 
 }
 
-// Experimental
-void FIRM::executeFeedbackWithRollout(void)
+void FIRM::savePlannerData()
 {
+    std::string roadmapFileName;
 
-    // Open a file for writing rollout computation time
-    std::ofstream outfile;
-    if(doSaveLogs_)
+    if(!saveRoadmapAsXML_)
     {
-        outfile.open(logFilePath_+"RolloutComputationTime.csv");
-        outfile<<"RolloutNum, RadiusNN, NumNN, MCParticles, avgTimePerNeighbor, totalTimeSecs" <<std::endl;
+        namespace pt = boost::posix_time;
+
+        std::string timeStamp(to_iso_string(pt::second_clock::local_time()));
+
+        roadmapFileName = "FIRMRoadMap-" + timeStamp + ".firm";
+
+        if(!saveRoadMapToBinaryFile(roadmapFileName))
+            return;
+    }
+    else
+    {
+        roadmapFileName = saveRoadMapToXMLFile();
     }
 
-    Visualizer::setMode(Visualizer::VZRDrawingMode::RolloutMode);
-    Visualizer::clearRobotPath();
+    if(doSavePolicy_ && !feedback_.empty())
+    {
+        savePolicy(roadmapFileName, milestoneCount(), policyGoalVertex_);
+    }
 
-    const Vertex start = startM_[0];
-    const Vertex goal  = goalM_[0] ;
+    // the observability map is only valid for this roadmap's landmarks, keep the two together
+    if(siF_->getObservabilityMap() && !siF_->getObservabilityMap()->isEmpty())
+    {
+        siF_->getObservabilityMap()->save(ObservabilityMap::pathForRoadmap(roadmapFileName));
+    }
+}
 
-    sendMostLikelyPathToViz(start, goal) ;
+std::string FIRM::saveRoadMapToXMLFile()
+{
+    std::vector<std::pair<int,std::pair<arma::colvec,arma::mat> > > nodes;
 
-    ompl::base::State *goalState = si_->cloneState(stateProperty_[goal]);
+    // removed vertices leave gaps in the vertex ids, the file numbers the nodes without them
+    const std::vector<long> ordinals = vertexOrdinals();
 
-    //===== SET A Custom Init Covariance=====================
-    // using namespace arma;
+    foreach(Vertex v, boost::vertices(g_))
+    {
+        if(ordinals[v] < 0)
+            continue;
 
-    // mat tempCC(3,3);
+        arma::colvec xVec = stateProperty_[v]->as<FIRM::StateType>()->getArmaData();
 
-    // tempCC<< 0.1 << 0.0 << 0.0 << endr
-    //         << 0.0 << 0.1 << 0.0 << endr
-    //         << 0.0 << 0.0 << 0.0000001<<endr;
+        arma::mat cov = stateProperty_[v]->as<FIRM::StateType>()->getCovariance();
 
-    // stateProperty_[start]->as<StateType>()->setCovariance(tempCC);
-    // Visualizer::updateCurrentBelief(stateProperty_[start]);
-    //================================
+        std::pair<int,std::pair<arma::colvec,arma::mat> > nodeToWrite = std::make_pair(ordinals[v], std::make_pair(xVec, cov)) ;
 
-    siF_->setTrueState(stateProperty_[start]);
-    siF_->setBelief(stateProperty_[start]);
+        nodes.push_back(nodeToWrite);
 
-    Vertex currentVertex =  start;
+    }
 
-    ompl::base::State *cstartState = si_->allocState();
-    si_->copyState(cstartState, stateProperty_[start]);
+    std::vector<std::pair<std::pair<int,int>,FIRMWeight> > edgeWeights;
 
-    ompl::base::State *cendState = si_->allocState();
+    foreach(Edge e, boost::edges(g_))
+    {
+        const long start = ordinals[boost::source(e,g_)];
+        const long goal  = ordinals[boost::target(e,g_)];
 
-    OMPL_INFORM("FIRM: Running policy execution");
+        const FIRMWeight w = boost::get(boost::edge_weight, g_, e);
 
-    Edge e = feedback_[currentVertex];
+        edgeWeights.push_back(std::make_pair(std::make_pair(start,goal),w));
 
-    Vertex tempVertex = currentVertex;
+    }
 
-    OMPL_INFORM("Goal State is: \n");
+    return FIRMUtils::writeFIRMGraphToXML(nodes, edgeWeights);
+}
 
-    si_->printState(goalState);
+bool FIRM::saveRoadMapToBinaryFile(const std::string &pathToFile)
+{
+    const unsigned int stateDim = si_->getStateDimension();
 
-    double averageTimeForRolloutComputation = 0;
+    const unsigned int controlDim = siF_->getMotionModel()->controlDim();
 
-    int numberOfRollouts = 0;
+    std::vector<RoadmapFile::Node> nodes;
 
-    Visualizer::doSaveVideo(doSaveVideo_);
+    std::vector<RoadmapFile::Edge> edges;
 
-    nodeReachedHistory_.push_back(std::make_pair(currentTimeStep_, numberofNodesReached_) );
+    std::vector<double> trajectories;
 
-    // While the robot state hasn't reached the goal state, keep running
-    while(!goalState->as<FIRM::StateType>()->isReached(cstartState, true))
+    nodes.reserve(milestoneCount());
+
+    edges.reserve(boost::num_edges(g_));
+
+    // removed vertices leave gaps in the vertex ids, the file numbers the nodes without them
+    const std::vector<long> ordinals = vertexOrdinals();
+
+    foreach(Vertex v, boost::vertices(g_))
     {
+        if(ordinals[v] < 0)
+            continue;
 
-        double succProb = evaluateSuccessProbability(e, tempVertex, goal);
+        const FIRM::StateType *state = stateProperty_[v]->as<FIRM::StateType>();
 
-        OMPL_INFORM("FIRM Rollout: Moving from Vertex %u to %u with TP = %f", tempVertex, boost::target(e, g_), succProb);
+        arma::colvec xVec = state->getArmaData();
 
-        successProbabilityHistory_.push_back(std::make_pair(currentTimeStep_, succProb ) );
+        arma::mat cov = state->getCovariance();
 
-        EdgeControllerType controller = edgeControllers_[e];
+        assert(xVec.n_elem == 3 && cov.n_elem == 9);
 
-        assert(controller.getGoal());
+        RoadmapFile::Node node;
 
-        ompl::base::Cost cost;
+        node.id = ordinals[v];
 
-        siF_->doVelocityLogging(true);
+        std::copy(xVec.begin(), xVec.end(), node.state);
 
-        /**
-            Instead of executing the entire controller, we need to execute N steps, then calculate the cost to go through the neighboring nodes.
-            Whichever gives the lowest cost to go, is our new path. Do this at every N steps.
-        */
-        int stepsExecuted = 0;
+        // armadillo is column-major, so is the file
+        std::copy(cov.begin(), cov.end(), node.covariance);
 
-        controller.setSpaceInformation(policyExecutionSI_);
+        nodes.push_back(node);
+    }
 
-        controller.executeUpto(rolloutSteps_, cstartState, cendState, cost, stepsExecuted, false);
+    std::vector<arma::colvec> nominalXs, nominalUs;
 
-        executionCost_ += cost.value() - ompl::magic::EDGE_COST_BIAS;
+    foreach(Edge e, boost::edges(g_))
+    {
+        const FIRMWeight w = boost::get(boost::edge_weight, g_, e);
 
-        costToGoHistory_.push_back(std::make_pair(currentTimeStep_, executionCost_));
+        RoadmapFile::Edge edge;
 
-        ompl::base::State *tState = si_->allocState();
+        edge.source = ordinals[boost::source(e, g_)];
+        edge.target = ordinals[boost::target(e, g_)];
+        edge.cost = w.getCost();
+        edge.successProbability = w.getSuccessProbability();
+        edge.trajectoryOffset = trajectories.size();
+        edge.trajectoryLength = 0;
 
-        siF_->getTrueState(tState);
+        // edges that are not cached are built just for saving, without pushing the cached ones out
+        EdgeControllerType controller;
 
-        if(!si_->isValid(tState))
+        if(!edgeControllers_.get(e, controller))
+            materializeEdgeController(e, controller);
+
+        if(controller.Length() > 0)
         {
-            OMPL_INFORM("Robot Collided :(");
-            return;
-        }
+            controller.getNominalTrajectory(nominalXs, nominalUs);
 
-        currentTimeStep_ += stepsExecuted;
+            edge.trajectoryLength = nominalXs.size();
 
-        // If the robot has already reached a FIRM node then take feedback edge
-        // else do rollout
-        if(stateProperty_[boost::target(e,g_)]->as<FIRM::StateType>()->isReached(cendState, true))
-        {
-            OMPL_INFORM("FIRM Rollout: Reached FIRM Node: %u", boost::target(e,g_));
+            for(size_t i = 0; i < nominalXs.size(); i++)
+                trajectories.insert(trajectories.end(), nominalXs[i].begin(), nominalXs[i].end());
 
-            numberofNodesReached_++;
+            for(size_t i = 0; i < nominalUs.size(); i++)
+                trajectories.insert(trajectories.end(), nominalUs[i].begin(), nominalUs[i].end());
+        }
 
-            nodeReachedHistory_.push_back(std::make_pair(currentTimeStep_, numberofNodesReached_) );
+        edges.push_back(edge);
+    }
 
-            tempVertex = boost::target(e,g_);
+    if(!RoadmapFile::write(pathToFile, stateDim, controlDim, nodes, edges, trajectories, environmentStamp_.get()))
+        return false;
 
-            e = feedback_[tempVertex];
+    OMPL_INFORM("FIRM: Saved %lu nodes and %lu edges to %s", (unsigned long)nodes.size(), (unsigned long)edges.size(), pathToFile.c_str());
 
-        }
+    return true;
+}
 
-        else
-        {
-	    
-            siF_->doVelocityLogging(false);
 
-            Visualizer::doSaveVideo(false);
+void FIRM::loadRoadMapFromFile(const std::string &pathToFile)
+{
+    const std::size_t numVerticesBefore = boost::num_vertices(g_);
 
-            // start profiling time to compute rollout
-            auto start_time = std::chrono::high_resolution_clock::now();
+    if(RoadmapFile::isRoadmapFile(pathToFile))
+    {
+        loadRoadMapFromBinaryFile(pathToFile);
+    }
+    else
+    {
+        loadRoadMapFromXMLFile(pathToFile);
+    }
 
-            tempVertex = addStateToGraph(cendState, false);
+    // saved policies refer to the roadmap nodes by vertex id, which only holds if the roadmap was loaded into an empty graph
+    if(numVerticesBefore == 0 && boost::num_vertices(g_) > 0)
+    {
+        loadedRoadmapPath_ = pathToFile;
 
-            siF_->setTrueState(tState);
+        numLoadedVertices_ = boost::num_vertices(g_);
+    }
+}
 
-            e = generateRolloutPolicy(tempVertex, goal);
+void FIRM::loadRoadMapFromXMLFile(const std::string &pathToFile)
+{
+    std::vector<std::pair<int, arma::colvec> > FIRMNodePosList;
+    std::vector<std::pair<int, arma::mat> > FIRMNodeCovarianceList;
+    std::vector<std::pair<std::pair<int,int>,FIRMWeight> > edgeProperties;
 
-            // end profiling time to compute rollout
-            auto end_time = std::chrono::high_resolution_clock::now();
+    if(!FIRMUtils::readFIRMGraphFromXML(pathToFile,  FIRMNodePosList, FIRMNodeCovarianceList , edgeProperties))
+        return;
 
-            Visualizer::doSaveVideo(doSaveVideo_);
+    loadedRoadmapFromFile_ = true;
 
-            numberOfRollouts++;
+    this->setup();
 
-            int numNN = numNearestNeighbors_;
+    std::vector<ompl::base::State*> states(FIRMNodePosList.size());
 
-            double timeToDoRollout = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+    for(int i = 0; i < FIRMNodePosList.size() ; i++)
+    {
+        assert(FIRMNodePosList[i].first == i && "IDS DONT MATCH !!");
 
-            averageTimeForRolloutComputation +=  timeToDoRollout / numNN;
+        states[i] = siF_->allocState();
 
-            if(doSaveLogs_)
-            {
-                outfile<<numberOfRollouts<<","<<NNRadius_<<","
-                   <<numNN<<","<<numMCParticles_<<","<<timeToDoRollout / (1000*numNN)<<","<<timeToDoRollout/1000<<std::endl;
-            }
+        states[i]->as<FIRM::StateType>()->setArmaData(FIRMNodePosList[i].second);
+        states[i]->as<FIRM::StateType>()->setCovariance(FIRMNodeCovarianceList[i].second);
+    }
 
-            std::cout << "Time to execute rollout : "<<timeToDoRollout << " milli seconds."<<std::endl;
+    // the stationary covariance of every node is solved for again, one DARE per node, spread over all cores
+    std::vector<NodeControllerType> nodeControllers(states.size());
 
-            showRolloutConnections(tempVertex);
+    FIRMUtils::parallelFor(states.size(), [&](std::size_t i)
+    {
+        generateNodeController(states[i], nodeControllers[i]);
+    });
 
-            // clear the rollout candidate connection drawings and show the selected edge
-            Visualizer::clearRolloutConnections();
+    // edge controllers are built after the nodes since they copy the target node's covariance,
+    // with a memory budget they are left to be built on first use
+    std::vector<EdgeControllerType> edgeControllers;
 
-            Visualizer::setChosenRolloutConnection(stateProperty_[tempVertex], stateProperty_[boost::target(e,g_)]);
+    if(edgeControllers_.getBudget() == 0)
+    {
+        edgeControllers.resize(edgeProperties.size());
+
+        FIRMUtils::parallelFor(edgeProperties.size(), [&](std::size_t i)
+        {
+            generateEdgeController(states[edgeProperties[i].first.first], states[edgeProperties[i].first.second], edgeControllers[i]);
+        });
+    }
 
-            boost::remove_vertex(tempVertex, g_);
+    addLoadedRoadmapToGraph(states, nodeControllers, edgeProperties, edgeControllers);
+}
 
-        }
+void FIRM::loadRoadMapFromBinaryFile(const std::string &pathToFile)
+{
+    std::shared_ptr<RoadmapFile> roadmapFilePtr = std::make_shared<RoadmapFile>();
 
-        si_->freeState(tState);
+    const RoadmapFile &roadmapFile = *roadmapFilePtr;
 
-        si_->copyState(cstartState, cendState);
+    if(!roadmapFilePtr->map(pathToFile))
+    {
+        OMPL_INFORM("FIRM: Could not load roadmap from %s. Need to construct graph.", pathToFile.c_str());
+        return;
+    }
 
+    if(roadmapFile.getStateDimension() != si_->getStateDimension() || roadmapFile.getControlDimension() != siF_->getMotionModel()->controlDim())
+    {
+        OMPL_ERROR("FIRM: Roadmap %s was built for a different state/control space. Need to construct graph.", pathToFile.c_str());
+        return;
     }
 
-    nodeReachedHistory_.push_back(std::make_pair(currentTimeStep_, numberofNodesReached_) );
+    loadedRoadmapFromFile_ = true;
 
-    OMPL_INFORM("FIRM: Number of nodes reached with Rollout: %u", numberofNodesReached_);
+    this->setup();
 
-    averageTimeForRolloutComputation = averageTimeForRolloutComputation / (1000*numberOfRollouts);
+    std::vector<ompl::base::State*> states(roadmapFile.getNumNodes());
 
-    std::cout<<"Nearest Neighbor Radius: "<<NNRadius_<<", Monte Carlo Particles: "<<numMCParticles_<<", Avg Time/neighbor (seconds): "<<averageTimeForRolloutComputation<<std::endl;    
+    for(std::size_t i = 0; i < roadmapFile.getNumNodes(); i++)
+    {
+        const RoadmapFile::Node &node = roadmapFile.getNode(i);
 
-    if(doSaveLogs_)
+        assert(node.id == (std::int64_t)i && "IDS DONT MATCH !!");
+
+        states[i] = siF_->allocState();
+
+        states[i]->as<FIRM::StateType>()->setArmaData(arma::colvec(node.state, 3));
+        states[i]->as<FIRM::StateType>()->setCovariance(arma::mat(node.covariance, 3, 3));
+    }
+
+    std::vector<std::pair<std::pair<int,int>,FIRMWeight> > edgeProperties(roadmapFile.getNumEdges());
+
+    std::vector<std::size_t> edgeRecords(roadmapFile.getNumEdges());
+
+    for(std::size_t i = 0; i < roadmapFile.getNumEdges(); i++)
     {
+        const RoadmapFile::Edge &edge = roadmapFile.getEdge(i);
 
-        outfile.close();
+        edgeProperties[i] = std::make_pair(std::make_pair((int)edge.source, (int)edge.target), FIRMWeight(edge.cost, edge.successProbability));
+
+        edgeRecords[i] = i;
+    }
 
-        writeTimeSeriesDataToFile("RolloutFIRMCostHistory.csv", "costToGo");
+    const bool regenerateEdgeControllers = updateLoadedRoadmap(pathToFile, roadmapFile, states, edgeProperties, edgeRecords);
 
-        writeTimeSeriesDataToFile("RolloutFIRMSuccessProbabilityHistory.csv", "successProbability");
+    // the stationary covariance comes from the file, no need to solve for it again
+    std::vector<NodeControllerType> nodeControllers(states.size());
 
-        writeTimeSeriesDataToFile("RolloutFIRMNodesReachedHistory.csv","nodesReached");
+    FIRMUtils::parallelFor(states.size(), [&](std::size_t i)
+    {
+        createNodeController(states[i], nodeControllers[i]);
+    });
 
-        std::vector<std::pair<double, double> > velLog;
+    // with a memory budget the edge controllers are restored from the mapped file on first use
+    std::vector<EdgeControllerType> edgeControllers;
 
-        siF_->getVelocityLog(velLog);
+    if(edgeControllers_.getBudget() == 0)
+    {
+        edgeControllers.resize(edgeProperties.size());
 
-        for(int i=0; i < velLog.size(); i++)
+        FIRMUtils::parallelFor(edgeProperties.size(), [&](std::size_t i)
         {
-            velocityHistory_.push_back(std::make_pair(i, sqrt( pow(velLog[i].first,2) + pow(velLog[i].second,2) ))); // omni
-            //velocityHistory_.push_back(std::make_pair(i, velLog[i].first)); // unicycle
-        }
+            const RoadmapFile::Edge &edge = roadmapFile.getEdge(edgeRecords[i]);
 
-        writeTimeSeriesDataToFile("RolloutFIRMVelocityHistory.csv", "velocity");
+            const ompl::base::State *source = states[edgeProperties[i].first.first];
+
+            const ompl::base::State *target = states[edgeProperties[i].first.second];
+
+            if(edge.trajectoryLength > 0 && !regenerateEdgeControllers)
+            {
+                restoreEdgeController(target, roadmapFile, edge, edgeControllers[i]);
+            }
+            else
+            {
+                generateEdgeController(source, target, edgeControllers[i]);
+            }
+        });
     }
 
-    Visualizer::doSaveVideo(false);
+    const unsigned int firstEdgeID = maxEdgeID_;
 
+    addLoadedRoadmapToGraph(states, nodeControllers, edgeProperties, edgeControllers);
 
+    // remember where every edge is stored, so its controller can be rebuilt after it is evicted
+    roadmapFileEdgeRecords_.resize(maxEdgeID_, -1);
+
+    for(std::size_t i = 0; i < edgeProperties.size(); i++)
+        roadmapFileEdgeRecords_[firstEdgeID + i] = regenerateEdgeControllers ? -1 : (long)edgeRecords[i];
+
+    loadedRoadmapFile_ = roadmapFilePtr;
+
+    OMPL_INFORM("FIRM: Loaded %lu nodes and %lu edges from %s", (unsigned long)states.size(), (unsigned long)edgeProperties.size(), pathToFile.c_str());
 }
 
-void FIRM::showRolloutConnections(const FIRM::Vertex v)
+bool FIRM::updateLoadedRoadmap(const std::string &pathToFile, const RoadmapFile &roadmapFile, std::vector<ompl::base::State*> &states,
+                               std::vector<std::pair<std::pair<int,int>,FIRMWeight> > &edgeProperties, std::vector<std::size_t> &edgeRecords)
 {
-    Visualizer::clearRolloutConnections();
+    if(!environmentStamp_)
+        return false;
 
-    const std::vector<Vertex>& neighbors = connectionStrategy_(v);
+    EnvironmentStamp savedStamp;
 
-    foreach (Vertex n, neighbors)
+    if(!roadmapFile.getEnvironmentStamp(savedStamp))
     {
-        Visualizer::addRolloutConnection(stateProperty_[v], stateProperty_[n]);
+        OMPL_WARN("FIRM: Roadmap %s has no environment stamp, it is used as it is", pathToFile.c_str());
+        return false;
     }
 
-    boost::this_thread::sleep(boost::posix_time::milliseconds(50));
-}
+    if(savedStamp.matches(*environmentStamp_))
+        return false;
 
-void FIRM::addStateToVisualization(const ompl::base::State *state)
-{
-    Visualizer::addState(state);
-}
+    const std::string pathToDelta = RoadmapDelta::pathForRoadmap(pathToFile);
 
-void FIRM::sendFeedbackEdgesToViz()
-{
-    Visualizer::ClearFeedbackEdges();
+    const std::uint64_t roadmapHash = FIRMUtils::hashFileContents(pathToFile);
 
-    for(typename std::map<Vertex, Edge>::const_iterator i=feedback_.begin(), e=feedback_.end(); i!=e; ++i)
+    const std::uint64_t environmentHash = environmentStamp_->getCombinedHash();
+
+    RoadmapDelta delta;
+
+    if(delta.load(pathToDelta) && delta.appliesTo(roadmapHash, environmentHash))
     {
-        Vertex sourceVertex, targetVertex;
-        Edge edge;
-        sourceVertex = i->first;
-        edge = i->second;
-        targetVertex = boost::target(edge, g_);
-        //OMPL_INFORM("FIRM: MLP from Vertex %u to %u", sourceVertex,targetVertex);
-        Visualizer::addFeedbackEdge(stateProperty_[sourceVertex], stateProperty_[targetVertex], 0);
+        OMPL_INFORM("FIRM: Environment changed since %s was saved, applying %s", pathToFile.c_str(), pathToDelta.c_str());
     }
+    else
+    {
+        OMPL_INFORM("FIRM: Environment changed since %s was saved, updating the affected nodes and edges", pathToFile.c_str());
 
-}
+        delta = RoadmapDelta();
 
-void FIRM::sendMostLikelyPathToViz(const FIRM::Vertex start, const FIRM::Vertex goal)
-{
-    Visualizer::clearMostLikelyPath();
+        delta.baseRoadmapHash = roadmapHash;
+
+        delta.environmentHash = environmentHash;
 
-    Vertex v = start;
+        computeRoadmapDelta(roadmapFile, environmentStamp_->diff(savedStamp), states, delta);
 
-    while(v != goal)
+        delta.save(pathToDelta);
+    }
+
+    for(std::size_t i = 0; i < delta.updatedNodes.size(); i++)
     {
-        Vertex targetVertex;
+        if(delta.updatedNodes[i].id < states.size())
+            states[delta.updatedNodes[i].id]->as<FIRM::StateType>()->setCovariance(delta.updatedNodes[i].covariance);
+    }
 
-        Edge edge = feedback_[v];
+    for(std::size_t i = 0; i < delta.updatedEdges.size(); i++)
+    {
+        const RoadmapDelta::EdgeUpdate &update = delta.updatedEdges[i];
 
-        targetVertex = boost::target(edge, g_);
+        if(update.index < edgeProperties.size())
+            edgeProperties[update.index].second = FIRMWeight(update.cost, update.successProbability);
+    }
 
-        OMPL_INFORM("Most Likely Path from %u to %u", v, targetVertex);
-        
-        Visualizer::addMostLikelyPathEdge(stateProperty_[v], stateProperty_[targetVertex]);
+    std::vector<bool> nodeRemoved(states.size(), false);
 
-        v = targetVertex;
+    std::vector<bool> edgeRemoved(edgeProperties.size(), false);
+
+    for(std::size_t i = 0; i < delta.removedNodes.size(); i++)
+    {
+        if(delta.removedNodes[i] < states.size())
+            nodeRemoved[delta.removedNodes[i]] = true;
     }
-}
 
-bool FIRM::isFeedbackPolicyValid(FIRM::Vertex currentVertex, FIRM::Vertex goalVertex)
-{
-    // cycle through feedback, if feedback edge is invalid, return false
-    while(currentVertex != goalVertex)
+    for(std::size_t i = 0; i < delta.removedEdges.size(); i++)
     {
-        Edge edge = feedback_[currentVertex]; // get the edge
+        if(delta.removedEdges[i] < edgeProperties.size())
+            edgeRemoved[delta.removedEdges[i]] = true;
+    }
 
-        Vertex target = boost::target(edge, g_); // get the target of this edge
+    // node i has to become vertex i, so the ids of the remaining nodes are compacted
+    std::vector<int> newNodeID(states.size(), -1);
 
-        // if edge is invalid, increase its cost
-        if(!si_->checkMotion(stateProperty_[currentVertex], stateProperty_[target]))
+    std::vector<ompl::base::State*> keptStates;
+
+    for(std::size_t i = 0; i < states.size(); i++)
+    {
+        if(nodeRemoved[i])
         {
-            return false;
+            siF_->freeState(states[i]);
+            continue;
         }
-           
-        currentVertex =  target;
 
-    }
+        newNodeID[i] = keptStates.size();
 
-    return true;
+        keptStates.push_back(states[i]);
+    }
 
-}
+    std::vector<std::pair<std::pair<int,int>,FIRMWeight> > keptEdgeProperties;
 
-FIRM::Edge FIRM::generateRolloutPolicy(const FIRM::Vertex currentVertex, const FIRM::Vertex goal)
-{
-    /**
-        For the given node, find the out edges and see the total cost of taking that edge
-        The cost of taking the edge is cost to go from the target of the edge + the cost of the edge itself
-    */
-    double minCost = std::numeric_limits<double>::max();
-    Edge edgeToTake;
+    std::vector<std::size_t> keptEdgeRecords;
 
-    // Iterate over the out edges
-    foreach(Edge e, boost::out_edges(currentVertex, g_))
+    for(std::size_t i = 0; i < edgeProperties.size(); i++)
     {
+        const int a = newNodeID[edgeProperties[i].first.first];
 
-        // Get the target node of the edge
-        Vertex targetNode = boost::target(e, g_);  
+        const int b = newNodeID[edgeProperties[i].first.second];
 
-        // The FIRM edge to take from the target node
-        Edge nextFIRMEdge = feedback_[targetNode];
+        if(edgeRemoved[i] || a < 0 || b < 0)
+            continue;
 
-        // The node to which next firm edge goes
-        Vertex targetOfNextFIRMEdge = boost::target(nextFIRMEdge, g_);
+        keptEdgeProperties.push_back(std::make_pair(std::make_pair(a, b), edgeProperties[i].second));
 
-        // Check if feedback from target to goal is valid or not
-        if(!isFeedbackPolicyValid(targetNode, goal))
-        {
+        keptEdgeRecords.push_back(edgeRecords[i]);
+    }
 
-            OMPL_INFORM("Rollout: Invalid path detected from Vertex %u to %u", targetNode, targetOfNextFIRMEdge);
+    OMPL_INFORM("FIRM: Removed %lu nodes and %lu edges, recomputed %lu node covariances and %lu edge weights",
+                (unsigned long)(states.size() - keptStates.size()), (unsigned long)(edgeProperties.size() - keptEdgeProperties.size()),
+                (unsigned long)delta.updatedNodes.size(), (unsigned long)delta.updatedEdges.size());
 
-            updateEdgeCollisionCost(targetNode, goal);
+    states.swap(keptStates);
 
-            // resolve DP
-            solveDynamicProgram(goal);
+    edgeProperties.swap(keptEdgeProperties);
 
-            targetOfNextFIRMEdge = boost::target(feedback_[targetNode], g_);  
+    edgeRecords.swap(keptEdgeRecords);
 
-            OMPL_INFORM("Rollout: Updated path, next firm edge moving from Vertex %u to %u", targetNode, targetOfNextFIRMEdge);
+    return delta.regenerateEdgeControllers;
+}
 
-        }
+void FIRM::computeRoadmapDelta(const RoadmapFile &roadmapFile, const EnvironmentStamp::Difference &difference, std::vector<ompl::base::State*> &states,
+                               RoadmapDelta &delta)
+{
+    const double margin = ompl::magic::ENVIRONMENT_CHANGE_MARGIN;
 
-        // The cost to go from the target node
-        double nextNodeCostToGo = costToGo_[targetNode];
+    delta.regenerateEdgeControllers = difference.motionModelChanged;
 
-        // Find the weight of the edge
-        FIRMWeight edgeWeight =  boost::get(boost::edge_weight, g_, e);
+    std::vector<bool> nodeRemoved(states.size(), false);
 
-        // The transition prob of the edge
-        double transitionProbability = edgeWeight.getSuccessProbability();        
-        
-        // compute distance from goal to target
-        //arma::colvec targetToGoalVec = stateProperty_[goal]->as<FIRM::StateType>()->getArmaData() - stateProperty_[targetNode]->as<FIRM::StateType>()->getArmaData();
-        //double distToGoalFromTarget = arma::norm(targetToGoalVec.subvec(0,1),2); 
+    std::vector<bool> nodeUpdated(states.size(), false);
 
-        // the cost of taking the edge
-        double edgeCostToGo = transitionProbability*nextNodeCostToGo + (1-transitionProbability)*obstacleCostToGo_ + edgeWeight.getCost();
+    std::vector<std::size_t> nodesToUpdate;
 
-        if(edgeCostToGo < minCost)
+    for(std::size_t i = 0; i < states.size(); i++)
+    {
+        const FIRM::StateType *state = states[i]->as<FIRM::StateType>();
+
+        const EnvironmentStamp::Box box = {state->getX(), state->getY(), state->getX(), state->getY()};
+
+        // only nodes near a changed obstacle can have become invalid
+        if(EnvironmentStamp::intersectsAny(box, difference.obstacleRegions, margin) && !si_->isValid(states[i]))
         {
-            minCost  = edgeCostToGo;
-            edgeToTake = e;
+            nodeRemoved[i] = true;
+            delta.removedNodes.push_back(i);
+            continue;
+        }
 
+        if(difference.isGlobal() || EnvironmentStamp::intersectsAny(box, difference.sensingRegions, 0))
+        {
+            nodeUpdated[i] = true;
+            nodesToUpdate.push_back(i);
         }
+    }
 
+    // one DARE per node whose view of the landmarks changed, spread over all cores
+    FIRMUtils::parallelFor(nodesToUpdate.size(), [&](std::size_t k)
+    {
+        NodeControllerType nodeController;
+        generateNodeController(states[nodesToUpdate[k]], nodeController);
+    });
 
+    for(std::size_t k = 0; k < nodesToUpdate.size(); k++)
+    {
+        RoadmapDelta::NodeUpdate update;
+        update.id = nodesToUpdate[k];
+        update.covariance = states[nodesToUpdate[k]]->as<FIRM::StateType>()->getCovariance();
+        delta.updatedNodes.push_back(update);
     }
 
-    return edgeToTake;
-}
-
-void FIRM::simulateKidnapping()
-{
-    siF_->setTrueState(kidnappedState_);
-}
+    const unsigned int stateDim = roadmapFile.getStateDimension();
 
-bool FIRM::detectKidnapping(ompl::base::State *previousState, ompl::base::State *newState)
-{
+    std::vector<std::size_t> edgesToUpdate;
 
-    using namespace arma;
+    for(std::size_t i = 0; i < roadmapFile.getNumEdges(); i++)
+    {
+        const RoadmapFile::Edge &edge = roadmapFile.getEdge(i);
 
-    mat previousCov = previousState->as<FIRM::StateType>()->getCovariance();
+        if(nodeRemoved[edge.source] || nodeRemoved[edge.target])
+        {
+            delta.removedEdges.push_back(i);
+            continue;
+        }
 
-    mat newCov = newState->as<FIRM::StateType>()->getCovariance();
+        if(difference.isGlobal() || nodeUpdated[edge.source] || nodeUpdated[edge.target])
+        {
+            edgesToUpdate.push_back(i);
+            continue;
+        }
 
-    double innovSignal = (trace(newCov) - trace(previousCov)) / trace(previousCov);
+        // the area swept by the edge is bounded by its end nodes and its nominal trajectory
+        const FIRM::StateType *source = states[edge.source]->as<FIRM::StateType>();
 
-    if(innovSignal >= ompl::magic::KIDNAPPING_INNOVATION_CHANGE_THRESHOLD )
-    {
-        return true;
-    }
+        const FIRM::StateType *target = states[edge.target]->as<FIRM::StateType>();
 
-    return false;
+        EnvironmentStamp::Box box = {std::min(source->getX(), target->getX()), std::min(source->getY(), target->getY()),
+                                     std::max(source->getX(), target->getX()), std::max(source->getY(), target->getY())};
 
-}
+        const double *xs = roadmapFile.getNominalStates(edge);
 
-void FIRM::savePlannerData()
-{
+        for(std::size_t k = 0; k < edge.trajectoryLength; k++)
+        {
+            box.xMin = std::min(box.xMin, xs[k*stateDim]);
+            box.xMax = std::max(box.xMax, xs[k*stateDim]);
+            box.yMin = std::min(box.yMin, xs[k*stateDim + 1]);
+            box.yMax = std::max(box.yMax, xs[k*stateDim + 1]);
+        }
 
-    std::vector<std::pair<int,std::pair<arma::colvec,arma::mat> > > nodes;
+        if(EnvironmentStamp::intersectsAny(box, difference.obstacleRegions, margin) || EnvironmentStamp::intersectsAny(box, difference.sensingRegions, 0))
+            edgesToUpdate.push_back(i);
+    }
 
-    foreach(Vertex v, boost::vertices(g_))
+    // controllers are built in parallel, the Monte Carlo runs share the true state of siF_ and are run one after the other
+    for(std::size_t first = 0; first < edgesToUpdate.size(); first += ompl::magic::ROADMAP_DELTA_EDGE_BATCH)
     {
+        const std::size_t batchSize = std::min<std::size_t>(ompl::magic::ROADMAP_DELTA_EDGE_BATCH, edgesToUpdate.size() - first);
 
-        arma::colvec xVec = stateProperty_[v]->as<FIRM::StateType>()->getArmaData();
+        std::vector<EdgeControllerType> edgeControllers(batchSize);
 
-        arma::mat cov = stateProperty_[v]->as<FIRM::StateType>()->getCovariance();
+        FIRMUtils::parallelFor(batchSize, [&](std::size_t k)
+        {
+            const RoadmapFile::Edge &edge = roadmapFile.getEdge(edgesToUpdate[first + k]);
 
-        std::pair<int,std::pair<arma::colvec,arma::mat> > nodeToWrite = std::make_pair(v, std::make_pair(xVec, cov)) ;
+            if(edge.trajectoryLength > 0 && !delta.regenerateEdgeControllers)
+            {
+                restoreEdgeController(states[edge.target], roadmapFile, edge, edgeControllers[k]);
+            }
+            else
+            {
+                generateEdgeController(states[edge.source], states[edge.target], edgeControllers[k]);
+            }
+        });
 
-        nodes.push_back(nodeToWrite);
+        for(std::size_t k = 0; k < batchSize; k++)
+        {
+            const std::size_t i = edgesToUpdate[first + k];
 
+            const FIRMWeight weight = simulateEdgeController(states[roadmapFile.getEdge(i).source], edgeControllers[k]);
+
+            if(weight.getSuccessProbability() == 0)
+            {
+                delta.removedEdges.push_back(i);
+                continue;
+            }
+
+            RoadmapDelta::EdgeUpdate update;
+            update.index = i;
+            update.cost = weight.getCost();
+            update.successProbability = weight.getSuccessProbability();
+            delta.updatedEdges.push_back(update);
+        }
     }
+}
 
-    std::vector<std::pair<std::pair<int,int>,FIRMWeight> > edgeWeights;
+void FIRM::addLoadedRoadmapToGraph(const std::vector<ompl::base::State*> &states, const std::vector<NodeControllerType> &nodeControllers,
+                                   const std::vector<std::pair<std::pair<int,int>,FIRMWeight> > &edgeProperties, const std::vector<EdgeControllerType> &edgeControllers)
+{
+    std::vector<Vertex> loadedVertices;
+
+    std::vector<std::pair<const ompl::base::State*, const ompl::base::State*> > vizEdges;
 
-    foreach(Edge e, boost::edges(g_))
     {
-        Vertex start = boost::source(e,g_);
-        Vertex goal  = boost::target(e,g_);
+        boost::mutex::scoped_lock _(graphMutex_);
 
-        const FIRMWeight w = boost::get(boost::edge_weight, g_, e);
+        loadedVertices.reserve(states.size());
 
-        edgeWeights.push_back(std::make_pair(std::make_pair(start,goal),w));
+        for(std::size_t i = 0; i < states.size(); i++)
+        {
+            Vertex m = boost::add_vertex(g_);
 
-    }
+            stateProperty_[m] = states[i];
 
-    FIRMUtils::writeFIRMGraphToXML(nodes, edgeWeights);
+            nodeControllers_[m] = nodeControllers[i]; // Add it to the list
 
-}
+            // Initialize to its own (dis)connected component.
+            disjointSets_.make_set(m);
 
+            loadedVertices.push_back(m);
+        }
 
-void FIRM::loadRoadMapFromFile(const std::string &pathToFile)
-{
-    std::vector<std::pair<int, arma::colvec> > FIRMNodePosList;
-    std::vector<std::pair<int, arma::mat> > FIRMNodeCovarianceList;
+        // a single bulk insertion lets the nearest neighbor structure build itself once
+        nn_->add(loadedVertices);
 
-    boost::mutex::scoped_lock _(graphMutex_);
+        loadedEdgeProperties_ = edgeProperties;
 
-    if(FIRMUtils::readFIRMGraphFromXML(pathToFile,  FIRMNodePosList, FIRMNodeCovarianceList , loadedEdgeProperties_))
-    {
+        vizEdges.reserve(edgeProperties.size());
+
+        // an edge is only kept with its reverse, like in addStateToGraph(), so the components stay symmetric
+        std::set<std::pair<int, int> > usableEdges;
 
-        loadedRoadmapFromFile_ = true;
+        for(std::size_t i = 0; i < edgeProperties.size(); i++)
+        {
+            if(edgeProperties[i].second.getSuccessProbability() > 0)
+                usableEdges.insert(edgeProperties[i].first);
+        }
 
-        this->setup();
+        std::size_t numDroppedEdges = 0;
 
-        for(int i = 0; i < FIRMNodePosList.size() ; i++)
+        for(std::size_t i = 0; i < edgeProperties.size(); i++)
         {
-            ompl::base::State *newState = siF_->allocState();
+            Vertex a = loadedVertices[edgeProperties[i].first.first];
+            Vertex b = loadedVertices[edgeProperties[i].first.second];
 
-            arma::colvec xVec = FIRMNodePosList[i].second;
-            arma::mat     cov = FIRMNodeCovarianceList[i].second;
+            const FIRMWeight weight = edgeProperties[i].second;
 
-            newState->as<FIRM::StateType>()->setArmaData(xVec);
-            newState->as<FIRM::StateType>()->setCovariance(cov);
+            // the id is taken even for a dropped edge, it keeps the ids in step with the stored edges
+            const unsigned int id = maxEdgeID_++;
+
+            if(!usableEdges.count(edgeProperties[i].first) ||
+               !usableEdges.count(std::make_pair(edgeProperties[i].first.second, edgeProperties[i].first.first)))
+            {
+                numDroppedEdges++;
+                continue;
+            }
 
-            //Vertex v = addStateToGraph(siF_->cloneState(newState));
+            const Graph::edge_property_type properties(weight, id);
 
-            Vertex m;
+            // create an edge with the edge weight property
+            std::pair<Edge, bool> newEdge = boost::add_edge(a, b, properties, g_);
 
-            m = boost::add_vertex(g_);
+            if(!edgeControllers.empty())
+                edgeControllers_.insert(newEdge.first, edgeControllers[i], estimateEdgeControllerMemory(edgeControllers[i]));
 
-            stateProperty_[m] = newState;
+            uniteComponents(a, b);
 
-            NodeControllerType nodeController;
+            vizEdges.push_back(std::make_pair(stateProperty_[a], stateProperty_[b]));
+        }
 
-            generateNodeController(newState, nodeController); // Generate the node controller
+        if(numDroppedEdges > 0)
+            OMPL_WARN("FIRM: Dropped %lu loaded edges without a usable reverse edge", (unsigned long)numDroppedEdges);
+    }
 
-            nodeControllers_[m] = nodeController; // Add it to the list
+    policyGenerator_->addFIRMNodesToObservationGraph(states);
 
-            // Initialize to its own (dis)connected component.
-            disjointSets_.make_set(m);
+    Visualizer::addStates(states);
 
-            nn_->add(m);
+    Visualizer::addGraphEdges(vizEdges);
+}
 
-            policyGenerator_->addFIRMNodeToObservationGraph(newState);
+void FIRM::openTimeSeriesLogs(const std::string &prefix)
+{
+    if(!doSaveLogs_)
+        return;
 
-            addStateToVisualization(newState);
+    costToGoHistory_.open(logFilePath_ + prefix + "CostHistory.csv");
 
-            assert(m==FIRMNodePosList[i].first && "IDS DONT MATCH !!");
-        }
+    successProbabilityHistory_.open(logFilePath_ + prefix + "SuccessProbabilityHistory.csv");
 
-        bool unite = true;
+    nodeReachedHistory_.open(logFilePath_ + prefix + "NodesReachedHistory.csv");
 
-        for(int i=0; i<loadedEdgeProperties_.size(); i++)
-        {
-            EdgeControllerType edgeController;
+    velocityHistory_->open(logFilePath_ + prefix + "VelocityHistory.csv");
 
-            Vertex a = loadedEdgeProperties_[i].first.first;
-            Vertex b = loadedEdgeProperties_[i].first.second;
+    siF_->setVelocityLogger(velocityHistory_);
 
-            ompl::base::State* startNodeState = siF_->cloneState(stateProperty_[a]);
-            ompl::base::State* targetNodeState = siF_->cloneState(stateProperty_[b]);
+    costToGoHistory_.log(currentTimeStep_, executionCost_);
+}
 
-            // Generate the edge controller for given start and end state
-            generateEdgeController(startNodeState,targetNodeState,edgeController);
+void FIRM::closeTimeSeriesLogs()
+{
+    costToGoHistory_.close();
 
-            const FIRMWeight weight = loadedEdgeProperties_[i].second;
+    successProbabilityHistory_.close();
 
-            const unsigned int id = maxEdgeID_++;
+    nodeReachedHistory_.close();
 
-            const Graph::edge_property_type properties(weight, id);
+    velocityHistory_->close();
+}
 
-            // create an edge with the edge weight property
-            std::pair<Edge, bool> newEdge = boost::add_edge(a, b, properties, g_);
+FIRM::RunStatistics FIRM::getRunStatistics() const
+{
+    RunStatistics statistics = runStatistics_;
 
-            edgeControllers_[newEdge.first] = edgeController;
+    statistics.executionCost = executionCost_;
 
-            if(unite)
-                uniteComponents(a, b);
+    statistics.timeSteps = currentTimeStep_;
 
-            unite = !unite;
+    statistics.nodesReached = numberofNodesReached_;
 
-            Visualizer::addGraphEdge(stateProperty_[a], stateProperty_[b]);
+    statistics.numNodes = milestoneCount();
 
-        }
+    statistics.numEdges = boost::num_edges(g_);
 
-    }
+    return statistics;
 }
 
-void FIRM::writeTimeSeriesDataToFile(std::string fname, std::string dataName)
+void FIRM::openExecutionTrace(const std::string &prefix)
 {
+    if(!doSaveTrace_)
+        return;
 
-    std::ofstream outfile;
+    boost::filesystem::create_directories(boost::filesystem::path(logFilePath_));
 
-    outfile.open(logFilePath_ + fname);
+    if(!executionTrace_->open(logFilePath_ + prefix + ".trace"))
+        return;
 
-    if(dataName.compare("costToGo")==0)
-    {
-        for(int i=0; i < costToGoHistory_.size(); i++)
-        {
-            outfile<<costToGoHistory_[i].first<<","<<costToGoHistory_[i].second<<std::endl;
-        }
-    }
+    std::vector<const ompl::base::State*> nodes;
 
-    if(dataName.compare("successProbability")==0)
-    {
-        for(int i=0; i < successProbabilityHistory_.size(); i++)
-        {
-            outfile<<successProbabilityHistory_[i].first<<","<<successProbabilityHistory_[i].second<<std::endl;
-        }
-    }
+    std::vector<std::pair<const ompl::base::State*, const ompl::base::State*> > edges;
 
-    if(dataName.compare("nodesReached")==0)
+    foreach (Vertex v, boost::vertices(g_))
     {
-        for(int i=0; i < nodeReachedHistory_.size(); i++)
-        {
-            outfile<<nodeReachedHistory_[i].first<<","<<nodeReachedHistory_[i].second<<std::endl;
-        }
+        if(isVertexAlive(v))
+            nodes.push_back(stateProperty_[v]);
     }
 
-    if(dataName.compare("velocity")==0)
+    foreach (Edge e, boost::edges(g_))
     {
-        for(int i=0; i < velocityHistory_.size(); i++)
-        {
-            outfile<<velocityHistory_[i].first<<","<<velocityHistory_[i].second<<std::endl;
-        }
+        edges.push_back(std::make_pair(stateProperty_[boost::source(e, g_)], stateProperty_[boost::target(e, g_)]));
     }
 
-    if(dataName.compare("multiModalWeights")==0)
-    {
-        for(int i=0; i < successProbabilityHistory_.size(); i++)
-        {
-            outfile<<weightsHistory_[i].first<<",";
+    executionTrace_->recordRoadmap(nodes, edges);
 
-            for(int j=0; j< weightsHistory_[i].second.size(); j++)
-            {
-                outfile<<weightsHistory_[i].second[j]<<",";
-            }
-            outfile<<std::endl;
-        }
-    }
+    siF_->setExecutionTrace(executionTrace_);
 
-    outfile.close();
+    policyExecutionSI_->setExecutionTrace(executionTrace_);
 }
 
-void FIRM::loadParametersFromFile(const std::string &pathToFile)
+void FIRM::closeExecutionTrace()
 {
-   TiXmlDocument doc(pathToFile);
+    siF_->setExecutionTrace(ExecutionTrace::ExecutionTracePtr());
 
-    bool loadOkay = doc.LoadFile();
+    policyExecutionSI_->setExecutionTrace(ExecutionTrace::ExecutionTracePtr());
 
-    if( !loadOkay )
-    {
-        printf( "FIRM: Could not load setup file. Error='%s'. Exiting.\n", doc.ErrorDesc() );
+    executionTrace_->close();
+}
 
-        exit( 1 );
-    }
+void FIRM::loadParametersFromFile(const std::string &pathToFile)
+{
+    loadParameters(SetupConfiguration(pathToFile));
+}
 
-    TiXmlNode* node = 0;
+void FIRM::loadParameters(const SetupConfiguration &config)
+{
+    const TiXmlNode* node = 0;
 
-    TiXmlElement* itemElement = 0;
+    const TiXmlElement* itemElement = 0;
 
-    node = doc.FirstChild( "FIRM" );
+    node = config.getSection( "FIRM" );
     assert( node );
 
-    TiXmlNode* child = 0;
+    const TiXmlNode* child = 0;
 
     // Video
     child = node->FirstChild("Video");
@@ -2090,7 +3627,12 @@ void FIRM::loadParametersFromFile(const std::string &pathToFile)
 
     int saveVideo = 0;
     itemElement->QueryIntAttribute("save", &saveVideo);
-    if(saveVideo == 1) doSaveLogs_ = true;
+    if(saveVideo == 1) doSaveVideo_ = true;
+
+    // optional, a command that reads the y4m stream from stdin, e.g. "ffmpeg -y -i - trial.mp4"
+    std::string videoEncoder;
+    if(itemElement->QueryStringAttribute("encoder", &videoEncoder) == TIXML_SUCCESS)
+        Visualizer::setVideoEncoder(videoEncoder);
 
     // Logging
     child = node->FirstChild("DataLog");
@@ -2146,6 +3688,86 @@ void FIRM::loadParametersFromFile(const std::string &pathToFile)
         doSavePlannerData_ = false;
     }
 
+    // binary (default) keeps the edge controllers, xml only the nodes and weights
+    std::string roadmapFormat = "binary";
+    itemElement->QueryStringAttribute("format", &roadmapFormat);
+    saveRoadmapAsXML_ = (roadmapFormat == "xml");
+
+    // Edge controller memory budget, optional, by default every controller is kept
+    child = node->FirstChild("EdgeControllerCache");
+
+    if(child)
+    {
+        itemElement = child->ToElement();
+        assert( itemElement );
+
+        double memoryMB = 0.0;
+        itemElement->QueryDoubleAttribute("memoryMB", &memoryMB);
+
+        setEdgeControllerMemoryBudget(memoryMB > 0 ? (std::size_t)(memoryMB*1024*1024) : 0);
+    }
+
+    // DP policy output, optional
+    child = node->FirstChild("Policy");
+
+    if(child)
+    {
+        itemElement = child->ToElement();
+        assert( itemElement );
+
+        int savePolicy = 0;
+        itemElement->QueryIntAttribute("save", &savePolicy);
+        doSavePolicy_ = (savePolicy == 1);
+    }
+
+    // Execution trace, optional
+    child = node->FirstChild("Trace");
+
+    if(child)
+    {
+        itemElement = child->ToElement();
+        assert( itemElement );
+
+        int saveTrace = 0;
+        itemElement->QueryIntAttribute("save", &saveTrace);
+        doSaveTrace_ = (saveTrace == 1);
+    }
+
+    // Hot path profile, optional
+    child = node->FirstChild("Profiling");
+
+    if(child)
+    {
+        itemElement = child->ToElement();
+        assert( itemElement );
+
+        int saveProfile = 0;
+        itemElement->QueryIntAttribute("save", &saveProfile);
+
+        if(saveProfile == 1)
+        {
+            if(Profiler::isEnabled())
+                Profiler::exportAtExit(logFilePath_ + "Profile");
+            else
+                OMPL_WARN("FIRM: Profiling requested but the profiling scopes are compiled out, configure with -DFIRM_PROFILING=ON");
+        }
+    }
+
+    // Grid of start beliefs for NBM3P after a kidnapping, optional
+    child = node->FirstChild("NBM3PSampling");
+
+    if(child)
+    {
+        itemElement = child->ToElement();
+        assert( itemElement );
+
+        double gridSize = 0.0, rotationSpacing = 0.0;
+        itemElement->QueryDoubleAttribute("grid", &gridSize);
+        itemElement->QueryDoubleAttribute("rotation", &rotationSpacing);
+
+        policyGenerator_->setSamplingGrid(gridSize, rotationSpacing);
+    }
+
     // Monte carlo parameters
     child = node->FirstChild("MCParticles");
     assert( child );
@@ -2251,6 +3873,25 @@ void FIRM::loadParametersFromFile(const std::string &pathToFile)
     itemElement->QueryIntAttribute("dpiter", &maxDPIterations);
     maxDPIterations_ = maxDPIterations;
 
+    // DP solver, optional
+    child = node->FirstChild("DPSolver");
+
+    if(child)
+    {
+        itemElement = child->ToElement();
+        assert( itemElement );
+
+        std::string solverType;
+        itemElement->QueryStringAttribute("type", &solverType);
+
+        if(solverType == "indexed")
+            dpSolver_ = DP_SOLVER_INDEXED;
+        else if(solverType == "map")
+            dpSolver_ = DP_SOLVER_MAP;
+        else
+            OMPL_WARN("FIRM: Unknown DP solver %s, using the map solver", solverType.c_str());
+    }
+
     OMPL_INFORM("FIRM: NNRadius = %f", NNRadius_);
 }
 
@@ -2297,7 +3938,8 @@ void FIRM::recoverLostRobot(ompl::base::State *recoveredState)
 
     std::cout << "Time to sample beliefs: "<<std::chrono::duration_cast<std::chrono::milliseconds>(end_time_sampling - start_time_sampling).count() << " milli seconds."<<std::endl;
 
-    std::cin.get();
+    if(!FIRMUtils::isHeadless())
+        std::cin.get();
 
     //ompl::base::State *currentTrueState = siF_->allocState();
 
@@ -2309,7 +3951,9 @@ void FIRM::recoverLostRobot(ompl::base::State *recoveredState)
 
     int timeSinceKidnap = 0;
 
-    weightsHistory_.push_back(std::make_pair(timeSinceKidnap,policyGenerator_->getWeights()));
+    weightsHistory_.open(logFilePath_ + "MultiModalWeightsHistory.csv");
+
+    weightsHistory_.log(timeSinceKidnap, policyGenerator_->getWeights());
 
     auto start_time_recovery = std::chrono::high_resolution_clock::now();
 
@@ -2363,7 +4007,7 @@ void FIRM::recoverLostRobot(ompl::base::State *recoveredState)
 
             timeSinceKidnap++;
 
-            weightsHistory_.push_back(std::make_pair(timeSinceKidnap,policyGenerator_->getWeights()));
+            weightsHistory_.log(timeSinceKidnap, policyGenerator_->getWeights());
 
 
         }
@@ -2374,7 +4018,14 @@ void FIRM::recoverLostRobot(ompl::base::State *recoveredState)
 
     std::cout << "Time to sample recover (exclude sampling): "<<std::chrono::duration_cast<std::chrono::milliseconds>(end_time_recovery - start_time_recovery).count() << " milli seconds."<<std::endl;
 
-    std::cin.get();
+    runStatistics_.recoveries++;
+
+    // the pauses for the viewer between sampling and recovery are not part of it
+    runStatistics_.recoveryTime += std::chrono::duration<double>(end_time_sampling - start_time_sampling).count()
+                                 + std::chrono::duration<double>(end_time_recovery - start_time_recovery).count();
+
+    if(!FIRMUtils::isHeadless())
+        std::cin.get();
 
     std::vector<ompl::base::State*> bstates;
 
@@ -2384,7 +4035,7 @@ void FIRM::recoverLostRobot(ompl::base::State *recoveredState)
 
     Visualizer::setMode(Visualizer::VZRDrawingMode::PRMViewMode);
 
-    writeTimeSeriesDataToFile("MultiModalWeightsHistory.csv", "multiModalWeights");
+    weightsHistory_.close();
 
 
 }
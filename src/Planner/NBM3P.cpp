@@ -40,6 +40,7 @@
 #include "Planner/NBM3P.h"
 #include "Visualization/Visualizer.h"
 #include "Utils/FIRMUtils.h"
+#include "Utils/Profiler.h"
 #include "ObservationModels/CamAruco2DObservationModel.h"
 #include "LinearSystem/LinearSystem.h"
 
@@ -78,6 +79,8 @@ namespace ompl
 
 void NBM3P::sampleNewBeliefStates()
 {
+    FIRM_PROFILE_SCOPE("NBM3P::sampleNewBeliefStates");
+
     /**
     Logic:
     1. Grid the environment
@@ -96,13 +99,13 @@ void NBM3P::sampleNewBeliefStates()
     double Y_1 = bounds.low[1];
     double Y_2 = bounds.high[1];
 
-    double spacing = ompl::magic::SAMPLING_GRID_SIZE;
+    double spacing = samplingGridSize_ > 0 ? samplingGridSize_ : ompl::magic::SAMPLING_GRID_SIZE;
 
     // grid size
     int gridSizeX = std::ceil( (X_2-X_1) / spacing);
     int gridSizeY = std::ceil( (Y_2-Y_1) / spacing);
 
-    double rotationSpacing = FIRMUtils::degree2Radian(ompl::magic::SAMPLING_ROTATION_SPACING);// radians
+    double rotationSpacing = FIRMUtils::degree2Radian(samplingRotationSpacing_ > 0 ? samplingRotationSpacing_ : ompl::magic::SAMPLING_ROTATION_SPACING);// radians
 
     int numHeadings = std::floor(2*boost::math::constants::pi<double>()/rotationSpacing);
 
@@ -203,6 +206,8 @@ void NBM3P::sampleNewBeliefStates()
 
 void NBM3P::generatePolicy(std::vector<ompl::control::Control*> &policy)
 {
+    FIRM_PROFILE_SCOPE("NBM3P::generatePolicy");
+
     si_->showRobotVisualization(false);
 
     Visualizer::clearOpenLoopRRTPaths();
@@ -346,6 +351,7 @@ void NBM3P::generatePolicy(std::vector<ompl::control::Control*> &policy)
 ompl::base::Cost NBM3P::executeOpenLoopPolicyOnMode(std::vector<ompl::control::Control*> controls,
                                                                 const ompl::base::State* state)
 {
+    FIRM_PROFILE_SCOPE("NBM3P::executeOpenLoopPolicyOnMode");
 
     double I1 = 0;
     //get weighted sum of trace of covariance
@@ -423,6 +429,8 @@ ompl::base::Cost NBM3P::executeOpenLoopPolicyOnMode(std::vector<ompl::control::C
 
 void NBM3P::propagateBeliefs(const ompl::control::Control *control, bool isSimulation)
 {
+    FIRM_PROFILE_SCOPE("NBM3P::propagateBeliefs");
+
     // To propagate beliefs we need to apply the control to the true state, get observations and update the beliefs.
     ExtendedKF kf(si_);
 
@@ -494,6 +502,7 @@ bool NBM3P::areSimilarWeights()
 
 void NBM3P::updateWeights(const arma::colvec trueObservation)
 {
+    FIRM_PROFILE_SCOPE("NBM3P::updateWeights");
 
     arma::colvec sigma(2);
 
@@ -872,6 +881,8 @@ bool NBM3P::isConverged()
 
 void NBM3P::removeDuplicateModes()
 {
+    FIRM_PROFILE_SCOPE("NBM3P::removeDuplicateModes");
+
     std::vector<int> toDelete;
 
     for(int i = 0; i < currentBeliefStates_.size(); i++)
@@ -923,6 +934,11 @@ void NBM3P::drawBeliefs()
         Visualizer::addBeliefMode(currentBeliefStates_[i]);
     }
 
+    const ExecutionTrace::ExecutionTracePtr &trace = policyExecutionSI_->getExecutionTrace();
+
+    if(trace)
+        trace->recordModes(currentBeliefStates_, weights_);
+
 }
 
 void NBM3P::getStateWithMaxWeight(ompl::base::State *state, float &weight)
@@ -984,6 +1000,42 @@ void NBM3P::addStateToObservationGraph(ompl::base::State *state)
 }
 
 
+void NBM3P::addFIRMNodesToObservationGraph(const std::vector<ompl::base::State*> &states)
+{
+    const Vertex firstNew = boost::num_vertices(g_);
+
+    for(unsigned int i = 0; i < states.size(); i++)
+    {
+        Vertex m = boost::add_vertex(g_);
+
+        stateProperty_[m] = si_->cloneState(states[i]);
+    }
+
+    // one observation per vertex, the old vertices are refreshed as addStateToObservationGraph would do
+    foreach(Vertex v, boost::vertices(g_))
+    {
+        evaluateObservationListForVertex(v);
+    }
+
+    // connect every new vertex to the ones before it, same edges as adding them one at a time
+    for(Vertex m = firstNew; m < boost::num_vertices(g_); m++)
+    {
+        for(Vertex n = 0; n < m; n++)
+        {
+            unsigned int weight = 0;
+
+            if(stateProperty_[m] != stateProperty_[n] && countObservationOverlap(m, n, weight))
+            {
+                const unsigned int id = maxEdgeID_++;
+
+                const Graph::edge_property_type properties(weight, id);
+
+                boost::add_edge(m, n, properties, g_);
+            }
+        }
+    }
+}
+
 void NBM3P::addEdgeToObservationGraph(const Vertex a, const Vertex b)
 {
 
@@ -1029,6 +1081,11 @@ bool NBM3P::getObservationOverlap(Vertex a, Vertex b, unsigned int &weight)
 
     evaluateObservationListForVertex(b);
 
+    return countObservationOverlap(a, b, weight);
+}
+
+bool NBM3P::countObservationOverlap(Vertex a, Vertex b, unsigned int &weight)
+{
 
     bool isOverlapping = false;
 
@@ -1041,13 +1098,15 @@ bool NBM3P::getObservationOverlap(Vertex a, Vertex b, unsigned int &weight)
         return true;
     }
 
+    // Check for overlap if they are not looking at the same physical landmark
+    const bool farApart = si_->distance(stateProperty_[a],stateProperty_[b]) > 4.0; // 4.0 is 2x the camera range
+
     // Check if there is an overlap
     for(int i = 0; i < stateObservationProperty_[a].size(); i++)
     {
         for(int j= 0; j < stateObservationProperty_[b].size(); j++)
         {
-            // Check for overlap if they are not looking at the same physical landmark
-            if(si_->distance(stateProperty_[a],stateProperty_[b]) > 4.0) // 4.0 is 2x the camera range
+            if(farApart)
             {
                 if(stateObservationProperty_[a][i] == stateObservationProperty_[b][j])
                 {
@@ -104,14 +104,14 @@ bool GaussianValidBeliefSampler::sampleNear(ompl::base::State *state, const ompl
 
 bool GaussianValidBeliefSampler::isObservable(ompl::base::State *state)
 {
-    /*
-    LinearSystem ls(si_, state, motionModel_->getZeroControl(), observationModel_->getObservation(state, false), motionModel_, observationModel_);
+    // table lookup in the precomputed observability map instead of linearizing and solving the DARE here
+    const firm::SpaceInformation *siF = dynamic_cast<const firm::SpaceInformation*>(si_);
 
-    arma::mat S;
+    if(siF && siF->getObservabilityMap())
+    {
+        return siF->getObservabilityMap()->isObservable(state);
+    }
 
-    bool systemStable = dare (trans(ls.getA()),trans(ls.getH()),ls.getG() * ls.getQ() * trans(ls.getG()),
-                                ls.getM() * ls.getR() * trans(ls.getM()), S );
-    */
     return true;
 
 }
@@ -37,6 +37,9 @@
 #include "Samplers/UniformValidBeliefSampler.h"
 #include "ompl/base/SpaceInformation.h"
 #include "ompl/tools/config/MagicConstants.h"
+#include "Spaces/SE2BeliefSpace.h"
+#include "ValidityCheckers/SignedDistanceFieldValidityChecker.h"
+#include <boost/math/constants/constants.hpp>
 
 
 UniformValidBeliefSampler::UniformValidBeliefSampler(const ompl::base::SpaceInformation *si) :
@@ -72,10 +75,96 @@ bool UniformValidBeliefSampler::sampleNear(State *state, const State *near, cons
     return valid;
 }
 
+unsigned int UniformValidBeliefSampler::sampleBatch(State **states, unsigned int count)
+{
+    const SE2BeliefSpace *space = dynamic_cast<const SE2BeliefSpace*>(si_->getStateSpace().get());
+
+    unsigned int filled = 0;
+
+    unsigned int attempts = 0;
+
+    const unsigned int maxAttempts = attempts_ * count;
+
+    // only SE2 beliefs are drawn in blocks, other spaces go through the regular sampler
+    if(!space)
+    {
+        while(filled < count && attempts < maxAttempts)
+        {
+            if(sample(states[filled]))
+                filled++;
+
+            attempts += attempts_;
+        }
+
+        return filled;
+    }
+
+    const ompl::base::RealVectorBounds &bounds = space->getBounds();
+
+    const double pi = boost::math::constants::pi<double>();
+
+    // the distance field answers a whole block with one call, other checkers are asked one state at a time
+    const SignedDistanceFieldValidityChecker *sdf = dynamic_cast<const SignedDistanceFieldValidityChecker*>(si_->getStateValidityChecker().get());
+
+    std::vector<double> xs, ys, yaws;
+
+    std::vector<unsigned char> valid;
+
+    while(filled < count && attempts < maxAttempts)
+    {
+        // draw the coordinates for all remaining slots at once
+        const unsigned int block = std::min(count - filled, maxAttempts - attempts);
+
+        xs.resize(block);
+        ys.resize(block);
+        yaws.resize(block);
+
+        for(unsigned int i = 0; i < block; i++)
+            xs[i] = rng_.uniformReal(bounds.low[0], bounds.high[0]);
+
+        for(unsigned int i = 0; i < block; i++)
+            ys[i] = rng_.uniformReal(bounds.low[1], bounds.high[1]);
+
+        for(unsigned int i = 0; i < block; i++)
+            yaws[i] = rng_.uniformReal(-pi, pi);
+
+        // the candidates go straight into the unfilled states, the accepted ones are moved to the front
+        const unsigned int first = filled;
+
+        for(unsigned int i = 0; i < block; i++)
+            states[first + i]->as<SE2BeliefSpace::StateType>()->setXYYaw(xs[i], ys[i], yaws[i]);
+
+        if(sdf)
+            sdf->isValid(states + first, block, valid);
+
+        for(unsigned int i = 0; i < block; i++)
+        {
+            State *candidate = states[first + i];
+
+            if(!isObservable(candidate) || !(sdf ? valid[i] : si_->isValid(candidate)))
+                continue;
+
+            if(first + i != filled)
+                si_->copyState(states[filled], candidate);
+
+            filled++;
+        }
+
+        attempts += block;
+    }
+
+    return filled;
+}
+
 bool UniformValidBeliefSampler::isObservable(ompl::base::State *state)
 {
-    //if(observationModel_->isStateObservable(state)) std::cout<<"Observable"<<std::endl;
-    //else std::cout<<"Not Observable"<<std::endl;
-    //return observationModel_->isStateObservable(state);
-    return true;//si_->getObservationModel()->isStateObservable(state);
+    // table lookup in the precomputed observability map, accept everything if there is none
+    const firm::SpaceInformation *siF = dynamic_cast<const firm::SpaceInformation*>(si_);
+
+    if(siF && siF->getObservabilityMap())
+    {
+        return siF->getObservabilityMap()->isObservable(state);
+    }
+
+    return true;
 }
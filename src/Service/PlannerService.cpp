@@ -0,0 +1,381 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "Service/PlannerService.h"
+#include "Setup/TwoDPointRobotSetup.h"
+#include <chrono>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+    /** \brief Pending connections the socket keeps while a query is answered */
+    const int SERVICE_BACKLOG = 16;
+
+    /** \brief Requests longer than this are rejected */
+    const size_t MAX_REQUEST_LENGTH = 4096;
+
+    /** \brief A client that sends or takes nothing for this many seconds is disconnected, so it cannot hold up the others */
+    const int CONNECTION_TIMEOUT_SECONDS = 5;
+
+    std::string jsonEscape(const std::string &s)
+    {
+        std::string out;
+
+        for(size_t i = 0; i < s.size(); i++)
+        {
+            const unsigned char c = s[i];
+
+            if(c == '"' || c == '\\')
+            {
+                out += '\\';
+                out += c;
+            }
+            else if(c < 0x20)
+            {
+                char code[8];
+                snprintf(code, sizeof(code), "\\u%04x", c);
+                out += code;
+            }
+            else
+                out += c;
+        }
+
+        return out;
+    }
+
+    std::string errorResponse(const std::string &message)
+    {
+        return "{\"ok\":false,\"error\":\"" + jsonEscape(message) + "\"}";
+    }
+
+    bool writeAll(int fd, const std::string &data)
+    {
+        size_t written = 0;
+
+        while(written < data.size())
+        {
+            const ssize_t n = write(fd, data.data() + written, data.size() - written);
+
+            if(n < 0 && errno == EINTR)
+                continue;
+
+            if(n <= 0)
+                return false;
+
+            written += n;
+        }
+
+        return true;
+    }
+}
+
+PlannerService::PlannerService(TwoDPointRobotSetup *setup) : setup_(setup), numQueries_(0)
+{
+}
+
+std::string PlannerService::handleRequest(const std::string &request, bool &closeConnection, bool &shutdown)
+{
+    std::istringstream in(request);
+
+    std::string command;
+
+    in >> command;
+
+    std::string arguments;
+
+    std::getline(in, arguments);
+
+    if(command == "plan")
+    {
+        // a failed query answers this request only, the service keeps running
+        try
+        {
+            return plan(arguments);
+        }
+        catch(const std::exception &e)
+        {
+            OMPL_ERROR("PlannerService: Query failed: %s", e.what());
+            return errorResponse(std::string("query failed: ") + e.what());
+        }
+    }
+
+    if(command == "stats")
+        return stats();
+
+    if(command == "quit" || command == "shutdown")
+    {
+        closeConnection = true;
+
+        shutdown = command == "shutdown";
+
+        return "{\"ok\":true}";
+    }
+
+    return errorResponse("unknown command '" + command + "'");
+}
+
+std::string PlannerService::plan(const std::string &arguments)
+{
+    std::istringstream in(arguments);
+
+    double start[3], goal[3];
+
+    if(!(in >> start[0] >> start[1] >> start[2] >> goal[0] >> goal[1] >> goal[2]))
+        return errorResponse("expected plan <sx> <sy> <syaw> <gx> <gy> <gyaw> [cov <9 values>]");
+
+    arma::mat covariance = arma::zeros<arma::mat>(3,3);
+
+    std::string keyword;
+
+    if(in >> keyword)
+    {
+        if(keyword != "cov")
+            return errorResponse("unexpected '" + keyword + "'");
+
+        for(unsigned int i = 0; i < 9; i++)
+        {
+            if(!(in >> covariance(i/3, i%3)))
+                return errorResponse("cov needs 9 values");
+        }
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    const firm::SpaceInformation::SpaceInformationPtr &si = setup_->getSpaceInformation();
+
+    ompl::base::State *startState = si->allocState();
+
+    ompl::base::State *goalState = si->allocState();
+
+    startState->as<SE2BeliefSpace::StateType>()->setXYYaw(start[0], start[1], start[2]);
+
+    startState->as<SE2BeliefSpace::StateType>()->setCovariance(covariance);
+
+    goalState->as<SE2BeliefSpace::StateType>()->setXYYaw(goal[0], goal[1], goal[2]);
+
+    FIRM *planner = setup_->getFIRM();
+
+    FIRM::QueryResult result;
+
+    try
+    {
+        result = planner->query(startState, goalState);
+    }
+    catch(...)
+    {
+        si->freeState(startState);
+
+        si->freeState(goalState);
+
+        throw;
+    }
+
+    si->freeState(startState);
+
+    si->freeState(goalState);
+
+    numQueries_++;
+
+    const double timeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::ostringstream out;
+
+    out << "{\"ok\":true,\"solved\":" << (result.solved ? "true" : "false")
+        << ",\"successProbability\":" << result.successProbability
+        << ",\"cost\":" << result.cost
+        << ",\"cachedPolicy\":" << (result.cachedPolicy ? "true" : "false")
+        << ",\"timeMs\":" << timeMs
+        << ",\"nodes\":[";
+
+    for(size_t i = 0; i < result.path.size(); i++)
+    {
+        const arma::colvec x = planner->getVertexState(result.path[i])->as<SE2BeliefSpace::StateType>()->getArmaData();
+
+        out << (i > 0 ? "," : "") << "[" << result.path[i] << "," << x[0] << "," << x[1] << "," << x[2] << "]";
+    }
+
+    out << "]}";
+
+    return out.str();
+}
+
+std::string PlannerService::stats() const
+{
+    const FIRM *planner = setup_->getFIRM();
+
+    const FIRM::Graph &g = planner->getRoadmap();
+
+    std::ostringstream out;
+
+    // removed nodes keep their slot in the graph, so they are not counted from it
+    out << "{\"ok\":true,\"nodes\":" << planner->milestoneCount() << ",\"edges\":" << boost::num_edges(g) << ",\"queries\":" << numQueries_ << "}";
+
+    return out.str();
+}
+
+bool PlannerService::serveConnection(int inFd, int outFd)
+{
+    std::string buffer;
+
+    char chunk[1024];
+
+    bool closeConnection = false, shutdown = false;
+
+    while(!closeConnection)
+    {
+        size_t newline = buffer.find('\n');
+
+        if(newline == std::string::npos)
+        {
+            if(buffer.size() > MAX_REQUEST_LENGTH)
+            {
+                writeAll(outFd, errorResponse("request too long") + "\n");
+                break;
+            }
+
+            const ssize_t n = read(inFd, chunk, sizeof(chunk));
+
+            if(n < 0 && errno == EINTR)
+                continue;
+
+            if(n <= 0)
+                break;
+
+            buffer.append(chunk, n);
+
+            continue;
+        }
+
+        std::string request = buffer.substr(0, newline);
+
+        buffer.erase(0, newline + 1);
+
+        if(!request.empty() && request[request.size()-1] == '\r')
+            request.erase(request.size()-1);
+
+        if(request.find_first_not_of(" \t") == std::string::npos)
+            continue;
+
+        if(!writeAll(outFd, handleRequest(request, closeConnection, shutdown) + "\n"))
+            break;
+    }
+
+    return shutdown;
+}
+
+bool PlannerService::serveSocket(const std::string &path)
+{
+    sockaddr_un address;
+
+    if(path.size() >= sizeof(address.sun_path))
+    {
+        OMPL_ERROR("PlannerService: Socket path %s is too long", path.c_str());
+        return false;
+    }
+
+    // a client that disconnects while its answer is written must not end the service
+    signal(SIGPIPE, SIG_IGN);
+
+    const int server = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if(server < 0)
+    {
+        OMPL_ERROR("PlannerService: Could not create socket: %s", strerror(errno));
+        return false;
+    }
+
+    memset(&address, 0, sizeof(address));
+
+    address.sun_family = AF_UNIX;
+
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    unlink(path.c_str());
+
+    if(bind(server, (sockaddr*)&address, sizeof(address)) < 0 || listen(server, SERVICE_BACKLOG) < 0)
+    {
+        OMPL_ERROR("PlannerService: Could not listen on %s: %s", path.c_str(), strerror(errno));
+        close(server);
+        return false;
+    }
+
+    OMPL_INFORM("PlannerService: Listening on %s", path.c_str());
+
+    bool shutdown = false;
+
+    while(!shutdown)
+    {
+        const int client = accept(server, NULL, NULL);
+
+        if(client < 0)
+        {
+            if(errno == EINTR)
+                continue;
+
+            OMPL_ERROR("PlannerService: accept failed: %s", strerror(errno));
+            break;
+        }
+
+        timeval timeout;
+
+        timeout.tv_sec = CONNECTION_TIMEOUT_SECONDS;
+
+        timeout.tv_usec = 0;
+
+        setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+        shutdown = serveConnection(client, client);
+
+        close(client);
+    }
+
+    close(server);
+
+    unlink(path.c_str());
+
+    OMPL_INFORM("PlannerService: Answered %lu queries, shutting down", numQueries_);
+
+    return shutdown;
+}
@@ -44,6 +44,10 @@ void firm::SpaceInformation::setBelief(const ompl::base::State *state)
     if(showRobot_)
     {
         Visualizer::updateCurrentBelief(belief_);
+
+        // the belief is set once per step of the robot, after the filter update
+        if(executionTrace_)
+            executionTrace_->recordStep(trueState_, belief_);
     }
 }
 
@@ -59,6 +63,8 @@ void firm::SpaceInformation::setTrueState(const ompl::base::State *state)
 
 void firm::SpaceInformation::applyControl(const ompl::control::Control *control, bool withNoise)
 {
+    FIRM_PROFILE_SCOPE("SpaceInformation::applyControl");
+
     typename MotionModelMethod::NoiseType noise;
 
     if(withNoise)
@@ -77,17 +83,20 @@ void firm::SpaceInformation::applyControl(const ompl::control::Control *control,
         Visualizer::updateTrueState(trueState_);
     }
 
-    if(logVelocity_)
+    if(logVelocity_ && velocityLogger_)
     {
         const double *conVals = control->as<ompl::control::RealVectorControlSpace::ControlType>()->values;
 
-        velocityLog_.push_back(std::make_pair(conVals[0], conVals[1]));
+        // speed of the omnidirectional robot, for the unicycle conVals[0] alone is the linear velocity
+        velocityLogger_->log(velocityLogCount_++, sqrt( pow(conVals[0],2) + pow(conVals[1],2) ));
     }
 
 }
 
 ObservationModelMethod::ObservationType firm::SpaceInformation::getObservation()
 {
+    FIRM_PROFILE_SCOPE("SpaceInformation::getObservation");
+
     return observationModel_->getObservation(trueState_, true);
 }
 
@@ -74,9 +74,20 @@ bool R2BeliefSpace::StateType::isReached(ompl::base::State *state, bool relaxedC
 ompl::base::State* R2BeliefSpace::allocState(void) const
 {
 
-    StateType *rstate = new StateType();
+    StateType *rstate = BeliefStatePool<R2BeliefSpace>::acquire();
 
-    rstate->values = new double[dimension_];
+    if(rstate)
+    {
+        rstate->resetBelief();
+    }
+    else
+    {
+        rstate = new StateType();
+
+        rstate->values = new double[dimension_];
+
+        BeliefStatePool<R2BeliefSpace>::recordAllocation();
+    }
 
     return rstate;
 }
@@ -90,7 +101,15 @@ void R2BeliefSpace::copyState(State *destination, const State *source) const
 
 void R2BeliefSpace::freeState(State *state) const
 {
-    RealVectorStateSpace::freeState(state);
+    BeliefStatePool<R2BeliefSpace>::release(state->as<StateType>());
+}
+
+void R2BeliefSpace::destroyPooledState(StateType *state)
+{
+    delete[] state->values;
+
+    // deleting through StateType releases the covariance as well
+    delete state;
 }
 
 double R2BeliefSpace::distance(const State* state1, const State *state2)
@@ -84,10 +84,23 @@ bool SE2BeliefSpace::StateType::isReached(ompl::base::State *state, bool relaxed
 
 ompl::base::State* SE2BeliefSpace::allocState(void) const
 {
-    StateType *state = new StateType();
-    
-    allocStateComponents(state);
-    
+    StateType *state = BeliefStatePool<SE2BeliefSpace>::acquire();
+
+    if(state)
+    {
+        state->setX(0.0);
+        state->setY(0.0);
+        state->resetBelief();
+    }
+    else
+    {
+        state = new StateType();
+
+        allocStateComponents(state);
+
+        BeliefStatePool<SE2BeliefSpace>::recordAllocation();
+    }
+
     state->setYaw(0.0);
     
     return state;
@@ -103,7 +116,21 @@ void SE2BeliefSpace::copyState(State *destination, const State *source) const
 
 void SE2BeliefSpace::freeState(State *state) const
 {
-    CompoundStateSpace::freeState(state);
+    BeliefStatePool<SE2BeliefSpace>::release(state->as<StateType>());
+}
+
+void SE2BeliefSpace::destroyPooledState(StateType *state)
+{
+    // the components are deleted through their concrete types, the subspaces are not needed for that
+    RealVectorStateSpace::StateType *position = state->as<RealVectorStateSpace::StateType>(0);
+
+    delete[] position->values;
+    delete position;
+    delete state->as<SO2StateSpace::StateType>(1);
+    delete[] state->components;
+
+    // deleting through StateType releases the covariance as well
+    delete state;
 }
 
 double SE2BeliefSpace::distance(const State* state1, const State *state2)
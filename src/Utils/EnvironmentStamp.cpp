@@ -0,0 +1,268 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "Utils/EnvironmentStamp.h"
+#include "Utils/FIRMUtils.h"
+#include "Utils/SetupConfiguration.h"
+#include <ompl/util/Console.h>
+#include <boost/functional/hash.hpp>
+#include <tinyxml.h>
+#include <algorithm>
+#include <set>
+
+namespace
+{
+    std::uint64_t hashSection(const SetupConfiguration &config, const char *section)
+    {
+        std::uint64_t hash = FIRMUtils::HASH_SEED;
+
+        const TiXmlElement *element = config.getSection(section);
+
+        if(element)
+            FIRMUtils::hashXMLElement(element, hash);
+
+        return hash;
+    }
+
+    /** \brief Key used to compare landmarks of two stamps */
+    std::size_t landmarkKey(const EnvironmentStamp::Landmark &l)
+    {
+        std::size_t seed = 0;
+        boost::hash_combine(seed, l.id);
+        boost::hash_combine(seed, l.x);
+        boost::hash_combine(seed, l.y);
+        boost::hash_combine(seed, l.theta);
+        return seed;
+    }
+}
+
+EnvironmentStamp::EnvironmentStamp() : meshHash(0), landmarkHash(0), observationModelHash(0), motionModelHash(0), sensingRange(-1)
+{
+}
+
+bool EnvironmentStamp::compute(const SetupConfiguration &config, const std::string &pathToEnvironmentMesh)
+{
+    landmarkHash = hashSection(config, "LandmarkList");
+
+    observationModelHash = hashSection(config, "ObservationModels");
+
+    motionModelHash = hashSection(config, "MotionModels");
+
+    landmarks.clear();
+
+    const TiXmlElement *landmarkList = config.getSection("LandmarkList");
+
+    if(landmarkList)
+    {
+        for(const TiXmlElement *element = landmarkList->FirstChildElement(); element; element = element->NextSiblingElement())
+        {
+            double id = 0;
+
+            Landmark l;
+            l.x = l.y = l.theta = 0;
+
+            element->QueryDoubleAttribute("id", &id);
+            element->QueryDoubleAttribute("x", &l.x);
+            element->QueryDoubleAttribute("y", &l.y);
+            element->QueryDoubleAttribute("theta", &l.theta);
+
+            l.id = (std::int64_t)id;
+
+            landmarks.push_back(l);
+        }
+    }
+
+    sensingRange = -1;
+
+    const TiXmlElement *models = config.getSection("ObservationModels");
+
+    if(models)
+    {
+        for(const TiXmlElement *element = models->FirstChildElement(); element; element = element->NextSiblingElement())
+        {
+            double range = 0;
+
+            if(element->QueryDoubleAttribute("camera_range", &range) == TIXML_SUCCESS)
+                sensingRange = std::max(sensingRange, range);
+        }
+    }
+
+    meshHash = FIRMUtils::hashFileContents(pathToEnvironmentMesh);
+
+    std::vector<arma::colvec> vertices;
+
+    std::vector<std::vector<int> > meshFaces;
+
+    faces.clear();
+
+    if(!FIRMUtils::readOBJMesh(pathToEnvironmentMesh, vertices, meshFaces))
+    {
+        OMPL_WARN("EnvironmentStamp: Could not read environment mesh %s", pathToEnvironmentMesh.c_str());
+        return false;
+    }
+
+    faces.reserve(meshFaces.size());
+
+    for(size_t f = 0; f < meshFaces.size(); f++)
+    {
+        Face face;
+
+        std::size_t seed = 0;
+
+        const arma::colvec &first = vertices[meshFaces[f][0]];
+
+        face.box.xMin = face.box.xMax = first[0];
+        face.box.yMin = face.box.yMax = first[1];
+
+        for(size_t k = 0; k < meshFaces[f].size(); k++)
+        {
+            const arma::colvec &v = vertices[meshFaces[f][k]];
+
+            boost::hash_combine(seed, v[0]);
+            boost::hash_combine(seed, v[1]);
+            boost::hash_combine(seed, v[2]);
+
+            face.box.xMin = std::min(face.box.xMin, v[0]);
+            face.box.xMax = std::max(face.box.xMax, v[0]);
+            face.box.yMin = std::min(face.box.yMin, v[1]);
+            face.box.yMax = std::max(face.box.yMax, v[1]);
+        }
+
+        face.hash = seed;
+
+        faces.push_back(face);
+    }
+
+    return true;
+}
+
+bool EnvironmentStamp::matches(const EnvironmentStamp &other) const
+{
+    return meshHash == other.meshHash && landmarkHash == other.landmarkHash
+        && observationModelHash == other.observationModelHash && motionModelHash == other.motionModelHash;
+}
+
+EnvironmentStamp::Difference EnvironmentStamp::diff(const EnvironmentStamp &older) const
+{
+    Difference d;
+
+    d.motionModelChanged = motionModelHash != older.motionModelHash;
+
+    d.observationModelChanged = observationModelHash != older.observationModelHash;
+
+    if(meshHash != older.meshHash)
+    {
+        std::multiset<std::uint64_t> oldFaces, newFaces;
+
+        for(size_t i = 0; i < older.faces.size(); i++)
+            oldFaces.insert(older.faces[i].hash);
+
+        for(size_t i = 0; i < faces.size(); i++)
+            newFaces.insert(faces[i].hash);
+
+        // a face that is only in one of the meshes was added or removed, both change the free space around it
+        for(size_t i = 0; i < older.faces.size(); i++)
+            if(newFaces.find(older.faces[i].hash) == newFaces.end())
+                d.obstacleRegions.push_back(older.faces[i].box);
+
+        for(size_t i = 0; i < faces.size(); i++)
+            if(oldFaces.find(faces[i].hash) == oldFaces.end())
+                d.obstacleRegions.push_back(faces[i].box);
+    }
+
+    if(landmarkHash != older.landmarkHash)
+    {
+        std::set<std::size_t> oldLandmarks, newLandmarks;
+
+        for(size_t i = 0; i < older.landmarks.size(); i++)
+            oldLandmarks.insert(landmarkKey(older.landmarks[i]));
+
+        for(size_t i = 0; i < landmarks.size(); i++)
+            newLandmarks.insert(landmarkKey(landmarks[i]));
+
+        std::vector<Landmark> changed;
+
+        for(size_t i = 0; i < older.landmarks.size(); i++)
+            if(newLandmarks.find(landmarkKey(older.landmarks[i])) == newLandmarks.end())
+                changed.push_back(older.landmarks[i]);
+
+        for(size_t i = 0; i < landmarks.size(); i++)
+            if(oldLandmarks.find(landmarkKey(landmarks[i])) == oldLandmarks.end())
+                changed.push_back(landmarks[i]);
+
+        if(!changed.empty() && (sensingRange < 0 || older.sensingRange < 0))
+        {
+            d.sensingChangedEverywhere = true;
+        }
+        else
+        {
+            const double range = std::max(sensingRange, older.sensingRange);
+
+            for(size_t i = 0; i < changed.size(); i++)
+            {
+                Box b = {changed[i].x - range, changed[i].y - range, changed[i].x + range, changed[i].y + range};
+                d.sensingRegions.push_back(b);
+            }
+        }
+    }
+
+    return d;
+}
+
+std::uint64_t EnvironmentStamp::getCombinedHash() const
+{
+    std::size_t seed = 0;
+    boost::hash_combine(seed, meshHash);
+    boost::hash_combine(seed, landmarkHash);
+    boost::hash_combine(seed, observationModelHash);
+    boost::hash_combine(seed, motionModelHash);
+    return seed;
+}
+
+bool EnvironmentStamp::intersects(const Box &a, const Box &b, double margin)
+{
+    return a.xMin - margin <= b.xMax && b.xMin <= a.xMax + margin
+        && a.yMin - margin <= b.yMax && b.yMin <= a.yMax + margin;
+}
+
+bool EnvironmentStamp::intersectsAny(const Box &a, const std::vector<Box> &regions, double margin)
+{
+    for(size_t i = 0; i < regions.size(); i++)
+    {
+        if(intersects(a, regions[i], margin))
+            return true;
+    }
+
+    return false;
+}
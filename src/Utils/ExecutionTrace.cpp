@@ -0,0 +1,401 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "Utils/ExecutionTrace.h"
+#include "Spaces/SE2BeliefSpace.h"
+#include <ompl/util/Console.h>
+#include <cstring>
+
+namespace
+{
+    const char TRACE_FILE_MAGIC[8] = {'F','I','R','M','T','R','C','E'};
+
+    const std::uint32_t TRACE_FILE_VERSION = 1;
+
+    enum RecordType
+    {
+        ROADMAP_RECORD = 1,
+        STEP_RECORD,
+        EDGE_RECORD,
+        ROLLOUT_RECORD,
+        MODES_RECORD
+    };
+
+    ExecutionTrace::Pose toPose(const ompl::base::State *state)
+    {
+        const SE2BeliefSpace::StateType *s = state->as<SE2BeliefSpace::StateType>();
+
+        const arma::mat covariance = s->getCovariance();
+
+        ExecutionTrace::Pose pose;
+
+        pose.x = s->getX();
+        pose.y = s->getY();
+        pose.yaw = s->getYaw();
+
+        for(unsigned int i = 0; i < 9; i++)
+            pose.covariance[i] = covariance.n_elem == 9 ? covariance(i) : 0.0;
+
+        return pose;
+    }
+
+    ExecutionTrace::Segment toSegment(const ompl::base::State *source, const ompl::base::State *target)
+    {
+        const SE2BeliefSpace::StateType *s = source->as<SE2BeliefSpace::StateType>();
+
+        const SE2BeliefSpace::StateType *t = target->as<SE2BeliefSpace::StateType>();
+
+        ExecutionTrace::Segment segment = {s->getX(), s->getY(), t->getX(), t->getY()};
+
+        return segment;
+    }
+
+    template <class T>
+    void write(std::ofstream &out, const T &value)
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <class T>
+    void writeVector(std::ofstream &out, const std::vector<T> &values)
+    {
+        const std::uint64_t size = values.size();
+        write(out, size);
+        out.write(reinterpret_cast<const char*>(values.data()), sizeof(T)*size);
+    }
+
+    template <class T>
+    bool read(std::ifstream &in, T &value)
+    {
+        in.read(reinterpret_cast<char*>(&value), sizeof(T));
+        return in.good();
+    }
+
+    template <class T>
+    bool readVector(std::ifstream &in, std::vector<T> &values)
+    {
+        std::uint64_t size = 0;
+
+        if(!read(in, size))
+            return false;
+
+        // the size comes from the file, it must fit in what is left of it before anything is allocated
+        const std::streamoff position = in.tellg();
+
+        in.seekg(0, std::ios::end);
+
+        const std::uint64_t remaining = (std::uint64_t)(in.tellg() - position);
+
+        in.seekg(position);
+
+        if(size > remaining / sizeof(T))
+        {
+            in.setstate(std::ios::failbit);
+            return false;
+        }
+
+        values.resize(size);
+        in.read(reinterpret_cast<char*>(values.data()), sizeof(T)*size);
+
+        return in.good();
+    }
+}
+
+ExecutionTrace::ExecutionTrace() : numSteps_(0)
+{
+}
+
+ExecutionTrace::~ExecutionTrace()
+{
+    close();
+}
+
+bool ExecutionTrace::open(const std::string &path)
+{
+    close();
+
+    boost::mutex::scoped_lock lock(mutex_);
+
+    out_.open(path.c_str(), std::ios::binary | std::ios::trunc);
+
+    if(!out_.is_open())
+    {
+        OMPL_ERROR("ExecutionTrace: Could not open %s for writing", path.c_str());
+        return false;
+    }
+
+    out_.write(TRACE_FILE_MAGIC, sizeof(TRACE_FILE_MAGIC));
+    write(out_, TRACE_FILE_VERSION);
+
+    numSteps_ = 0;
+
+    OMPL_INFORM("ExecutionTrace: Recording to %s", path.c_str());
+
+    return true;
+}
+
+void ExecutionTrace::close()
+{
+    boost::mutex::scoped_lock lock(mutex_);
+
+    if(out_.is_open())
+        out_.close();
+}
+
+void ExecutionTrace::writeHeader(std::uint8_t type)
+{
+    write(out_, type);
+    write(out_, numSteps_);
+}
+
+void ExecutionTrace::recordRoadmap(const std::vector<const ompl::base::State*> &nodes,
+                                   const std::vector<std::pair<const ompl::base::State*, const ompl::base::State*> > &edges)
+{
+    RoadmapEvent roadmap;
+
+    roadmap.nodes.reserve(nodes.size());
+
+    for(size_t i = 0; i < nodes.size(); i++)
+        roadmap.nodes.push_back(toPose(nodes[i]));
+
+    roadmap.edges.reserve(edges.size());
+
+    for(size_t i = 0; i < edges.size(); i++)
+        roadmap.edges.push_back(toSegment(edges[i].first, edges[i].second));
+
+    boost::mutex::scoped_lock lock(mutex_);
+
+    if(!out_.is_open())
+        return;
+
+    writeHeader(ROADMAP_RECORD);
+    writeVector(out_, roadmap.nodes);
+    writeVector(out_, roadmap.edges);
+}
+
+void ExecutionTrace::recordStep(const ompl::base::State *trueState, const ompl::base::State *belief)
+{
+    Step step;
+
+    step.trueState = toPose(trueState);
+    step.belief = toPose(belief);
+
+    boost::mutex::scoped_lock lock(mutex_);
+
+    if(!out_.is_open())
+        return;
+
+    writeHeader(STEP_RECORD);
+    write(out_, step);
+
+    numSteps_++;
+}
+
+void ExecutionTrace::recordEdge(std::int64_t source, std::int64_t target, const ompl::base::State *sourceState, const ompl::base::State *targetState)
+{
+    const Segment segment = toSegment(sourceState, targetState);
+
+    boost::mutex::scoped_lock lock(mutex_);
+
+    if(!out_.is_open())
+        return;
+
+    writeHeader(EDGE_RECORD);
+    write(out_, source);
+    write(out_, target);
+    write(out_, segment);
+}
+
+void ExecutionTrace::recordRollout(const ompl::base::State *from, const std::vector<const ompl::base::State*> &candidates, const ompl::base::State *chosen)
+{
+    std::vector<Segment> segments;
+
+    segments.reserve(candidates.size());
+
+    for(size_t i = 0; i < candidates.size(); i++)
+        segments.push_back(toSegment(from, candidates[i]));
+
+    const Segment chosenSegment = toSegment(from, chosen);
+
+    boost::mutex::scoped_lock lock(mutex_);
+
+    if(!out_.is_open())
+        return;
+
+    writeHeader(ROLLOUT_RECORD);
+    writeVector(out_, segments);
+    write(out_, chosenSegment);
+}
+
+void ExecutionTrace::recordModes(const std::vector<ompl::base::State*> &modes, const std::vector<float> &weights)
+{
+    std::vector<Pose> poses;
+
+    poses.reserve(modes.size());
+
+    for(size_t i = 0; i < modes.size(); i++)
+        poses.push_back(toPose(modes[i]));
+
+    boost::mutex::scoped_lock lock(mutex_);
+
+    if(!out_.is_open())
+        return;
+
+    writeHeader(MODES_RECORD);
+    writeVector(out_, poses);
+    writeVector(out_, weights);
+}
+
+bool ExecutionTrace::load(const std::string &path)
+{
+    std::ifstream in(path.c_str(), std::ios::binary);
+
+    if(!in.is_open())
+    {
+        OMPL_ERROR("ExecutionTrace: Could not open %s", path.c_str());
+        return false;
+    }
+
+    char magic[sizeof(TRACE_FILE_MAGIC)];
+
+    std::uint32_t version = 0;
+
+    in.read(magic, sizeof(magic));
+
+    if(!read(in, version) || std::memcmp(magic, TRACE_FILE_MAGIC, sizeof(magic)) != 0)
+    {
+        OMPL_ERROR("ExecutionTrace: %s is not an execution trace", path.c_str());
+        return false;
+    }
+
+    if(version != TRACE_FILE_VERSION)
+    {
+        OMPL_ERROR("ExecutionTrace: %s has version %u, expected %u", path.c_str(), version, TRACE_FILE_VERSION);
+        return false;
+    }
+
+    steps_.clear();
+    roadmaps_.clear();
+    edges_.clear();
+    rollouts_.clear();
+    modes_.clear();
+
+    bool complete = true;
+
+    while(true)
+    {
+        std::uint8_t type = 0;
+
+        std::uint64_t step = 0;
+
+        in.read(reinterpret_cast<char*>(&type), sizeof(type));
+
+        // a clean end of file between two records
+        if(in.eof())
+            break;
+
+        if(!read(in, step))
+        {
+            complete = false;
+            break;
+        }
+
+        bool ok = true;
+
+        switch(type)
+        {
+            case STEP_RECORD:
+            {
+                Step s;
+                ok = read(in, s);
+                if(ok) steps_.push_back(s);
+                break;
+            }
+
+            case ROADMAP_RECORD:
+            {
+                RoadmapEvent roadmap;
+                roadmap.step = step;
+                ok = readVector(in, roadmap.nodes) && readVector(in, roadmap.edges);
+                if(ok) roadmaps_.push_back(roadmap);
+                break;
+            }
+
+            case EDGE_RECORD:
+            {
+                EdgeEvent edge;
+                edge.step = step;
+                ok = read(in, edge.source) && read(in, edge.target) && read(in, edge.segment);
+                if(ok) edges_.push_back(edge);
+                break;
+            }
+
+            case ROLLOUT_RECORD:
+            {
+                RolloutEvent rollout;
+                rollout.step = step;
+                ok = readVector(in, rollout.candidates) && read(in, rollout.chosen);
+                if(ok) rollouts_.push_back(rollout);
+                break;
+            }
+
+            case MODES_RECORD:
+            {
+                ModesEvent modes;
+                modes.step = step;
+                ok = readVector(in, modes.modes) && readVector(in, modes.weights);
+                if(ok) modes_.push_back(modes);
+                break;
+            }
+
+            default:
+                OMPL_ERROR("ExecutionTrace: Unknown record type %u in %s", (unsigned int)type, path.c_str());
+                ok = false;
+        }
+
+        if(!ok)
+        {
+            complete = false;
+            break;
+        }
+    }
+
+    if(!complete)
+        OMPL_WARN("ExecutionTrace: %s ends with an incomplete record, it was read up to the last complete one", path.c_str());
+
+    OMPL_INFORM("ExecutionTrace: Loaded %u steps, %u edges, %u rollouts and %u mode updates from %s", (unsigned int)steps_.size(),
+                (unsigned int)edges_.size(), (unsigned int)rollouts_.size(), (unsigned int)modes_.size(), path.c_str());
+
+    return true;
+}
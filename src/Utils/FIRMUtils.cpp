@@ -39,6 +39,15 @@
 #include <utility>
 #include <random>
 #include <tinyxml.h>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <exception>
+#include <algorithm>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
 
 
 void FIRMUtils::normalizeAngleToPiRange(double &theta)
@@ -65,6 +74,27 @@ int FIRMUtils::signum(const double d)
             return -1;
 }
 
+namespace
+{
+    std::atomic<bool> headless(false);
+}
+
+void FIRMUtils::setHeadless(bool flag)
+{
+    headless = flag;
+}
+
+bool FIRMUtils::isHeadless()
+{
+    return headless;
+}
+
+void FIRMUtils::waitForViewer(unsigned int milliseconds)
+{
+    if(!headless)
+        boost::this_thread::sleep(boost::posix_time::milliseconds(milliseconds));
+}
+
 int FIRMUtils::generateRandomIntegerInRange(const int floor, const int ceiling)
 {
     //std::random_device rd; // obtain a random number from hardware
@@ -80,7 +110,7 @@ int FIRMUtils::generateRandomIntegerInRange(const int floor, const int ceiling)
     return r;
 }
 
-void FIRMUtils::writeFIRMGraphToXML(const std::vector<std::pair<int,std::pair<arma::colvec,arma::mat> > > nodes, const std::vector<std::pair<std::pair<int,int>,FIRMWeight> > edgeWeights)
+std::string FIRMUtils::writeFIRMGraphToXML(const std::vector<std::pair<int,std::pair<arma::colvec,arma::mat> > > nodes, const std::vector<std::pair<std::pair<int,int>,FIRMWeight> > edgeWeights)
 {
     TiXmlDocument doc;
 
@@ -149,6 +179,8 @@ void FIRMUtils::writeFIRMGraphToXML(const std::vector<std::pair<int,std::pair<ar
     std::string roadmapFileName =  "FIRMRoadMap-" + timeStamp + ".xml";
 
 	doc.SaveFile(roadmapFileName);
+
+    return roadmapFileName;
 }
 
 bool FIRMUtils::readFIRMGraphFromXML(const std::string &pathToXML, std::vector<std::pair<int, arma::colvec> > &FIRMNodePosList, std::vector<std::pair<int, arma::mat> > &FIRMNodeCovarianceList, std::vector<std::pair<std::pair<int,int>,FIRMWeight> > &edgeWeights)
@@ -280,3 +312,182 @@ double FIRMUtils::radian2Degree(double rads)
     return rads*180.0/boost::math::constants::pi<double>();
 }
 
+bool FIRMUtils::readOBJMesh(const std::string &path, std::vector<arma::colvec> &vertices, std::vector<std::vector<int> > &faces)
+{
+    std::ifstream in(path.c_str());
+
+    if(!in.is_open())
+        return false;
+
+    vertices.clear();
+
+    faces.clear();
+
+    std::string line;
+
+    while(std::getline(in, line))
+    {
+        std::istringstream ss(line);
+
+        std::string tag;
+
+        ss >> tag;
+
+        if(tag == "v")
+        {
+            arma::colvec v = arma::zeros<arma::colvec>(3);
+            ss >> v[0] >> v[1] >> v[2];
+            vertices.push_back(v);
+        }
+        else if(tag == "f")
+        {
+            std::vector<int> face;
+            std::string token;
+
+            bool valid = true;
+
+            while(ss >> token)
+            {
+                // "12", "12/3" or "12/3/4", negative indices count back from the last vertex read
+                int index = std::atoi(token.substr(0, token.find('/')).c_str());
+
+                index = index < 0 ? (int)vertices.size() + index : index - 1;
+
+                valid = valid && index >= 0 && index < (int)vertices.size();
+
+                face.push_back(index);
+            }
+
+            if(valid && face.size() >= 2)
+                faces.push_back(face);
+        }
+    }
+
+    return true;
+}
+
+namespace
+{
+    void hashBytes(const char *data, std::size_t n, std::uint64_t &hash)
+    {
+        for(std::size_t i = 0; i < n; i++)
+        {
+            hash ^= (unsigned char)data[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    /** \brief Hash a string with its terminating zero, so that "ab","c" and "a","bc" differ */
+    void hashString(const char *s, std::uint64_t &hash)
+    {
+        hashBytes(s, std::strlen(s) + 1, hash);
+    }
+}
+
+void FIRMUtils::hashXMLElement(const TiXmlElement *element, std::uint64_t &hash)
+{
+    hashString(element->Value(), hash);
+
+    for(const TiXmlAttribute *attr = element->FirstAttribute(); attr; attr = attr->Next())
+    {
+        hashString(attr->Name(), hash);
+        hashString(attr->Value(), hash);
+    }
+
+    for(const TiXmlElement *child = element->FirstChildElement(); child; child = child->NextSiblingElement())
+    {
+        hashXMLElement(child, hash);
+    }
+
+    // close the element, so a child and a following sibling hash differently
+    hashBytes("", 1, hash);
+}
+
+std::uint64_t FIRMUtils::hashFileContents(const std::string &path)
+{
+    std::ifstream in(path.c_str(), std::ios::binary);
+
+    if(!in.is_open())
+        return 0;
+
+    std::uint64_t hash = HASH_SEED;
+
+    char buffer[65536];
+
+    while(in)
+    {
+        in.read(buffer, sizeof(buffer));
+
+        hashBytes(buffer, in.gcount(), hash);
+    }
+
+    return hash;
+}
+
+namespace
+{
+    /** \brief The first exception thrown by a task of parallelFor(), rethrown in the calling thread */
+    struct ParallelForError
+    {
+        boost::mutex mutex;
+
+        std::exception_ptr exception;
+    };
+
+    void parallelForWorker(std::atomic<std::size_t> *next, std::size_t n, const boost::function<void (std::size_t)> *task, ParallelForError *error)
+    {
+        try
+        {
+            // hand out one index at a time, the tasks (e.g. edge controllers) differ a lot in cost
+            for(std::size_t i = (*next)++; i < n; i = (*next)++)
+            {
+                (*task)(i);
+            }
+        }
+        catch(...)
+        {
+            boost::mutex::scoped_lock lock(error->mutex);
+
+            if(!error->exception)
+                error->exception = std::current_exception();
+
+            // the other workers stop after their current task
+            *next = n;
+        }
+    }
+}
+
+void FIRMUtils::parallelFor(std::size_t n, const boost::function<void (std::size_t)> &task, unsigned int numThreads)
+{
+    if(numThreads == 0)
+        numThreads = std::max(1u, boost::thread::hardware_concurrency());
+
+    if(numThreads > n)
+        numThreads = n;
+
+    if(numThreads <= 1)
+    {
+        for(std::size_t i = 0; i < n; i++)
+            task(i);
+
+        return;
+    }
+
+    std::atomic<std::size_t> next(0);
+
+    ParallelForError error;
+
+    boost::thread_group workers;
+
+    // the calling thread takes part too
+    for(unsigned int t = 1; t < numThreads; t++)
+        workers.create_thread(boost::bind(&parallelForWorker, &next, n, &task, &error));
+
+    parallelForWorker(&next, n, &task, &error);
+
+    workers.join_all();
+
+    // an exception must not escape a worker thread, where it would terminate the process
+    if(error.exception)
+        std::rethrow_exception(error.exception);
+}
@@ -0,0 +1,290 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "Utils/ObservabilityMap.h"
+#include "SpaceInformation/SpaceInformation.h"
+#include "LinearSystem/LinearSystem.h"
+#include "Spaces/SE2BeliefSpace.h"
+#include "Filters/dare.h"
+#include "Utils/FIRMUtils.h"
+#include "Utils/SetupConfiguration.h"
+#include <boost/math/constants/constants.hpp>
+#include <fstream>
+#include <cmath>
+#include <cstring>
+#include <tinyxml.h>
+
+namespace
+{
+    const char OBSERVABILITY_MAP_MAGIC[8] = {'F','I','R','M','O','B','S','1'};
+}
+
+ObservabilityMap::ObservabilityMap() : xMin_(0), yMin_(0), resolution_(0), nx_(0), ny_(0), nyaw_(0), sensingFingerprint_(0)
+{
+}
+
+bool ObservabilityMap::isStateStable(const std::shared_ptr<firm::SpaceInformation> &si, const ompl::base::State *state)
+{
+    using namespace arma;
+
+    LinearSystem ls(si, state, si->getMotionModel()->getZeroControl(),
+                    si->getObservationModel()->getObservation(state, false), si->getMotionModel(), si->getObservationModel());
+
+    arma::mat S;
+
+    bool stable = false;
+
+    try
+    {
+        stable = dare (trans(ls.getA()),trans(ls.getH()),ls.getG() * ls.getQ() * trans(ls.getG()),
+                        ls.getM() * ls.getR() * trans(ls.getM()), S );
+    }
+    catch(int e)
+    {
+        stable = false;
+    }
+
+    si->freeState(ls.getX());
+
+    return stable;
+}
+
+void ObservabilityMap::build(const std::shared_ptr<firm::SpaceInformation> &si, double resolution, unsigned int yawBins, std::uint64_t sensingFingerprint)
+{
+    assert(resolution > 0 && yawBins > 0);
+
+    const ompl::base::RealVectorBounds &bounds = si->getStateSpace()->as<SE2BeliefSpace>()->getBounds();
+
+    xMin_ = bounds.low[0];
+    yMin_ = bounds.low[1];
+    resolution_ = resolution;
+    nx_ = std::max(1, (int)std::ceil((bounds.high[0] - bounds.low[0]) / resolution));
+    ny_ = std::max(1, (int)std::ceil((bounds.high[1] - bounds.low[1]) / resolution));
+    nyaw_ = yawBins;
+    sensingFingerprint_ = sensingFingerprint;
+
+    cells_.assign((std::size_t)nx_*ny_*nyaw_, 0);
+
+    const double pi = boost::math::constants::pi<double>();
+
+    const double yawStep = 2*pi / nyaw_;
+
+    ompl::base::State *state = si->allocState();
+
+    std::size_t numStable = 0;
+
+    for(unsigned int j = 0; j < ny_; j++)
+    {
+        for(unsigned int i = 0; i < nx_; i++)
+        {
+            for(unsigned int k = 0; k < nyaw_; k++)
+            {
+                state->as<SE2BeliefSpace::StateType>()->setXYYaw(xMin_ + (i+0.5)*resolution_, yMin_ + (j+0.5)*resolution_, -pi + (k+0.5)*yawStep);
+
+                unsigned char stable = isStateStable(si, state) ? 1 : 0;
+
+                cells_[((std::size_t)j*nx_ + i)*nyaw_ + k] = stable;
+
+                numStable += stable;
+            }
+        }
+    }
+
+    si->freeState(state);
+
+    OMPL_INFORM("ObservabilityMap: Built %u x %u x %u cells, %u are stable", nx_, ny_, nyaw_, (unsigned int)numStable);
+}
+
+bool ObservabilityMap::cellIndex(double x, double y, double yaw, std::size_t &index) const
+{
+    const double pi = boost::math::constants::pi<double>();
+
+    int i = (int)std::floor((x - xMin_) / resolution_);
+    int j = (int)std::floor((y - yMin_) / resolution_);
+
+    if(i < 0 || j < 0 || i >= (int)nx_ || j >= (int)ny_)
+        return false;
+
+    double wrapped = std::fmod(yaw + pi, 2*pi);
+
+    if(wrapped < 0)
+        wrapped += 2*pi;
+
+    int k = std::min((int)nyaw_ - 1, (int)std::floor(wrapped / (2*pi) * nyaw_));
+
+    index = ((std::size_t)j*nx_ + i)*nyaw_ + k;
+
+    return true;
+}
+
+bool ObservabilityMap::isObservable(const ompl::base::State *state) const
+{
+    if(cells_.empty())
+        return true;
+
+    const SE2BeliefSpace::StateType *belief = state->as<SE2BeliefSpace::StateType>();
+
+    std::size_t index = 0;
+
+    if(!cellIndex(belief->getX(), belief->getY(), belief->getYaw(), index))
+        return true;
+
+    return cells_[index] == 1;
+}
+
+bool ObservabilityMap::save(const std::string &path) const
+{
+    std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+
+    if(!out.is_open())
+    {
+        OMPL_ERROR("ObservabilityMap: Could not open %s for writing", path.c_str());
+        return false;
+    }
+
+    std::uint64_t fingerprint = sensingFingerprint_;
+
+    out.write(OBSERVABILITY_MAP_MAGIC, sizeof(OBSERVABILITY_MAP_MAGIC));
+    out.write(reinterpret_cast<const char*>(&fingerprint), sizeof(fingerprint));
+    out.write(reinterpret_cast<const char*>(&xMin_), sizeof(xMin_));
+    out.write(reinterpret_cast<const char*>(&yMin_), sizeof(yMin_));
+    out.write(reinterpret_cast<const char*>(&resolution_), sizeof(resolution_));
+    out.write(reinterpret_cast<const char*>(&nx_), sizeof(nx_));
+    out.write(reinterpret_cast<const char*>(&ny_), sizeof(ny_));
+    out.write(reinterpret_cast<const char*>(&nyaw_), sizeof(nyaw_));
+    out.write(reinterpret_cast<const char*>(cells_.data()), cells_.size());
+
+    return out.good();
+}
+
+bool ObservabilityMap::load(const std::string &path, std::uint64_t sensingFingerprint)
+{
+    std::ifstream in(path.c_str(), std::ios::binary);
+
+    if(!in.is_open())
+        return false;
+
+    char magic[sizeof(OBSERVABILITY_MAP_MAGIC)];
+
+    std::uint64_t fingerprint = 0;
+
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&fingerprint), sizeof(fingerprint));
+
+    if(!in.good() || std::memcmp(magic, OBSERVABILITY_MAP_MAGIC, sizeof(magic)) != 0)
+    {
+        OMPL_ERROR("ObservabilityMap: %s is not an observability map", path.c_str());
+        return false;
+    }
+
+    if(fingerprint != sensingFingerprint)
+    {
+        OMPL_INFORM("ObservabilityMap: %s was built for different landmarks/sensor parameters, ignoring it", path.c_str());
+        return false;
+    }
+
+    double xMin = 0, yMin = 0, resolution = 0;
+    unsigned int nx = 0, ny = 0, nyaw = 0;
+
+    in.read(reinterpret_cast<char*>(&xMin), sizeof(xMin));
+    in.read(reinterpret_cast<char*>(&yMin), sizeof(yMin));
+    in.read(reinterpret_cast<char*>(&resolution), sizeof(resolution));
+    in.read(reinterpret_cast<char*>(&nx), sizeof(nx));
+    in.read(reinterpret_cast<char*>(&ny), sizeof(ny));
+    in.read(reinterpret_cast<char*>(&nyaw), sizeof(nyaw));
+
+    if(!in.good())
+    {
+        OMPL_ERROR("ObservabilityMap: %s is truncated", path.c_str());
+        return false;
+    }
+
+    // the cell count comes from the file, it must fit in what is left of it before anything is allocated
+    const std::streamoff headerEnd = in.tellg();
+
+    in.seekg(0, std::ios::end);
+
+    const std::streamoff remaining = in.tellg() - headerEnd;
+
+    in.seekg(headerEnd);
+
+    const unsigned long long numCells = (unsigned long long)nx*ny*nyaw;
+
+    if(nx == 0 || ny == 0 || nyaw == 0 || remaining < 0 || numCells != (unsigned long long)remaining)
+    {
+        OMPL_ERROR("ObservabilityMap: %s has %llu cells but %lld bytes of cell data", path.c_str(), numCells, (long long)remaining);
+        return false;
+    }
+
+    std::vector<unsigned char> cells((std::size_t)numCells);
+
+    in.read(reinterpret_cast<char*>(cells.data()), cells.size());
+
+    if(!in.good() || resolution <= 0)
+    {
+        OMPL_ERROR("ObservabilityMap: %s is truncated", path.c_str());
+        return false;
+    }
+
+    xMin_ = xMin;
+    yMin_ = yMin;
+    resolution_ = resolution;
+    nx_ = nx;
+    ny_ = ny;
+    nyaw_ = nyaw;
+    sensingFingerprint_ = sensingFingerprint;
+    cells_.swap(cells);
+
+    OMPL_INFORM("ObservabilityMap: Loaded %u x %u x %u cells from %s", nx_, ny_, nyaw_, path.c_str());
+
+    return true;
+}
+
+std::uint64_t ObservabilityMap::fingerprintSensing(const SetupConfiguration &config)
+{
+    std::uint64_t hash = FIRMUtils::HASH_SEED;
+
+    // the stability test linearizes both the observation and the motion model
+    const char *sections[] = {"LandmarkList", "ObservationModels", "MotionModels"};
+
+    for(unsigned int i = 0; i < 3; i++)
+    {
+        const TiXmlElement *element = config.getSection(sections[i]);
+
+        if(element)
+            FIRMUtils::hashXMLElement(element, hash);
+    }
+
+    return hash;
+}
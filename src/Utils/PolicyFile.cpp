@@ -0,0 +1,207 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "Utils/PolicyFile.h"
+#include <ompl/util/Console.h>
+#include <fstream>
+#include <cstring>
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+    const char POLICY_FILE_MAGIC[8] = {'F','I','R','M','P','O','L','Y'};
+
+    /** \brief Goals closer than this in every coordinate are the same goal */
+    const double GOAL_TOLERANCE = 1e-6;
+
+    bool sameGoal(const double a[3], const double b[3])
+    {
+        for(int i = 0; i < 3; i++)
+        {
+            if(std::fabs(a[i] - b[i]) > GOAL_TOLERANCE)
+                return false;
+        }
+
+        return true;
+    }
+}
+
+const std::int64_t PolicyFile::NEXT_NONE;
+
+const std::int64_t PolicyFile::NEXT_GOAL;
+
+PolicyFile::PolicyFile() : fingerprint_(0)
+{
+}
+
+bool PolicyFile::save(const std::string &path) const
+{
+    // written next to the old file and renamed over it, a run killed while saving keeps the old policies
+    const std::string tmpPath = path + ".tmp";
+
+    std::ofstream out(tmpPath.c_str(), std::ios::binary | std::ios::trunc);
+
+    if(!out.is_open())
+    {
+        OMPL_ERROR("PolicyFile: Could not open %s for writing", tmpPath.c_str());
+        return false;
+    }
+
+    const std::uint64_t numPolicies = policies_.size();
+
+    out.write(POLICY_FILE_MAGIC, sizeof(POLICY_FILE_MAGIC));
+    out.write(reinterpret_cast<const char*>(&fingerprint_), sizeof(fingerprint_));
+    out.write(reinterpret_cast<const char*>(&numPolicies), sizeof(numPolicies));
+
+    for(size_t i = 0; i < policies_.size(); i++)
+    {
+        const std::uint64_t numEntries = policies_[i].entries.size();
+
+        out.write(reinterpret_cast<const char*>(policies_[i].goal), sizeof(policies_[i].goal));
+        out.write(reinterpret_cast<const char*>(&numEntries), sizeof(numEntries));
+        out.write(reinterpret_cast<const char*>(policies_[i].entries.data()), sizeof(Entry)*numEntries);
+    }
+
+    out.close();
+
+    if(!out || std::rename(tmpPath.c_str(), path.c_str()) != 0)
+    {
+        OMPL_ERROR("PolicyFile: Could not write %s", path.c_str());
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool PolicyFile::load(const std::string &path, std::uint64_t fingerprint)
+{
+    std::ifstream in(path.c_str(), std::ios::binary);
+
+    if(!in.is_open())
+        return false;
+
+    in.seekg(0, std::ios::end);
+
+    const std::uint64_t fileSize = (std::uint64_t)in.tellg();
+
+    in.seekg(0, std::ios::beg);
+
+    char magic[sizeof(POLICY_FILE_MAGIC)];
+
+    std::uint64_t savedFingerprint = 0, numPolicies = 0;
+
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&savedFingerprint), sizeof(savedFingerprint));
+    in.read(reinterpret_cast<char*>(&numPolicies), sizeof(numPolicies));
+
+    if(!in.good() || std::memcmp(magic, POLICY_FILE_MAGIC, sizeof(magic)) != 0)
+    {
+        OMPL_ERROR("PolicyFile: %s is not a policy file", path.c_str());
+        return false;
+    }
+
+    if(savedFingerprint != fingerprint)
+    {
+        OMPL_INFORM("PolicyFile: %s was solved for a different roadmap, environment or DP parameters, ignoring it", path.c_str());
+        return false;
+    }
+
+    // the counts are only trusted as far as the rest of the file can hold them
+    const std::uint64_t policyHeaderSize = sizeof(Policy::goal) + sizeof(std::uint64_t);
+
+    if(numPolicies > (fileSize - (std::uint64_t)in.tellg()) / policyHeaderSize)
+    {
+        OMPL_ERROR("PolicyFile: %s is truncated", path.c_str());
+        return false;
+    }
+
+    std::vector<Policy> policies(numPolicies);
+
+    for(size_t i = 0; i < policies.size(); i++)
+    {
+        std::uint64_t numEntries = 0;
+
+        in.read(reinterpret_cast<char*>(policies[i].goal), sizeof(policies[i].goal));
+        in.read(reinterpret_cast<char*>(&numEntries), sizeof(numEntries));
+
+        if(!in.good() || numEntries > (fileSize - (std::uint64_t)in.tellg()) / sizeof(Entry))
+        {
+            in.setstate(std::ios::failbit);
+            break;
+        }
+
+        policies[i].entries.resize(numEntries);
+
+        in.read(reinterpret_cast<char*>(policies[i].entries.data()), sizeof(Entry)*numEntries);
+    }
+
+    if(!in.good())
+    {
+        OMPL_ERROR("PolicyFile: %s is truncated", path.c_str());
+        return false;
+    }
+
+    fingerprint_ = fingerprint;
+
+    policies_.swap(policies);
+
+    return true;
+}
+
+const PolicyFile::Policy* PolicyFile::find(const double goal[3]) const
+{
+    for(size_t i = 0; i < policies_.size(); i++)
+    {
+        if(sameGoal(policies_[i].goal, goal))
+            return &policies_[i];
+    }
+
+    return NULL;
+}
+
+void PolicyFile::set(const Policy &policy)
+{
+    for(size_t i = 0; i < policies_.size(); i++)
+    {
+        if(sameGoal(policies_[i].goal, policy.goal))
+        {
+            policies_[i] = policy;
+            return;
+        }
+    }
+
+    policies_.push_back(policy);
+}
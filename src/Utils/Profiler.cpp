@@ -0,0 +1,483 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "Utils/Profiler.h"
+#include <ompl/util/Console.h>
+#include <boost/thread/mutex.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    struct TraceEvent
+    {
+        const char *name;
+
+        std::uint64_t startNs;
+
+        std::uint64_t durationNs;
+
+        unsigned int threadId;
+    };
+
+    struct ThreadStore;
+
+    /** \brief Process wide list of live thread stores and whatever exited threads recorded.
+               It is never destroyed so that thread stores torn down during exit can still retire into it. */
+    struct Registry
+    {
+        Registry() : numDroppedEvents(0), nextThreadId(1), exportRegistered(false)
+        {
+        }
+
+        boost::mutex mutex;
+
+        std::set<ThreadStore*> threads;
+
+        std::map<std::string, Profiler::ScopeStatistics> retiredScopes;
+
+        std::map<std::string, std::uint64_t> retiredCounters;
+
+        std::vector<TraceEvent> retiredEvents;
+
+        /** \brief Trace events of exited threads that did not fit in Profiler::RETIRED_TRACE_EVENTS */
+        std::uint64_t numDroppedEvents;
+
+        unsigned int nextThreadId;
+
+        std::string exportPrefix;
+
+        bool exportRegistered;
+    };
+
+    Registry& registry()
+    {
+        static Registry *instance = new Registry();
+        return *instance;
+    }
+
+    /** \brief What one thread recorded. The mutex is only ever contended while an export reads the store. */
+    struct ThreadStore
+    {
+        ThreadStore()
+        {
+            Registry &reg = registry();
+
+            boost::mutex::scoped_lock lock(reg.mutex);
+
+            threadId = reg.nextThreadId++;
+
+            reg.threads.insert(this);
+        }
+
+        ~ThreadStore()
+        {
+            Registry &reg = registry();
+
+            boost::mutex::scoped_lock lock(reg.mutex);
+
+            reg.threads.erase(this);
+
+            for(auto it = scopes.begin(); it != scopes.end(); ++it)
+                reg.retiredScopes[it->first].merge(it->second);
+
+            for(auto it = counters.begin(); it != counters.end(); ++it)
+                reg.retiredCounters[it->first] += it->second;
+
+            // every short lived worker thread retires its events, without a cap for all of them together they would pile up
+            const std::size_t numKept = std::min<std::size_t>(events.size(), Profiler::RETIRED_TRACE_EVENTS - reg.retiredEvents.size());
+
+            reg.retiredEvents.insert(reg.retiredEvents.end(), events.begin(), events.begin() + numKept);
+
+            reg.numDroppedEvents += events.size() - numKept;
+        }
+
+        boost::mutex mutex;
+
+        std::unordered_map<const char*, Profiler::ScopeStatistics> scopes;
+
+        std::unordered_map<const char*, std::uint64_t> counters;
+
+        std::vector<TraceEvent> events;
+
+        unsigned int threadId;
+    };
+
+    ThreadStore& localStore()
+    {
+        static thread_local ThreadStore store;
+        return store;
+    }
+
+    unsigned int bucketIndex(std::uint64_t ns)
+    {
+        if(ns == 0)
+            return 0;
+
+        unsigned int index = 63 - __builtin_clzll(ns);
+
+        return std::min(index, Profiler::HISTOGRAM_BUCKETS - 1);
+    }
+
+    /** \brief Copy of every trace event recorded so far, sorted by start time */
+    std::vector<TraceEvent> collectEvents()
+    {
+        Registry &reg = registry();
+
+        boost::mutex::scoped_lock lock(reg.mutex);
+
+        std::vector<TraceEvent> events = reg.retiredEvents;
+
+        for(auto it = reg.threads.begin(); it != reg.threads.end(); ++it)
+        {
+            boost::mutex::scoped_lock storeLock((*it)->mutex);
+
+            events.insert(events.end(), (*it)->events.begin(), (*it)->events.end());
+        }
+
+        std::sort(events.begin(), events.end(),
+                  [](const TraceEvent &a, const TraceEvent &b) { return a.startNs < b.startNs; });
+
+        return events;
+    }
+
+    std::string jsonEscape(const std::string &s)
+    {
+        std::string out;
+
+        for(size_t i = 0; i < s.size(); i++)
+        {
+            if(s[i] == '"' || s[i] == '\\')
+                out += '\\';
+            out += s[i];
+        }
+
+        return out;
+    }
+
+    void exportProfile()
+    {
+        std::string prefix;
+        {
+            Registry &reg = registry();
+            boost::mutex::scoped_lock lock(reg.mutex);
+            prefix = reg.exportPrefix;
+        }
+
+        if(prefix.empty())
+            return;
+
+        if(Profiler::writeJSON(prefix + ".json") && Profiler::writeChromeTrace(prefix + "Trace.json"))
+            OMPL_INFORM("Profiler: Wrote %s.json and %sTrace.json", prefix.c_str(), prefix.c_str());
+    }
+}
+
+Profiler::ScopeStatistics::ScopeStatistics() : count(0), totalNs(0), minNs(0), maxNs(0)
+{
+    std::fill(buckets, buckets + HISTOGRAM_BUCKETS, 0);
+}
+
+void Profiler::ScopeStatistics::add(std::uint64_t ns)
+{
+    minNs = count == 0 ? ns : std::min(minNs, ns);
+    maxNs = std::max(maxNs, ns);
+    totalNs += ns;
+    count++;
+    buckets[bucketIndex(ns)]++;
+}
+
+void Profiler::ScopeStatistics::merge(const ScopeStatistics &other)
+{
+    if(other.count == 0)
+        return;
+
+    minNs = count == 0 ? other.minNs : std::min(minNs, other.minNs);
+    maxNs = std::max(maxNs, other.maxNs);
+    totalNs += other.totalNs;
+    count += other.count;
+
+    for(unsigned int i = 0; i < HISTOGRAM_BUCKETS; i++)
+        buckets[i] += other.buckets[i];
+}
+
+double Profiler::ScopeStatistics::quantile(double q) const
+{
+    if(count == 0)
+        return 0;
+
+    const double target = q * count;
+
+    std::uint64_t cumulative = 0;
+
+    for(unsigned int i = 0; i < HISTOGRAM_BUCKETS; i++)
+    {
+        cumulative += buckets[i];
+
+        if(cumulative >= target && buckets[i] > 0)
+        {
+            // upper edge of the bucket, never outside the observed range
+            double upper = double(std::uint64_t(1) << (i + 1));
+            return std::max(double(minNs), std::min(upper, double(maxNs)));
+        }
+    }
+
+    return double(maxNs);
+}
+
+std::uint64_t Profiler::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Profiler::record(const char *name, std::uint64_t startNs, std::uint64_t endNs)
+{
+    ThreadStore &store = localStore();
+
+    const std::uint64_t durationNs = endNs > startNs ? endNs - startNs : 0;
+
+    boost::mutex::scoped_lock lock(store.mutex);
+
+    store.scopes[name].add(durationNs);
+
+    if(store.events.size() < TRACE_EVENTS_PER_THREAD)
+    {
+        TraceEvent event = {name, startNs, durationNs, store.threadId};
+        store.events.push_back(event);
+    }
+}
+
+void Profiler::count(const char *name, std::uint64_t n)
+{
+    ThreadStore &store = localStore();
+
+    boost::mutex::scoped_lock lock(store.mutex);
+
+    store.counters[name] += n;
+}
+
+bool Profiler::isEnabled()
+{
+#ifdef FIRM_ENABLE_PROFILING
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::map<std::string, Profiler::ScopeStatistics> Profiler::getStatistics()
+{
+    Registry &reg = registry();
+
+    boost::mutex::scoped_lock lock(reg.mutex);
+
+    std::map<std::string, ScopeStatistics> stats = reg.retiredScopes;
+
+    for(auto it = reg.threads.begin(); it != reg.threads.end(); ++it)
+    {
+        boost::mutex::scoped_lock storeLock((*it)->mutex);
+
+        for(auto s = (*it)->scopes.begin(); s != (*it)->scopes.end(); ++s)
+            stats[s->first].merge(s->second);
+    }
+
+    return stats;
+}
+
+std::map<std::string, std::uint64_t> Profiler::getCounters()
+{
+    Registry &reg = registry();
+
+    boost::mutex::scoped_lock lock(reg.mutex);
+
+    std::map<std::string, std::uint64_t> counters = reg.retiredCounters;
+
+    for(auto it = reg.threads.begin(); it != reg.threads.end(); ++it)
+    {
+        boost::mutex::scoped_lock storeLock((*it)->mutex);
+
+        for(auto c = (*it)->counters.begin(); c != (*it)->counters.end(); ++c)
+            counters[c->first] += c->second;
+    }
+
+    return counters;
+}
+
+void Profiler::reset()
+{
+    Registry &reg = registry();
+
+    boost::mutex::scoped_lock lock(reg.mutex);
+
+    reg.retiredScopes.clear();
+    reg.retiredCounters.clear();
+    reg.retiredEvents.clear();
+    reg.numDroppedEvents = 0;
+
+    for(auto it = reg.threads.begin(); it != reg.threads.end(); ++it)
+    {
+        boost::mutex::scoped_lock storeLock((*it)->mutex);
+
+        (*it)->scopes.clear();
+        (*it)->counters.clear();
+        (*it)->events.clear();
+    }
+}
+
+bool Profiler::writeJSON(const std::string &path)
+{
+    std::ofstream out(path.c_str(), std::ios::out | std::ios::trunc);
+
+    if(!out.is_open())
+    {
+        OMPL_ERROR("Profiler: Could not open %s for writing", path.c_str());
+        return false;
+    }
+
+    const std::map<std::string, ScopeStatistics> stats = getStatistics();
+
+    const std::map<std::string, std::uint64_t> counters = getCounters();
+
+    out << std::fixed << std::setprecision(3);
+
+    out << "{\n  \"scopes\": {";
+
+    for(auto it = stats.begin(); it != stats.end(); ++it)
+    {
+        const ScopeStatistics &s = it->second;
+
+        out << (it == stats.begin() ? "\n" : ",\n");
+        out << "    \"" << jsonEscape(it->first) << "\": {"
+            << "\"count\": " << s.count
+            << ", \"totalMs\": " << s.totalNs / 1e6
+            << ", \"meanUs\": " << (s.count ? s.totalNs / 1e3 / s.count : 0.0)
+            << ", \"minUs\": " << s.minNs / 1e3
+            << ", \"maxUs\": " << s.maxNs / 1e3
+            << ", \"p50Us\": " << s.quantile(0.5) / 1e3
+            << ", \"p90Us\": " << s.quantile(0.9) / 1e3
+            << ", \"p99Us\": " << s.quantile(0.99) / 1e3
+            << ", \"histogram\": [";
+
+        bool first = true;
+
+        for(unsigned int i = 0; i < HISTOGRAM_BUCKETS; i++)
+        {
+            if(s.buckets[i] == 0)
+                continue;
+
+            out << (first ? "" : ", ") << "{\"fromNs\": " << (i == 0 ? 0 : std::uint64_t(1) << i)
+                << ", \"count\": " << s.buckets[i] << "}";
+
+            first = false;
+        }
+
+        out << "]}";
+    }
+
+    out << "\n  },\n  \"counters\": {";
+
+    for(auto it = counters.begin(); it != counters.end(); ++it)
+    {
+        out << (it == counters.begin() ? "\n" : ",\n");
+        out << "    \"" << jsonEscape(it->first) << "\": " << it->second;
+    }
+
+    out << "\n  }\n}\n";
+
+    return out.good();
+}
+
+bool Profiler::writeChromeTrace(const std::string &path)
+{
+    std::ofstream out(path.c_str(), std::ios::out | std::ios::trunc);
+
+    if(!out.is_open())
+    {
+        OMPL_ERROR("Profiler: Could not open %s for writing", path.c_str());
+        return false;
+    }
+
+    const std::vector<TraceEvent> events = collectEvents();
+
+    {
+        Registry &reg = registry();
+
+        boost::mutex::scoped_lock lock(reg.mutex);
+
+        if(reg.numDroppedEvents > 0)
+            OMPL_WARN("Profiler: %llu trace events of exited threads were dropped, %s is incomplete",
+                      (unsigned long long)reg.numDroppedEvents, path.c_str());
+    }
+
+    const std::uint64_t originNs = events.empty() ? 0 : events.front().startNs;
+
+    out << std::fixed << std::setprecision(3);
+
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+
+    for(size_t i = 0; i < events.size(); i++)
+    {
+        // complete events, timestamps in microseconds
+        out << (i == 0 ? "\n" : ",\n");
+        out << "{\"name\": \"" << jsonEscape(events[i].name) << "\", \"ph\": \"X\", \"pid\": 1"
+            << ", \"tid\": " << events[i].threadId
+            << ", \"ts\": " << (events[i].startNs - originNs) / 1e3
+            << ", \"dur\": " << events[i].durationNs / 1e3 << "}";
+    }
+
+    out << "\n]}\n";
+
+    return out.good();
+}
+
+void Profiler::exportAtExit(const std::string &prefix)
+{
+    Registry &reg = registry();
+
+    boost::mutex::scoped_lock lock(reg.mutex);
+
+    reg.exportPrefix = prefix;
+
+    if(!reg.exportRegistered)
+    {
+        std::atexit(exportProfile);
+        reg.exportRegistered = true;
+    }
+}
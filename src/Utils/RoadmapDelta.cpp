@@ -0,0 +1,200 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "Utils/RoadmapDelta.h"
+#include <ompl/util/Console.h>
+#include <tinyxml.h>
+#include <sstream>
+
+namespace
+{
+    // tinyxml has no 64 bit integer attributes, hashes are written as hex strings
+    std::string toHex(std::uint64_t value)
+    {
+        std::ostringstream os;
+        os << std::hex << value;
+        return os.str();
+    }
+
+    bool fromHex(const char *text, std::uint64_t &value)
+    {
+        if(!text)
+            return false;
+
+        std::istringstream is(text);
+        is >> std::hex >> value;
+        return !is.fail();
+    }
+}
+
+RoadmapDelta::RoadmapDelta() : baseRoadmapHash(0), environmentHash(0), regenerateEdgeControllers(false)
+{
+}
+
+bool RoadmapDelta::save(const std::string &path) const
+{
+    TiXmlDocument doc;
+
+    TiXmlDeclaration *decl = new TiXmlDeclaration("1.0", "", "");
+    doc.LinkEndChild(decl);
+
+    TiXmlElement *root = new TiXmlElement("RoadmapDelta");
+    root->SetAttribute("base", toHex(baseRoadmapHash).c_str());
+    root->SetAttribute("environment", toHex(environmentHash).c_str());
+    root->SetAttribute("regenerateEdgeControllers", regenerateEdgeControllers ? 1 : 0);
+    doc.LinkEndChild(root);
+
+    for(size_t i = 0; i < removedNodes.size(); i++)
+    {
+        TiXmlElement *element = new TiXmlElement("removedNode");
+        element->SetAttribute("id", (int)removedNodes[i]);
+        root->LinkEndChild(element);
+    }
+
+    for(size_t i = 0; i < updatedNodes.size(); i++)
+    {
+        const arma::mat &cov = updatedNodes[i].covariance;
+
+        TiXmlElement *element = new TiXmlElement("node");
+        element->SetAttribute("id", (int)updatedNodes[i].id);
+
+        // the covariance is written row by row as c11 c12 ... like the XML roadmap does
+        for(unsigned int r = 0; r < cov.n_rows; r++)
+        {
+            for(unsigned int c = 0; c < cov.n_cols; c++)
+            {
+                std::ostringstream name;
+                name << "c" << r+1 << c+1;
+                element->SetDoubleAttribute(name.str().c_str(), cov(r, c));
+            }
+        }
+
+        root->LinkEndChild(element);
+    }
+
+    for(size_t i = 0; i < removedEdges.size(); i++)
+    {
+        TiXmlElement *element = new TiXmlElement("removedEdge");
+        element->SetAttribute("index", (int)removedEdges[i]);
+        root->LinkEndChild(element);
+    }
+
+    for(size_t i = 0; i < updatedEdges.size(); i++)
+    {
+        TiXmlElement *element = new TiXmlElement("edge");
+        element->SetAttribute("index", (int)updatedEdges[i].index);
+        element->SetDoubleAttribute("cost", updatedEdges[i].cost);
+        element->SetDoubleAttribute("successProb", updatedEdges[i].successProbability);
+        root->LinkEndChild(element);
+    }
+
+    if(!doc.SaveFile(path.c_str()))
+    {
+        OMPL_ERROR("RoadmapDelta: Could not write %s", path.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool RoadmapDelta::load(const std::string &path)
+{
+    TiXmlDocument doc(path.c_str());
+
+    if(!doc.LoadFile())
+        return false;
+
+    TiXmlElement *root = doc.FirstChildElement("RoadmapDelta");
+
+    if(!root || !fromHex(root->Attribute("base"), baseRoadmapHash) || !fromHex(root->Attribute("environment"), environmentHash))
+    {
+        OMPL_ERROR("RoadmapDelta: %s is not a roadmap delta", path.c_str());
+        return false;
+    }
+
+    int regenerate = 0;
+    root->QueryIntAttribute("regenerateEdgeControllers", &regenerate);
+    regenerateEdgeControllers = regenerate != 0;
+
+    removedNodes.clear();
+    updatedNodes.clear();
+    removedEdges.clear();
+    updatedEdges.clear();
+
+    for(TiXmlElement *element = root->FirstChildElement(); element; element = element->NextSiblingElement())
+    {
+        const std::string tag = element->Value();
+
+        int id = 0;
+
+        if(tag == "removedNode" && element->QueryIntAttribute("id", &id) == TIXML_SUCCESS)
+        {
+            removedNodes.push_back(id);
+        }
+        else if(tag == "node" && element->QueryIntAttribute("id", &id) == TIXML_SUCCESS)
+        {
+            NodeUpdate update;
+            update.id = id;
+            update.covariance = arma::zeros<arma::mat>(3, 3);
+
+            for(unsigned int r = 0; r < 3; r++)
+            {
+                for(unsigned int c = 0; c < 3; c++)
+                {
+                    std::ostringstream name;
+                    name << "c" << r+1 << c+1;
+                    element->QueryDoubleAttribute(name.str().c_str(), &update.covariance(r, c));
+                }
+            }
+
+            updatedNodes.push_back(update);
+        }
+        else if(tag == "removedEdge" && element->QueryIntAttribute("index", &id) == TIXML_SUCCESS)
+        {
+            removedEdges.push_back(id);
+        }
+        else if(tag == "edge" && element->QueryIntAttribute("index", &id) == TIXML_SUCCESS)
+        {
+            EdgeUpdate update;
+            update.index = id;
+            update.cost = 0;
+            update.successProbability = 0;
+            element->QueryDoubleAttribute("cost", &update.cost);
+            element->QueryDoubleAttribute("successProb", &update.successProbability);
+            updatedEdges.push_back(update);
+        }
+    }
+
+    return true;
+}
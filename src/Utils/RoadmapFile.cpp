@@ -0,0 +1,332 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "Utils/RoadmapFile.h"
+#include "Utils/EnvironmentStamp.h"
+#include <ompl/util/Console.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <cassert>
+
+namespace
+{
+    const char ROADMAP_FILE_MAGIC[8] = {'F','I','R','M','R','M','A','P'};
+
+    /** \brief Layout of the start of a roadmap file */
+    struct RoadmapFileHeader
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t stateDimension;
+        std::uint32_t controlDimension;
+        std::uint32_t reserved;
+        std::uint64_t numNodes;
+        std::uint64_t numEdges;
+        std::uint64_t numTrajectoryValues;
+        std::uint32_t hasStamp;
+        std::uint32_t reserved2;
+        std::uint64_t meshHash;
+        std::uint64_t landmarkHash;
+        std::uint64_t observationModelHash;
+        std::uint64_t motionModelHash;
+        double sensingRange;
+        std::uint64_t numFaces;
+        std::uint64_t numLandmarks;
+    };
+
+    const RoadmapFileHeader* header(const void *mapped)
+    {
+        return static_cast<const RoadmapFileHeader*>(mapped);
+    }
+}
+
+RoadmapFile::RoadmapFile() : mapped_(NULL), mappedSize_(0), nodes_(NULL), edges_(NULL), trajectories_(NULL),
+    stampFaces_(NULL), stampLandmarks_(NULL)
+{
+}
+
+RoadmapFile::~RoadmapFile()
+{
+    unmap();
+}
+
+bool RoadmapFile::write(const std::string &path, std::uint32_t stateDimension, std::uint32_t controlDimension,
+                        const std::vector<Node> &nodes, const std::vector<Edge> &edges, const std::vector<double> &trajectories,
+                        const EnvironmentStamp *stamp)
+{
+    RoadmapFileHeader h;
+
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, ROADMAP_FILE_MAGIC, sizeof(h.magic));
+    h.version = VERSION;
+    h.stateDimension = stateDimension;
+    h.controlDimension = controlDimension;
+    h.numNodes = nodes.size();
+    h.numEdges = edges.size();
+    h.numTrajectoryValues = trajectories.size();
+    h.sensingRange = -1;
+
+    if(stamp)
+    {
+        h.hasStamp = 1;
+        h.meshHash = stamp->meshHash;
+        h.landmarkHash = stamp->landmarkHash;
+        h.observationModelHash = stamp->observationModelHash;
+        h.motionModelHash = stamp->motionModelHash;
+        h.sensingRange = stamp->sensingRange;
+        h.numFaces = stamp->faces.size();
+        h.numLandmarks = stamp->landmarks.size();
+    }
+
+    std::string tmpPath = path + ".tmp";
+
+    std::ofstream out(tmpPath.c_str(), std::ios::binary | std::ios::trunc);
+
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+
+    if(!nodes.empty())
+        out.write(reinterpret_cast<const char*>(&nodes[0]), sizeof(Node)*nodes.size());
+
+    if(!edges.empty())
+        out.write(reinterpret_cast<const char*>(&edges[0]), sizeof(Edge)*edges.size());
+
+    if(!trajectories.empty())
+        out.write(reinterpret_cast<const char*>(&trajectories[0]), sizeof(double)*trajectories.size());
+
+    if(stamp && !stamp->faces.empty())
+        out.write(reinterpret_cast<const char*>(&stamp->faces[0]), sizeof(EnvironmentStamp::Face)*stamp->faces.size());
+
+    if(stamp && !stamp->landmarks.empty())
+        out.write(reinterpret_cast<const char*>(&stamp->landmarks[0]), sizeof(EnvironmentStamp::Landmark)*stamp->landmarks.size());
+
+    out.close();
+
+    if(!out || std::rename(tmpPath.c_str(), path.c_str()) != 0)
+    {
+        OMPL_ERROR("RoadmapFile: Could not write %s", path.c_str());
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool RoadmapFile::isRoadmapFile(const std::string &path)
+{
+    std::ifstream in(path.c_str(), std::ios::binary);
+
+    char magic[sizeof(ROADMAP_FILE_MAGIC)];
+
+    if(!in.read(magic, sizeof(magic)))
+        return false;
+
+    return std::memcmp(magic, ROADMAP_FILE_MAGIC, sizeof(magic)) == 0;
+}
+
+bool RoadmapFile::map(const std::string &path)
+{
+    unmap();
+
+    int fd = open(path.c_str(), O_RDONLY);
+
+    if(fd < 0)
+    {
+        OMPL_ERROR("RoadmapFile: Could not open %s", path.c_str());
+        return false;
+    }
+
+    struct stat st;
+
+    if(fstat(fd, &st) != 0 || (std::size_t)st.st_size < sizeof(RoadmapFileHeader))
+    {
+        close(fd);
+        OMPL_ERROR("RoadmapFile: %s is too short to be a roadmap", path.c_str());
+        return false;
+    }
+
+    void *mapped = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // the mapping stays valid after the descriptor is closed
+    close(fd);
+
+    if(mapped == MAP_FAILED)
+    {
+        OMPL_ERROR("RoadmapFile: Could not map %s", path.c_str());
+        return false;
+    }
+
+    const RoadmapFileHeader *h = header(mapped);
+
+    if(std::memcmp(h->magic, ROADMAP_FILE_MAGIC, sizeof(h->magic)) != 0 || h->version != VERSION)
+    {
+        OMPL_ERROR("RoadmapFile: %s is not a version %u roadmap", path.c_str(), VERSION);
+        munmap(mapped, st.st_size);
+        return false;
+    }
+
+    const std::size_t expectedSize = sizeof(RoadmapFileHeader) + sizeof(Node)*h->numNodes + sizeof(Edge)*h->numEdges
+                                     + sizeof(double)*h->numTrajectoryValues + sizeof(EnvironmentStamp::Face)*h->numFaces
+                                     + sizeof(EnvironmentStamp::Landmark)*h->numLandmarks;
+
+    if((std::size_t)st.st_size != expectedSize)
+    {
+        OMPL_ERROR("RoadmapFile: %s is truncated or corrupt", path.c_str());
+        munmap(mapped, st.st_size);
+        return false;
+    }
+
+    const char *data = static_cast<const char*>(mapped) + sizeof(RoadmapFileHeader);
+
+    const Node *nodes = reinterpret_cast<const Node*>(data);
+
+    const Edge *edges = reinterpret_cast<const Edge*>(data + sizeof(Node)*h->numNodes);
+
+    const double *trajectories = reinterpret_cast<const double*>(data + sizeof(Node)*h->numNodes + sizeof(Edge)*h->numEdges);
+
+    const char *faces = reinterpret_cast<const char*>(trajectories + h->numTrajectoryValues);
+
+    const char *landmarks = faces + sizeof(EnvironmentStamp::Face)*h->numFaces;
+
+    // make sure no edge points outside the file before anybody dereferences it
+    const std::uint64_t valuesPerStep = h->stateDimension + h->controlDimension;
+
+    for(std::uint64_t i = 0; i < h->numEdges; i++)
+    {
+        if(edges[i].source < 0 || edges[i].target < 0 || (std::uint64_t)edges[i].source >= h->numNodes || (std::uint64_t)edges[i].target >= h->numNodes
+            || edges[i].trajectoryOffset + edges[i].trajectoryLength*valuesPerStep > h->numTrajectoryValues)
+        {
+            OMPL_ERROR("RoadmapFile: Edge %lu in %s is corrupt", (unsigned long)i, path.c_str());
+            munmap(mapped, st.st_size);
+            return false;
+        }
+    }
+
+    mapped_ = mapped;
+    mappedSize_ = st.st_size;
+    nodes_ = nodes;
+    edges_ = edges;
+    trajectories_ = trajectories;
+    stampFaces_ = faces;
+    stampLandmarks_ = landmarks;
+
+    return true;
+}
+
+void RoadmapFile::unmap()
+{
+    if(mapped_)
+        munmap(mapped_, mappedSize_);
+
+    mapped_ = NULL;
+    mappedSize_ = 0;
+    nodes_ = NULL;
+    edges_ = NULL;
+    trajectories_ = NULL;
+    stampFaces_ = NULL;
+    stampLandmarks_ = NULL;
+}
+
+std::uint32_t RoadmapFile::getStateDimension() const
+{
+    assert(mapped_);
+    return header(mapped_)->stateDimension;
+}
+
+std::uint32_t RoadmapFile::getControlDimension() const
+{
+    assert(mapped_);
+    return header(mapped_)->controlDimension;
+}
+
+std::size_t RoadmapFile::getNumNodes() const
+{
+    return mapped_ ? header(mapped_)->numNodes : 0;
+}
+
+std::size_t RoadmapFile::getNumEdges() const
+{
+    return mapped_ ? header(mapped_)->numEdges : 0;
+}
+
+const RoadmapFile::Node& RoadmapFile::getNode(std::size_t i) const
+{
+    assert(i < getNumNodes());
+    return nodes_[i];
+}
+
+const RoadmapFile::Edge& RoadmapFile::getEdge(std::size_t i) const
+{
+    assert(i < getNumEdges());
+    return edges_[i];
+}
+
+const double* RoadmapFile::getNominalStates(const Edge &edge) const
+{
+    return trajectories_ + edge.trajectoryOffset;
+}
+
+const double* RoadmapFile::getNominalControls(const Edge &edge) const
+{
+    return trajectories_ + edge.trajectoryOffset + edge.trajectoryLength*getStateDimension();
+}
+
+bool RoadmapFile::getEnvironmentStamp(EnvironmentStamp &stamp) const
+{
+    assert(mapped_);
+
+    const RoadmapFileHeader *h = header(mapped_);
+
+    if(!h->hasStamp)
+        return false;
+
+    stamp.meshHash = h->meshHash;
+    stamp.landmarkHash = h->landmarkHash;
+    stamp.observationModelHash = h->observationModelHash;
+    stamp.motionModelHash = h->motionModelHash;
+    stamp.sensingRange = h->sensingRange;
+
+    const EnvironmentStamp::Face *faces = static_cast<const EnvironmentStamp::Face*>(stampFaces_);
+
+    const EnvironmentStamp::Landmark *landmarks = static_cast<const EnvironmentStamp::Landmark*>(stampLandmarks_);
+
+    stamp.faces.assign(faces, faces + h->numFaces);
+    stamp.landmarks.assign(landmarks, landmarks + h->numLandmarks);
+
+    return true;
+}
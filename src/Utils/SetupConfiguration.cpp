@@ -0,0 +1,103 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "Utils/SetupConfiguration.h"
+#include <ompl/util/Console.h>
+#include <boost/algorithm/string.hpp>
+#include <cstdio>
+#include <cstdlib>
+
+SetupConfiguration::SetupConfiguration(const std::string &pathToSetupFile) : path_(pathToSetupFile), doc_(pathToSetupFile.c_str())
+{
+    if(!doc_.LoadFile())
+    {
+        printf( "Could not load setup file %s. Error='%s'. Exiting.\n", pathToSetupFile.c_str(), doc_.ErrorDesc() );
+
+        exit( 1 );
+    }
+}
+
+bool SetupConfiguration::setAttribute(const std::string &override)
+{
+    const size_t at = override.find('@');
+
+    const size_t eq = at == std::string::npos ? std::string::npos : override.find('=', at);
+
+    if(at == std::string::npos || eq == std::string::npos || at == 0 || eq == at + 1)
+    {
+        OMPL_ERROR("SetupConfiguration: Override '%s' is not of the form Section/Child@attribute=value", override.c_str());
+        return false;
+    }
+
+    std::vector<std::string> path;
+
+    boost::algorithm::split(path, override.substr(0, at), boost::algorithm::is_any_of("/"));
+
+    TiXmlElement *element = doc_.FirstChildElement(path[0].c_str());
+
+    for(size_t i = 1; element && i < path.size(); i++)
+        element = element->FirstChildElement(path[i].c_str());
+
+    if(!element)
+    {
+        OMPL_ERROR("SetupConfiguration: %s has no element %s", path_.c_str(), override.substr(0, at).c_str());
+        return false;
+    }
+
+    element->SetAttribute(override.substr(at + 1, eq - at - 1).c_str(), override.substr(eq + 1).c_str());
+
+    return true;
+}
+
+bool SetupConfiguration::setAttributes(const std::vector<std::string> &overrides)
+{
+    for(size_t i = 0; i < overrides.size(); i++)
+    {
+        if(!setAttribute(overrides[i]))
+            return false;
+    }
+
+    return true;
+}
+
+bool SetupConfiguration::saveFile(const std::string &path) const
+{
+    if(!doc_.SaveFile(path.c_str()))
+    {
+        OMPL_ERROR("SetupConfiguration: Could not write %s", path.c_str());
+        return false;
+    }
+
+    return true;
+}
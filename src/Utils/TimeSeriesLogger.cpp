@@ -0,0 +1,229 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "Utils/TimeSeriesLogger.h"
+#include <ompl/util/Console.h>
+#include <cassert>
+
+namespace ompl
+{
+    namespace magic
+    {
+        /** \brief Longest time in milliseconds a logged row waits before it is written to disk */
+        static const unsigned int TIME_SERIES_LOG_FLUSH_PERIOD = 500;
+    }
+}
+
+TimeSeriesLogger::TimeSeriesLogger(size_t capacity) : ring_(capacity), batch_(capacity), head_(0), count_(0), writing_(0), isOpen_(false), stop_(false)
+{
+    assert(capacity > 0);
+}
+
+TimeSeriesLogger::~TimeSeriesLogger()
+{
+    close();
+}
+
+bool TimeSeriesLogger::open(const std::string &path)
+{
+    close();
+
+    file_.open(path.c_str(), std::ios::out | std::ios::trunc);
+
+    if(!file_.is_open())
+    {
+        OMPL_ERROR("TimeSeriesLogger: Could not open %s for writing", path.c_str());
+        return false;
+    }
+
+    stop_ = false;
+
+    isOpen_ = true;
+
+    writerThread_ = boost::thread(&TimeSeriesLogger::writerLoop, this);
+
+    return true;
+}
+
+void TimeSeriesLogger::close()
+{
+    if(!isOpen_)
+        return;
+
+    {
+        boost::mutex::scoped_lock lock(mutex_);
+        stop_ = true;
+    }
+
+    rowsAvailable_.notify_one();
+
+    writerThread_.join();
+
+    file_.close();
+
+    isOpen_ = false;
+}
+
+void TimeSeriesLogger::log(double time, double value)
+{
+    if(!isOpen_)
+        return;
+
+    boost::unique_lock<boost::mutex> lock(mutex_);
+
+    Row &row = nextRow(lock);
+
+    row.time = time;
+    row.values.resize(1);
+    row.values[0] = value;
+}
+
+void TimeSeriesLogger::log(double time, const std::vector<double> &values)
+{
+    if(!isOpen_)
+        return;
+
+    boost::unique_lock<boost::mutex> lock(mutex_);
+
+    Row &row = nextRow(lock);
+
+    row.time = time;
+    row.values.assign(values.begin(), values.end());
+}
+
+void TimeSeriesLogger::log(double time, const std::vector<float> &values)
+{
+    if(!isOpen_)
+        return;
+
+    boost::unique_lock<boost::mutex> lock(mutex_);
+
+    Row &row = nextRow(lock);
+
+    row.time = time;
+    row.values.assign(values.begin(), values.end());
+}
+
+void TimeSeriesLogger::flush()
+{
+    if(!isOpen_)
+        return;
+
+    boost::unique_lock<boost::mutex> lock(mutex_);
+
+    rowsAvailable_.notify_one();
+
+    while(count_ > 0 || writing_ > 0)
+    {
+        rowsWritten_.wait(lock);
+    }
+}
+
+TimeSeriesLogger::Row& TimeSeriesLogger::nextRow(boost::unique_lock<boost::mutex> &lock)
+{
+    while(count_ == ring_.size())
+    {
+        rowsAvailable_.notify_one();
+        rowsWritten_.wait(lock);
+    }
+
+    Row &row = ring_[(head_ + count_) % ring_.size()];
+
+    count_++;
+
+    // wake the writer early once the ring is half full
+    if(count_ == ring_.size()/2)
+        rowsAvailable_.notify_one();
+
+    return row;
+}
+
+void TimeSeriesLogger::writerLoop()
+{
+    boost::unique_lock<boost::mutex> lock(mutex_);
+
+    while(true)
+    {
+        if(count_ == 0 && !stop_)
+        {
+            rowsAvailable_.timed_wait(lock, boost::posix_time::milliseconds(ompl::magic::TIME_SERIES_LOG_FLUSH_PERIOD));
+        }
+
+        if(count_ == 0)
+        {
+            if(stop_)
+                break;
+
+            continue;
+        }
+
+        // move the pending rows out of the ring so producers can keep going while we write
+        size_t n = count_;
+
+        for(size_t i = 0; i < n; i++)
+        {
+            std::swap(batch_[i], ring_[(head_ + i) % ring_.size()]);
+        }
+
+        head_ = (head_ + n) % ring_.size();
+
+        count_ = 0;
+
+        writing_ = n;
+
+        rowsWritten_.notify_all();
+
+        lock.unlock();
+
+        for(size_t i = 0; i < n; i++)
+        {
+            file_ << batch_[i].time;
+
+            for(size_t j = 0; j < batch_[i].values.size(); j++)
+            {
+                file_ << "," << batch_[i].values[j];
+            }
+
+            file_ << "\n";
+        }
+
+        file_.flush();
+
+        lock.lock();
+
+        writing_ = 0;
+
+        rowsWritten_.notify_all();
+    }
+}
@@ -0,0 +1,148 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "ValidityCheckers/ClearanceAdaptiveMotionValidator.h"
+#include "Spaces/SE2BeliefSpace.h"
+#include "Utils/Profiler.h"
+#include <boost/math/constants/constants.hpp>
+#include <cmath>
+
+ClearanceAdaptiveMotionValidator::ClearanceAdaptiveMotionValidator(const ompl::base::SpaceInformationPtr &si, double boundingRadius) :
+    ompl::base::MotionValidator(si), boundingRadius_(boundingRadius)
+{
+}
+
+double ClearanceAdaptiveMotionValidator::advance(const ompl::base::State *s1, const ompl::base::State *s2) const
+{
+    const SE2BeliefSpace::StateType *from = s1->as<SE2BeliefSpace::StateType>();
+    const SE2BeliefSpace::StateType *to = s2->as<SE2BeliefSpace::StateType>();
+
+    const double pi = boost::math::constants::pi<double>();
+
+    double dYaw = std::fabs(to->getYaw() - from->getYaw());
+
+    if(dYaw > pi)
+        dYaw = 2*pi - dYaw;
+
+    // upper bound on how far any point of the robot moves over the whole motion
+    const double sweep = std::hypot(to->getX() - from->getX(), to->getY() - from->getY()) + boundingRadius_*dYaw;
+
+    // the smallest step, same spacing as the discrete motion validator uses
+    const double fineStep = si_->getStateValidityCheckingResolution() * si_->getMaximumExtent();
+
+    if(sweep <= 0)
+        return si_->isValid(s1) ? 1.0 : 0.0;
+
+    const ompl::base::StateValidityCheckerPtr &svc = si_->getStateValidityChecker();
+
+    const bool hasClearance = svc->getSpecs().clearanceComputationType != ompl::base::StateValidityCheckerSpecs::NONE;
+
+    ompl::base::State *test = si_->allocState();
+
+    double t = 0.0;
+
+    double lastValidT = 0.0;
+
+    bool valid = true;
+
+    while(true)
+    {
+        si_->getStateSpace()->interpolate(s1, s2, t, test);
+
+        double clearance = 0.0;
+
+        if(hasClearance)
+        {
+            valid = svc->isValid(test, clearance) && si_->satisfiesBounds(test);
+        }
+        else
+        {
+            valid = si_->isValid(test);
+        }
+
+        if(!valid)
+            break;
+
+        lastValidT = t;
+
+        if(t >= 1.0)
+            break;
+
+        // the motion is free as long as the sweep stays within the clearance
+        t = std::min(1.0, t + std::max(clearance, fineStep) / sweep);
+    }
+
+    si_->freeState(test);
+
+    return valid ? 1.0 : lastValidT;
+}
+
+bool ClearanceAdaptiveMotionValidator::checkMotion(const ompl::base::State *s1, const ompl::base::State *s2) const
+{
+    FIRM_PROFILE_SCOPE("MotionValidator::checkMotion");
+
+    bool result = advance(s1, s2) >= 1.0;
+
+    if(result)
+        valid_++;
+    else
+        invalid_++;
+
+    return result;
+}
+
+bool ClearanceAdaptiveMotionValidator::checkMotion(const ompl::base::State *s1, const ompl::base::State *s2, std::pair<ompl::base::State*, double> &lastValid) const
+{
+    FIRM_PROFILE_SCOPE("MotionValidator::checkMotion");
+
+    double t = advance(s1, s2);
+
+    bool result = t >= 1.0;
+
+    if(result)
+    {
+        valid_++;
+    }
+    else
+    {
+        lastValid.second = t;
+
+        if(lastValid.first)
+            si_->getStateSpace()->interpolate(s1, s2, t, lastValid.first);
+
+        invalid_++;
+    }
+
+    return result;
+}
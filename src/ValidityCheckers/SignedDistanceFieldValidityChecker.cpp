@@ -0,0 +1,460 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "ValidityCheckers/SignedDistanceFieldValidityChecker.h"
+#include "Spaces/SE2BeliefSpace.h"
+#include <ompl/util/Console.h>
+#include <ompl/util/Exception.h>
+#include "Utils/FIRMUtils.h"
+#include "Utils/Profiler.h"
+#include <boost/functional/hash.hpp>
+#include <boost/filesystem.hpp>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <limits>
+#include <cmath>
+#include <cstdlib>
+#include <cassert>
+
+namespace
+{
+    const char SDF_CACHE_MAGIC[8] = {'F','I','R','M','S','D','F','1'};
+
+    /** \brief Layout of the start of a cache file, the distances follow as floats */
+    struct SDFCacheHeader
+    {
+        char magic[8];
+        std::uint64_t key;
+        double xMin, yMin, resolution;
+        std::int32_t nx, ny;
+    };
+
+    struct Point2D
+    {
+        double x, y;
+    };
+}
+
+SignedDistanceFieldValidityChecker::SignedDistanceFieldValidityChecker(const ompl::base::SpaceInformationPtr &si, const std::string &pathToEnvironmentMesh,
+                                                                       double resolution, double robotRadius, const std::string &cacheDirectory) :
+    ompl::base::StateValidityChecker(si), xMin_(0), yMin_(0), resolution_(resolution), nx_(0), ny_(0), robotRadius_(robotRadius),
+    distances_(NULL), mapped_(NULL), mappedSize_(0)
+{
+    assert(resolution > 0);
+
+    specs_.clearanceComputationType = ompl::base::StateValidityCheckerSpecs::APPROXIMATE;
+
+    std::string cachePath;
+
+    std::uint64_t key = 0;
+
+    if(!cacheDirectory.empty())
+    {
+        // the padding around the mesh depends on the radius, so it is part of the key too
+        std::size_t seed = FIRMUtils::hashFileContents(pathToEnvironmentMesh);
+        boost::hash_combine(seed, resolution);
+        boost::hash_combine(seed, robotRadius);
+        key = seed;
+
+        std::ostringstream name;
+        name << std::hex << key;
+
+        cachePath = (boost::filesystem::path(cacheDirectory) / ("sdf-" + name.str() + ".bin")).string();
+
+        if(mapCache(cachePath, key))
+        {
+            OMPL_INFORM("SignedDistanceFieldValidityChecker: Mapped %d x %d field for %s from %s", nx_, ny_, pathToEnvironmentMesh.c_str(), cachePath.c_str());
+            return;
+        }
+    }
+
+    std::vector<unsigned char> occupied;
+
+    if(!rasterizeMesh(pathToEnvironmentMesh, occupied))
+    {
+        throw ompl::Exception("SignedDistanceFieldValidityChecker: Could not read environment mesh " + pathToEnvironmentMesh);
+    }
+
+    computeSignedDistances(occupied);
+
+    OMPL_INFORM("SignedDistanceFieldValidityChecker: Built %d x %d field at %f m resolution for %s", nx_, ny_, resolution_, pathToEnvironmentMesh.c_str());
+
+    if(!cachePath.empty())
+    {
+        boost::system::error_code ec;
+        boost::filesystem::create_directories(cacheDirectory, ec);
+
+        writeCache(cachePath, key);
+    }
+}
+
+SignedDistanceFieldValidityChecker::~SignedDistanceFieldValidityChecker()
+{
+    if(mapped_)
+        munmap(mapped_, mappedSize_);
+}
+
+bool SignedDistanceFieldValidityChecker::mapCache(const std::string &path, std::uint64_t key)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+
+    if(fd < 0)
+        return false;
+
+    struct stat st;
+
+    if(fstat(fd, &st) != 0 || (std::size_t)st.st_size < sizeof(SDFCacheHeader))
+    {
+        close(fd);
+        return false;
+    }
+
+    void *mapped = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // the mapping stays valid after the descriptor is closed
+    close(fd);
+
+    if(mapped == MAP_FAILED)
+        return false;
+
+    const SDFCacheHeader *header = static_cast<const SDFCacheHeader*>(mapped);
+
+    const std::size_t expectedSize = sizeof(SDFCacheHeader) + sizeof(float)*(std::size_t)header->nx*header->ny;
+
+    if(std::memcmp(header->magic, SDF_CACHE_MAGIC, sizeof(header->magic)) != 0 || header->key != key
+        || header->nx <= 0 || header->ny <= 0 || (std::size_t)st.st_size != expectedSize)
+    {
+        munmap(mapped, st.st_size);
+        return false;
+    }
+
+    xMin_ = header->xMin;
+    yMin_ = header->yMin;
+    resolution_ = header->resolution;
+    nx_ = header->nx;
+    ny_ = header->ny;
+
+    mapped_ = mapped;
+    mappedSize_ = st.st_size;
+    distances_ = reinterpret_cast<const float*>(static_cast<const char*>(mapped) + sizeof(SDFCacheHeader));
+
+    return true;
+}
+
+void SignedDistanceFieldValidityChecker::writeCache(const std::string &path, std::uint64_t key) const
+{
+    SDFCacheHeader header;
+
+    std::memcpy(header.magic, SDF_CACHE_MAGIC, sizeof(header.magic));
+    header.key = key;
+    header.xMin = xMin_;
+    header.yMin = yMin_;
+    header.resolution = resolution_;
+    header.nx = nx_;
+    header.ny = ny_;
+
+    // write to a temporary file and rename so that a concurrent reader never maps a partial file
+    std::string tmpPath = path + ".tmp";
+
+    std::ofstream out(tmpPath.c_str(), std::ios::binary | std::ios::trunc);
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(distances_), sizeof(float)*(std::size_t)nx_*ny_);
+    out.close();
+
+    if(!out || std::rename(tmpPath.c_str(), path.c_str()) != 0)
+    {
+        OMPL_WARN("SignedDistanceFieldValidityChecker: Could not write cache file %s", path.c_str());
+        std::remove(tmpPath.c_str());
+    }
+}
+
+bool SignedDistanceFieldValidityChecker::rasterizeMesh(const std::string &pathToEnvironmentMesh, std::vector<unsigned char> &occupied)
+{
+    std::vector<arma::colvec> meshVertices;
+
+    std::vector<std::vector<int> > faces;
+
+    if(!FIRMUtils::readOBJMesh(pathToEnvironmentMesh, meshVertices, faces) || meshVertices.empty())
+        return false;
+
+    std::vector<Point2D> vertices(meshVertices.size());
+
+    for(size_t i = 0; i < meshVertices.size(); i++)
+    {
+        vertices[i].x = meshVertices[i][0];
+        vertices[i].y = meshVertices[i][1];
+    }
+
+    double xmin = vertices[0].x, xmax = vertices[0].x, ymin = vertices[0].y, ymax = vertices[0].y;
+
+    for(size_t i = 1; i < vertices.size(); i++)
+    {
+        xmin = std::min(xmin, vertices[i].x);
+        xmax = std::max(xmax, vertices[i].x);
+        ymin = std::min(ymin, vertices[i].y);
+        ymax = std::max(ymax, vertices[i].y);
+    }
+
+    // leave room around the mesh so that the field is meaningful up to the robot radius outside of it
+    const double pad = robotRadius_ + 2*resolution_;
+
+    xMin_ = xmin - pad;
+    yMin_ = ymin - pad;
+    nx_ = (int)std::ceil((xmax - xmin + 2*pad) / resolution_);
+    ny_ = (int)std::ceil((ymax - ymin + 2*pad) / resolution_);
+
+    occupied.assign((size_t)nx_*ny_, 0);
+
+    for(size_t f = 0; f < faces.size(); f++)
+    {
+        const std::vector<int> &face = faces[f];
+
+        // vertical faces project to segments, so the outline is always drawn
+        for(size_t k = 0; k < face.size(); k++)
+        {
+            const Point2D &a = vertices[face[k]];
+            const Point2D &b = vertices[face[(k+1) % face.size()]];
+
+            double length = std::hypot(b.x - a.x, b.y - a.y);
+
+            int steps = std::max(1, (int)std::ceil(2*length / resolution_));
+
+            for(int s = 0; s <= steps; s++)
+            {
+                double t = (double)s / steps;
+
+                int i = (int)std::floor((a.x + t*(b.x - a.x) - xMin_) / resolution_);
+                int j = (int)std::floor((a.y + t*(b.y - a.y) - yMin_) / resolution_);
+
+                if(i >= 0 && j >= 0 && i < nx_ && j < ny_)
+                    occupied[(size_t)j*nx_ + i] = 1;
+            }
+        }
+
+        // fill the interior of faces that are not vertical, as a triangle fan
+        for(size_t k = 1; k + 1 < face.size(); k++)
+        {
+            const Point2D &a = vertices[face[0]];
+            const Point2D &b = vertices[face[k]];
+            const Point2D &c = vertices[face[k+1]];
+
+            double area = (b.x - a.x)*(c.y - a.y) - (c.x - a.x)*(b.y - a.y);
+
+            if(std::abs(area) < 1e-12)
+                continue;
+
+            int i0 = std::max(0, (int)std::floor((std::min(a.x, std::min(b.x, c.x)) - xMin_) / resolution_));
+            int i1 = std::min(nx_ - 1, (int)std::floor((std::max(a.x, std::max(b.x, c.x)) - xMin_) / resolution_));
+            int j0 = std::max(0, (int)std::floor((std::min(a.y, std::min(b.y, c.y)) - yMin_) / resolution_));
+            int j1 = std::min(ny_ - 1, (int)std::floor((std::max(a.y, std::max(b.y, c.y)) - yMin_) / resolution_));
+
+            for(int j = j0; j <= j1; j++)
+            {
+                for(int i = i0; i <= i1; i++)
+                {
+                    double px = xMin_ + (i + 0.5)*resolution_;
+                    double py = yMin_ + (j + 0.5)*resolution_;
+
+                    double w0 = ((b.x - px)*(c.y - py) - (c.x - px)*(b.y - py)) / area;
+                    double w1 = ((c.x - px)*(a.y - py) - (a.x - px)*(c.y - py)) / area;
+                    double w2 = 1.0 - w0 - w1;
+
+                    if(w0 >= 0 && w1 >= 0 && w2 >= 0)
+                        occupied[(size_t)j*nx_ + i] = 1;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+void SignedDistanceFieldValidityChecker::squaredDistanceTransform(const std::vector<unsigned char> &seed, std::vector<double> &dist) const
+{
+    // exact Euclidean distance transform, one 1D lower envelope pass along x then along y
+    const double inf = std::numeric_limits<double>::max() / 4;
+
+    dist.resize(seed.size());
+
+    for(size_t c = 0; c < seed.size(); c++)
+        dist[c] = seed[c] ? 0.0 : inf;
+
+    const int n = std::max(nx_, ny_);
+
+    std::vector<double> f(n), d(n), z(n+1);
+
+    std::vector<int> v(n);
+
+    for(int pass = 0; pass < 2; pass++)
+    {
+        const int lines  = pass == 0 ? ny_ : nx_;
+        const int length = pass == 0 ? nx_ : ny_;
+
+        for(int line = 0; line < lines; line++)
+        {
+            for(int q = 0; q < length; q++)
+                f[q] = pass == 0 ? dist[(size_t)line*nx_ + q] : dist[(size_t)q*nx_ + line];
+
+            int k = 0;
+            v[0] = 0;
+            z[0] = -inf;
+            z[1] = inf;
+
+            for(int q = 1; q < length; q++)
+            {
+                double s = ((f[q] + q*q) - (f[v[k]] + v[k]*v[k])) / (2*q - 2*v[k]);
+
+                while(s <= z[k])
+                {
+                    k--;
+                    s = ((f[q] + q*q) - (f[v[k]] + v[k]*v[k])) / (2*q - 2*v[k]);
+                }
+
+                k++;
+                v[k] = q;
+                z[k] = s;
+                z[k+1] = inf;
+            }
+
+            k = 0;
+
+            for(int q = 0; q < length; q++)
+            {
+                while(z[k+1] < q)
+                    k++;
+
+                d[q] = (q - v[k])*(q - v[k]) + f[v[k]];
+            }
+
+            for(int q = 0; q < length; q++)
+            {
+                if(pass == 0)
+                    dist[(size_t)line*nx_ + q] = d[q];
+                else
+                    dist[(size_t)q*nx_ + line] = d[q];
+            }
+        }
+    }
+}
+
+void SignedDistanceFieldValidityChecker::computeSignedDistances(const std::vector<unsigned char> &occupied)
+{
+    std::vector<unsigned char> freeCells(occupied.size());
+
+    for(size_t c = 0; c < occupied.size(); c++)
+        freeCells[c] = occupied[c] ? 0 : 1;
+
+    std::vector<double> toObstacle, toFree;
+
+    squaredDistanceTransform(occupied, toObstacle);
+
+    squaredDistanceTransform(freeCells, toFree);
+
+    storage_.resize(occupied.size());
+
+    // cell center distances are shifted by half a cell to approximate the distance to the boundary
+    for(size_t c = 0; c < occupied.size(); c++)
+    {
+        if(occupied[c])
+            storage_[c] = -(std::sqrt(toFree[c]) - 0.5) * resolution_;
+        else
+            storage_[c] = (std::sqrt(toObstacle[c]) - 0.5) * resolution_;
+    }
+
+    distances_ = storage_.data();
+}
+
+double SignedDistanceFieldValidityChecker::signedDistance(double x, double y) const
+{
+    double fx = (x - xMin_) / resolution_ - 0.5;
+    double fy = (y - yMin_) / resolution_ - 0.5;
+
+    int i = (int)std::floor(fx);
+    int j = (int)std::floor(fy);
+
+    if(i < 0 || j < 0 || i >= nx_ - 1 || j >= ny_ - 1)
+        return -std::numeric_limits<double>::infinity();
+
+    double tx = fx - i;
+    double ty = fy - j;
+
+    const float *row0 = &distances_[(size_t)j*nx_ + i];
+    const float *row1 = row0 + nx_;
+
+    return (1-ty)*((1-tx)*row0[0] + tx*row0[1]) + ty*((1-tx)*row1[0] + tx*row1[1]);
+}
+
+double SignedDistanceFieldValidityChecker::clearance(const ompl::base::State *state) const
+{
+    const SE2BeliefSpace::StateType *s = state->as<SE2BeliefSpace::StateType>();
+
+    return signedDistance(s->getX(), s->getY()) - robotRadius_;
+}
+
+bool SignedDistanceFieldValidityChecker::isValid(const ompl::base::State *state) const
+{
+    FIRM_PROFILE_SCOPE("ValidityChecker::isValid");
+
+    return si_->satisfiesBounds(state) && clearance(state) > 0;
+}
+
+bool SignedDistanceFieldValidityChecker::isValid(const ompl::base::State *state, double &dist) const
+{
+    FIRM_PROFILE_SCOPE("ValidityChecker::isValid");
+
+    dist = clearance(state);
+
+    return si_->satisfiesBounds(state) && dist > 0;
+}
+
+void SignedDistanceFieldValidityChecker::isValid(const ompl::base::State *const *states, unsigned int count, std::vector<unsigned char> &valid) const
+{
+    FIRM_PROFILE_SCOPE("ValidityChecker::isValidBatch");
+
+    valid.resize(count);
+
+    for(unsigned int i = 0; i < count; i++)
+    {
+        const SE2BeliefSpace::StateType *s = states[i]->as<SE2BeliefSpace::StateType>();
+
+        valid[i] = si_->satisfiesBounds(states[i]) && signedDistance(s->getX(), s->getY()) > robotRadius_;
+    }
+}
@@ -0,0 +1,225 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "Visualization/FrameRecorder.h"
+#include <cassert>
+#include <csignal>
+#include <ompl/util/Console.h>
+
+FrameRecorder::FrameRecorder(const std::string &outputPath, const std::string &encoderCommand,
+                             unsigned int framesPerSecond, unsigned int ringSize) :
+    outputPath_(outputPath), encoderCommand_(encoderCommand), framesPerSecond_(framesPerSecond),
+    ring_(ringSize), stop_(false), droppedFrames_(0), stream_(NULL), streamWidth_(0), streamHeight_(0)
+{
+    assert(ringSize > 0 && framesPerSecond > 0);
+
+    for(unsigned int i = 0; i < ring_.size(); i++)
+    {
+        ring_[i].width = 0;
+        ring_[i].height = 0;
+        freeFrames_.push_back(&ring_[i]);
+    }
+
+    writer_ = boost::thread(&FrameRecorder::writeFrames, this);
+}
+
+FrameRecorder::~FrameRecorder()
+{
+    {
+        boost::mutex::scoped_lock lock(queueMutex_);
+        stop_ = true;
+    }
+
+    frameQueued_.notify_one();
+
+    writer_.join();
+
+    if(droppedFrames_ > 0)
+        OMPL_WARN("FrameRecorder: %u frames were dropped because the writer could not keep up", droppedFrames_.load());
+}
+
+FrameRecorder::Frame* FrameRecorder::acquire(int width, int height)
+{
+    Frame *frame = NULL;
+
+    {
+        boost::mutex::scoped_lock lock(queueMutex_);
+
+        if(freeFrames_.empty())
+        {
+            droppedFrames_++;
+            return NULL;
+        }
+
+        frame = freeFrames_.front();
+        freeFrames_.pop_front();
+    }
+
+    frame->width = width;
+    frame->height = height;
+    frame->pixels.resize(3*width*height);
+
+    return frame;
+}
+
+void FrameRecorder::submit(Frame *frame)
+{
+    {
+        boost::mutex::scoped_lock lock(queueMutex_);
+        queuedFrames_.push_back(frame);
+    }
+
+    frameQueued_.notify_one();
+}
+
+void FrameRecorder::writeFrames()
+{
+    bool ok = true;
+
+    while(true)
+    {
+        Frame *frame = NULL;
+
+        {
+            boost::mutex::scoped_lock lock(queueMutex_);
+
+            while(queuedFrames_.empty() && !stop_)
+                frameQueued_.wait(lock);
+
+            // the queue is drained before stopping so that no recorded frame is lost
+            if(queuedFrames_.empty())
+                break;
+
+            frame = queuedFrames_.front();
+            queuedFrames_.pop_front();
+        }
+
+        if(ok && !stream_)
+            ok = openStream(frame->width, frame->height);
+
+        if(ok)
+        {
+            if(frame->width == streamWidth_ && frame->height == streamHeight_)
+                ok = writeFrame(*frame);
+            else
+                droppedFrames_++;
+        }
+
+        boost::mutex::scoped_lock lock(queueMutex_);
+        freeFrames_.push_back(frame);
+    }
+
+    if(stream_)
+    {
+        if(encoderCommand_.empty())
+            fclose(stream_);
+        else
+            pclose(stream_);
+
+        stream_ = NULL;
+    }
+}
+
+bool FrameRecorder::openStream(int width, int height)
+{
+    if(encoderCommand_.empty())
+    {
+        stream_ = fopen(outputPath_.c_str(), "wb");
+
+        if(!stream_)
+        {
+            OMPL_ERROR("FrameRecorder: Could not open %s, video will not be recorded", outputPath_.c_str());
+            return false;
+        }
+
+        OMPL_INFORM("FrameRecorder: Recording %dx%d video to %s", width, height, outputPath_.c_str());
+    }
+    else
+    {
+        // an encoder that exits early must end the recording, not the planner
+        signal(SIGPIPE, SIG_IGN);
+
+        stream_ = popen(encoderCommand_.c_str(), "w");
+
+        if(!stream_)
+        {
+            OMPL_ERROR("FrameRecorder: Could not start encoder '%s', video will not be recorded", encoderCommand_.c_str());
+            return false;
+        }
+
+        OMPL_INFORM("FrameRecorder: Recording %dx%d video through '%s'", width, height, encoderCommand_.c_str());
+    }
+
+    streamWidth_ = width;
+    streamHeight_ = height;
+
+    // the window size can not change within a stream, later frames of another size are dropped
+    fprintf(stream_, "YUV4MPEG2 W%d H%d F%u:1 Ip A1:1 C444\n", width, height, framesPerSecond_);
+
+    yuv_.resize(3*width*height);
+
+    return true;
+}
+
+bool FrameRecorder::writeFrame(const Frame &frame)
+{
+    const size_t planeSize = frame.width*frame.height;
+
+    unsigned char *yPlane = &yuv_[0], *uPlane = yPlane + planeSize, *vPlane = uPlane + planeSize;
+
+    // glReadPixels returns the bottom row first, y4m starts at the top (BT.601, video range)
+    for(int row = 0; row < frame.height; row++)
+    {
+        const unsigned char *rgb = &frame.pixels[3*frame.width*(frame.height - 1 - row)];
+
+        for(int col = 0; col < frame.width; col++, rgb += 3)
+        {
+            const int r = rgb[0], g = rgb[1], b = rgb[2];
+
+            const size_t i = row*frame.width + col;
+
+            yPlane[i] = (( 66*r + 129*g +  25*b + 128) >> 8) + 16;
+            uPlane[i] = ((-38*r -  74*g + 112*b + 128) >> 8) + 128;
+            vPlane[i] = ((112*r -  94*g -  18*b + 128) >> 8) + 128;
+        }
+    }
+
+    if(fputs("FRAME\n", stream_) < 0 || fwrite(&yuv_[0], 1, yuv_.size(), stream_) != yuv_.size())
+    {
+        OMPL_ERROR("FrameRecorder: Writing the video stream failed, recording stopped");
+        return false;
+    }
+
+    return true;
+}
@@ -52,11 +52,17 @@ using namespace std;
 
 #include "Visualization/GLWidget.h"
 
+//the window is redrawn every 33 ms
+static const unsigned int VIDEO_FRAMES_PER_SECOND = 30;
+
+//frames that may wait for the encoder before new ones are dropped
+static const unsigned int VIDEO_FRAME_BUFFERS = 8;
+
 GLWidget::GLWidget(QWidget *parent)
   : QGLWidget(QGLFormat(QGL::SampleBuffers), parent),
     m_drawAxes(false),
     m_camZoom(27), m_view(false),
-    m_snapshotPath(tr("")), m_framePath(tr(""))
+    m_snapshotPath(tr("")), m_frameRecorder(NULL)
 {
     using namespace arma;
     arma::colvec campos(3);
@@ -76,6 +82,12 @@ GLWidget::GLWidget(QWidget *parent)
 
 }
 
+GLWidget::~GLWidget()
+{
+    // flushes the frames that are still queued
+    delete m_frameRecorder;
+}
+
 
 
 QSize GLWidget::minimumSizeHint() const
@@ -160,27 +172,29 @@ void GLWidget::saveSnapshot()
 
 void GLWidget::saveFrame()
 {
-  static unsigned int frameNum = 0;
-
-   //the first time, make a good snapshot directory
-    if(m_framePath == "")
+    //the first time, open the video stream
+    if(!m_frameRecorder)
     {
         QString dateTime = QDateTime::currentDateTime().toString("MMM.dd.yyyy_hh.mmap");
 
         QDir currPath(QDir::currentPath());
-        currPath.mkpath(tr("VideoFrames/") + dateTime);
-        m_framePath = QDir::currentPath() + QString("/VideoFrames/") + dateTime + QString("/");
+        currPath.mkpath(tr("VideoFrames"));
+        QString videoPath = QDir::currentPath() + QString("/VideoFrames/") + dateTime + QString(".y4m");
+
+        m_frameRecorder = new FrameRecorder(videoPath.toStdString(), Display::videoEncoder(),
+                                            VIDEO_FRAMES_PER_SECOND, VIDEO_FRAME_BUFFERS);
     }
 
-    char number[8];
-    sprintf(number, "%07u", frameNum);
-    ostringstream oss;
-    oss << m_framePath.toStdString() << "Frame" << "_" << number << ".png";
+    // all buffers are still being encoded, skip this frame rather than stall the GUI
+    FrameRecorder::Frame *frame = m_frameRecorder->acquire(width(), height());
 
-    QString fileName(oss.str().c_str());
-    saveImage(fileName);
+    if(!frame)
+        return;
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, frame->width, frame->height, GL_RGB, GL_UNSIGNED_BYTE, &frame->pixels[0]);
 
-    ++frameNum;
+    m_frameRecorder->submit(frame);
 }
 
 
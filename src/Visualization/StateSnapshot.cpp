@@ -0,0 +1,118 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "Visualization/StateSnapshot.h"
+
+StateSnapshot::StateSnapshot() : sequence_(0)
+{
+    for(unsigned int i = 0; i < DATA_SIZE; i++)
+    {
+        data_[i].store(0.0, std::memory_order_relaxed);
+    }
+}
+
+void StateSnapshot::publish(const ompl::base::State *state)
+{
+    const SE2BeliefSpace::StateType *belief = state->as<SE2BeliefSpace::StateType>();
+
+    double values[DATA_SIZE];
+
+    values[0] = belief->getX();
+    values[1] = belief->getY();
+    values[2] = belief->getYaw();
+
+    const arma::mat &cov = belief->getCovariance();
+
+    for(unsigned int i = 0; i < 9; i++)
+    {
+        values[3+i] = cov.n_elem == 9 ? cov(i) : 0.0;
+    }
+
+    unsigned int seq = sequence_.load(std::memory_order_relaxed);
+
+    // mark the write as in progress before touching the data
+    sequence_.store(seq+1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for(unsigned int i = 0; i < DATA_SIZE; i++)
+    {
+        data_[i].store(values[i], std::memory_order_relaxed);
+    }
+
+    sequence_.store(seq+2, std::memory_order_release);
+}
+
+bool StateSnapshot::read(ompl::base::State *state) const
+{
+    double values[DATA_SIZE];
+
+    unsigned int before, after;
+
+    do
+    {
+        before = sequence_.load(std::memory_order_acquire);
+
+        if(before == 0)
+            return false;
+
+        // a write is in progress
+        if(before & 1)
+            continue;
+
+        for(unsigned int i = 0; i < DATA_SIZE; i++)
+        {
+            values[i] = data_[i].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        after = sequence_.load(std::memory_order_relaxed);
+
+    } while((before & 1) || before != after);
+
+    SE2BeliefSpace::StateType *belief = state->as<SE2BeliefSpace::StateType>();
+
+    belief->setXYYaw(values[0], values[1], values[2]);
+
+    arma::mat cov(3,3);
+
+    for(unsigned int i = 0; i < 9; i++)
+    {
+        cov(i) = values[3+i];
+    }
+
+    belief->setCovariance(cov);
+
+    return true;
+}
@@ -0,0 +1,254 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "Visualization/TraceReplay.h"
+#include "Visualization/Visualizer.h"
+#include "Spaces/SE2BeliefSpace.h"
+#include <ompl/control/spaces/RealVectorControlSpace.h>
+#include <algorithm>
+
+TraceReplay::TraceReplay() : currentStep_(0), shownRoadmap_(-1)
+{
+    ompl::base::StateSpacePtr space(new SE2BeliefSpace());
+
+    ompl::control::ControlSpacePtr controlSpace(new ompl::control::RealVectorControlSpace(space, 3));
+
+    si_.reset(new firm::SpaceInformation(space, controlSpace));
+}
+
+bool TraceReplay::load(const std::string &path)
+{
+    if(!trace_.load(path))
+        return false;
+
+    Visualizer::updateSpaceInformation(si_);
+
+    shownRoadmap_ = -1;
+
+    seek(0);
+
+    return true;
+}
+
+ompl::base::State* TraceReplay::allocState(const ExecutionTrace::Pose &pose) const
+{
+    ompl::base::State *state = si_->allocState();
+
+    state->as<SE2BeliefSpace::StateType>()->setXYYaw(pose.x, pose.y, pose.yaw);
+
+    state->as<SE2BeliefSpace::StateType>()->setCovariance(arma::mat(pose.covariance, 3, 3));
+
+    return state;
+}
+
+std::pair<ompl::base::State*, ompl::base::State*> TraceReplay::allocStates(const ExecutionTrace::Segment &segment) const
+{
+    ompl::base::State *source = si_->allocState();
+
+    ompl::base::State *target = si_->allocState();
+
+    source->as<SE2BeliefSpace::StateType>()->setXY(segment.x1, segment.y1);
+
+    target->as<SE2BeliefSpace::StateType>()->setXY(segment.x2, segment.y2);
+
+    return std::make_pair(source, target);
+}
+
+void TraceReplay::freeStates(const std::pair<ompl::base::State*, ompl::base::State*> &states) const
+{
+    si_->freeState(states.first);
+
+    si_->freeState(states.second);
+}
+
+template <class Event>
+long TraceReplay::findLastEvent(const std::vector<Event> &events, size_t step)
+{
+    long last = -1;
+
+    // events are recorded in order, so the search can stop at the first one after step
+    for(size_t i = 0; i < events.size() && events[i].step <= step; i++)
+    {
+        last = i;
+    }
+
+    return last;
+}
+
+void TraceReplay::showRoadmap(long index)
+{
+    if(index == shownRoadmap_)
+        return;
+
+    shownRoadmap_ = index;
+
+    Visualizer::clearStates();
+
+    Visualizer::clearGraphEdges();
+
+    if(index < 0)
+        return;
+
+    const ExecutionTrace::RoadmapEvent &roadmap = trace_.getRoadmaps()[index];
+
+    std::vector<ompl::base::State*> nodes;
+
+    for(size_t i = 0; i < roadmap.nodes.size(); i++)
+    {
+        nodes.push_back(allocState(roadmap.nodes[i]));
+    }
+
+    std::vector<std::pair<ompl::base::State*, ompl::base::State*> > edgeStates;
+
+    std::vector<std::pair<const ompl::base::State*, const ompl::base::State*> > edges;
+
+    for(size_t i = 0; i < roadmap.edges.size(); i++)
+    {
+        edgeStates.push_back(allocStates(roadmap.edges[i]));
+        edges.push_back(std::make_pair(edgeStates.back().first, edgeStates.back().second));
+    }
+
+    Visualizer::addStates(nodes);
+
+    Visualizer::addGraphEdges(edges);
+
+    for(size_t i = 0; i < nodes.size(); i++)
+    {
+        si_->freeState(nodes[i]);
+    }
+
+    for(size_t i = 0; i < edgeStates.size(); i++)
+    {
+        freeStates(edgeStates[i]);
+    }
+}
+
+void TraceReplay::seek(long step)
+{
+    const std::vector<ExecutionTrace::Step> &steps = trace_.getSteps();
+
+    if(steps.empty())
+        return;
+
+    const size_t target = step < 0 ? 0 : std::min<size_t>(step, steps.size() - 1);
+
+    // the trail of the robot is only drawn forward
+    if(target < currentStep_)
+        Visualizer::clearRobotPath();
+
+    currentStep_ = target;
+
+    showRoadmap(findLastEvent(trace_.getRoadmaps(), currentStep_));
+
+    ompl::base::State *trueState = allocState(steps[currentStep_].trueState);
+
+    ompl::base::State *belief = allocState(steps[currentStep_].belief);
+
+    Visualizer::updateTrueState(trueState);
+
+    Visualizer::updateCurrentBelief(belief);
+
+    si_->freeState(trueState);
+
+    si_->freeState(belief);
+
+    const long edge = findLastEvent(trace_.getEdges(), currentStep_);
+
+    const long rollout = findLastEvent(trace_.getRollouts(), currentStep_);
+
+    const long modes = findLastEvent(trace_.getModes(), currentStep_);
+
+    Visualizer::clearMostLikelyPath();
+
+    if(edge >= 0)
+    {
+        std::pair<ompl::base::State*, ompl::base::State*> states = allocStates(trace_.getEdges()[edge].segment);
+
+        Visualizer::addMostLikelyPathEdge(states.first, states.second);
+
+        freeStates(states);
+    }
+
+    // the most recent kind of decision decides what is shown
+    const size_t edgeStep = edge >= 0 ? trace_.getEdges()[edge].step : 0;
+
+    const size_t rolloutStep = rollout >= 0 ? trace_.getRollouts()[rollout].step : 0;
+
+    if(modes >= 0 && trace_.getModes()[modes].step >= std::max(edgeStep, rolloutStep))
+    {
+        const ExecutionTrace::ModesEvent &event = trace_.getModes()[modes];
+
+        Visualizer::clearBeliefModes();
+
+        for(size_t i = 0; i < event.modes.size(); i++)
+        {
+            ompl::base::State *mode = allocState(event.modes[i]);
+
+            Visualizer::addBeliefMode(mode);
+
+            si_->freeState(mode);
+        }
+
+        Visualizer::setMode(Visualizer::VZRDrawingMode::MultiModalMode);
+    }
+    else if(rollout >= 0 && rolloutStep >= edgeStep)
+    {
+        const ExecutionTrace::RolloutEvent &event = trace_.getRollouts()[rollout];
+
+        Visualizer::clearRolloutConnections();
+
+        for(size_t i = 0; i < event.candidates.size(); i++)
+        {
+            std::pair<ompl::base::State*, ompl::base::State*> states = allocStates(event.candidates[i]);
+
+            Visualizer::addRolloutConnection(states.first, states.second);
+
+            freeStates(states);
+        }
+
+        std::pair<ompl::base::State*, ompl::base::State*> chosen = allocStates(event.chosen);
+
+        Visualizer::setChosenRolloutConnection(chosen.first, chosen.second);
+
+        freeStates(chosen);
+
+        Visualizer::setMode(Visualizer::VZRDrawingMode::RolloutMode);
+    }
+    else
+    {
+        Visualizer::clearRolloutConnections();
+
+        Visualizer::setMode(Visualizer::VZRDrawingMode::PRMViewMode);
+    }
+}
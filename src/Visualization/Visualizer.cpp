@@ -36,33 +36,65 @@
 
 #include "Visualization/Visualizer.h"
 
+namespace
+{
+    /** \brief Segments of the unit circle used for disks and covariance ellipses */
+    const unsigned int CIRCLE_SEGMENTS = 40;
+
+    /** \brief A layer that keeps changing (e.g. while the roadmap is built) is recompiled at most this often */
+    const std::chrono::milliseconds MIN_LAYER_REBUILD_INTERVAL(200);
+
+    /** \brief cos and sin of the angles of the unit circle, computed once */
+    const std::vector<std::pair<double,double> >& unitCircle()
+    {
+        static std::vector<std::pair<double,double> > circle;
+
+        if(circle.empty())
+        {
+            for(unsigned int i = 0; i < CIRCLE_SEGMENTS; i++)
+            {
+                const double th = 2*boost::math::constants::pi<double>()*i/CIRCLE_SEGMENTS;
+                circle.push_back(std::make_pair(cos(th), sin(th)));
+            }
+        }
+
+        return circle;
+    }
+}
+
 boost::mutex Visualizer::drawMutex_;
 
-std::list<ompl::base::State*> Visualizer::states_;
+std::vector<Visualizer::VZRPose> Visualizer::states_;
 
-std::list<ompl::base::State*> Visualizer::beliefModes_;
+std::vector<Visualizer::VZRPose> Visualizer::beliefModes_;
 
 ompl::base::State* Visualizer::trueState_;
 
 ompl::base::State* Visualizer::currentBelief_;
 
+StateSnapshot Visualizer::trueStateSnapshot_;
+
+StateSnapshot Visualizer::currentBeliefSnapshot_;
+
 std::vector<arma::colvec> Visualizer::landmarks_;
 
 firm::SpaceInformation::SpaceInformationPtr Visualizer::si_;
 
-std::vector<std::pair<const ompl::base::State*, const ompl::base::State*> > Visualizer::graphEdges_;
+std::vector<Visualizer::VZREdge> Visualizer::graphEdges_;
 
-std::vector<std::pair<const ompl::base::State*, const ompl::base::State*> > Visualizer::rolloutConnections_;
+std::vector<Visualizer::VZREdge> Visualizer::rolloutConnections_;
 
-std::vector<std::pair<const ompl::base::State*, const ompl::base::State*> > Visualizer::mostLikelyPath_;
+std::vector<Visualizer::VZREdge> Visualizer::mostLikelyPath_;
 
 std::vector<Visualizer::VZRFeedbackEdge> Visualizer::feedbackEdges_;
 
-boost::optional<std::pair<const ompl::base::State*, const ompl::base::State*> > Visualizer::chosenRolloutConnection_;
+boost::optional<Visualizer::VZREdge> Visualizer::chosenRolloutConnection_;
 
-std::vector<const ompl::base::State*> Visualizer::robotPath_;
+std::vector<Visualizer::VZRPose> Visualizer::robotPath_;
 
-std::vector<ompl::geometric::PathGeometric> Visualizer::openLoopRRTPaths_;
+unsigned int Visualizer::robotPathGeneration_ = 0;
+
+std::vector<std::vector<Visualizer::VZRPose> > Visualizer::openLoopRRTPaths_;
 
 Visualizer::VZRDrawingMode Visualizer::mode_;
 
@@ -74,7 +106,52 @@ int Visualizer::envIndx_   = -1;
 
 bool Visualizer::saveVideo_ = false;
 
-void Visualizer::drawLandmark(arma::colvec& landmark)
+std::string Visualizer::videoEncoder_;
+
+unsigned int Visualizer::layerVersion_[Visualizer::NUM_LAYERS] = {1, 1, 1, 1, 1};
+
+unsigned int Visualizer::builtVersion_[Visualizer::NUM_LAYERS] = {0, 0, 0, 0, 0};
+
+std::chrono::steady_clock::time_point Visualizer::buildTime_[Visualizer::NUM_LAYERS];
+
+GLuint Visualizer::layerList_[Visualizer::NUM_LAYERS] = {0, 0, 0, 0, 0};
+
+GLuint Visualizer::diskList_ = 0;
+
+std::vector<double> Visualizer::renderedRobotPath_;
+
+unsigned int Visualizer::renderedRobotPathGeneration_ = 0;
+
+Visualizer::VZRPose Visualizer::toPose(const ompl::base::State *state)
+{
+    const SE2BeliefSpace::StateType *s = state->as<SE2BeliefSpace::StateType>();
+
+    const arma::mat covariance = s->getCovariance();
+
+    VZRPose pose;
+
+    pose.x = s->getX();
+    pose.y = s->getY();
+    pose.yaw = s->getYaw();
+    pose.cxx = covariance(0,0);
+    pose.cxy = covariance(0,1);
+    pose.cyy = covariance(1,1);
+
+    return pose;
+}
+
+Visualizer::VZREdge Visualizer::toEdge(const ompl::base::State *source, const ompl::base::State *target)
+{
+    const SE2BeliefSpace::StateType *s = source->as<SE2BeliefSpace::StateType>();
+
+    const SE2BeliefSpace::StateType *t = target->as<SE2BeliefSpace::StateType>();
+
+    VZREdge edge = {s->getX(), s->getY(), t->getX(), t->getY()};
+
+    return edge;
+}
+
+void Visualizer::drawLandmark(const arma::colvec& landmark)
 {
 
     double scale = 0.15;
@@ -97,23 +174,22 @@ void Visualizer::drawLandmark(arma::colvec& landmark)
 
 }
 
-void Visualizer::drawRobot(const ompl::base::State *state)
+void Visualizer::drawRobot(const VZRPose &pose)
 {
 
-    if(robotIndx_ <=0)
+    // without a renderer (e.g. when replaying a trace) the robot is drawn as a disk
+    if(robotIndx_ <=0 && renderGeom_)
     {
         robotIndx_ = renderGeom_->renderRobot();
     }
     else
     {
 
-        drawState(state,VZRStateType::TrueState);
+        drawState(pose,VZRStateType::TrueState);
         /*
-        arma::colvec x = state->as<SE2BeliefSpace::StateType>()->getArmaData();
-
         glPushMatrix();
-            glTranslated(x[0], x[1], 0.0);
-            glRotated(-90+(180/3.14157)*x[2],0,0,1);
+            glTranslated(pose.x, pose.y, 0.0);
+            glRotated(-90+(180/3.14157)*pose.yaw,0,0,1);
             glCallList(robotIndx_);
         glPopMatrix();
         */
@@ -121,13 +197,33 @@ void Visualizer::drawRobot(const ompl::base::State *state)
     }
 }
 
-void Visualizer::drawState(const ompl::base::State *state, VZRStateType stateType)
+void Visualizer::drawDisk(double radius)
 {
-    if(!state)
-        return;
+    if(diskList_ == 0)
+    {
+        const std::vector<std::pair<double,double> > &circle = unitCircle();
 
-    using namespace arma;
+        diskList_ = glGenLists(1);
 
+        glNewList(diskList_, GL_COMPILE);
+            glBegin(GL_TRIANGLE_FAN);
+            glVertex3f(0, 0, 0);
+            for(unsigned int i = 0; i <= circle.size(); i++)
+            {
+                glVertex3f(circle[i % circle.size()].first, circle[i % circle.size()].second, 0);
+            }
+            glEnd();
+        glEndList();
+    }
+
+    glPushMatrix();
+        glScaled(radius, radius, 1.0);
+        glCallList(diskList_);
+    glPopMatrix();
+}
+
+void Visualizer::drawState(const VZRPose &pose, VZRStateType stateType)
+{
     double outerDiskRadius, z;
 
     switch(stateType)
@@ -157,177 +253,304 @@ void Visualizer::drawState(const ompl::base::State *state, VZRStateType stateTyp
             break;
     }
 
-    arma::colvec x = state->as<SE2BeliefSpace::StateType>()->getArmaData();
-    mat covariance = state->as<SE2BeliefSpace::StateType>()->getCovariance();
-
     glPushMatrix();
-        glTranslated(x[0], x[1], z);
+        glTranslated(pose.x, pose.y, z);
+
+        drawDisk(outerDiskRadius);
+
+        const double headingLength = stateType == VZRStateType::TrueState ? 1.0 : 0.5;
 
-        //draw a black disk
-        GLUquadric *disk = gluNewQuadric();
-        gluDisk(disk, 0, outerDiskRadius, 100, 1);
-        gluDeleteQuadric(disk);
         glBegin(GL_LINES);
         glVertex3f(0, 0, 0);
-        if(stateType == VZRStateType::TrueState)
-        {
-            glVertex3f(1.0*cos(x[2]), 1.0*sin(x[2]), 0);
-        }
-        else
-        {
-            glVertex3f(0.5*cos(x[2]), 0.5*sin(x[2]), 0);
-        }
+        glVertex3f(headingLength*cos(pose.yaw), headingLength*sin(pose.yaw), 0);
         glEnd();
 
-        double fovRadius = 2.5; //meters
-        double fovAngle = 22.5*3.14157/180; //radians
-        arma::colvec fovLeft(3), fovRight(3);
-
-        fovLeft	<< fovRadius*cos(x[2] + fovAngle) << endr
-                << fovRadius*sin(x[2] + fovAngle) << endr
-                << 0                              << endr;
-
-        fovRight << fovRadius*cos(x[2] - fovAngle) 	<< endr
-                 << fovRadius*sin(x[2] - fovAngle) 	<< endr
-                 <<	0								<< endr;
-
     glPopMatrix();
 
-    if(trace(covariance) != 0 && stateType == VZRStateType::BeliefState)
+    if(pose.cxx + pose.cyy != 0 && stateType == VZRStateType::BeliefState)
     {
         //see http://www.visiondummy.com/2014/04/draw-error-ellipse-representing-covariance-matrix/
         // https://people.richland.edu/james/lecture/m170/tbl-chi.html
         double chi2 = 9.210; // 95% -> chi2 = 5.991, 99% -> chi2 = 9.210
         double magnify = 1.0; // scaled up for viewing
-        mat pos;
-        for(double th = 0; th < 2*boost::math::constants::pi<double>(); th += 0.05*boost::math::constants::pi<double>())
+        const double scale = sqrt(chi2)*magnify;
+
+        // lower cholesky factor of the xy covariance [a 0; b c], written out for the 2x2 case
+        const double a2 = pose.cxx;
+
+        const double c2 = a2 > 0 ? pose.cyy - pose.cxy*pose.cxy/a2 : 0;
+
+        if(a2 > 0 && c2 > 0)
         {
-            mat tmpRow(1,2);
-            tmpRow << cos(th) << sin(th) << endr;
-            pos = join_cols(pos, tmpRow);
-        }
+            const double a = sqrt(a2), b = pose.cxy/a, c = sqrt(c2);
 
-        pos *= sqrt(chi2);
-        pos *= magnify;
+            const std::vector<std::pair<double,double> > &circle = unitCircle();
 
-        int nPoints = pos.n_rows;
+            glLineWidth(2.0);
 
+            glBegin(GL_LINES);
 
-        mat cholDecomp;
+            for(unsigned int i = 0; i < circle.size(); ++i)
+            {
+                const double u = scale*circle[i].first, v = scale*circle[i].second;
 
-        bool cholSucceeded = chol(cholDecomp, covariance.submat(0,0,1,1));
+                glVertex2f(pose.x + a*u, pose.y + b*u + c*v);
+            }
 
-        glLineWidth(2.0);
+            glEnd();
 
-        // std::ofstream outfile; // remove
-        // outfile.open("RobotCovarianceEllipse.csv",std::ios::app);//remove
+            glLineWidth(1.0);
+        }
+    }
 
-       if(cholSucceeded)
-        {
-            mat K = trans(cholDecomp);
+}
 
-            mat shift;
+void Visualizer::buildLayer(VZRLayer layer, const std::vector<VZRPose> &nodes, const std::vector<VZREdge> &edges,
+                            const std::vector<arma::colvec> &landmarks)
+{
+    if(layer == EnvironmentLayer)
+    {
+        // ompl::app compiles the environment into a display list of its own
+        if(envIndx_ > 0)
+            glDeleteLists(envIndx_, 1);
 
-            shift = join_cols((ones(1,nPoints)*x[0]),(ones(1,nPoints)*x[1]));
+        envIndx_ = renderGeom_ ? renderGeom_->renderEnvironment() : -1;
 
-            mat transformed = K*trans(pos) + shift;
+        return;
+    }
 
-            glPushMatrix();
+    if(layerList_[layer] == 0)
+        layerList_[layer] = glGenLists(1);
 
-            glBegin(GL_LINES);
+    glNewList(layerList_[layer], GL_COMPILE);
+
+    switch(layer)
+    {
+        case LandmarksLayer:
+
+            for(size_t i = 0 ; i < landmarks.size(); ++i)
+            {
+                drawLandmark(landmarks[i]);
+            }
+
+            break;
+
+        case NodesLayer:
 
-            for(unsigned int i = 0; i < transformed.n_cols; ++i)
+            for(size_t i = 0; i < nodes.size(); i++)
             {
-                glVertex2f(transformed(0,i), transformed(1,i));
-                // outfile<<transformed(0,i)<<","<<transformed(1,i)<<std::endl; // remove
+                drawState(nodes[i], VZRStateType::GraphNodeState);
             }
 
+            break;
+
+        case GraphEdgesLayer:
+
+            glColor3d(0.5,0.5,0.5);
+
+            glBegin(GL_LINES);
+            for(size_t i = 0; i < edges.size(); i++)
+            {
+                glVertex2d(edges[i].x1, edges[i].y1);
+                glVertex2d(edges[i].x2, edges[i].y2);
+            }
             glEnd();
 
-            glPopMatrix();
-        }
+            break;
 
-         // outfile.close();//remove
+        case FeedbackLayer:
 
-        glLineWidth(1.0);
+            glLineWidth(4.0);
+
+            glColor3d(0,0.9,0);
 
+            glBegin(GL_LINES);
+            for(size_t i = 0; i < edges.size(); i++)
+            {
+                glVertex2d(edges[i].x1, edges[i].y1);
+                glVertex2d(edges[i].x2, edges[i].y2);
+            }
+            glEnd();
+
+            glLineWidth(1.0);
+
+            break;
+
+        default:
+            break;
     }
 
+    glEndList();
 }
 
 void Visualizer::refresh()
 {
-        
-    boost::mutex::scoped_lock sl(drawMutex_);
+    // everything this frame needs is copied out under the lock, nothing is drawn while holding it
+    std::vector<VZRPose> nodes, beliefModes;
+
+    std::vector<VZREdge> graphEdges, feedbackEdges, rolloutConnections, mostLikelyPath;
+
+    std::vector<std::vector<VZRPose> > rrtPaths;
+
+    std::vector<arma::colvec> landmarks;
+
+    boost::optional<VZREdge> chosenRolloutConnection;
+
+    boost::optional<VZRPose> truePose, beliefPose;
+
+    bool rebuild[NUM_LAYERS];
+
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    const VZRDrawingMode mode = mode_;
+
+    {
+        boost::mutex::scoped_lock sl(drawMutex_);
+
+        // pick up the latest robot state without making the simulation wait for this frame
+        if(trueState_ && trueStateSnapshot_.read(trueState_))
+        {
+            truePose = toPose(trueState_);
+        }
+
+        if(currentBelief_ && currentBeliefSnapshot_.read(currentBelief_))
+        {
+            beliefPose = toPose(currentBelief_);
+        }
+
+        for(int l = 0; l < NUM_LAYERS; l++)
+        {
+            rebuild[l] = builtVersion_[l] != layerVersion_[l] && now - buildTime_[l] >= MIN_LAYER_REBUILD_INTERVAL;
+
+            if(rebuild[l])
+                builtVersion_[l] = layerVersion_[l];
+        }
+
+        // the environment is compiled by ompl::app straight from the mesh, so it is done here
+        if(rebuild[EnvironmentLayer])
+        {
+            buildLayer(EnvironmentLayer, nodes, graphEdges, landmarks);
+            buildTime_[EnvironmentLayer] = now;
+        }
+
+        if(rebuild[LandmarksLayer])
+            landmarks = landmarks_;
+
+        if(rebuild[NodesLayer])
+            nodes = states_;
+
+        if(rebuild[GraphEdgesLayer])
+            graphEdges = graphEdges_;
+
+        mostLikelyPath = mostLikelyPath_;
+
+        if(rebuild[FeedbackLayer])
+        {
+            // feedback edges on the most likely path are only drawn as part of the path
+            for(size_t i = 0; i < feedbackEdges_.size(); i++)
+            {
+                if(std::find(mostLikelyPath.begin(), mostLikelyPath.end(), feedbackEdges_[i].edge) == mostLikelyPath.end())
+                    feedbackEdges.push_back(feedbackEdges_[i].edge);
+            }
+        }
+
+        rolloutConnections = rolloutConnections_;
+
+        chosenRolloutConnection = chosenRolloutConnection_;
+
+        beliefModes = beliefModes_;
+
+        if(mode == MultiModalMode)
+            rrtPaths = openLoopRRTPaths_;
+
+        if(mode == RolloutMode && truePose)
+            robotPath_.push_back(*truePose);
+
+        // the path only grows between clears, so only the new points are copied
+        if(renderedRobotPathGeneration_ != robotPathGeneration_)
+        {
+            renderedRobotPath_.clear();
+            renderedRobotPathGeneration_ = robotPathGeneration_;
+        }
+
+        for(size_t i = renderedRobotPath_.size()/2; i < robotPath_.size(); i++)
+        {
+            renderedRobotPath_.push_back(robotPath_[i].x);
+            renderedRobotPath_.push_back(robotPath_[i].y);
+        }
+    }
+
+    for(int l = LandmarksLayer; l < NUM_LAYERS; l++)
+    {
+        if(rebuild[l])
+        {
+            buildLayer((VZRLayer)l, nodes, l == FeedbackLayer ? feedbackEdges : graphEdges, landmarks);
+            buildTime_[l] = now;
+        }
+    }
 
     glPushMatrix();
 
     glEnable(GL_DEPTH_TEST);
     glClear(GL_DEPTH_BUFFER_BIT);
 
-    drawRobotPath();
+    if(renderedRobotPath_.size() >= 4)
+    {
+        glDisable(GL_LIGHTING);
+        glColor3d(0.0 , 1.0 , 0.6); // green
+        glLineWidth(4.0);
+
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glVertexPointer(2, GL_DOUBLE, 0, &renderedRobotPath_[0]);
+        glDrawArrays(GL_LINE_STRIP, 0, renderedRobotPath_.size()/2);
+        glDisableClientState(GL_VERTEX_ARRAY);
+
+        glLineWidth(1.f);
+    }
 
     drawEnvironment();
 
     glDisable(GL_LIGHTING);
     glDisable(GL_DEPTH_TEST);
 
-    switch(mode_)
+    glCallList(layerList_[NodesLayer]);
+
+    switch(mode)
     {
         case NodeViewMode:
 
-            drawGraphBeliefNodes();
-
             break;
 
         case FeedbackViewMode:
 
-            drawGraphBeliefNodes();
-
-            if(feedbackEdges_.size()>0) drawFeedbackEdges();
+            glCallList(layerList_[FeedbackLayer]);
 
             break;
 
         case PRMViewMode:
 
-            drawGraphBeliefNodes();
-
-            if(graphEdges_.size()>0) drawGraphEdges();
-
-            drawMostLikelyPath();
+            glCallList(layerList_[GraphEdgesLayer]);
 
             break;
 
         case RolloutMode:
 
-            drawGraphBeliefNodes();
-
-            drawRolloutConnections();
-
-            drawMostLikelyPath();
-
-            // draw the rollout connection with lowest cost
-            if(chosenRolloutConnection_)
+            glColor3d(1.0,0.0,0);
+            glLineWidth(3.0);
+            for(size_t i = 0; i < rolloutConnections.size(); i++)
             {
-                glColor3d(1.0 , 0.0 , 0.0);
-                glLineWidth(3.0);
-                    drawEdge(chosenRolloutConnection_->first, chosenRolloutConnection_->second);
-                glLineWidth(1.0);
+                drawEdge(rolloutConnections[i]);
             }
-
-            robotPath_.push_back(si_->cloneState(trueState_));
+            glLineWidth(1.0);
 
             break;
 
         case MultiModalMode:
 
-            drawOpenLoopRRTPaths();
-
-            drawGraphBeliefNodes();
-
-            drawRobot(trueState_);
-
-            drawBeliefModes();
+            for(size_t i = 0; i < rrtPaths.size(); i++)
+            {
+                drawGeometricPath(rrtPaths[i]);
+            }
 
             break;
 
@@ -339,47 +562,67 @@ void Visualizer::refresh()
             exit(1);
     }
 
-    //draw landmarks
-    for(size_t i = 0 ; i < landmarks_.size(); ++i)
+    // the feedback layer leaves out the edges on the most likely path, so the path is drawn in feedback mode too
+    if(mode == PRMViewMode || mode == RolloutMode || mode == FeedbackViewMode)
     {
-        drawLandmark(landmarks_[i]);
+        glLineWidth(4.0);
+        glColor3d(1.0 , 1.0 , 0.0); // yellow
+        for(size_t i = 0; i < mostLikelyPath.size(); i++)
+        {
+            drawEdge(mostLikelyPath[i]);
+        }
+        glLineWidth(1.f);
     }
 
-    if(trueState_ && mode_ !=MultiModalMode)
+    // draw the rollout connection with lowest cost
+    if(mode == RolloutMode && chosenRolloutConnection)
     {
-        drawRobot(trueState_);
+        glColor3d(1.0 , 0.0 , 0.0);
+        glLineWidth(3.0);
+            drawEdge(*chosenRolloutConnection);
+        glLineWidth(1.0);
     }
 
-    if(currentBelief_ && mode_ !=MultiModalMode)
+    if(mode == MultiModalMode)
     {
-        drawState(currentBelief_, (VZRStateType)1);
+        if(truePose)
+            drawRobot(*truePose);
+
+        for(size_t i = 0; i < beliefModes.size(); i++)
+        {
+            drawState(beliefModes[i], VZRStateType::BeliefState);
+        }
+    }
+
+    //draw landmarks
+    glCallList(layerList_[LandmarksLayer]);
+
+    if(truePose && mode !=MultiModalMode)
+    {
+        drawRobot(*truePose);
+    }
+
+    if(beliefPose && mode !=MultiModalMode)
+    {
+        drawState(*beliefPose, VZRStateType::BeliefState);
     }
 
     glPopMatrix();
 }
 
-void Visualizer::drawEdge(const ompl::base::State* source, const ompl::base::State* target)
+void Visualizer::drawEdge(const VZREdge &edge)
 {
-    using namespace arma;
-
-    colvec::fixed<2> sourceData = source->as<SE2BeliefSpace::StateType>()->getArmaData().subvec(0,1);
-    colvec::fixed<2> targetData = target->as<SE2BeliefSpace::StateType>()->getArmaData().subvec(0,1);
-
     glBegin(GL_LINES);
-        glVertex2d(sourceData[0],sourceData[1]);
-        glVertex2d(targetData[0],targetData[1]);
+        glVertex2d(edge.x1, edge.y1);
+        glVertex2d(edge.x2, edge.y2);
     glEnd();
 }
 
 void Visualizer::drawEnvironment()
 {
-    if(renderGeom_)
+    if(envIndx_ > 0)
     {
-        
-        envIndx_ = renderGeom_->renderEnvironment();
-        
         glCallList(envIndx_);
-
     }
 
 }
@@ -405,144 +648,32 @@ void Visualizer::drawObstacle()
 
 }
 
-void Visualizer::drawGraphBeliefNodes()
-{
-    for(typename std::list<ompl::base::State*>::iterator s=states_.begin(), e=states_.end(); s!=e; ++s)
-    {
-          drawState(*s, (VZRStateType)2);
-    }
-
-}
-
-void Visualizer::drawBeliefModes()
-{
-    for(typename std::list<ompl::base::State*>::iterator s=beliefModes_.begin(), e=beliefModes_.end(); s!=e; ++s)
-    {
-          drawState(*s, (VZRStateType)1);
-    }
-
-}
-
-void Visualizer::drawGraphEdges()
-{
-    for(unsigned int i=0; i<graphEdges_.size();i++)
-    {
-        glColor3d(0.5,0.5,0.5);
-        drawEdge(graphEdges_[i].first,graphEdges_[i].second);
-    }
-}
-
-
-void Visualizer::drawRolloutConnections()
-{
-    glDisable(GL_LIGHTING);
-
-    for(int i=0; i<rolloutConnections_.size();i++)
-    {
-        glColor3d(1.0,0.0,0);
-        glLineWidth(3.0);
-        drawEdge(rolloutConnections_[i].first,rolloutConnections_[i].second);
-        glLineWidth(1.0);
-
-    }
-}
-
-void Visualizer::drawFeedbackEdges()
+void Visualizer::drawGeometricPath(const std::vector<VZRPose> &path)
 {
-    using namespace arma;
+    glColor3d(0 , 1.0, 0);
+    glLineWidth(2.0);
 
-    double maxCost = 0;
-    for(typename std::vector<VZRFeedbackEdge>::iterator i=feedbackEdges_.begin(), e=feedbackEdges_.end(); i!=e; ++i)
+    glBegin(GL_LINE_STRIP);
+    for(size_t i = 0; i < path.size(); i++)
     {
-        maxCost = std::max(maxCost, i->cost);
+        glVertex2d(path[i].x, path[i].y);
     }
+    glEnd();
 
-    glLineWidth(4.0);
-    for(typename std::vector<VZRFeedbackEdge>::iterator i=feedbackEdges_.begin(), e=feedbackEdges_.end();i!=e; ++i)
-    {
-        std::pair<const ompl::base::State*, const ompl::base::State*> vertexPair = std::make_pair(i->source, i->target);
-
-        std::vector<std::pair<const ompl::base::State*, const ompl::base::State*> >::iterator it = std::find(mostLikelyPath_.begin(), mostLikelyPath_.end(), vertexPair);
-
-        // if this pair does not exist in most likely path, then draw it, other we will only draw it in most likely path
-        if( it == mostLikelyPath_.end())
-        {
-            double costFactor = sqrt(i->cost/maxCost);
-            glColor3d(0,0.9,0);
-
-            drawEdge(i->source, i->target);
-
-        }
-    }
     glLineWidth(1.0);
 }
 
-void Visualizer::drawMostLikelyPath()
-{
-    glDisable(GL_LIGHTING);
-
-    glLineWidth(4.0);
-    for(int i=0; i<mostLikelyPath_.size();i++)
-    {
-        glColor3d(1.0 , 1.0 , 0.0); // yellow
-        //glColor3d(0.2 , 0.2 , 0.2); // almost black
-
-        drawEdge(mostLikelyPath_[i].first,mostLikelyPath_[i].second);
-    }
-    glLineWidth(1.f);
-}
-
-void Visualizer::drawRobotPath()
-{
-
-    if(robotPath_.size()>=2)
-    {
-        glDisable(GL_LIGHTING);
-        glColor3d(0.0 , 1.0 , 0);
-
-        for(int i=0; i<robotPath_.size()-1;i++)
-        {
-//            glColor3d(0.6 , 0.6 , 0.6); // grey
-            glColor3d(0.0 , 1.0 , 0.6); // green
-
-            glLineWidth(4.0);
-                drawEdge(robotPath_[i],robotPath_[i+1]);
-            glLineWidth(1.f);
-        }
-    }
-}
-
-void Visualizer::drawGeometricPath(ompl::geometric::PathGeometric path)
-{
-    for(int i=0;i<path.getStateCount()-1;i++)
-    {
-        glColor3d(0 , 1.0, 0);
-        glLineWidth(2.0);
-        drawEdge(path.getState(i),path.getState(i+1)) ;
-        glLineWidth(1.0);
-    }
-}
-
-void Visualizer::drawOpenLoopRRTPaths()
-{
-    for(int i=0;i<openLoopRRTPaths_.size();i++)
-    {
-        drawGeometricPath(openLoopRRTPaths_[i]);
-    }
-}
-
 void Visualizer::printRobotPathToFile(std::string path)
 {
+    boost::mutex::scoped_lock sl(drawMutex_);
 
     std::ofstream outfile;
     outfile.open(path+"RobotPath.csv",std::ios::app);
             
-    for(int i=0; i<robotPath_.size()-1;i++)
+    for(size_t i = 0; i + 1 < robotPath_.size(); i++)
     {
 
-        arma::colvec::fixed<2> x = robotPath_[i]->as<SE2BeliefSpace::StateType>()->getArmaData().subvec(0,1);
-
-        outfile<<x[0]<<","<<x[1]<<std::endl;
+        outfile<<robotPath_[i].x<<","<<robotPath_[i].y<<std::endl;
 
     }
 
@@ -41,9 +41,10 @@ using namespace std;
 
 #include "Visualization/GLWidget.h"
 #include "Visualization/Window.h"
+#include "Visualization/TraceReplay.h"
 
 //When given a list of polygons
-MyWindow::MyWindow()
+MyWindow::MyWindow() : replay_(NULL), playing_(false)
 {
   //define all buttons
   QPushButton* resetCamButton = new QPushButton("Reset Camera", this);
@@ -87,6 +88,14 @@ MyWindow::MyWindow()
 }
 
 void MyWindow::simulate(){
+  if(replay_ && playing_)
+  {
+    if(replay_->getCurrentStep() + 1 < replay_->getNumberOfSteps())
+      seekReplay(replay_->getCurrentStep() + 1);
+    else
+      playing_ = false;
+  }
+
   glWidget_->updateGL();
 
   //if(quit->ShouldQuit()) {
@@ -99,7 +108,50 @@ void MyWindow::resetCamera(){
   glWidget_->resetCam();
 }
 
+void MyWindow::setReplay(TraceReplay *replay){
+  replay_ = replay;
+  playing_ = false;
+  seekReplay(0);
+}
+
+void MyWindow::seekReplay(long step){
+  replay_->seek(step);
+  setWindowTitle(tr("FIRM Replay - step %1 / %2 (Space: play/pause, Left/Right: step, Up/Down: 100 steps)")
+                 .arg(replay_->getCurrentStep() + 1).arg(replay_->getNumberOfSteps()));
+}
+
 void MyWindow::keyPressEvent(QKeyEvent *e) {
+  if(replay_){
+    const long step = replay_->getCurrentStep();
+    switch(e->key()){
+      case Qt::Key_Space:
+        playing_ = !playing_;
+        return;
+      case Qt::Key_Right:
+        playing_ = false;
+        seekReplay(step + 1);
+        return;
+      case Qt::Key_Left:
+        playing_ = false;
+        seekReplay(step - 1);
+        return;
+      case Qt::Key_Up:
+        seekReplay(step + 100);
+        return;
+      case Qt::Key_Down:
+        seekReplay(step - 100);
+        return;
+      case Qt::Key_Home:
+        seekReplay(0);
+        return;
+      case Qt::Key_End:
+        seekReplay(replay_->getNumberOfSteps() - 1);
+        return;
+      default:
+        break;
+    }
+  }
+
   switch(e->key()){
     case Qt::Key_Escape:
       cout << "User pressed Esc to close " << endl;
@@ -0,0 +1,120 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include <boost/program_options.hpp>
+#include <boost/filesystem.hpp>
+#include <iostream>
+
+#include "Experiments/BatchExperiment.h"
+
+namespace po = boost::program_options;
+
+/**
+    bsp-batch: run every setup file with every seed without the GUI.
+
+    bsp-batch --setups a.xml b.xml --seeds 1 2 3 --set "FIRM/MCParticles@numparticles=20" --jobs 4 --out results
+*/
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> setups, overrides;
+
+    std::vector<unsigned int> seeds;
+
+    unsigned int numWorkers = 0;
+
+    double timeout = 0;
+
+    std::string outputDirectory;
+
+    po::options_description desc("Options");
+
+    desc.add_options()
+        ("help", "show this message")
+        ("setups", po::value<std::vector<std::string> >(&setups)->multitoken()->required(), "setup files to run")
+        ("seeds", po::value<std::vector<unsigned int> >(&seeds)->multitoken(), "random seeds, every setup runs once per seed (default 1)")
+        ("set", po::value<std::vector<std::string> >(&overrides)->composing(), "parameter override Element/Child@attribute=value, may be repeated")
+        ("jobs", po::value<unsigned int>(&numWorkers)->default_value(0), "jobs that run at the same time, 0 uses all cores")
+        ("timeout", po::value<double>(&timeout)->default_value(0), "kill a job after this many seconds, 0 waits forever")
+        ("out", po::value<std::string>(&outputDirectory)->default_value("BatchResults"), "output directory");
+
+    po::variables_map vm;
+
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+
+        if(vm.count("help"))
+        {
+            std::cout << desc << std::endl;
+            return 0;
+        }
+
+        po::notify(vm);
+    }
+    catch(po::error &e)
+    {
+        std::cerr << e.what() << std::endl << desc << std::endl;
+        return 1;
+    }
+
+    if(seeds.empty())
+        seeds.push_back(1);
+
+    BatchExperiment experiment(outputDirectory);
+
+    experiment.setNumWorkers(numWorkers);
+
+    experiment.setTimeout(timeout);
+
+    for(size_t i = 0; i < setups.size(); i++)
+    {
+        for(size_t j = 0; j < seeds.size(); j++)
+        {
+            experiment.addJob(setups[i], seeds[j], overrides);
+        }
+    }
+
+    experiment.run();
+
+    const std::string results = (boost::filesystem::path(outputDirectory) / "results.csv").string();
+
+    const std::string summary = (boost::filesystem::path(outputDirectory) / "summary.csv").string();
+
+    if(!experiment.writeResults(results) || !experiment.writeSummary(summary))
+        return 1;
+
+    OMPL_INFORM("Batch complete, results in %s, summary in %s", results.c_str(), summary.c_str());
+
+    return 0;
+}
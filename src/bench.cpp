@@ -0,0 +1,315 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include <boost/program_options.hpp>
+#include <ompl/base/goals/GoalState.h>
+
+#include "Setup/TwoDPointRobotSetup.h"
+#include "Experiments/MicroBenchmark.h"
+#include "Experiments/ToolDriver.h"
+
+namespace po = boost::program_options;
+
+namespace
+{
+    /** \brief Length of the edge the controller benchmark executes, meters */
+    const double BENCH_EDGE_LENGTH = 1.0;
+
+    /** \brief Number of random states the collision benchmarks cycle through */
+    const unsigned int BENCH_NUM_STATES = 1000;
+
+    /** \brief Longest motion the motion check benchmark validates, meters */
+    const double BENCH_MAX_MOTION_LENGTH = 0.5;
+
+    /** \brief Covariance of the benchmark belief if the start is not observable */
+    const double BENCH_DEFAULT_COVARIANCE = 0.01;
+}
+
+/**
+    bsp-bench: time the kernels that dominate planning and execution in isolation.
+
+    bsp-bench --setup ./SetupFiles/SetupTROSims.xml --seed 1 --format csv --out bench.csv
+
+    The space, motion model, observation model and validity checker are the ones TwoDPointRobotSetup builds from the
+    setup file; the unicycle and camera models are built from the same file. The kernels work on the start state of
+    the planning problem and on an edge of BENCH_EDGE_LENGTH from the start towards the goal.
+*/
+int main(int argc, char *argv[])
+{
+    unsigned int minIterations = 0;
+
+    double minTime = 0;
+
+    ToolDriver driver("bsp-bench", "kernels", "./SetupFiles/SetupTROSims.xml", "random seed, applied before every kernel");
+
+    driver.getOptions().add_options()
+        ("min-iterations", po::value<unsigned int>(&minIterations)->default_value(100), "timed iterations per kernel, at least")
+        ("min-time", po::value<double>(&minTime)->default_value(0.5), "seconds per kernel, at least");
+
+    const int exitCode = driver.parse(argc, argv);
+
+    if(exitCode >= 0)
+        return exitCode;
+
+    SetupConfiguration::SetupConfigurationPtr config = driver.start();
+
+    if(!config)
+        return 1;
+
+    TwoDPointRobotSetup *setup(new TwoDPointRobotSetup);
+
+    setup->setSetupConfiguration(config);
+
+    setup->setup();
+
+    const firm::SpaceInformation::SpaceInformationPtr &si = setup->getSpaceInformation();
+
+    si->showRobotVisualization(false);
+
+    MotionModelMethod::MotionModelPointer mm = si->getMotionModel();
+
+    ObservationModelMethod::ObservationModelPointer om = si->getObservationModel();
+
+    const ompl::base::ProblemDefinitionPtr &pdef = setup->getFIRM()->getProblemDefinition();
+
+    ompl::base::State *start = si->cloneState(pdef->getStartState(0));
+
+    const ompl::base::State *goal = pdef->getGoal()->as<ompl::base::GoalState>()->getState();
+
+    // the belief at the start carries the stationary covariance of a node there, as a FIRM node would
+    const ObservationModelMethod::ObservationType startObservation = om->getObservation(start, false);
+
+    LinearSystem nodeSystem(si, start, mm->getZeroControl(), startObservation, mm, om);
+
+    LinearizedKF linearizedKF(si);
+
+    const bool startObservable = om->isStateObservable(start);
+
+    arma::mat startCovariance = arma::eye(3, 3) * BENCH_DEFAULT_COVARIANCE;
+
+    if(startObservable)
+        startCovariance = linearizedKF.computeStationaryCovariance(nodeSystem);
+    else
+        OMPL_WARN("bsp-bench: The start state is not observable, the stationary covariance kernel is skipped");
+
+    start->as<SE2BeliefSpace::StateType>()->setCovariance(startCovariance);
+
+    // an edge from the start towards the goal, built the way FIRM builds edge controllers
+    ompl::base::State *target = si->allocState();
+
+    const double goalDistance = si->distance(start, goal);
+
+    si->getStateSpace()->interpolate(start, goal, goalDistance > BENCH_EDGE_LENGTH ? BENCH_EDGE_LENGTH / goalDistance : 1.0, target);
+
+    target->as<SE2BeliefSpace::StateType>()->setCovariance(startCovariance);
+
+    std::vector<ompl::control::Control*> openLoopControls;
+
+    mm->generateOpenLoopControls(start, target, openLoopControls);
+
+    if(openLoopControls.empty())
+    {
+        OMPL_ERROR("bsp-bench: The start of the planning problem is at the goal, there is no edge to benchmark");
+        return 1;
+    }
+
+    std::vector<ompl::base::State*> intermediates;
+
+    ompl::base::State *intermediate = si->cloneState(start);
+
+    for(size_t i = 0; i < openLoopControls.size(); i++)
+    {
+        ompl::base::State *x = si->allocState();
+        mm->Evolve(intermediate, openLoopControls[i], mm->getZeroNoise(), x);
+        intermediates.push_back(x);
+        si->copyState(intermediate, x);
+    }
+
+    si->freeState(intermediate);
+
+    FIRM::EdgeControllerType edgeController(target, intermediates, openLoopControls, si);
+
+    edgeController.adoptNominalTrajectory(intermediates, openLoopControls);
+
+    // the unicycle and the camera are not part of this setup, they read their sections of the same file
+    MotionModelMethod::MotionModelPointer unicycle(new UnicycleMotionModel(si, *config));
+
+    std::vector<ompl::control::Control*> unicycleControls;
+
+    unicycle->generateOpenLoopControls(start, target, unicycleControls);
+
+    ompl::control::Control *unicycleControl = unicycleControls.empty() ? unicycle->getZeroControl() : unicycleControls.front();
+
+    const MotionModelMethod::NoiseType unicycleNoise = unicycle->generateNoise(start, unicycleControl);
+
+    ObservationModelMethod::ObservationModelPointer camera(new CamAruco2DObservationModel(si, *config));
+
+    const ObservationModelMethod::ObservationType cameraObservation = camera->getObservation(start, false);
+
+    OMPL_INFORM("bsp-bench: The camera sees %u landmarks from the start", (unsigned int)(cameraObservation.n_rows / CamAruco2DObservationModel::singleObservationDim));
+
+    // random states and short motions for the collision checks
+    std::vector<ompl::base::State*> states(BENCH_NUM_STATES), motionEnds(BENCH_NUM_STATES);
+
+    ompl::base::StateSamplerPtr sampler = si->allocStateSampler();
+
+    for(unsigned int i = 0; i < BENCH_NUM_STATES; i++)
+    {
+        states[i] = si->allocState();
+        sampler->sampleUniform(states[i]);
+    }
+
+    for(unsigned int i = 0; i < BENCH_NUM_STATES; i++)
+    {
+        const ompl::base::State *towards = states[(i + 1) % BENCH_NUM_STATES];
+
+        const double d = si->distance(states[i], towards);
+
+        motionEnds[i] = si->allocState();
+
+        si->getStateSpace()->interpolate(states[i], towards, d > BENCH_MAX_MOTION_LENGTH ? BENCH_MAX_MOTION_LENGTH / d : 1.0, motionEnds[i]);
+    }
+
+    const ompl::base::StateValidityCheckerPtr &validityChecker = si->getStateValidityChecker();
+
+    const std::string checkerName = std::dynamic_pointer_cast<SignedDistanceFieldValidityChecker>(validityChecker) ?
+                                    "SignedDistanceFieldValidityChecker" : "FCLStateValidityChecker";
+
+    // kernel outputs, kept alive so that the calls cannot be optimized away
+    ompl::base::State *evolved = si->allocState();
+
+    ompl::base::State *endState = si->allocState();
+
+    arma::mat matrixResult;
+
+    ObservationModelMethod::ObservationType observationResult;
+
+    LinearSystem unusedSystem;
+
+    ExtendedKF extendedKF(si);
+
+    unsigned int stateIndex = 0;
+
+    unsigned int validCount = 0;
+
+    MicroBenchmark bench(driver.getSeed());
+
+    bench.setMinIterations(minIterations);
+
+    bench.setMinTime(minTime);
+
+    bench.setFilter(driver.getFilter());
+
+    bench.add("ExtendedKF::Evolve", [&]()
+    {
+        extendedKF.Evolve(start, openLoopControls.front(), startObservation, unusedSystem, unusedSystem, evolved);
+    });
+
+    bench.add("UnicycleMotionModel::getStateJacobian", [&]()
+    {
+        matrixResult = unicycle->getStateJacobian(start, unicycleControl, unicycle->getZeroNoise());
+    });
+
+    bench.add("UnicycleMotionModel::Evolve", [&]()
+    {
+        unicycle->Evolve(start, unicycleControl, unicycleNoise, evolved);
+    });
+
+    bench.add("CamAruco2DObservationModel::getObservation", [&]()
+    {
+        observationResult = camera->getObservation(start, true);
+    });
+
+    bench.add("CamAruco2DObservationModel::getObservationPrediction", [&]()
+    {
+        observationResult = camera->getObservationPrediction(start, cameraObservation);
+    });
+
+    bench.add("dare", [&]()
+    {
+        dare(nodeSystem.getA(), nodeSystem.getB(), mm->getTerminalStateCost(), mm->getControlCost(), matrixResult);
+    });
+
+    if(startObservable)
+    {
+        bench.add("LinearizedKF::computeStationaryCovariance", [&]()
+        {
+            matrixResult = linearizedKF.computeStationaryCovariance(nodeSystem);
+        });
+    }
+
+    bench.add("Controller::Execute", [&]()
+    {
+        si->setTrueState(start);
+        si->setBelief(start);
+
+        ompl::base::Cost filteringCost(0);
+        int stepsTaken = 0, timeToStop = 0;
+
+        edgeController.Execute(start, endState, filteringCost, stepsTaken, timeToStop, true);
+    });
+
+    bench.add(checkerName + "::isValid", [&]()
+    {
+        validCount += validityChecker->isValid(states[stateIndex++ % BENCH_NUM_STATES]);
+    });
+
+    bench.add(checkerName + "::checkMotion", [&]()
+    {
+        const unsigned int i = stateIndex++ % BENCH_NUM_STATES;
+
+        validCount += si->checkMotion(states[i], motionEnds[i]);
+    });
+
+    bench.run();
+
+    OMPL_INFORM("bsp-bench: %u valid states and motions", validCount);
+
+    const bool written = driver.write(bench.getResultTable());
+
+    for(unsigned int i = 0; i < BENCH_NUM_STATES; i++)
+    {
+        si->freeState(states[i]);
+        si->freeState(motionEnds[i]);
+    }
+
+    si->freeState(evolved);
+    si->freeState(endState);
+    si->freeState(target);
+    si->freeState(start);
+
+    delete setup;
+
+    return written ? 0 : 1;
+}
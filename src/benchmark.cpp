@@ -0,0 +1,104 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include <boost/program_options.hpp>
+#include <iostream>
+
+#include "Experiments/PlannerBenchmark.h"
+
+namespace po = boost::program_options;
+
+/**
+    bsp-benchmark: run the reference scenarios end to end and write results comparable across commits.
+
+    bsp-benchmark --benchmark ./SetupFiles/BenchmarkReference.xml --out BenchmarkResults/<commit>
+    ompl_benchmark_statistics.py BenchmarkResults/<commit>/*.log -d benchmark.db
+*/
+int main(int argc, char *argv[])
+{
+    std::string benchmarkFile, outputDirectory;
+
+    std::vector<unsigned int> seeds;
+
+    double budget = 0;
+
+    unsigned int numWorkers = 1;
+
+    po::options_description desc("Options");
+
+    desc.add_options()
+        ("help", "show this message")
+        ("benchmark", po::value<std::string>(&benchmarkFile)->default_value("./SetupFiles/BenchmarkReference.xml"), "benchmark file with the scenarios")
+        ("seeds", po::value<std::vector<unsigned int> >(&seeds)->multitoken(), "replace the seeds of the benchmark file")
+        ("budget", po::value<double>(&budget), "replace the planning budget of the benchmark file, seconds")
+        ("jobs", po::value<unsigned int>(&numWorkers)->default_value(1), "runs at the same time, more than 1 skews the timings")
+        ("out", po::value<std::string>(&outputDirectory)->default_value("BenchmarkResults"), "output directory");
+
+    po::variables_map vm;
+
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+
+        if(vm.count("help"))
+        {
+            std::cout << desc << std::endl;
+            return 0;
+        }
+
+        po::notify(vm);
+    }
+    catch(po::error &e)
+    {
+        std::cerr << e.what() << std::endl << desc << std::endl;
+        return 1;
+    }
+
+    PlannerBenchmark benchmark(benchmarkFile, outputDirectory);
+
+    if(!seeds.empty())
+        benchmark.setSeeds(seeds);
+
+    if(vm.count("budget"))
+        benchmark.setBudget(budget);
+
+    benchmark.setNumWorkers(numWorkers);
+
+    if(!benchmark.run())
+        return 1;
+
+    OMPL_INFORM("Benchmark complete, results in %s", outputDirectory.c_str());
+
+    return 0;
+}
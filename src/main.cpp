@@ -64,6 +64,7 @@
 #endif
 
 #include "Setup/MultiModalSetup.h"
+#include "Visualization/TraceReplay.h"
 //#include "Testing/Tests.h"
 
 using namespace std;
@@ -189,6 +190,25 @@ int main(int argc, char *argv[])
 
     window.resetCamera();
 
+    // bsp-app-demo --replay <trace>: step through a recorded execution instead of planning
+    if(argc > 2 && std::string(argv[1]) == "--replay")
+    {
+        TraceReplay replay;
+
+        if(!replay.load(argv[2]))
+        {
+            printf("Could not load execution trace %s. Exiting.\n", argv[2]);
+
+            exit(1);
+        }
+
+        window.setReplay(&replay);
+
+        app.exec();
+
+        exit(0);
+    }
+
     /**
      Below you have 2 options:
 
@@ -0,0 +1,131 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include <boost/program_options.hpp>
+#include <iostream>
+#include <unistd.h>
+
+#include "Setup/TwoDPointRobotSetup.h"
+#include "Service/PlannerService.h"
+#include "Utils/FIRMUtils.h"
+
+namespace po = boost::program_options;
+
+/**
+    bsp-service: solve a setup once, then answer start/goal queries on its roadmap.
+
+    bsp-service --setup ./SetupFiles/SetupTROSims.xml --socket /tmp/firm.sock
+    bsp-service --setup ./SetupFiles/SetupTROSims.xml --stdin
+*/
+int main(int argc, char *argv[])
+{
+    std::string setupFile, socketPath;
+
+    po::options_description desc("Options");
+
+    desc.add_options()
+        ("help", "show this message")
+        ("setup", po::value<std::string>(&setupFile)->required(), "setup file, its planning problem is solved once to build the roadmap")
+        ("socket", po::value<std::string>(&socketPath), "listen on this Unix domain socket")
+        ("stdin", "read requests from stdin and answer on stdout, the log goes to stderr");
+
+    po::variables_map vm;
+
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+
+        if(vm.count("help"))
+        {
+            std::cout << desc << std::endl;
+            return 0;
+        }
+
+        po::notify(vm);
+    }
+    catch(po::error &e)
+    {
+        std::cerr << e.what() << std::endl << desc << std::endl;
+        return 1;
+    }
+
+    if(socketPath.empty() == !vm.count("stdin"))
+    {
+        std::cerr << "Give either --socket or --stdin" << std::endl << desc << std::endl;
+        return 1;
+    }
+
+    // keep stdout for the answers, everything the planner prints goes to stderr
+    int responseFd = STDOUT_FILENO;
+
+    if(vm.count("stdin"))
+    {
+        std::cout.flush();
+
+        responseFd = dup(STDOUT_FILENO);
+
+        dup2(STDERR_FILENO, STDOUT_FILENO);
+    }
+
+    FIRMUtils::setHeadless(true);
+
+    TwoDPointRobotSetup *setup(new TwoDPointRobotSetup);
+
+    setup->setPathToSetupFile(setupFile);
+
+    setup->setup();
+
+    if(!setup->solve())
+    {
+        OMPL_ERROR("Could not solve the planning problem of %s, there is no roadmap to serve.", setupFile.c_str());
+        return 1;
+    }
+
+    PlannerService service(setup);
+
+    if(vm.count("stdin"))
+    {
+        OMPL_INFORM("PlannerService: Reading requests from stdin");
+
+        service.serveConnection(STDIN_FILENO, responseFd);
+    }
+    else if(!service.serveSocket(socketPath))
+    {
+        return 1;
+    }
+
+    delete setup;
+
+    return 0;
+}
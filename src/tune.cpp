@@ -0,0 +1,110 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include <boost/program_options.hpp>
+#include <boost/filesystem.hpp>
+#include <iostream>
+
+#include "Experiments/ParameterTuner.h"
+
+namespace po = boost::program_options;
+
+/**
+    bsp-tune: search the planner parameters of a setup file and write the best configuration as a new setup file.
+
+    bsp-tune --tuning ./SetupFiles/TuningTask3.xml --jobs 2 --out TuningResults --setup-out ./SetupFiles/Task3-tuned.xml
+*/
+int main(int argc, char *argv[])
+{
+    std::string tuningFile, outputDirectory, setupOutput, strategy;
+
+    std::vector<unsigned int> seeds;
+
+    unsigned int numWorkers = 1;
+
+    po::options_description desc("Options");
+
+    desc.add_options()
+        ("help", "show this message")
+        ("tuning", po::value<std::string>(&tuningFile)->required(), "tuning file with the setup file, target and parameters")
+        ("seeds", po::value<std::vector<unsigned int> >(&seeds)->multitoken(), "replace the seeds of the tuning file")
+        ("strategy", po::value<std::string>(&strategy), "replace the strategy of the tuning file, grid or coordinate")
+        ("jobs", po::value<unsigned int>(&numWorkers)->default_value(1), "runs at the same time, more than 1 skews the planning times")
+        ("out", po::value<std::string>(&outputDirectory)->default_value("TuningResults"), "output directory")
+        ("setup-out", po::value<std::string>(&setupOutput), "where to write the tuned setup file (default <out>/tuned.xml)");
+
+    po::variables_map vm;
+
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+
+        if(vm.count("help"))
+        {
+            std::cout << desc << std::endl;
+            return 0;
+        }
+
+        po::notify(vm);
+    }
+    catch(po::error &e)
+    {
+        std::cerr << e.what() << std::endl << desc << std::endl;
+        return 1;
+    }
+
+    ParameterTuner tuner(tuningFile, outputDirectory);
+
+    if(!seeds.empty())
+        tuner.setSeeds(seeds);
+
+    if(vm.count("strategy"))
+        tuner.setStrategy(strategy);
+
+    tuner.setNumWorkers(numWorkers);
+
+    if(!tuner.run())
+        return 1;
+
+    if(setupOutput.empty())
+        setupOutput = (boost::filesystem::path(outputDirectory) / "tuned.xml").string();
+
+    if(!tuner.writeBestSetup(setupOutput))
+        return 1;
+
+    OMPL_INFORM("Tuning complete, candidates in %s, best setup written to %s", outputDirectory.c_str(), setupOutput.c_str());
+
+    // a configuration that misses the target is still written, but the caller should know
+    return tuner.meetsTarget(tuner.getBest()) ? 0 : 2;
+}
@@ -0,0 +1,394 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2014, Texas A&M University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Texas A&M University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include <boost/program_options.hpp>
+#include <boost/algorithm/string.hpp>
+#include <ompl/base/goals/GoalState.h>
+#include <ompl/util/RandomNumbers.h>
+#include <sstream>
+
+#include "Setup/TwoDPointRobotSetup.h"
+#include "Experiments/DifferentialVerifier.h"
+#include "Experiments/ToolDriver.h"
+
+namespace po = boost::program_options;
+
+namespace
+{
+    /** \brief Filter steps per trial of the estimator check */
+    const unsigned int VERIFY_FILTER_STEPS = 50;
+
+    /** \brief Random poses per trial of the line of sight check */
+    const unsigned int VERIFY_NUM_LOS_STATES = 200;
+
+    /** \brief Covariance of the initial belief of the estimator check */
+    const double VERIFY_INITIAL_COVARIANCE = 0.01;
+
+    /** \brief Deterministic implementations must agree up to rounding */
+    const DifferentialVerifier::Tolerance NUMERIC_TOLERANCE = {1e-9, 1e-9, 0};
+
+    /** \brief The distance field bounds the robot by a disc, a few line of sight answers near obstacles may differ from FCL */
+    const DifferentialVerifier::Tolerance LINE_OF_SIGHT_TOLERANCE = {0, 0, 0.05};
+
+    /** \brief Parse "name=absolute,relative,decisions" */
+    bool parseTolerance(const std::string &text, std::string &name, DifferentialVerifier::Tolerance &tolerance)
+    {
+        const size_t eq = text.find('=');
+
+        if(eq == std::string::npos)
+            return false;
+
+        name = text.substr(0, eq);
+
+        std::vector<std::string> fields;
+
+        boost::algorithm::split(fields, text.substr(eq + 1), boost::algorithm::is_any_of(","));
+
+        if(fields.size() != 3)
+            return false;
+
+        std::istringstream in(fields[0] + " " + fields[1] + " " + fields[2]);
+
+        return bool(in >> tolerance.absolute >> tolerance.relative >> tolerance.decisions);
+    }
+
+    /** \brief The live vertex with the given ordinal, see FIRM::vertexOrdinals() */
+    FIRM::Vertex vertexAt(const std::vector<long> &ordinals, long ordinal)
+    {
+        for(size_t v = 0; v < ordinals.size(); v++)
+        {
+            if(ordinals[v] == ordinal)
+                return v;
+        }
+
+        return 0;
+    }
+}
+
+/**
+    bsp-verify: run the reference implementations next to their faster alternatives on the same inputs and seeds and
+    fail if the results differ by more than the tolerances.
+
+    bsp-verify --setup ./SetupFiles/SetupTRO-iLQG-Comparison-Sim-Task3.xml --trials 5 --tolerance "LineOfSight=0,0,0.02"
+
+    Checks:
+    - ExtendedKFDeterminism: the EKF against a second instance of itself over noisy trajectories from the start. There is
+      no faster estimator yet, so this only catches a filter step that depends on anything but its inputs (e.g. state
+      kept between calls or unseeded noise). It becomes a differential check once candidateFilter is a new estimator.
+    - solveDynamicProgram: the map based DP (FIRM::DP_SOLVER_MAP) against the indexed DP (FIRM::DP_SOLVER_INDEXED), on the
+      roadmap solve() builds or loads, for a different goal node in every trial. Costs-to-go are values, feedback targets
+      are decisions.
+    - LineOfSight: CamAruco2DObservationModel::hasClearLineOfSight with the FCL checker of the robot mesh against the same
+      test with the signed distance field checker, for random poses and every landmark of the camera.
+
+    A new fast path is added as the candidate of its check.
+*/
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> tolerances;
+
+    unsigned int trials = 0;
+
+    ToolDriver driver("bsp-verify", "checks", "./SetupFiles/SetupTRO-iLQG-Comparison-Sim-Task3.xml", "random seed, trial t uses seed + t");
+
+    driver.getOptions().add_options()
+        ("trials", po::value<unsigned int>(&trials)->default_value(5), "trials per check")
+        ("tolerance", po::value<std::vector<std::string> >(&tolerances)->composing(), "check=absolute,relative,decisions, may be repeated");
+
+    const int exitCode = driver.parse(argc, argv);
+
+    if(exitCode >= 0)
+        return exitCode;
+
+    const unsigned int seed = driver.getSeed();
+
+    SetupConfiguration::SetupConfigurationPtr config = driver.start();
+
+    if(!config)
+        return 1;
+
+    // the reference collision backend is FCL, the distance field is built below as the candidate
+    const TiXmlElement *planningProblem = config->getSection("PlanningProblem");
+
+    const TiXmlElement *collisionChecker = planningProblem ? planningProblem->FirstChildElement("CollisionChecker") : NULL;
+
+    double sdfResolution = 0.05, robotRadius = 0.2;
+
+    std::string environmentCacheDir, pathToEnvironmentMesh;
+
+    if(collisionChecker)
+    {
+        collisionChecker->QueryDoubleAttribute("resolution", &sdfResolution);
+        collisionChecker->QueryDoubleAttribute("robotRadius", &robotRadius);
+        collisionChecker->QueryStringAttribute("cacheDir", &environmentCacheDir);
+
+        config->setAttribute("PlanningProblem/CollisionChecker@type=fcl");
+    }
+
+    if(const TiXmlElement *environment = planningProblem ? planningProblem->FirstChildElement("Environment") : NULL)
+        environment->QueryStringAttribute("environmentFile", &pathToEnvironmentMesh);
+
+    TwoDPointRobotSetup *setup(new TwoDPointRobotSetup);
+
+    setup->setSetupConfiguration(config);
+
+    setup->setup();
+
+    const firm::SpaceInformation::SpaceInformationPtr &si = setup->getSpaceInformation();
+
+    si->showRobotVisualization(false);
+
+    MotionModelMethod::MotionModelPointer mm = si->getMotionModel();
+
+    ObservationModelMethod::ObservationModelPointer om = si->getObservationModel();
+
+    const ompl::base::ProblemDefinitionPtr &pdef = setup->getFIRM()->getProblemDefinition();
+
+    const ompl::base::RealVectorBounds &bounds = si->getStateSpace()->as<SE2BeliefSpace>()->getBounds();
+
+    DifferentialVerifier verifier(seed);
+
+    verifier.setTrials(trials);
+
+    verifier.setFilter(driver.getFilter());
+
+    // Estimator: every trial drives the true state with noise from the start towards a random pose and records the observations,
+    // both filters then run on the same controls and observations
+    struct FilterInput
+    {
+        std::vector<ompl::control::Control*> controls;
+
+        std::vector<ObservationModelMethod::ObservationType> observations;
+    };
+
+    std::vector<FilterInput> filterInputs(trials);
+
+    ompl::base::State *start = si->cloneState(pdef->getStartState(0));
+
+    start->as<SE2BeliefSpace::StateType>()->setCovariance(arma::eye(3, 3) * VERIFY_INITIAL_COVARIANCE);
+
+    for(unsigned int t = 0; t < trials; t++)
+    {
+        ompl::RNG rng(seed + t);
+
+        arma::arma_rng::set_seed(seed + t);
+
+        ompl::base::State *target = si->allocState();
+
+        target->as<SE2BeliefSpace::StateType>()->setXYYaw(rng.uniformReal(bounds.low[0], bounds.high[0]), rng.uniformReal(bounds.low[1], bounds.high[1]),
+                                                        rng.uniformReal(-boost::math::constants::pi<double>(), boost::math::constants::pi<double>()));
+
+        mm->generateOpenLoopControls(start, target, filterInputs[t].controls);
+
+        if(filterInputs[t].controls.size() > VERIFY_FILTER_STEPS)
+            filterInputs[t].controls.resize(VERIFY_FILTER_STEPS);
+
+        ompl::base::State *trueState = si->cloneState(start);
+
+        ompl::base::State *nextState = si->allocState();
+
+        for(size_t i = 0; i < filterInputs[t].controls.size(); i++)
+        {
+            mm->Evolve(trueState, filterInputs[t].controls[i], mm->generateNoise(trueState, filterInputs[t].controls[i]), nextState);
+
+            si->copyState(trueState, nextState);
+
+            filterInputs[t].observations.push_back(om->getObservation(trueState, true));
+        }
+
+        si->freeState(nextState);
+        si->freeState(trueState);
+        si->freeState(target);
+    }
+
+    ExtendedKF referenceFilter(si);
+
+    // the candidate filter, replace it (and rename the check) to verify a faster estimator
+    std::shared_ptr<KalmanFilterMethod> candidateFilter(new ExtendedKF(si));
+
+    const auto runFilter = [&](KalmanFilterMethod &kf, unsigned int trial, DifferentialVerifier::Output &output)
+    {
+        const FilterInput &input = filterInputs[trial];
+
+        LinearSystem unusedSystem;
+
+        ompl::base::State *belief = si->cloneState(start);
+
+        ompl::base::State *evolved = si->allocState();
+
+        for(size_t i = 0; i < input.controls.size(); i++)
+        {
+            kf.Evolve(belief, input.controls[i], input.observations[i], unusedSystem, unusedSystem, evolved);
+
+            si->copyState(belief, evolved);
+
+            const arma::colvec mean = belief->as<SE2BeliefSpace::StateType>()->getArmaData();
+
+            const arma::mat covariance = belief->as<SE2BeliefSpace::StateType>()->getCovariance();
+
+            output.values.insert(output.values.end(), mean.begin(), mean.end());
+            output.values.insert(output.values.end(), covariance.begin(), covariance.end());
+        }
+
+        si->freeState(evolved);
+        si->freeState(belief);
+    };
+
+    verifier.add("ExtendedKFDeterminism",
+                 [&](unsigned int trial, DifferentialVerifier::Output &output) { runFilter(referenceFilter, trial, output); },
+                 [&](unsigned int trial, DifferentialVerifier::Output &output) { runFilter(*candidateFilter, trial, output); },
+                 NUMERIC_TOLERANCE);
+
+    // Dynamic program, on the roadmap of the planning problem
+    FIRM *firm = setup->getFIRM();
+
+    bool haveRoadmap = false;
+
+    if(verifier.isSelected("solveDynamicProgram"))
+    {
+        haveRoadmap = bool(setup->solve()) && firm->milestoneCount() > 1;
+
+        if(!haveRoadmap)
+            OMPL_WARN("bsp-verify: The planning problem was not solved, the dynamic program check is skipped");
+    }
+
+    const auto runDP = [&](FIRM::DPSolverType solver, unsigned int trial, DifferentialVerifier::Output &output)
+    {
+        const FIRM::Graph &g = firm->getRoadmap();
+
+        // removed vertices leave free slots in the graph, the goals and the results only use the live ones
+        const std::vector<long> ordinals = firm->vertexOrdinals();
+
+        // spread the goals of the trials over the roadmap
+        const FIRM::Vertex goal = vertexAt(ordinals, (trial + 1) * firm->milestoneCount() / (trials + 1));
+
+        std::map<FIRM::Vertex, double> costToGo;
+
+        std::map<FIRM::Vertex, FIRM::Edge> feedback;
+
+        firm->solvePolicy(goal, solver, costToGo, feedback);
+
+        BOOST_FOREACH(FIRM::Vertex v, boost::vertices(g))
+        {
+            if(!firm->isVertexAlive(v))
+                continue;
+
+            output.values.push_back(costToGo[v]);
+
+            std::map<FIRM::Vertex, FIRM::Edge>::const_iterator f = feedback.find(v);
+
+            output.decisions.push_back(f == feedback.end() ? -1 : ordinals[boost::target(f->second, g)]);
+        }
+    };
+
+    if(haveRoadmap)
+    {
+        verifier.add("solveDynamicProgram",
+                     [&](unsigned int trial, DifferentialVerifier::Output &output) { runDP(FIRM::DP_SOLVER_MAP, trial, output); },
+                     [&](unsigned int trial, DifferentialVerifier::Output &output) { runDP(FIRM::DP_SOLVER_INDEXED, trial, output); },
+                     NUMERIC_TOLERANCE);
+    }
+
+    // Line of sight, with the configured FCL checker and with the distance field of the same environment
+    const ompl::base::StateValidityCheckerPtr referenceChecker = si->getStateValidityChecker();
+
+    ompl::base::StateValidityCheckerPtr candidateChecker;
+
+    if(!pathToEnvironmentMesh.empty() && verifier.isSelected("LineOfSight"))
+        candidateChecker = std::make_shared<SignedDistanceFieldValidityChecker>(si, pathToEnvironmentMesh, sdfResolution, robotRadius, environmentCacheDir);
+
+    std::shared_ptr<CamAruco2DObservationModel> camera;
+
+    if(config->getSection("LandmarkList"))
+        camera = std::make_shared<CamAruco2DObservationModel>(si, *config);
+
+    const auto runLineOfSight = [&](const ompl::base::StateValidityCheckerPtr &checker, unsigned int trial, DifferentialVerifier::Output &output)
+    {
+        ompl::RNG rng(seed + trial);
+
+        ompl::base::State *state = si->allocState();
+
+        si->setStateValidityChecker(checker);
+
+        const std::vector<arma::colvec> &landmarks = camera->getLandmarks();
+
+        for(unsigned int i = 0; i < VERIFY_NUM_LOS_STATES; i++)
+        {
+            state->as<SE2BeliefSpace::StateType>()->setXYYaw(rng.uniformReal(bounds.low[0], bounds.high[0]),
+                                                            rng.uniformReal(bounds.low[1], bounds.high[1]), 0);
+
+            for(size_t j = 0; j < landmarks.size(); j++)
+                output.decisions.push_back(camera->hasClearLineOfSight(state, landmarks[j]));
+        }
+
+        si->setStateValidityChecker(referenceChecker);
+
+        si->freeState(state);
+    };
+
+    if(candidateChecker && camera)
+    {
+        verifier.add("LineOfSight",
+                     [&](unsigned int trial, DifferentialVerifier::Output &output) { runLineOfSight(referenceChecker, trial, output); },
+                     [&](unsigned int trial, DifferentialVerifier::Output &output) { runLineOfSight(candidateChecker, trial, output); },
+                     LINE_OF_SIGHT_TOLERANCE);
+    }
+    else if(verifier.isSelected("LineOfSight"))
+    {
+        OMPL_WARN("bsp-verify: The setup file has no environment mesh or no landmarks, the line of sight check is skipped");
+    }
+
+    for(size_t i = 0; i < tolerances.size(); i++)
+    {
+        std::string name;
+
+        DifferentialVerifier::Tolerance tolerance;
+
+        if(!parseTolerance(tolerances[i], name, tolerance) || !verifier.setTolerance(name, tolerance))
+        {
+            OMPL_ERROR("bsp-verify: Invalid tolerance %s, expected check=absolute,relative,decisions for a check that runs", tolerances[i].c_str());
+            return 1;
+        }
+    }
+
+    verifier.run();
+
+    const bool written = driver.write(verifier.getResultTable());
+
+    si->freeState(start);
+
+    delete setup;
+
+    return written && verifier.passed() ? 0 : 1;
+}